@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+
 #include <cstdint> /// for uint64_t
 
 namespace tean
@@ -37,17 +40,29 @@ public:
 #if (not defined(NDEBUG))
       m_prevSequenceNumber(0),
 #endif
-      m_value(0.0)
+      m_value(0.0),
+      m_prevValue(0.0)
    {}
 
-   accumulation_distribution_line(accumulation_distribution_line &&) = delete;
-   accumulation_distribution_line(accumulation_distribution_line const &) = delete;
+   [[maybe_unused, nodiscard]] accumulation_distribution_line(accumulation_distribution_line &&) noexcept = default;
+   [[maybe_unused, nodiscard]] accumulation_distribution_line(accumulation_distribution_line const &) = default;
+
+   [[maybe_unused]] accumulation_distribution_line &operator = (accumulation_distribution_line &&) noexcept = default;
+   [[maybe_unused]] accumulation_distribution_line &operator = (accumulation_distribution_line const &) = default;
 
-   accumulation_distribution_line &operator = (accumulation_distribution_line &&) = delete;
-   accumulation_distribution_line &operator = (accumulation_distribution_line const &) = delete;
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose, double inVolume) noexcept;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose, double inVolume) noexcept;
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   /// Money flow volume the latest bar added to the line
+   [[maybe_unused, nodiscard]] double money_flow_volume() const noexcept
+   {
+      return m_value - m_prevValue;
+   }
+
    [[nodiscard]] double pick(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose, double inVolume) const noexcept;
 
    [[maybe_unused]] void reset() noexcept
@@ -56,13 +71,24 @@ public:
       m_prevSequenceNumber = 0;
 #endif
       m_value = 0.0;
+      m_prevValue = 0.0;
    }
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number and returns the line after it, carried forward bars
+   /// repeat the money flow volume of the latest bar, zero volume and decay only bars add nothing, the missing bars cannot be amended
+   [[nodiscard]] double skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
 private:
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
 #endif
    double m_value;
+   /// The value preceding the latest bar, an amended calc starts over from it
+   double m_prevValue;
+
+   [[nodiscard]] double do_calc(double inHigh, double inLow, double inClose, double inVolume) noexcept;
 };
 
 }
@@ -26,34 +26,261 @@
 #pragma once
 
 #include "tean/accumulation_distribution_line.hpp" /// for tean::accumulation_distribution_line
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
+#include <limits> /// for std::numeric_limits
 
 namespace tean
 {
 
-class [[nodiscard]] accumulation_distribution_oscillator final
+template<uint32_t fast_period = static_cast<uint32_t>(-1), uint32_t slow_period = static_cast<uint32_t>(-1)>
+class accumulation_distribution_oscillator;
+
+template<uint32_t fast_period, uint32_t slow_period>
+class [[maybe_unused]] accumulation_distribution_oscillator final
 {
+   static_assert(1 < fast_period);
+   static_assert(fast_period < slow_period);
+
+   static constexpr inline auto fast_smoothing_factor{2.0 / (fast_period + 1),};
+   static constexpr inline auto slow_smoothing_factor{2.0 / (slow_period + 1),};
+
 public:
+   /// A copy carries the line and both averages, so hypothetical bars never reach the indicator and never allocate
+   using lookahead_type = accumulation_distribution_oscillator;
+
+   [[maybe_unused, nodiscard]] explicit constexpr accumulation_distribution_oscillator(uint32_t const inUntrustedPeriod) noexcept :
+      m_lookbackPeriod{inUntrustedPeriod + slow_period - 1,}
+   {}
+
+   [[maybe_unused, nodiscard]] accumulation_distribution_oscillator(accumulation_distribution_oscillator &&) noexcept = default;
+   [[maybe_unused, nodiscard]] accumulation_distribution_oscillator(accumulation_distribution_oscillator const &) = default;
+
+   [[maybe_unused]] accumulation_distribution_oscillator &operator = (accumulation_distribution_oscillator &&) noexcept = default;
+   [[maybe_unused]] accumulation_distribution_oscillator &operator = (accumulation_distribution_oscillator const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) noexcept
+   {
+      m_fastMovingAverage = m_prevFastMovingAverage;
+      m_slowMovingAverage = m_prevSlowMovingAverage;
+      return do_calc(inSequenceNumber, m_accumulationDistributionLine.amend(inSequenceNumber, inHigh, inLow, inClose, inVolume));
+   }
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume, double &outAccumulationDistribution) noexcept
+   {
+      m_fastMovingAverage = m_prevFastMovingAverage;
+      m_slowMovingAverage = m_prevSlowMovingAverage;
+      outAccumulationDistribution = m_accumulationDistributionLine.amend(inSequenceNumber, inHigh, inLow, inClose, inVolume);
+      return do_calc(inSequenceNumber, outAccumulationDistribution);
+   }
+
+   [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) noexcept
+   {
+      m_prevFastMovingAverage = m_fastMovingAverage;
+      m_prevSlowMovingAverage = m_slowMovingAverage;
+      return do_calc(inSequenceNumber, m_accumulationDistributionLine.calc(inSequenceNumber, inHigh, inLow, inClose, inVolume));
+   }
+
+   [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume, double &outAccumulationDistribution) noexcept
+   {
+      m_prevFastMovingAverage = m_fastMovingAverage;
+      m_prevSlowMovingAverage = m_slowMovingAverage;
+      outAccumulationDistribution = m_accumulationDistributionLine.calc(inSequenceNumber, inHigh, inLow, inClose, inVolume);
+      return do_calc(inSequenceNumber, outAccumulationDistribution);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(m_lookbackPeriod))
+         && (true == inReader.expect(fast_smoothing_factor))
+         && (true == inReader.expect(slow_smoothing_factor))
+         && (true == m_accumulationDistributionLine.load(inSequenceNumber, inReader))
+         && (true == inReader.read(m_fastMovingAverage))
+         && (true == inReader.read(m_slowMovingAverage))
+         && (true == inReader.read(m_prevFastMovingAverage))
+         && (true == inReader.read(m_prevSlowMovingAverage))
+      );
+   }
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t lookback_period() const noexcept
+   {
+      return m_lookbackPeriod;
+   }
+
+   [[maybe_unused, nodiscard]] static constexpr uint32_t period() noexcept
+   {
+      return slow_period;
+   }
+
+   [[maybe_unused, nodiscard]] double pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) const noexcept
+   {
+      return do_pick(inSequenceNumber, m_accumulationDistributionLine.pick(inSequenceNumber, inHigh, inLow, inClose, inVolume));
+   }
+
+   [[maybe_unused, nodiscard]] double pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume, double &outAccumulationDistribution) const noexcept
+   {
+      outAccumulationDistribution = m_accumulationDistributionLine.pick(inSequenceNumber, inHigh, inLow, inClose, inVolume);
+      return do_pick(inSequenceNumber, outAccumulationDistribution);
+   }
+
+   [[maybe_unused]] void reset() noexcept
+   {
+      m_accumulationDistributionLine.reset();
+      m_fastMovingAverage = 0;
+      m_slowMovingAverage = 0;
+      m_prevFastMovingAverage = 0;
+      m_prevSlowMovingAverage = 0;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(m_lookbackPeriod);
+      outWriter.write(fast_smoothing_factor);
+      outWriter.write(slow_smoothing_factor);
+      m_accumulationDistributionLine.save(inSequenceNumber, outWriter);
+      outWriter.write(m_fastMovingAverage);
+      outWriter.write(m_slowMovingAverage);
+      outWriter.write(m_prevFastMovingAverage);
+      outWriter.write(m_prevSlowMovingAverage);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, the line moves by the same money flow volume f
+   /// every missing bar, see accumulation_distribution_line::skip, and an average with smoothing factor a settles d = f * (1 - a) / a behind
+   /// such a ramp, so n bars taking the line from x0 to xn move the average to xn - d + (1 - a)^n * (average - x0 + d), the missing bars cannot be amended
+   [[maybe_unused]] void skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+   {
+      m_prevFastMovingAverage = std::numeric_limits<double>::signaling_NaN();
+      m_prevSlowMovingAverage = std::numeric_limits<double>::signaling_NaN();
+      auto const accumulationDistribution{m_accumulationDistributionLine.skip(inSequenceNumber, inGap, inFill),};
+      auto const moneyFlowVolume{m_accumulationDistributionLine.money_flow_volume(),};
+      m_fastMovingAverage = do_skip(m_fastMovingAverage, fast_smoothing_factor, accumulationDistribution, moneyFlowVolume, inGap);
+      m_slowMovingAverage = do_skip(m_slowMovingAverage, slow_smoothing_factor, accumulationDistribution, moneyFlowVolume, inGap);
+   }
+
+private:
+   uint32_t m_lookbackPeriod;
+   accumulation_distribution_line m_accumulationDistributionLine{};
+   double m_fastMovingAverage{0,};
+   double m_slowMovingAverage{0,};
+   /// The averages preceding the latest calc, an amended calc starts over from them
+   double m_prevFastMovingAverage{0,};
+   double m_prevSlowMovingAverage{0,};
+
+   [[nodiscard]] constexpr double do_calc(uint64_t const inSequenceNumber, double const inAccumulationDistribution) noexcept
+   {
+      assert(true == std::isfinite(inAccumulationDistribution));
+      assert(false == std::isnan(inAccumulationDistribution));
+      if (0 < inSequenceNumber) [[likely]]
+      {
+         m_fastMovingAverage += fast_smoothing_factor * (inAccumulationDistribution - m_fastMovingAverage);
+         m_slowMovingAverage += slow_smoothing_factor * (inAccumulationDistribution - m_slowMovingAverage);
+         if (m_lookbackPeriod <= inSequenceNumber) [[likely]]
+         {
+            return m_fastMovingAverage - m_slowMovingAverage;
+         }
+      }
+      else
+      {
+         m_fastMovingAverage = inAccumulationDistribution;
+         m_slowMovingAverage = inAccumulationDistribution;
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[nodiscard]] constexpr double do_pick(uint64_t const inSequenceNumber, double const inAccumulationDistribution) const noexcept
+   {
+      assert(true == std::isfinite(inAccumulationDistribution));
+      assert(false == std::isnan(inAccumulationDistribution));
+      if (m_lookbackPeriod <= inSequenceNumber) [[likely]]
+      {
+         auto const fastMovingAverage{m_fastMovingAverage + fast_smoothing_factor * (inAccumulationDistribution - m_fastMovingAverage),};
+         auto const slowMovingAverage{m_slowMovingAverage + slow_smoothing_factor * (inAccumulationDistribution - m_slowMovingAverage),};
+         return fastMovingAverage - slowMovingAverage;
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[nodiscard]] static double do_skip(
+      double const inMovingAverage,
+      double const inSmoothingFactor,
+      double const inAccumulationDistribution,
+      double const inMoneyFlowVolume,
+      uint64_t const inGap
+   ) noexcept
+   {
+      auto const lag{inMoneyFlowVolume * (1.0 - inSmoothingFactor) / inSmoothingFactor,};
+      auto const prevAccumulationDistribution{inAccumulationDistribution - inMoneyFlowVolume * static_cast<double>(inGap),};
+      auto const decay{std::pow(1.0 - inSmoothingFactor, static_cast<double>(inGap)),};
+      return inAccumulationDistribution - lag + decay * (inMovingAverage - prevAccumulationDistribution + lag);
+   }
+};
+
+template<>
+class [[maybe_unused]] accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)> final
+{
+public:
+   /// A copy carries the line and both averages, so hypothetical bars never reach the indicator and never allocate
+   using lookahead_type = accumulation_distribution_oscillator;
+
    accumulation_distribution_oscillator() = delete;
-   accumulation_distribution_oscillator(accumulation_distribution_oscillator &&) = delete;
-   accumulation_distribution_oscillator(accumulation_distribution_oscillator const &) = delete;
+   [[maybe_unused, nodiscard]] accumulation_distribution_oscillator(accumulation_distribution_oscillator &&) noexcept = default;
+   [[maybe_unused, nodiscard]] accumulation_distribution_oscillator(accumulation_distribution_oscillator const &) = default;
    [[nodiscard]] accumulation_distribution_oscillator(uint32_t inFastPeriod, uint32_t inSlowPeriod, uint32_t inUntrustedPeriod) noexcept;
 
-   accumulation_distribution_oscillator &operator = (accumulation_distribution_oscillator &&) = delete;
-   accumulation_distribution_oscillator &operator = (accumulation_distribution_oscillator const &) = delete;
+   [[maybe_unused]] accumulation_distribution_oscillator &operator = (accumulation_distribution_oscillator &&) noexcept = default;
+   [[maybe_unused]] accumulation_distribution_oscillator &operator = (accumulation_distribution_oscillator const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) noexcept
+   {
+      m_fastMovingAverage = m_prevFastMovingAverage;
+      m_slowMovingAverage = m_prevSlowMovingAverage;
+      return do_calc(inSequenceNumber, m_accumulationDistributionLine.amend(inSequenceNumber, inHigh, inLow, inClose, inVolume));
+   }
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume, double &outAccumulationDistribution) noexcept
+   {
+      m_fastMovingAverage = m_prevFastMovingAverage;
+      m_slowMovingAverage = m_prevSlowMovingAverage;
+      outAccumulationDistribution = m_accumulationDistributionLine.amend(inSequenceNumber, inHigh, inLow, inClose, inVolume);
+      return do_calc(inSequenceNumber, outAccumulationDistribution);
+   }
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) noexcept
    {
+      m_prevFastMovingAverage = m_fastMovingAverage;
+      m_prevSlowMovingAverage = m_slowMovingAverage;
       return do_calc(inSequenceNumber, m_accumulationDistributionLine.calc(inSequenceNumber, inHigh, inLow, inClose, inVolume));
    }
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume, double &outAccumulationDistribution) noexcept
    {
+      m_prevFastMovingAverage = m_fastMovingAverage;
+      m_prevSlowMovingAverage = m_slowMovingAverage;
       outAccumulationDistribution = m_accumulationDistributionLine.calc(inSequenceNumber, inHigh, inLow, inClose, inVolume);
       return do_calc(inSequenceNumber, outAccumulationDistribution);
    }
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -80,20 +307,33 @@ public:
       m_accumulationDistributionLine.reset();
       m_fastMovingAverage = 0.0;
       m_slowMovingAverage = 0.0;
+      m_prevFastMovingAverage = 0.0;
+      m_prevSlowMovingAverage = 0.0;
    }
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, the line moves by the same money flow volume f
+   /// every missing bar, see accumulation_distribution_line::skip, and an average with smoothing factor a settles d = f * (1 - a) / a behind
+   /// such a ramp, so n bars taking the line from x0 to xn move the average to xn - d + (1 - a)^n * (average - x0 + d), the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
-   double const m_fastSmoothingFactor;
-   double const m_slowSmoothingFactor;
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   double m_fastSmoothingFactor;
+   double m_slowSmoothingFactor;
    accumulation_distribution_line m_accumulationDistributionLine;
    double m_fastMovingAverage;
    double m_slowMovingAverage;
+   double m_prevFastMovingAverage;
+   double m_prevSlowMovingAverage;
 
    [[nodiscard]] double do_calc(uint64_t inSequenceNumber, double inAccumulationDistribution) noexcept;
 
    [[nodiscard]] double do_pick(uint64_t inSequenceNumber, double inAccumulationDistribution) const noexcept;
+
+   [[nodiscard]] static double do_skip(double inMovingAverage, double inSmoothingFactor, double inAccumulationDistribution, double inMoneyFlowVolume, uint64_t inGap) noexcept;
 };
 
 }
@@ -25,35 +25,257 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 #include "tean/true_range.hpp" /// for tean::true_range
 
+#include <algorithm> /// for std::min
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
+#include <limits> /// for std::numeric_limits
 
 namespace tean
 {
 
-class [[nodiscard]] average_true_range final
+template<uint32_t period = static_cast<uint32_t>(-1)>
+class average_true_range;
+
+template<uint32_t fixed_period>
+class [[maybe_unused]] average_true_range final
 {
+   static_assert(true_range::lookback_period() < fixed_period);
+
+   static constexpr inline auto reciprocal_period{1.0 / fixed_period,};
+
 public:
+   /// A copy carries the true range and the running average, so it evaluates any number of hypothetical bars without allocating
+   using lookahead_type = average_true_range;
+
+   [[maybe_unused, nodiscard]] explicit constexpr average_true_range(uint32_t const inUntrustedPeriod) noexcept :
+      m_lookbackPeriod{inUntrustedPeriod + fixed_period,}
+   {}
+
+   [[maybe_unused, nodiscard]] average_true_range(average_true_range &&) noexcept = default;
+   [[maybe_unused, nodiscard]] average_true_range(average_true_range const &) = default;
+
+   [[maybe_unused]] average_true_range &operator = (average_true_range &&) noexcept = default;
+   [[maybe_unused]] average_true_range &operator = (average_true_range const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+   {
+      m_value = m_prevValue;
+      return do_calc(inSequenceNumber, m_trueRange.amend(inSequenceNumber, inHigh, inLow, inClose));
+   }
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double &outTrueRange) noexcept
+   {
+      m_value = m_prevValue;
+      outTrueRange = m_trueRange.amend(inSequenceNumber, inHigh, inLow, inClose);
+      return do_calc(inSequenceNumber, outTrueRange);
+   }
+
+   [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+   {
+      m_prevValue = m_value;
+      return do_calc(inSequenceNumber, m_trueRange.calc(inSequenceNumber, inHigh, inLow, inClose));
+   }
+
+   [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double &outTrueRange) noexcept
+   {
+      m_prevValue = m_value;
+      outTrueRange = m_trueRange.calc(inSequenceNumber, inHigh, inLow, inClose);
+      return do_calc(inSequenceNumber, outTrueRange);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(fixed_period))
+         && (true == inReader.expect(m_lookbackPeriod))
+         && (true == m_trueRange.load(inSequenceNumber, inReader))
+         && (true == inReader.read(m_value))
+         && (true == inReader.read(m_prevValue))
+      );
+   }
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t lookback_period() const noexcept
+   {
+      return m_lookbackPeriod;
+   }
+
+   [[maybe_unused, nodiscard]] static constexpr uint32_t period() noexcept
+   {
+      return fixed_period;
+   }
+
+   [[maybe_unused, nodiscard]] double pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) const noexcept
+   {
+      return do_pick(inSequenceNumber, m_trueRange.pick(inSequenceNumber, inHigh, inLow, inClose));
+   }
+
+   [[maybe_unused, nodiscard]] double pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double &outTrueRange) const noexcept
+   {
+      outTrueRange = m_trueRange.pick(inSequenceNumber, inHigh, inLow, inClose);
+      return do_pick(inSequenceNumber, outTrueRange);
+   }
+
+   [[maybe_unused]] void reset() noexcept
+   {
+      m_trueRange.reset();
+      m_value = 0;
+      m_prevValue = 0;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(fixed_period);
+      outWriter.write(m_lookbackPeriod);
+      m_trueRange.save(inSequenceNumber, outWriter);
+      outWriter.write(m_value);
+      outWriter.write(m_prevValue);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, every missing bar has the true range
+   /// true_range::skip gives for the fill and n bars of the same true range r move the average to r + (1 - 1 / period)^n * (average - r),
+   /// the missing bars cannot be amended
+   [[maybe_unused]] void skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+   {
+      m_prevValue = std::numeric_limits<double>::signaling_NaN();
+      auto const trueRange{m_trueRange.skip(inSequenceNumber, inGap, inFill),};
+      auto smoothedNumber{inGap,};
+      if (fixed_period >= inSequenceNumber)
+      {
+         /// The seed sums the true ranges up to the period-th bar
+         auto const seedNumber{std::min<uint64_t>(inGap, fixed_period + 1 - inSequenceNumber),};
+         smoothedNumber -= seedNumber;
+         m_value += trueRange * static_cast<double>(seedNumber);
+         if (fixed_period < (inSequenceNumber + seedNumber))
+         {
+            m_value *= reciprocal_period;
+         }
+      }
+      if (0 < smoothedNumber)
+      {
+         m_value = trueRange + std::pow(1.0 - reciprocal_period, static_cast<double>(smoothedNumber)) * (m_value - trueRange);
+      }
+   }
+
+private:
+   uint32_t m_lookbackPeriod;
+   true_range m_trueRange{};
+   double m_value{0,};
+   /// The value preceding the latest calc, an amended calc starts over from it
+   double m_prevValue{0,};
+
+   [[nodiscard]] constexpr double do_calc(uint64_t const inSequenceNumber, double const inTrueRange) noexcept
+   {
+      if (true_range::lookback_period() <= inSequenceNumber) [[likely]]
+      {
+         assert(true == std::isfinite(inTrueRange));
+         assert(false == std::isnan(inTrueRange));
+         if (fixed_period < inSequenceNumber) [[likely]]
+         {
+            m_value += (inTrueRange - m_value) * reciprocal_period;
+            if (m_lookbackPeriod <= inSequenceNumber) [[likely]]
+            {
+               return m_value;
+            }
+         }
+         else
+         {
+            m_value += inTrueRange;
+            if (fixed_period == inSequenceNumber) [[unlikely]]
+            {
+               m_value *= reciprocal_period;
+               if (m_lookbackPeriod == inSequenceNumber)
+               {
+                  return m_value;
+               }
+            }
+         }
+      }
+      else
+      {
+         assert(true == std::isnan(inTrueRange));
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[nodiscard]] constexpr double do_pick(uint64_t const inSequenceNumber, double const inTrueRange) const noexcept
+   {
+      if (m_lookbackPeriod <= inSequenceNumber) [[likely]]
+      {
+         assert(true == std::isfinite(inTrueRange));
+         assert(false == std::isnan(inTrueRange));
+         if (fixed_period < inSequenceNumber) [[likely]]
+         {
+            return m_value + (inTrueRange - m_value) * reciprocal_period;
+         }
+         assert(fixed_period == m_lookbackPeriod);
+         return (m_value + inTrueRange) * reciprocal_period;
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+};
+
+template<>
+class [[maybe_unused]] average_true_range<static_cast<uint32_t>(-1)> final
+{
+public:
+   /// A copy carries the true range and the running average, so it evaluates any number of hypothetical bars without allocating
+   using lookahead_type = average_true_range;
+
    average_true_range() = delete;
-   average_true_range(average_true_range &&) = delete;
-   average_true_range(average_true_range const &) = delete;
+   [[maybe_unused, nodiscard]] average_true_range(average_true_range &&) noexcept = default;
+   [[maybe_unused, nodiscard]] average_true_range(average_true_range const &) = default;
    [[nodiscard]] average_true_range(uint32_t inPeriod, uint32_t inUntrustedPeriod) noexcept;
 
-   average_true_range &operator = (average_true_range &&) = delete;
-   average_true_range &operator = (average_true_range const &) = delete;
+   [[maybe_unused]] average_true_range &operator = (average_true_range &&) noexcept = default;
+   [[maybe_unused]] average_true_range &operator = (average_true_range const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+   {
+      m_value = m_prevValue;
+      return do_calc(inSequenceNumber, m_trueRange.amend(inSequenceNumber, inHigh, inLow, inClose));
+   }
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double &outTrueRange) noexcept
+   {
+      m_value = m_prevValue;
+      outTrueRange = m_trueRange.amend(inSequenceNumber, inHigh, inLow, inClose);
+      return do_calc(inSequenceNumber, outTrueRange);
+   }
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
    {
+      m_prevValue = m_value;
       return do_calc(inSequenceNumber, m_trueRange.calc(inSequenceNumber, inHigh, inLow, inClose));
    }
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double &outTrueRange) noexcept
    {
+      m_prevValue = m_value;
       outTrueRange = m_trueRange.calc(inSequenceNumber, inHigh, inLow, inClose);
       return do_calc(inSequenceNumber, outTrueRange);
    }
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -79,13 +301,22 @@ public:
    {
       m_trueRange.reset();
       m_value = 0.0;
+      m_prevValue = 0.0;
    }
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, every missing bar has the true range
+   /// true_range::skip gives for the fill and n bars of the same true range r move the average to r + (1 - 1 / period)^n * (average - r),
+   /// the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
    true_range m_trueRange;
    double m_value;
+   double m_prevValue;
 
    [[nodiscard]] double do_calc(uint64_t inSequenceNumber, double inTrueRange) noexcept;
 
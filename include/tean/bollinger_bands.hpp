@@ -25,35 +25,154 @@
 
 #pragma once
 
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/simple_moving_average.hpp" /// for tean::simple_moving_average
 #include "tean/standard_deviation.hpp" /// for tean::standard_deviation
 
+#include <algorithm> /// for std::min, std::ranges::fill
+#include <array> /// for std::array
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::isnan
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <type_traits> /// for std::is_constructible_v
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <span> /// for std::span
+#include <type_traits> /// for std::integral_constant, std::is_constructible_v
 #include <utility> /// for std::forward
 
 namespace tean
 {
 
+struct [[maybe_unused, nodiscard]] bollinger_bands_result final
+{
+   [[maybe_unused]] double upper = std::numeric_limits<double>::signaling_NaN();
+   [[maybe_unused]] double middle = std::numeric_limits<double>::signaling_NaN();
+   [[maybe_unused]] double lower = std::numeric_limits<double>::signaling_NaN();
+};
+
+[[maybe_unused, nodiscard]] constexpr bollinger_bands_result make_bollinger_bands_result(
+   double const inMovingAverage,
+   double const inStandardDeviation,
+   double const inUpperBandMultiplier,
+   double const inLowerBandMultiplier
+) noexcept
+{
+   assert(true == std::isfinite(inStandardDeviation));
+   assert(false == std::isnan(inStandardDeviation));
+   assert(true == std::isfinite(inMovingAverage));
+   assert(false == std::isnan(inMovingAverage));
+   return bollinger_bands_result
+   {
+      .upper = inMovingAverage + (inStandardDeviation * inUpperBandMultiplier),
+      .middle = inMovingAverage,
+      .lower = inMovingAverage - (inStandardDeviation * inLowerBandMultiplier),
+   };
+}
+
+struct [[maybe_unused, nodiscard]] bollinger_bands_extended_result final
+{
+   [[maybe_unused]] double upper = std::numeric_limits<double>::signaling_NaN();
+   [[maybe_unused]] double middle = std::numeric_limits<double>::signaling_NaN();
+   [[maybe_unused]] double lower = std::numeric_limits<double>::signaling_NaN();
+   [[maybe_unused]] double percent_b = std::numeric_limits<double>::signaling_NaN();
+   [[maybe_unused]] double bandwidth = std::numeric_limits<double>::signaling_NaN();
+};
+
+[[maybe_unused, nodiscard]] constexpr bollinger_bands_extended_result make_bollinger_bands_extended_result(
+   double const inValue,
+   double const inMovingAverage,
+   double const inStandardDeviation,
+   double const inUpperBandMultiplier,
+   double const inLowerBandMultiplier
+) noexcept
+{
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   assert(true == std::isfinite(inStandardDeviation));
+   assert(false == std::isnan(inStandardDeviation));
+   assert(true == std::isfinite(inMovingAverage));
+   assert(false == std::isnan(inMovingAverage));
+   auto const upper{inMovingAverage + (inStandardDeviation * inUpperBandMultiplier),};
+   auto const lower{inMovingAverage - (inStandardDeviation * inLowerBandMultiplier),};
+   auto const width{upper - lower,};
+   return bollinger_bands_extended_result
+   {
+      .upper = upper,
+      .middle = inMovingAverage,
+      .lower = lower,
+      /// Collapsed bands mean a constant window, so the value sits exactly on the middle band
+      .percent_b = (0 == width) ? 0.5 : ((inValue - lower) / width),
+      .bandwidth = width / inMovingAverage,
+   };
+}
+
+/// Fixed period indicators tell their period without an instance
+template<typename indicator>
+concept fixed_period_indicator = requires
+{
+   typename std::integral_constant<uint32_t, indicator::period()>;
+};
+
+/// Deviation over the period of a moving average, fixed along with the moving average so its window stays inline
+template<typename moving_average>
+struct bollinger_bands_standard_deviation final
+{
+   using type = standard_deviation<>;
+};
+
+template<fixed_period_indicator moving_average>
+struct bollinger_bands_standard_deviation<moving_average> final
+{
+   using type = standard_deviation<moving_average::period()>;
+};
+
 template<typename moving_average>
 class [[nodiscard]] bollinger_bands final
 {
+   using standard_deviation_type = typename bollinger_bands_standard_deviation<moving_average>::type;
+
 public:
-   struct [[maybe_unused, nodiscard]] result_type final
+   using result_type = bollinger_bands_result;
+
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
    {
-      [[maybe_unused]] double upper = std::numeric_limits<double>::signaling_NaN();
-      [[maybe_unused]] double middle = std::numeric_limits<double>::signaling_NaN();
-      [[maybe_unused]] double lower = std::numeric_limits<double>::signaling_NaN();
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit lookahead_type(bollinger_bands const &inIndicator) noexcept :
+         m_indicator(std::addressof(inIndicator)),
+         m_standardDeviation(inIndicator.m_standardDeviation.lookahead()),
+         m_movingAverage(inIndicator.m_movingAverage.lookahead())
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] result_type calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         return m_indicator->make_value(inSequenceNumber, m_standardDeviation.calc(inSequenceNumber, inValue), m_movingAverage.calc(inSequenceNumber, inValue));
+      }
+
+      [[maybe_unused, nodiscard]] bollinger_bands_extended_result calc_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         return m_indicator->make_extended_value(inSequenceNumber, inValue, m_standardDeviation.calc(inSequenceNumber, inValue), m_movingAverage.calc(inSequenceNumber, inValue));
+      }
+
+   private:
+      bollinger_bands const * m_indicator;
+      typename standard_deviation_type::lookahead_type m_standardDeviation;
+      typename moving_average::lookahead_type m_movingAverage;
    };
 
-public:
    bollinger_bands() = delete;
-   bollinger_bands(bollinger_bands &&) = delete;
-   bollinger_bands(bollinger_bands const &) = delete;
+   [[maybe_unused, nodiscard]] bollinger_bands(bollinger_bands &&) noexcept = default;
+   [[maybe_unused, nodiscard]] bollinger_bands(bollinger_bands const &) = default;
 
-   template<typename... types> requires(true == std::is_constructible_v<moving_average, uint32_t, types...>)
+   template<typename... types> requires((false == fixed_period_indicator<moving_average>) && (true == std::is_constructible_v<moving_average, uint32_t, types...>))
    [[maybe_unused, nodiscard]] bollinger_bands(uint32_t const inPeriod, double const inUpperBandMultiplier, double const inLowerBandMultiplier, types &&...inValues) :
       m_upperBandMultiplier(inUpperBandMultiplier),
       m_lowerBandMultiplier(inLowerBandMultiplier),
@@ -68,14 +187,63 @@ public:
       assert(m_standardDeviation.lookback_period() <= m_movingAverage.lookback_period());
    }
 
-   bollinger_bands &operator = (bollinger_bands &&) = delete;
-   bollinger_bands &operator = (bollinger_bands const &) = delete;
+   /// A fixed period moving average knows its period, so only its own arguments follow the multipliers
+   template<typename... types> requires((true == fixed_period_indicator<moving_average>) && (true == std::is_constructible_v<moving_average, types...>))
+   [[maybe_unused, nodiscard]] bollinger_bands(double const inUpperBandMultiplier, double const inLowerBandMultiplier, types &&...inValues) :
+      m_upperBandMultiplier(inUpperBandMultiplier),
+      m_lowerBandMultiplier(inLowerBandMultiplier),
+      m_standardDeviation(),
+      m_movingAverage(std::forward<types>(inValues)...)
+   {
+      assert(true == std::isfinite(m_upperBandMultiplier));
+      assert(false == std::isnan(m_upperBandMultiplier));
+      assert(true == std::isfinite(m_lowerBandMultiplier));
+      assert(false == std::isnan(m_lowerBandMultiplier));
+      assert(standard_deviation_type::lookback_period <= m_movingAverage.lookback_period());
+   }
+
+   /// Passing the period of a fixed period moving average would feed it to the arguments of the moving average
+   bollinger_bands(uint32_t, double, double) requires(true == fixed_period_indicator<moving_average>) = delete;
+
+   [[maybe_unused]] bollinger_bands &operator = (bollinger_bands &&) noexcept = default;
+   [[maybe_unused]] bollinger_bands &operator = (bollinger_bands const &) = default;
+
+   [[maybe_unused, nodiscard]] result_type amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return make_value(inSequenceNumber, m_standardDeviation.amend(inSequenceNumber, inValue), m_movingAverage.amend(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result amend_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return make_extended_value(inSequenceNumber, inValue, m_standardDeviation.amend(inSequenceNumber, inValue), m_movingAverage.amend(inSequenceNumber, inValue));
+   }
 
    [[maybe_unused, nodiscard]] result_type calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
       return make_value(inSequenceNumber, m_standardDeviation.calc(inSequenceNumber, inValue), m_movingAverage.calc(inSequenceNumber, inValue));
    }
 
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result calc_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return make_extended_value(inSequenceNumber, inValue, m_standardDeviation.calc(inSequenceNumber, inValue), m_movingAverage.calc(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(m_upperBandMultiplier))
+         && (true == inReader.expect(m_lowerBandMultiplier))
+         && (true == m_standardDeviation.load(inSequenceNumber, inReader))
+         && (true == m_movingAverage.load(inSequenceNumber, inReader))
+      );
+   }
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_movingAverage.lookback_period();
@@ -91,36 +259,512 @@ public:
       return make_value(inSequenceNumber, m_standardDeviation.pick(inSequenceNumber, inValue), m_movingAverage.pick(inSequenceNumber, inValue));
    }
 
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result pick_extended(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+      return make_extended_value(inSequenceNumber, inValue, m_standardDeviation.pick(inSequenceNumber, inValue), m_movingAverage.pick(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused]] void pick_many(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<result_type> const outValues) const noexcept
+   {
+      assert(inValues.size() == outValues.size());
+      /// Every candidate shares the sequence number, so warming up is decided once and the chunk loops stay branch free
+      if (inSequenceNumber < m_movingAverage.lookback_period()) [[unlikely]]
+      {
+         std::ranges::fill(outValues, result_type{});
+         return;
+      }
+      /// Deviations are staged in stack chunks, the means of the deviation window are not the middle band here
+      std::array<double, 64> standardDeviations{};
+      std::array<double, 64> windowMeans{};
+      for (size_t chunkBegin{0,}; chunkBegin < inValues.size(); chunkBegin += windowMeans.size())
+      {
+         auto const chunkSize{std::min(windowMeans.size(), inValues.size() - chunkBegin),};
+         auto const chunkValues{inValues.subspan(chunkBegin, chunkSize),};
+         m_standardDeviation.pick_many(inSequenceNumber, chunkValues, std::span{standardDeviations}.first(chunkSize), std::span{windowMeans}.first(chunkSize));
+         for (size_t valueIndex{0,}; valueIndex < chunkSize; ++valueIndex)
+         {
+            outValues[chunkBegin + valueIndex] = make_bollinger_bands_result(
+               m_movingAverage.pick(inSequenceNumber, chunkValues[valueIndex]),
+               standardDeviations[valueIndex],
+               m_upperBandMultiplier,
+               m_lowerBandMultiplier
+            );
+         }
+      }
+   }
+
    [[maybe_unused]] void reset() noexcept
    {
       m_standardDeviation.reset();
       m_movingAverage.reset();
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(m_upperBandMultiplier);
+      outWriter.write(m_lowerBandMultiplier);
+      m_standardDeviation.save(inSequenceNumber, outWriter);
+      m_movingAverage.save(inSequenceNumber, outWriter);
+   }
+
 private:
-   double const m_upperBandMultiplier;
-   double const m_lowerBandMultiplier;
-   standard_deviation<> m_standardDeviation;
+   double m_upperBandMultiplier;
+   double m_lowerBandMultiplier;
+   standard_deviation_type m_standardDeviation;
    moving_average m_movingAverage;
 
    [[maybe_unused, nodiscard]] result_type make_value(uint64_t const inSequenceNumber, double const inStandardDeviation, double const inMovingAverage) const noexcept
    {
       if (m_movingAverage.lookback_period() <= inSequenceNumber) [[likely]]
       {
-         assert(true == std::isfinite(inStandardDeviation));
-         assert(false == std::isnan(inStandardDeviation));
-         assert(true == std::isfinite(inMovingAverage));
-         assert(false == std::isnan(inMovingAverage));
-         return result_type
-         {
-            .upper = inMovingAverage + (inStandardDeviation * m_upperBandMultiplier),
-            .middle = inMovingAverage,
-            .lower = inMovingAverage - (inStandardDeviation * m_lowerBandMultiplier),
-         };
+         return make_bollinger_bands_result(inMovingAverage, inStandardDeviation, m_upperBandMultiplier, m_lowerBandMultiplier);
       }
       assert(true == std::isnan(inMovingAverage));
       return result_type{};
    }
+
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result make_extended_value(
+      uint64_t const inSequenceNumber,
+      double const inValue,
+      double const inStandardDeviation,
+      double const inMovingAverage
+   ) const noexcept
+   {
+      if (m_movingAverage.lookback_period() <= inSequenceNumber) [[likely]]
+      {
+         return make_bollinger_bands_extended_result(inValue, inMovingAverage, inStandardDeviation, m_upperBandMultiplier, m_lowerBandMultiplier);
+      }
+      assert(true == std::isnan(inMovingAverage));
+      return bollinger_bands_extended_result{};
+   }
+};
+
+/// Simple moving average bands share a single window: the middle band is the mean the variance already tracks
+template<uint32_t period>
+class [[nodiscard]] bollinger_bands<simple_moving_average<period>> final
+{
+public:
+   using result_type = bollinger_bands_result;
+
+   static constexpr inline auto lookback_period{standard_deviation<period>::lookback_period,};
+
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(bollinger_bands const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_standardDeviation{inIndicator.m_standardDeviation.lookahead(),}
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr result_type calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+         return m_indicator->make_value(inSequenceNumber, standardDeviation, mean);
+      }
+
+      [[maybe_unused, nodiscard]] constexpr bollinger_bands_extended_result calc_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+         return m_indicator->make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+      }
+
+   private:
+      bollinger_bands const * m_indicator;
+      typename standard_deviation<period>::lookahead_type m_standardDeviation;
+   };
+
+   bollinger_bands() = delete;
+   [[maybe_unused, nodiscard]] bollinger_bands(bollinger_bands &&) noexcept = default;
+   [[maybe_unused, nodiscard]] bollinger_bands(bollinger_bands const &) = default;
+
+   [[maybe_unused, nodiscard]] constexpr bollinger_bands(double const inUpperBandMultiplier, double const inLowerBandMultiplier) noexcept :
+      m_upperBandMultiplier{inUpperBandMultiplier,},
+      m_lowerBandMultiplier{inLowerBandMultiplier,}
+   {
+      assert(true == std::isfinite(m_upperBandMultiplier));
+      assert(false == std::isnan(m_upperBandMultiplier));
+      assert(true == std::isfinite(m_lowerBandMultiplier));
+      assert(false == std::isnan(m_lowerBandMultiplier));
+   }
+
+   [[maybe_unused]] bollinger_bands &operator = (bollinger_bands &&) noexcept = default;
+   [[maybe_unused]] bollinger_bands &operator = (bollinger_bands const &) = default;
+
+   [[maybe_unused, nodiscard]] constexpr result_type amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.amend(inSequenceNumber, inValue, mean),};
+      return make_value(inSequenceNumber, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr bollinger_bands_extended_result amend_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.amend(inSequenceNumber, inValue, mean),};
+      return make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr result_type calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+      return make_value(inSequenceNumber, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr bollinger_bands_extended_result calc_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+      return make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(m_upperBandMultiplier))
+         && (true == inReader.expect(m_lowerBandMultiplier))
+         && (true == m_standardDeviation.load(inSequenceNumber, inReader))
+      );
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr result_type pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.pick(inSequenceNumber, inValue, mean),};
+      return make_value(inSequenceNumber, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr bollinger_bands_extended_result pick_extended(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.pick(inSequenceNumber, inValue, mean),};
+      return make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+   }
+
+   [[maybe_unused]] constexpr void pick_many(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<result_type> const outValues) const noexcept
+   {
+      assert(inValues.size() == outValues.size());
+      /// Every candidate shares the sequence number, so warming up is decided once and the chunk loops stay branch free
+      if (inSequenceNumber < lookback_period) [[unlikely]]
+      {
+         std::ranges::fill(outValues, result_type{});
+         return;
+      }
+      /// Deviations and means are staged in stack chunks
+      std::array<double, 64> standardDeviations{};
+      std::array<double, 64> means{};
+      for (size_t chunkBegin{0,}; chunkBegin < inValues.size(); chunkBegin += means.size())
+      {
+         auto const chunkSize{std::min(means.size(), inValues.size() - chunkBegin),};
+         m_standardDeviation.pick_many(
+            inSequenceNumber,
+            inValues.subspan(chunkBegin, chunkSize),
+            std::span{standardDeviations}.first(chunkSize),
+            std::span{means}.first(chunkSize)
+         );
+         for (size_t valueIndex{0,}; valueIndex < chunkSize; ++valueIndex)
+         {
+            outValues[chunkBegin + valueIndex] = make_bollinger_bands_result(
+               means[valueIndex],
+               standardDeviations[valueIndex],
+               m_upperBandMultiplier,
+               m_lowerBandMultiplier
+            );
+         }
+      }
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+      m_standardDeviation.reset();
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(m_upperBandMultiplier);
+      outWriter.write(m_lowerBandMultiplier);
+      m_standardDeviation.save(inSequenceNumber, outWriter);
+   }
+
+   /// Value whose pick puts the lower band right on it, NaN when out of reach, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] constexpr double solve_lower_band(uint64_t const inSequenceNumber) const noexcept
+   {
+      return m_standardDeviation.solve_z_score(inSequenceNumber, -m_lowerBandMultiplier);
+   }
+
+   /// Value whose pick puts the upper band right on it, NaN when out of reach, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] constexpr double solve_upper_band(uint64_t const inSequenceNumber) const noexcept
+   {
+      return m_standardDeviation.solve_z_score(inSequenceNumber, m_upperBandMultiplier);
+   }
+
+private:
+   double m_upperBandMultiplier;
+   double m_lowerBandMultiplier;
+   standard_deviation<period> m_standardDeviation{};
+
+   [[maybe_unused, nodiscard]] constexpr result_type make_value(uint64_t const inSequenceNumber, double const inStandardDeviation, double const inMean) const noexcept
+   {
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         return make_bollinger_bands_result(inMean, inStandardDeviation, m_upperBandMultiplier, m_lowerBandMultiplier);
+      }
+      assert(true == std::isnan(inMean));
+      return result_type{};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr bollinger_bands_extended_result make_extended_value(
+      uint64_t const inSequenceNumber,
+      double const inValue,
+      double const inStandardDeviation,
+      double const inMean
+   ) const noexcept
+   {
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         return make_bollinger_bands_extended_result(inValue, inMean, inStandardDeviation, m_upperBandMultiplier, m_lowerBandMultiplier);
+      }
+      assert(true == std::isnan(inMean));
+      return bollinger_bands_extended_result{};
+   }
+};
+
+template<>
+class [[nodiscard]] bollinger_bands<simple_moving_average<>> final
+{
+public:
+   using result_type = bollinger_bands_result;
+
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit lookahead_type(bollinger_bands const &inIndicator) noexcept :
+         m_indicator(std::addressof(inIndicator)),
+         m_standardDeviation(inIndicator.m_standardDeviation.lookahead())
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] result_type calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+         return m_indicator->make_value(inSequenceNumber, standardDeviation, mean);
+      }
+
+      [[maybe_unused, nodiscard]] bollinger_bands_extended_result calc_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+         return m_indicator->make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+      }
+
+   private:
+      bollinger_bands const * m_indicator;
+      standard_deviation<>::lookahead_type m_standardDeviation;
+   };
+
+   bollinger_bands() = delete;
+   [[maybe_unused, nodiscard]] bollinger_bands(bollinger_bands &&) noexcept = default;
+   [[maybe_unused, nodiscard]] bollinger_bands(bollinger_bands const &) = default;
+
+   [[maybe_unused, nodiscard]] bollinger_bands(
+      uint32_t const inPeriod,
+      double const inUpperBandMultiplier,
+      double const inLowerBandMultiplier,
+      std::pmr::memory_resource *const inMemoryResource = std::pmr::get_default_resource()
+   ) :
+      m_upperBandMultiplier(inUpperBandMultiplier),
+      m_lowerBandMultiplier(inLowerBandMultiplier),
+      m_standardDeviation(inPeriod, inMemoryResource)
+   {
+      assert(true == std::isfinite(m_upperBandMultiplier));
+      assert(false == std::isnan(m_upperBandMultiplier));
+      assert(true == std::isfinite(m_lowerBandMultiplier));
+      assert(false == std::isnan(m_lowerBandMultiplier));
+   }
+
+   [[maybe_unused]] bollinger_bands &operator = (bollinger_bands &&) noexcept = default;
+   [[maybe_unused]] bollinger_bands &operator = (bollinger_bands const &) = default;
+
+   [[maybe_unused, nodiscard]] result_type amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.amend(inSequenceNumber, inValue, mean),};
+      return make_value(inSequenceNumber, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result amend_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.amend(inSequenceNumber, inValue, mean),};
+      return make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] result_type calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+      return make_value(inSequenceNumber, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result calc_extended(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.calc(inSequenceNumber, inValue, mean),};
+      return make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(m_upperBandMultiplier))
+         && (true == inReader.expect(m_lowerBandMultiplier))
+         && (true == m_standardDeviation.load(inSequenceNumber, inReader))
+      );
+   }
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
+   {
+      return m_standardDeviation.lookback_period();
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t period() const noexcept
+   {
+      return m_standardDeviation.period();
+   }
+
+   [[maybe_unused, nodiscard]] result_type pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.pick(inSequenceNumber, inValue, mean),};
+      return make_value(inSequenceNumber, standardDeviation, mean);
+   }
+
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result pick_extended(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+      double mean{};
+      auto const standardDeviation{m_standardDeviation.pick(inSequenceNumber, inValue, mean),};
+      return make_extended_value(inSequenceNumber, inValue, standardDeviation, mean);
+   }
+
+   [[maybe_unused]] void pick_many(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<result_type> const outValues) const noexcept
+   {
+      assert(inValues.size() == outValues.size());
+      /// Every candidate shares the sequence number, so warming up is decided once and the chunk loops stay branch free
+      if (inSequenceNumber < lookback_period()) [[unlikely]]
+      {
+         std::ranges::fill(outValues, result_type{});
+         return;
+      }
+      /// Deviations and means are staged in stack chunks
+      std::array<double, 64> standardDeviations{};
+      std::array<double, 64> means{};
+      for (size_t chunkBegin{0,}; chunkBegin < inValues.size(); chunkBegin += means.size())
+      {
+         auto const chunkSize{std::min(means.size(), inValues.size() - chunkBegin),};
+         m_standardDeviation.pick_many(
+            inSequenceNumber,
+            inValues.subspan(chunkBegin, chunkSize),
+            std::span{standardDeviations}.first(chunkSize),
+            std::span{means}.first(chunkSize)
+         );
+         for (size_t valueIndex{0,}; valueIndex < chunkSize; ++valueIndex)
+         {
+            outValues[chunkBegin + valueIndex] = make_bollinger_bands_result(
+               means[valueIndex],
+               standardDeviations[valueIndex],
+               m_upperBandMultiplier,
+               m_lowerBandMultiplier
+            );
+         }
+      }
+   }
+
+   [[maybe_unused]] void reset() noexcept
+   {
+      m_standardDeviation.reset();
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(m_upperBandMultiplier);
+      outWriter.write(m_lowerBandMultiplier);
+      m_standardDeviation.save(inSequenceNumber, outWriter);
+   }
+
+   /// Value whose pick puts the lower band right on it, NaN when out of reach, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] double solve_lower_band(uint64_t const inSequenceNumber) const noexcept
+   {
+      return m_standardDeviation.solve_z_score(inSequenceNumber, -m_lowerBandMultiplier);
+   }
+
+   /// Value whose pick puts the upper band right on it, NaN when out of reach, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] double solve_upper_band(uint64_t const inSequenceNumber) const noexcept
+   {
+      return m_standardDeviation.solve_z_score(inSequenceNumber, m_upperBandMultiplier);
+   }
+
+private:
+   double m_upperBandMultiplier;
+   double m_lowerBandMultiplier;
+   standard_deviation<> m_standardDeviation;
+
+   [[maybe_unused, nodiscard]] result_type make_value(uint64_t const inSequenceNumber, double const inStandardDeviation, double const inMean) const noexcept
+   {
+      if (lookback_period() <= inSequenceNumber) [[likely]]
+      {
+         return make_bollinger_bands_result(inMean, inStandardDeviation, m_upperBandMultiplier, m_lowerBandMultiplier);
+      }
+      assert(true == std::isnan(inMean));
+      return result_type{};
+   }
+
+   [[maybe_unused, nodiscard]] bollinger_bands_extended_result make_extended_value(
+      uint64_t const inSequenceNumber,
+      double const inValue,
+      double const inStandardDeviation,
+      double const inMean
+   ) const noexcept
+   {
+      if (lookback_period() <= inSequenceNumber) [[likely]]
+      {
+         return make_bollinger_bands_extended_result(inValue, inMean, inStandardDeviation, m_upperBandMultiplier, m_lowerBandMultiplier);
+      }
+      assert(true == std::isnan(inMean));
+      return bollinger_bands_extended_result{};
+   }
 };
 
 }
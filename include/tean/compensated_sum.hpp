@@ -0,0 +1,41 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include <cmath> /// for std::abs
+
+namespace tean
+{
+
+/// Neumaier summation: the rounding error of every addition is accumulated into ioCompensation
+[[maybe_unused]] constexpr void compensated_add(double &ioSum, double &ioCompensation, double const inValue) noexcept
+{
+   auto const sum{ioSum + inValue,};
+   ioCompensation += (std::abs(ioSum) >= std::abs(inValue)) ? ((ioSum - sum) + inValue) : ((inValue - sum) + ioSum);
+   ioSum = sum;
+}
+
+}
@@ -0,0 +1,138 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include <cassert> /// for assert
+#include <compare> /// for std::strong_ordering
+#include <cstdint> /// for int64_t, uint32_t, uint64_t, uint8_t
+
+namespace tean
+{
+
+#if (defined(__SIZEOF_INT128__))
+__extension__ typedef __int128 int128_t;
+#else
+/// Two's complement 128-bit integer for targets without a native one (MSVC, 32-bit),
+/// limited to the wrapping arithmetic, ordering and conversion the decimal indicators need
+class [[nodiscard]] int128_t final
+{
+public:
+   [[maybe_unused, nodiscard]] constexpr int128_t() noexcept = default;
+
+   [[maybe_unused, nodiscard]] constexpr int128_t(int64_t const inValue) noexcept :
+      m_low{static_cast<uint64_t>(inValue),},
+      m_high{(0 > inValue) ? ~uint64_t{0,} : uint64_t{0,},}
+   {}
+
+   [[maybe_unused, nodiscard]] explicit constexpr operator double() const noexcept
+   {
+      /// Converting the magnitude keeps small negative values exact instead of cancelling against -2^64
+      if (0 > static_cast<int64_t>(m_high))
+      {
+         auto const magnitudeLow{~m_low + 1,};
+         auto const magnitudeHigh{~m_high + static_cast<uint64_t>(0 == magnitudeLow),};
+         return -(static_cast<double>(magnitudeHigh) * 18446744073709551616.0 + static_cast<double>(magnitudeLow));
+      }
+      return static_cast<double>(m_high) * 18446744073709551616.0 + static_cast<double>(m_low);
+   }
+
+   [[maybe_unused]] constexpr int128_t &operator += (int128_t const inValue) noexcept
+   {
+      m_low += inValue.m_low;
+      m_high += inValue.m_high + static_cast<uint64_t>(m_low < inValue.m_low);
+      return *this;
+   }
+
+   [[maybe_unused]] constexpr int128_t &operator -= (int128_t const inValue) noexcept
+   {
+      m_high -= inValue.m_high + static_cast<uint64_t>(m_low < inValue.m_low);
+      m_low -= inValue.m_low;
+      return *this;
+   }
+
+   [[maybe_unused, nodiscard]] friend constexpr int128_t operator + (int128_t inLeft, int128_t const inRight) noexcept
+   {
+      return inLeft += inRight;
+   }
+
+   [[maybe_unused, nodiscard]] friend constexpr int128_t operator - (int128_t inLeft, int128_t const inRight) noexcept
+   {
+      return inLeft -= inRight;
+   }
+
+   [[maybe_unused, nodiscard]] friend constexpr int128_t operator * (int128_t const inLeft, int128_t const inRight) noexcept
+   {
+      /// The high halves only contribute their products with the low halves, everything above 2^128 wraps away
+      auto result{multiply(inLeft.m_low, inRight.m_low),};
+      result.m_high += inLeft.m_high * inRight.m_low + inLeft.m_low * inRight.m_high;
+      return result;
+   }
+
+   [[maybe_unused, nodiscard]] friend constexpr bool operator == (int128_t const inLeft, int128_t const inRight) noexcept = default;
+
+   [[maybe_unused, nodiscard]] friend constexpr std::strong_ordering operator <=> (int128_t const inLeft, int128_t const inRight) noexcept
+   {
+      if (auto const ordering{static_cast<int64_t>(inLeft.m_high) <=> static_cast<int64_t>(inRight.m_high),}; 0 != ordering)
+      {
+         return ordering;
+      }
+      return inLeft.m_low <=> inRight.m_low;
+   }
+
+private:
+   uint64_t m_low{0,};
+   uint64_t m_high{0,};
+
+   /// Full 64 x 64 bit product from 32-bit halves
+   [[nodiscard]] static constexpr int128_t multiply(uint64_t const inLeft, uint64_t const inRight) noexcept
+   {
+      auto const leftLow{inLeft & 0xFFFFFFFFu,};
+      auto const leftHigh{inLeft >> 32,};
+      auto const rightLow{inRight & 0xFFFFFFFFu,};
+      auto const rightHigh{inRight >> 32,};
+      auto const lowLow{leftLow * rightLow,};
+      auto const middle{(lowLow >> 32) + (leftHigh * rightLow & 0xFFFFFFFFu) + leftLow * rightHigh,};
+      int128_t result{};
+      result.m_low = (middle << 32) | (lowLow & 0xFFFFFFFFu);
+      result.m_high = leftHigh * rightHigh + (leftHigh * rightLow >> 32) + (middle >> 32);
+      return result;
+   }
+};
+#endif
+
+[[maybe_unused, nodiscard]] constexpr double scale_to_divisor(uint8_t const inScale) noexcept
+{
+   /// Powers of ten up to 10^22 are exact in double
+   assert(18 >= inScale);
+   double divisor{1,};
+   for (auto scale{inScale,}; 0 != scale--; )
+   {
+      divisor *= 10;
+   }
+   return divisor;
+}
+
+}
@@ -0,0 +1,116 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include "tean/decimal.hpp" /// for tean::scale_to_divisor
+#include "tean/decimal_sum_over_period.hpp" /// for tean::decimal_sum_over_period
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+
+#include <cstdint> /// for int64_t, uint32_t, uint64_t, uint8_t
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+
+namespace tean
+{
+
+class [[nodiscard]] decimal_simple_moving_average final
+{
+public:
+   decimal_simple_moving_average() = delete;
+   [[maybe_unused, nodiscard]] decimal_simple_moving_average(decimal_simple_moving_average &&) noexcept = default;
+   [[maybe_unused, nodiscard]] decimal_simple_moving_average(decimal_simple_moving_average const &) = default;
+
+   [[maybe_unused, nodiscard]] decimal_simple_moving_average(uint32_t const inPeriod, uint8_t const inScale, std::pmr::memory_resource *const inMemoryResource = std::pmr::get_default_resource()) :
+      m_sumOverPeriod(inPeriod, inScale, inMemoryResource),
+      m_divisor(inPeriod * scale_to_divisor(inScale))
+   {}
+
+   [[maybe_unused]] decimal_simple_moving_average &operator = (decimal_simple_moving_average &&) noexcept = default;
+   [[maybe_unused]] decimal_simple_moving_average &operator = (decimal_simple_moving_average const &) = default;
+
+   [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, int64_t const inValue) noexcept
+   {
+      int64_t sumOverPeriod{0,};
+      return calc(inSequenceNumber, inValue, sumOverPeriod);
+   }
+
+   [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, int64_t const inValue, int64_t &outSumOverPeriod) noexcept
+   {
+      [[maybe_unused]] auto const sumOverPeriod = m_sumOverPeriod.calc(inSequenceNumber, inValue, outSumOverPeriod);
+      return do_calc(inSequenceNumber, outSumOverPeriod);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return m_sumOverPeriod.load(inSequenceNumber, inReader);
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
+   {
+      return m_sumOverPeriod.lookback_period();
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t period() const noexcept
+   {
+      return m_sumOverPeriod.period();
+   }
+
+   [[maybe_unused, nodiscard]] double pick(uint64_t const inSequenceNumber, int64_t const inValue) const noexcept
+   {
+      int64_t sumOverPeriod{0,};
+      return pick(inSequenceNumber, inValue, sumOverPeriod);
+   }
+
+   [[maybe_unused, nodiscard]] double pick(uint64_t const inSequenceNumber, int64_t const inValue, int64_t &outSumOverPeriod) const noexcept
+   {
+      [[maybe_unused]] auto const sumOverPeriod = m_sumOverPeriod.pick(inSequenceNumber, inValue, outSumOverPeriod);
+      return do_pick(inSequenceNumber, outSumOverPeriod);
+   }
+
+   [[maybe_unused]] void reset() noexcept
+   {
+      m_sumOverPeriod.reset();
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      m_sumOverPeriod.save(inSequenceNumber, outWriter);
+   }
+
+   [[maybe_unused, nodiscard]] uint8_t scale() const noexcept
+   {
+      return m_sumOverPeriod.scale();
+   }
+
+private:
+   decimal_sum_over_period m_sumOverPeriod;
+   double m_divisor;
+
+   [[nodiscard]] double do_calc(uint64_t inSequenceNumber, int64_t inSumOverPeriod) noexcept;
+
+   [[nodiscard]] double do_pick(uint64_t inSequenceNumber, int64_t inSumOverPeriod) const noexcept;
+};
+
+}
@@ -0,0 +1,97 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::ring_buffer
+
+#include <cstdint> /// for int64_t, uint32_t, uint64_t, uint8_t
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+
+namespace tean
+{
+
+class [[nodiscard]] decimal_sum_over_period final
+{
+public:
+   decimal_sum_over_period() = delete;
+   [[maybe_unused, nodiscard]] decimal_sum_over_period(decimal_sum_over_period &&) noexcept = default;
+   [[maybe_unused, nodiscard]] decimal_sum_over_period(decimal_sum_over_period const &) = default;
+   [[nodiscard]] decimal_sum_over_period(uint32_t inPeriod, uint8_t inScale, std::pmr::memory_resource *inMemoryResource = std::pmr::get_default_resource());
+
+   [[maybe_unused]] decimal_sum_over_period &operator = (decimal_sum_over_period &&) noexcept = default;
+   [[maybe_unused]] decimal_sum_over_period &operator = (decimal_sum_over_period const &) = default;
+
+   [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, int64_t const inValue) noexcept
+   {
+      int64_t sum{0,};
+      return calc(inSequenceNumber, inValue, sum);
+   }
+
+   [[nodiscard]] double calc(uint64_t inSequenceNumber, int64_t inValue, int64_t &outSum) noexcept;
+
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
+   {
+      return m_lookbackPeriod;
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t period() const noexcept
+   {
+      return m_period;
+   }
+
+   [[maybe_unused, nodiscard]] double pick(uint64_t const inSequenceNumber, int64_t const inValue) const noexcept
+   {
+      int64_t sum{0,};
+      return pick(inSequenceNumber, inValue, sum);
+   }
+
+   [[nodiscard]] double pick(uint64_t inSequenceNumber, int64_t inValue, int64_t &outSum) const noexcept;
+
+   void reset() noexcept;
+
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   [[maybe_unused, nodiscard]] uint8_t scale() const noexcept
+   {
+      return m_scale;
+   }
+
+private:
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   uint8_t m_scale;
+   double m_divisor;
+   ring_buffer<int64_t> m_values;
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber;
+#endif
+   int64_t m_sum;
+};
+
+}
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+
 #include <cstdint> /// for uint32_t, uint64_t
 
 namespace tean
@@ -40,14 +42,16 @@ public:
       m_mean(0.0)
    {}
 
-   ease_of_movement(ease_of_movement &&) = delete;
-   ease_of_movement(ease_of_movement const &) = delete;
+   [[maybe_unused, nodiscard]] ease_of_movement(ease_of_movement &&) noexcept = default;
+   [[maybe_unused, nodiscard]] ease_of_movement(ease_of_movement const &) = default;
 
-   ease_of_movement &operator = (ease_of_movement &&) = delete;
-   ease_of_movement &operator = (ease_of_movement const &) = delete;
+   [[maybe_unused]] ease_of_movement &operator = (ease_of_movement &&) noexcept = default;
+   [[maybe_unused]] ease_of_movement &operator = (ease_of_movement const &) = default;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inHigh, double inLow, double inVolume) noexcept;
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
    [[maybe_unused, nodiscard]] static constexpr uint32_t lookback_period() noexcept
    {
       return 1;
@@ -63,6 +67,8 @@ public:
       m_mean = 0.0;
    }
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
 private:
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
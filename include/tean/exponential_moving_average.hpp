@@ -25,24 +25,242 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+
+#include <algorithm> /// for std::min
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
+#include <limits> /// for std::numeric_limits
 
 namespace tean
 {
 
-class [[nodiscard]] exponential_moving_average final
+template<uint32_t period = static_cast<uint32_t>(-1)>
+class exponential_moving_average;
+
+template<uint32_t fixed_period>
+class [[maybe_unused]] exponential_moving_average final
 {
+   static_assert(1 < fixed_period);
+
+   static constexpr inline auto smoothing_factor{2.0 / (fixed_period + 1),};
+   static constexpr inline auto reciprocal_period{1.0 / fixed_period,};
+
 public:
+   /// The state is a handful of scalars, so a copy evaluates any number of hypothetical values without allocating
+   using lookahead_type = exponential_moving_average;
+
+   [[maybe_unused, nodiscard]] explicit constexpr exponential_moving_average(uint32_t const inUntrustedPeriod) noexcept :
+      m_lookbackPeriod{inUntrustedPeriod + fixed_period - 1,}
+   {}
+
+   [[maybe_unused, nodiscard]] exponential_moving_average(exponential_moving_average &&) noexcept = default;
+   [[maybe_unused, nodiscard]] exponential_moving_average(exponential_moving_average const &) = default;
+
+   [[maybe_unused]] exponential_moving_average &operator = (exponential_moving_average &&) noexcept = default;
+   [[maybe_unused]] exponential_moving_average &operator = (exponential_moving_average const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      /// A skip leaves no calc to amend
+      assert(false == std::isnan(m_prevValue));
+      m_value = m_prevValue;
+      return do_calc(inSequenceNumber, inValue);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      m_prevValue = m_value;
+      return do_calc(inSequenceNumber, inValue);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(fixed_period))
+         && (true == inReader.expect(m_lookbackPeriod))
+         && (true == inReader.expect(smoothing_factor))
+         && (true == inReader.read(m_value))
+         && (true == inReader.read(m_prevValue))
+         && (true == inReader.read(m_latestValue))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t lookback_period() const noexcept
+   {
+      return m_lookbackPeriod;
+   }
+
+   [[maybe_unused, nodiscard]] static constexpr uint32_t period() noexcept
+   {
+      return fixed_period;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      if ((fixed_period <= inSequenceNumber) && (m_lookbackPeriod <= inSequenceNumber)) [[likely]]
+      {
+         return m_value + smoothing_factor * (inValue - m_value);
+      }
+      if ((fixed_period == (inSequenceNumber + 1)) && (m_lookbackPeriod == inSequenceNumber))
+      {
+         return (m_value + inValue) * reciprocal_period;
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = 0;
+#endif
+      m_value = 0;
+      m_prevValue = 0;
+      m_latestValue = 0;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(fixed_period);
+      outWriter.write(m_lookbackPeriod);
+      outWriter.write(smoothing_factor);
+      outWriter.write(m_value);
+      outWriter.write(m_prevValue);
+      outWriter.write(m_latestValue);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, carried forward and zero volume bars
+   /// repeat the latest input and decay only bars are zeros, n bars of the same input x move the average to x + (1 - smoothing factor)^n * (average - x),
+   /// the missing bars cannot be amended
+   [[maybe_unused]] void skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+      m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+      assert(0 < inSequenceNumber);
+      assert(0 < inGap);
+      m_prevValue = std::numeric_limits<double>::signaling_NaN();
+      m_latestValue = (gap_fill::decay_only == inFill) ? 0.0 : m_latestValue;
+      auto smoothedNumber{inGap,};
+      if (fixed_period > inSequenceNumber)
+      {
+         /// The seed sums the first period inputs
+         auto const seedNumber{std::min<uint64_t>(inGap, fixed_period - inSequenceNumber),};
+         smoothedNumber -= seedNumber;
+         m_value += m_latestValue * static_cast<double>(seedNumber);
+         if (fixed_period == (inSequenceNumber + seedNumber))
+         {
+            m_value *= reciprocal_period;
+         }
+      }
+      if (0 < smoothedNumber)
+      {
+         m_value = m_latestValue + std::pow(1.0 - smoothing_factor, static_cast<double>(smoothedNumber)) * (m_value - m_latestValue);
+      }
+   }
+
+private:
+   uint32_t m_lookbackPeriod;
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber{0,};
+#endif
+   double m_value{0,};
+   /// The value preceding the latest calc, an amended calc starts over from it
+   double m_prevValue{0,};
+   /// The input of the latest calc, carried forward over gaps
+   double m_latestValue{0,};
+
+   [[nodiscard]] constexpr double do_calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      m_latestValue = inValue;
+      if (fixed_period <= inSequenceNumber) [[likely]]
+      {
+         m_value += smoothing_factor * (inValue - m_value);
+         if (m_lookbackPeriod <= inSequenceNumber) [[likely]]
+         {
+            return m_value;
+         }
+      }
+      else
+      {
+         m_value += inValue;
+         if (fixed_period == (inSequenceNumber + 1))
+         {
+            m_value *= reciprocal_period;
+            if (m_lookbackPeriod == inSequenceNumber)
+            {
+               return m_value;
+            }
+         }
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+};
+
+template<>
+class [[maybe_unused]] exponential_moving_average<static_cast<uint32_t>(-1)> final
+{
+public:
+   /// The state is a handful of scalars, so a copy evaluates any number of hypothetical values without allocating
+   using lookahead_type = exponential_moving_average;
+
    exponential_moving_average() = delete;
-   exponential_moving_average(exponential_moving_average &&) = delete;
-   exponential_moving_average(exponential_moving_average const &) = delete;
+   [[maybe_unused, nodiscard]] exponential_moving_average(exponential_moving_average &&) noexcept = default;
+   [[maybe_unused, nodiscard]] exponential_moving_average(exponential_moving_average const &) = default;
    [[nodiscard]] exponential_moving_average(uint32_t inPeriod, uint32_t inUntrustedPeriod, double inSmoothing = 2.0) noexcept;
 
-   exponential_moving_average &operator = (exponential_moving_average &&) = delete;
-   exponential_moving_average &operator = (exponential_moving_average const &) = delete;
+   [[maybe_unused]] exponential_moving_average &operator = (exponential_moving_average &&) noexcept = default;
+   [[maybe_unused]] exponential_moving_average &operator = (exponential_moving_average const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inValue) noexcept;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue) noexcept;
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -61,16 +279,29 @@ public:
       m_prevSequenceNumber = 0;
 #endif
       m_value = 0.0;
+      m_prevValue = 0.0;
+      m_latestValue = 0.0;
    }
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, carried forward and zero volume bars
+   /// repeat the latest input x and decay only bars are zeros, n such bars move the average to x + (1 - smoothing factor)^n * (average - x),
+   /// the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
-   double const m_smoothingFactor;
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   double m_smoothingFactor;
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
 #endif
    double m_value;
+   double m_prevValue;
+   double m_latestValue;
+
+   [[nodiscard]] double do_calc(uint64_t inSequenceNumber, double inValue) noexcept;
 };
 
 }
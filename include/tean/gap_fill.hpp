@@ -0,0 +1,47 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint> /// for uint8_t
+
+namespace tean
+{
+
+/// What the bars missing from a sequence gap are taken to be when an indicator skips over them,
+/// every skip documents the fills it takes and sum_over_period takes the missing value itself
+enum class gap_fill : uint8_t
+{
+   /// Every missing bar repeats the latest input, so averages converge to it and volume keeps flowing
+   carry_forward,
+   /// Every missing bar is flat at the latest close and has no volume, price-only indicators see a repeated close
+   zero_volume,
+   /// Every missing bar adds nothing, smoothed state only decays by the smoothing factor per bar,
+   /// a window of prices has no such bar, so windowed indicators reject it
+   decay_only,
+};
+
+}
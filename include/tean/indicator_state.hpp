@@ -0,0 +1,188 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef> /// for size_t, std::byte
+#include <cstdint> /// for uint16_t, uint32_t, uint64_t
+#include <cstring> /// for std::memcpy
+#include <memory> /// for std::addressof
+#include <span> /// for std::as_bytes, std::span
+#include <type_traits> /// for std::is_trivially_copyable_v, std::remove_cvref_t
+#include <vector> /// for std::vector
+
+namespace tean
+{
+
+/// Bumped whenever the saved state layout of any indicator changes
+[[maybe_unused]] constexpr uint16_t indicator_state_version{1,};
+
+/// Appends indicator states to a byte buffer, values are stored in native byte order
+class [[nodiscard]] state_writer final
+{
+public:
+   state_writer() = delete;
+   state_writer(state_writer &&) = delete;
+   state_writer(state_writer const &) = delete;
+
+   [[maybe_unused, nodiscard]] explicit state_writer(std::vector<std::byte> &outBuffer) noexcept :
+      m_buffer{outBuffer,}
+   {}
+
+   state_writer &operator = (state_writer &&) = delete;
+   state_writer &operator = (state_writer const &) = delete;
+
+   template<typename value_type> requires(true == std::is_trivially_copyable_v<value_type>)
+   [[maybe_unused]] void write(value_type const &inValue)
+   {
+      write_values(std::span<value_type const>{std::addressof(inValue), 1,});
+   }
+
+   /// Monotonic deques of ring slot indices are written oldest first, wherever they start in their storage
+   template<typename indices_type>
+   [[maybe_unused]] void write_deque(indices_type const &inIndices, uint32_t const inHead, uint32_t const inSize, uint32_t const inCapacity)
+   {
+      write(inSize);
+      for (uint32_t offset{0,}; offset < inSize; ++offset)
+      {
+         auto const index{inHead + offset,};
+         write(static_cast<uint32_t>(inIndices[(inCapacity > index) ? index : (index - inCapacity)]));
+      }
+   }
+
+   /// Every saved indicator starts with the format version and the sequence number of the last value it consumed
+   [[maybe_unused]] void write_header(uint64_t const inSequenceNumber)
+   {
+      write(indicator_state_version);
+      write(inSequenceNumber);
+   }
+
+   template<typename value_type> requires(true == std::is_trivially_copyable_v<value_type>)
+   [[maybe_unused]] void write_values(std::span<value_type const> const inValues)
+   {
+      auto const bytes{std::as_bytes(inValues),};
+      m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+   }
+
+private:
+   std::vector<std::byte> &m_buffer;
+};
+
+/// Reads indicator states back, the first truncated or mismatching read fails the reader and every read after it,
+/// an indicator whose load failed is left partially restored and has to be reset before further use
+class [[nodiscard]] state_reader final
+{
+public:
+   state_reader() = delete;
+   state_reader(state_reader &&) = delete;
+   state_reader(state_reader const &) = delete;
+
+   [[maybe_unused, nodiscard]] explicit state_reader(std::span<std::byte const> const inBuffer) noexcept :
+      m_buffer{inBuffer,}
+   {}
+
+   state_reader &operator = (state_reader &&) = delete;
+   state_reader &operator = (state_reader const &) = delete;
+
+   /// Reads a configuration value and fails unless it equals the one of the indicator being loaded
+   template<typename value_type> requires(true == std::is_trivially_copyable_v<value_type>)
+   [[maybe_unused, nodiscard]] bool expect(value_type const &inValue) noexcept
+   {
+      value_type value{};
+      return ((true == read(value)) && (inValue == value)) ? true : fail();
+   }
+
+   /// Fails the reader on a value that was read fine but is out of range for the indicator being loaded
+   [[maybe_unused]] bool fail() noexcept
+   {
+      m_good = false;
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] bool good() const noexcept
+   {
+      return m_good;
+   }
+
+   [[maybe_unused, nodiscard]] size_t position() const noexcept
+   {
+      return m_position;
+   }
+
+   template<typename value_type> requires(true == std::is_trivially_copyable_v<value_type>)
+   [[maybe_unused, nodiscard]] bool read(value_type &outValue) noexcept
+   {
+      return read_values(std::span<value_type>{std::addressof(outValue), 1,});
+   }
+
+   /// Reads a deque back to the start of its storage, neither its size nor any of its indices may reach the capacity
+   template<typename indices_type>
+   [[maybe_unused, nodiscard]] bool read_deque(indices_type &outIndices, uint32_t &outHead, uint32_t &outSize, uint32_t const inCapacity) noexcept
+   {
+      outHead = 0;
+      outSize = 0;
+      uint32_t size{0,};
+      if ((false == read(size)) || (inCapacity < size))
+      {
+         return fail();
+      }
+      for (; outSize < size; ++outSize)
+      {
+         /// Indices are stored as uint32_t whatever the element type of the deque is
+         uint32_t index{0,};
+         if ((false == read(index)) || (inCapacity <= index))
+         {
+            return fail();
+         }
+         outIndices[outSize] = static_cast<std::remove_cvref_t<decltype(outIndices[outSize])>>(index);
+      }
+      return true;
+   }
+
+   [[maybe_unused, nodiscard]] bool read_header(uint64_t const inSequenceNumber) noexcept
+   {
+      return (true == expect(indicator_state_version)) && (true == expect(inSequenceNumber));
+   }
+
+   template<typename value_type> requires(true == std::is_trivially_copyable_v<value_type>)
+   [[maybe_unused, nodiscard]] bool read_values(std::span<value_type> const outValues) noexcept
+   {
+      if ((false == m_good) || ((m_buffer.size() - m_position) < outValues.size_bytes()))
+      {
+         m_good = false;
+         return false;
+      }
+      std::memcpy(outValues.data(), m_buffer.data() + m_position, outValues.size_bytes());
+      m_position += outValues.size_bytes();
+      return true;
+   }
+
+private:
+   std::span<std::byte const> m_buffer;
+   size_t m_position{0,};
+   bool m_good{true,};
+};
+
+}
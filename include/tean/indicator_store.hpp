@@ -0,0 +1,210 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "tean/mapped_file.hpp" /// for tean::mapped_file
+
+#include <cassert> /// for assert
+#include <cstddef> /// for size_t
+#include <cstdint> /// for uint32_t, uint64_t, uint8_t
+#include <filesystem> /// for std::filesystem::file_size, std::filesystem::path
+#include <fstream> /// for std::ifstream
+#include <ios> /// for std::ios
+#include <memory> /// for std::addressof, std::uninitialized_fill_n
+#include <span> /// for std::span
+#include <string_view> /// for std::string_view
+#include <system_error> /// for std::error_code
+#include <type_traits> /// for std::is_trivially_copyable_v
+#include <utility> /// for std::exchange, std::move
+
+namespace tean
+{
+
+/// Fixed period indicators kept directly in a file backed mapping, one slot per symbol, so every calc persists without serialization.
+/// The file layout is tied to the indicator type, the build flavour, the compiler and the platform, sequence numbers are tracked by the caller.
+template<typename indicator_type>
+class [[maybe_unused, nodiscard]] indicator_store final
+{
+   static_assert(true == std::is_trivially_copyable_v<indicator_type>);
+
+public:
+   [[maybe_unused, nodiscard]] indicator_store() noexcept = default;
+
+   [[maybe_unused, nodiscard]] indicator_store(indicator_store &&inOther) noexcept :
+      m_file{std::move(inOther.m_file),},
+      m_slots{std::exchange(inOther.m_slots, std::span<indicator_type>{}),}
+   {}
+
+   indicator_store(indicator_store const &) = delete;
+
+   [[maybe_unused]] indicator_store &operator = (indicator_store &&inOther) noexcept
+   {
+      if (this != &inOther)
+      {
+         m_file = std::move(inOther.m_file);
+         m_slots = std::exchange(inOther.m_slots, std::span<indicator_type>{});
+      }
+      return *this;
+   }
+
+   indicator_store &operator = (indicator_store const &) = delete;
+
+   [[maybe_unused, nodiscard]] indicator_type &operator [] (uint32_t const inSlot) const noexcept
+   {
+      assert(inSlot < m_slots.size());
+      return m_slots[inSlot];
+   }
+
+   [[maybe_unused]] void close() noexcept
+   {
+      m_file.close();
+      m_slots = std::span<indicator_type>{};
+   }
+
+   [[maybe_unused, nodiscard]] bool is_open() const noexcept
+   {
+      return true == m_file.is_open();
+   }
+
+   /// Maps an existing store or creates a new one with every slot copied from inPrototype, a store of another layout is rejected
+   [[maybe_unused, nodiscard]] bool open(std::filesystem::path const &inPath, uint32_t const inSlotsNumber, indicator_type const &inPrototype) noexcept
+   {
+      close();
+      if (0 == inSlotsNumber)
+      {
+         return false;
+      }
+      /// The mapping extends a shorter file, so an existing file is validated before it is mapped
+      auto const storeSize{sizeof(header) + sizeof(indicator_type) * inSlotsNumber,};
+      if ((false == is_reusable(inPath, inSlotsNumber, storeSize)) || (false == m_file.open(inPath, storeSize)))
+      {
+         return false;
+      }
+      auto &storeHeader{*reinterpret_cast<header *>(m_file.bytes().data()),};
+      auto *const slots{reinterpret_cast<indicator_type *>(m_file.bytes().data() + sizeof(header)),};
+      if (0 == storeHeader.magic)
+      {
+         /// The magic is stored last, so a store interrupted during creation is initialized again
+         std::uninitialized_fill_n(slots, inSlotsNumber, inPrototype);
+         storeHeader.typeTag = type_tag();
+         storeHeader.version = header_version;
+         storeHeader.slotSize = static_cast<uint32_t>(sizeof(indicator_type));
+         storeHeader.slotAlignment = static_cast<uint32_t>(alignof(indicator_type));
+         storeHeader.slotsNumber = inSlotsNumber;
+         storeHeader.magic = header_magic;
+      }
+      else if (false == matches(storeHeader, inSlotsNumber))
+      {
+         m_file.close();
+         return false;
+      }
+      m_slots = std::span<indicator_type>{slots, inSlotsNumber,};
+      return true;
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t size() const noexcept
+   {
+      return static_cast<uint32_t>(m_slots.size());
+   }
+
+   [[maybe_unused, nodiscard]] std::span<indicator_type> slots() const noexcept
+   {
+      return m_slots;
+   }
+
+   /// Blocks until every slot is written back to the file, the file is updated by the system anyway
+   [[maybe_unused, nodiscard]] bool sync() noexcept
+   {
+      return m_file.sync();
+   }
+
+private:
+   struct alignas(64) header final
+   {
+      uint64_t magic;
+      uint64_t typeTag;
+      uint32_t version;
+      uint32_t slotSize;
+      uint32_t slotAlignment;
+      uint32_t slotsNumber;
+   };
+
+   static_assert(alignof(header) >= alignof(indicator_type));
+
+   static constexpr inline uint64_t header_magic{0x65726f74736e6174,};
+   static constexpr inline uint32_t header_version{2,};
+
+   mapped_file m_file{};
+   std::span<indicator_type> m_slots{};
+
+   /// A missing or empty file becomes a new store, as does a store interrupted during creation, since the magic is stored last
+   [[nodiscard]] static bool is_reusable(std::filesystem::path const &inPath, uint32_t const inSlotsNumber, size_t const inStoreSize) noexcept
+   {
+      std::error_code errorCode{};
+      auto const fileSize{std::filesystem::file_size(inPath, errorCode),};
+      if ((true == static_cast<bool>(errorCode)) || (0 == fileSize))
+      {
+         return true;
+      }
+      header storeHeader{};
+      std::ifstream file{inPath, std::ios::binary,};
+      if ((sizeof(header) > fileSize) || (false == static_cast<bool>(file.read(reinterpret_cast<char *>(std::addressof(storeHeader)), sizeof(header)))))
+      {
+         return false;
+      }
+      return (0 == storeHeader.magic) || ((true == matches(storeHeader, inSlotsNumber)) && (inStoreSize == fileSize));
+   }
+
+   [[nodiscard]] static bool matches(header const &inHeader, uint32_t const inSlotsNumber) noexcept
+   {
+      return (header_magic == inHeader.magic)
+         && (type_tag() == inHeader.typeTag)
+         && (header_version == inHeader.version)
+         && (sizeof(indicator_type) == inHeader.slotSize)
+         && (alignof(indicator_type) == inHeader.slotAlignment)
+         && (inSlotsNumber == inHeader.slotsNumber)
+      ;
+   }
+
+   /// FNV-1a of the compiler generated signature, which spells out the indicator type with all of its template arguments
+   [[nodiscard]] static consteval uint64_t type_tag() noexcept
+   {
+#if (defined(_MSC_VER))
+      std::string_view const signature{__FUNCSIG__,};
+#else
+      std::string_view const signature{__PRETTY_FUNCTION__,};
+#endif
+      uint64_t tag{0xcbf29ce484222325,};
+      for (auto const symbol : signature)
+      {
+         tag = (tag ^ static_cast<uint8_t>(symbol)) * 0x100000001b3;
+      }
+      return tag;
+   }
+};
+
+}
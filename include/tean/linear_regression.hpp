@@ -25,13 +25,18 @@
 
 #pragma once
 
-#include <algorithm> /// for std::ranges::fill
-#include <array> /// for std::array
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::ring_buffer, tean::window_view
+
+#include <algorithm> /// for std::max, std::min
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite
-#include <cstdint> /// for int32_t, uint32_t, uint64_t
+#include <cmath> /// for std::isfinite, std::sqrt
+#include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <memory> /// for std::unique_ptr
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <utility> /// for std::exchange
 
 namespace tean
 {
@@ -42,13 +47,26 @@ struct linear_regression_result final
    double slope{std::numeric_limits<double>::signaling_NaN(),};
 };
 
-template<uint32_t period = static_cast<uint32_t>(-1)>
+struct linear_regression_extended_result final
+{
+   double intercept{std::numeric_limits<double>::signaling_NaN(),};
+   double slope{std::numeric_limits<double>::signaling_NaN(),};
+   double value{std::numeric_limits<double>::signaling_NaN(),};
+   double forecast{std::numeric_limits<double>::signaling_NaN(),};
+   double r_squared{std::numeric_limits<double>::signaling_NaN(),};
+   double standard_error{std::numeric_limits<double>::signaling_NaN(),};
+   double upper_channel{std::numeric_limits<double>::signaling_NaN(),};
+   double lower_channel{std::numeric_limits<double>::signaling_NaN(),};
+};
+
+template<uint32_t period = static_cast<uint32_t>(-1), uint32_t inline_capacity = 0>
 class linear_regression;
 
-template<uint32_t period>
+template<uint32_t period, uint32_t inline_capacity>
 class [[maybe_unused]] linear_regression final
 {
    static_assert(1 < period);
+   static_assert(0 == inline_capacity);
 
 public:
    static constexpr inline auto lookback_period{period - 1,};
@@ -57,83 +75,437 @@ private:
    static constexpr inline auto sum_x{period * lookback_period * 0.5,};
    static constexpr inline auto sum_square_x{(period * lookback_period * (2 * period - 1)) / 6.0,};
    static constexpr inline auto divisor{sum_x * sum_x - period * sum_square_x,};
+   static constexpr inline auto square_deviation_x{-divisor / period,};
 
 public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile,
+   /// the view never resums, so it matches the committed calcs up to the rounding of the running sums
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(linear_regression const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_sumY{inIndicator.m_sumY,},
+         m_sumXY{inIndicator.m_sumXY,},
+         m_sumSquareY{inIndicator.m_sumSquareY,}
+#if (not defined(NDEBUG))
+         , m_prevSequenceNumber{inIndicator.m_prevSequenceNumber,}
+#endif
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr linear_regression_result calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         if (true == do_update(inSequenceNumber, inValue)) [[likely]]
+         {
+            return do_calc(m_sumY, m_sumXY);
+         }
+         return linear_regression_result{};
+      }
+
+      [[maybe_unused, nodiscard]] constexpr linear_regression_extended_result calc_extended(
+         uint64_t const inSequenceNumber,
+         double const inValue,
+         double const inChannelWidth
+      ) noexcept
+      {
+         assert(true == std::isfinite(inChannelWidth));
+         if (true == do_update(inSequenceNumber, inValue)) [[likely]]
+         {
+            return do_calc_extended(m_sumY, m_sumXY, m_sumSquareY, inChannelWidth);
+         }
+         return linear_regression_extended_result{};
+      }
+
+   private:
+      linear_regression const *m_indicator;
+      double m_sumY;
+      double m_sumXY;
+      double m_sumSquareY;
+      uint32_t m_valuesNumber{0,};
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+
+      /// Every value already in the window moves one step away from the newest one, which has x = 0
+      constexpr void do_push(double const inValue) noexcept
+      {
+         m_sumXY += m_sumY;
+         m_sumY += inValue;
+         m_sumSquareY += inValue * inValue;
+      }
+
+      [[nodiscard]] constexpr bool do_update(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+#if (not defined(NDEBUG))
+         assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         assert(true == std::isfinite(inValue));
+         assert(period > m_valuesNumber);
+         auto const &yValues{m_indicator->m_yValues,};
+         if (lookback_period < inSequenceNumber) [[likely]]
+         {
+            /// The j-th hypothetical value evicts the j-th oldest committed one
+            auto const yValue{yValues[yValues.wrap(yValues.cursor() + m_valuesNumber)],};
+            ++m_valuesNumber;
+            m_sumXY += m_sumY - period * yValue;
+            m_sumY += inValue - yValue;
+            m_sumSquareY += inValue * inValue - yValue * yValue;
+            return true;
+         }
+         if (0 == m_valuesNumber)
+         {
+            /// The sums are only kept once the window is full, until then the values committed so far fill the ring from its origin
+            m_sumY = 0;
+            m_sumXY = 0;
+            m_sumSquareY = 0;
+            for (uint32_t valueIndex{0,}; valueIndex < inSequenceNumber; ++valueIndex)
+            {
+               do_push(yValues[valueIndex]);
+            }
+         }
+         ++m_valuesNumber;
+         do_push(inValue);
+         return lookback_period == inSequenceNumber;
+      }
+   };
+
    [[maybe_unused, nodiscard]] constexpr linear_regression() noexcept
    {
 #if (not defined(NDEBUG))
-      std::ranges::fill(m_yValues, std::numeric_limits<double>::signaling_NaN());
+      m_yValues.reset(std::numeric_limits<double>::signaling_NaN());
 #endif
    }
 
-   linear_regression(linear_regression &&) = delete;
-   linear_regression(linear_regression const &) = delete;
+   [[maybe_unused, nodiscard]] explicit constexpr linear_regression(uint32_t const inResummationPeriod) noexcept :
+      m_resummationPeriod{inResummationPeriod,}
+   {
+      assert(0 < m_resummationPeriod);
+#if (not defined(NDEBUG))
+      m_yValues.reset(std::numeric_limits<double>::signaling_NaN());
+#endif
+   }
+
+   [[maybe_unused, nodiscard]] linear_regression(linear_regression &&) noexcept = default;
+   [[maybe_unused, nodiscard]] linear_regression(linear_regression const &) = default;
+
+   [[maybe_unused]] linear_regression &operator = (linear_regression &&) noexcept = default;
+   [[maybe_unused]] linear_regression &operator = (linear_regression const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] constexpr linear_regression_result amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      if (true == do_amend(inSequenceNumber, inValue)) [[likely]]
+      {
+         return do_calc(m_sumY, m_sumXY);
+      }
+      return linear_regression_result{};
+   }
 
-   linear_regression &operator = (linear_regression &&) = delete;
-   linear_regression &operator = (linear_regression const &) = delete;
+   [[maybe_unused, nodiscard]] constexpr linear_regression_extended_result amend_extended(
+      uint64_t const inSequenceNumber,
+      double const inValue,
+      double const inChannelWidth
+   ) noexcept
+   {
+      assert(true == std::isfinite(inChannelWidth));
+      if (true == do_amend(inSequenceNumber, inValue)) [[likely]]
+      {
+         return do_calc_extended(m_sumY, m_sumXY, m_sumSquareY, inChannelWidth);
+      }
+      return linear_regression_extended_result{};
+   }
 
    [[maybe_unused, nodiscard]] constexpr linear_regression_result calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
-#if (not defined(NDEBUG))
-      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
-      m_prevSequenceNumber = inSequenceNumber;
-#endif
-      assert(true == std::isfinite(inValue));
-      m_yValues[inSequenceNumber % period] = inValue;
-      if (lookback_period <= inSequenceNumber) [[likely]]
+      if (true == do_update(inSequenceNumber, inValue)) [[likely]]
       {
-         return do_calc(inSequenceNumber);
+         return do_calc(m_sumY, m_sumXY);
       }
       return linear_regression_result{};
    }
 
+   [[maybe_unused, nodiscard]] constexpr linear_regression_extended_result calc_extended(
+      uint64_t const inSequenceNumber,
+      double const inValue,
+      double const inChannelWidth
+   ) noexcept
+   {
+      assert(true == std::isfinite(inChannelWidth));
+      if (true == do_update(inSequenceNumber, inValue)) [[likely]]
+      {
+         return do_calc_extended(m_sumY, m_sumXY, m_sumSquareY, inChannelWidth);
+      }
+      return linear_regression_extended_result{};
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(m_resummationPeriod))
+         && (true == m_yValues.load(inReader))
+         && (true == inReader.read(m_resummationCountdown))
+         && (true == inReader.read(m_sumY))
+         && (true == inReader.read(m_sumXY))
+         && (true == inReader.read(m_sumSquareY))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t resummation_period() const noexcept
+   {
+      return m_resummationPeriod;
+   }
+
    [[maybe_unused]] constexpr void reset() noexcept
    {
+      m_yValues.seek(0);
 #if (not defined(NDEBUG))
-      std::ranges::fill(m_yValues, std::numeric_limits<double>::signaling_NaN());
+      m_yValues.reset(std::numeric_limits<double>::signaling_NaN());
       m_prevSequenceNumber = 0;
 #endif
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(m_resummationPeriod);
+      m_yValues.save(outWriter);
+      outWriter.write(m_resummationCountdown);
+      outWriter.write(m_sumY);
+      outWriter.write(m_sumXY);
+      outWriter.write(m_sumSquareY);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward and zero volume
+   /// bars repeat the latest value, decay only bars would put zero prices into the window and are rejected, the missing bars cannot be amended
+   [[maybe_unused]] constexpr void skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+   {
+      assert(0 < inSequenceNumber);
+      assert(0 < inGap);
+      assert(gap_fill::decay_only != inFill);
+      auto const yValue{m_yValues.newest(),};
+      auto const yValuesNumber{std::min<uint64_t>(inGap, period),};
+      for (auto sequenceNumber{inSequenceNumber,}; sequenceNumber < (inSequenceNumber + yValuesNumber); ++sequenceNumber)
+      {
+         [[maybe_unused]] auto const ready{do_update(sequenceNumber, yValue),};
+      }
+      if (inGap > yValuesNumber)
+      {
+         /// Once the window only holds copies of the value, the rest of the gap leaves the sums as is and only the resummation schedule moves on
+         auto const restNumber{inGap - yValuesNumber,};
+         if (m_resummationCountdown <= restNumber)
+         {
+            do_sum();
+         }
+         else
+         {
+            m_resummationCountdown -= static_cast<uint32_t>(restNumber);
+         }
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+      }
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_yValues.window();
+   }
+
 private:
-   std::array<double, period> m_yValues{};
+   ring_buffer<double, period> m_yValues{};
+   uint32_t m_resummationPeriod{1,};
+   uint32_t m_resummationCountdown{0,};
+   double m_sumY{0,};
+   double m_sumXY{0,};
+   double m_sumSquareY{0,};
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber{0,};
 #endif
 
-   [[nodiscard]] constexpr linear_regression_result do_calc(uint64_t const inSequenceNumber) const noexcept
+   /// The newest value has x = 0, so replacing it leaves the sum of x * y untouched
+   [[nodiscard]] constexpr bool do_amend(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
-      double sumY{0,};
-      double sumXY{0,};
-      for (auto x{static_cast<int32_t>(period),}; 0 != x--; )
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      assert(true == std::isfinite(inValue));
+      auto const yValue{std::exchange(m_yValues.newest(), inValue),};
+      if (lookback_period <= inSequenceNumber) [[likely]]
       {
-         auto const y{m_yValues[(inSequenceNumber - x) % period],};
-         sumY += y;
-         sumXY += x * y;
+         m_sumY += inValue - yValue;
+         m_sumSquareY += inValue * inValue - yValue * yValue;
+         return true;
       }
-      auto const slope{(period * sumXY - sum_x * sumY) / divisor,};
+      return false;
+   }
+
+   [[nodiscard]] static constexpr linear_regression_result do_calc(double const inSumY, double const inSumXY) noexcept
+   {
+      auto const slope{(period * inSumXY - sum_x * inSumY) / divisor,};
       return linear_regression_result
       {
-         .intercept = (sumY - slope * sum_x) / period,
+         .intercept = (inSumY - slope * sum_x) / period,
          .slope = slope,
       };
    }
+
+   [[nodiscard]] static constexpr linear_regression_extended_result do_calc_extended(
+      double const inSumY,
+      double const inSumXY,
+      double const inSumSquareY,
+      double const inChannelWidth
+   ) noexcept
+   {
+      auto const result{do_calc(inSumY, inSumXY),};
+      auto const deviationXY{inSumXY - sum_x * inSumY / period,};
+      auto const squareDeviationY{std::max(inSumSquareY - inSumY * inSumY / period, 0.0),};
+      auto const squareError{std::max(squareDeviationY - deviationXY * deviationXY / square_deviation_x, 0.0),};
+      auto const standardError{(2 < period) ? std::sqrt(squareError / (period - 2)) : 0.0,};
+      auto const value{result.intercept + result.slope * lookback_period,};
+      return linear_regression_extended_result
+      {
+         .intercept = result.intercept,
+         .slope = result.slope,
+         .value = value,
+         .forecast = result.intercept + result.slope * period,
+         .r_squared = (0 < squareDeviationY) ? (1.0 - squareError / squareDeviationY) : 0.0,
+         .standard_error = standardError,
+         .upper_channel = value + inChannelWidth * standardError,
+         .lower_channel = value - inChannelWidth * standardError,
+      };
+   }
+
+   constexpr void do_sum() noexcept
+   {
+      m_resummationCountdown = m_resummationPeriod;
+      m_sumY = 0;
+      m_sumXY = 0;
+      m_sumSquareY = 0;
+      for (uint32_t valueIndex{0,}; valueIndex < period; ++valueIndex)
+      {
+         auto const x{lookback_period - valueIndex,};
+         auto const y{m_yValues[m_yValues.wrap(m_yValues.cursor() + valueIndex)],};
+         m_sumY += y;
+         m_sumXY += x * y;
+         m_sumSquareY += y * y;
+      }
+   }
+
+   [[nodiscard]] constexpr bool do_update(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inValue));
+      auto const yValue{m_yValues.exchange(inValue),};
+      if ((lookback_period < inSequenceNumber) && (0 != --m_resummationCountdown)) [[likely]]
+      {
+         m_sumXY += m_sumY - period * yValue;
+         m_sumY += inValue - yValue;
+         m_sumSquareY += inValue * inValue - yValue * yValue;
+         return true;
+      }
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         do_sum();
+         return true;
+      }
+      return false;
+   }
 };
 
-template<>
-class [[maybe_unused]] linear_regression<static_cast<uint32_t>(-1)> final
+/// Windows of up to inline_capacity values are kept inside the object, the library instantiates inline capacities 0, 8, 16, 32 and 64
+template<uint32_t inline_capacity>
+class [[maybe_unused]] linear_regression<static_cast<uint32_t>(-1), inline_capacity> final
 {
+   static_assert(
+      (0 == inline_capacity) || (8 == inline_capacity) || (16 == inline_capacity) || (32 == inline_capacity) || (64 == inline_capacity),
+      "the runtime linear_regression is only instantiated with inline capacities 0, 8, 16, 32 and 64"
+   );
+
 public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile,
+   /// the view never resums, so it matches the committed calcs up to the rounding of the running sums
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+      [[nodiscard]] explicit lookahead_type(linear_regression const &inIndicator) noexcept;
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[nodiscard]] linear_regression_result calc(uint64_t inSequenceNumber, double inValue) noexcept;
+
+      [[nodiscard]] linear_regression_extended_result calc_extended(uint64_t inSequenceNumber, double inValue, double inChannelWidth) noexcept;
+
+   private:
+      linear_regression const *m_indicator;
+      double m_sumY;
+      double m_sumXY;
+      double m_sumSquareY;
+      uint32_t m_valuesNumber;
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+
+      /// Every value already in the window moves one step away from the newest one, which has x = 0
+      void do_push(double inValue) noexcept;
+
+      [[nodiscard]] bool do_update(uint64_t inSequenceNumber, double inValue) noexcept;
+   };
+
    linear_regression() = delete;
-   linear_regression(linear_regression &&) = delete;
-   linear_regression(linear_regression const &) = delete;
-   [[nodiscard]] explicit linear_regression(uint32_t inPeriod);
+   [[maybe_unused, nodiscard]] linear_regression(linear_regression &&) noexcept = default;
+   [[maybe_unused, nodiscard]] linear_regression(linear_regression const &) = default;
+   [[nodiscard]] explicit linear_regression(uint32_t inPeriod, uint32_t inResummationPeriod = 1, std::pmr::memory_resource *inMemoryResource = std::pmr::get_default_resource());
+
+   [[maybe_unused]] linear_regression &operator = (linear_regression &&) noexcept = default;
+   [[maybe_unused]] linear_regression &operator = (linear_regression const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[nodiscard]] linear_regression_result amend(uint64_t inSequenceNumber, double inValue) noexcept;
 
-   linear_regression &operator = (linear_regression &&) = delete;
-   linear_regression &operator = (linear_regression const &) = delete;
+   [[nodiscard]] linear_regression_extended_result amend_extended(uint64_t inSequenceNumber, double inValue, double inChannelWidth) noexcept;
 
    [[nodiscard]] linear_regression_result calc(uint64_t inSequenceNumber, double inValue) noexcept;
 
+   [[nodiscard]] linear_regression_extended_result calc_extended(uint64_t inSequenceNumber, double inValue, double inChannelWidth) noexcept;
+
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -146,17 +518,52 @@ public:
 
    void reset() noexcept;
 
+   [[maybe_unused, nodiscard]] uint32_t resummation_period() const noexcept
+   {
+      return m_resummationPeriod;
+   }
+
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward and zero volume
+   /// bars repeat the latest value, decay only bars would put zero prices into the window and are rejected, the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_yValues.window();
+   }
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
-   double const m_sumX;
-   double const m_divisor;
-   std::unique_ptr<double[]> const m_yValues;
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   uint32_t m_resummationPeriod;
+   double m_sumX;
+   double m_divisor;
+   ring_buffer<double, static_cast<uint32_t>(-1), inline_capacity> m_yValues;
+   uint32_t m_resummationCountdown{0,};
+   double m_sumY{0,};
+   double m_sumXY{0,};
+   double m_sumSquareY{0,};
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber{0,};
 #endif
 
-   [[nodiscard]] linear_regression_result do_calc(uint64_t inSequenceNumber) noexcept;
+   [[nodiscard]] bool do_amend(uint64_t inSequenceNumber, double inValue) noexcept;
+
+   [[nodiscard]] linear_regression_result do_calc(double inSumY, double inSumXY) const noexcept;
+
+   [[nodiscard]] linear_regression_extended_result do_calc_extended(double inSumY, double inSumXY, double inSumSquareY, double inChannelWidth) const noexcept;
+
+   void do_sum() noexcept;
+
+   [[nodiscard]] bool do_update(uint64_t inSequenceNumber, double inValue) noexcept;
 };
 
+extern template class linear_regression<static_cast<uint32_t>(-1), 0>;
+extern template class linear_regression<static_cast<uint32_t>(-1), 8>;
+extern template class linear_regression<static_cast<uint32_t>(-1), 16>;
+extern template class linear_regression<static_cast<uint32_t>(-1), 32>;
+extern template class linear_regression<static_cast<uint32_t>(-1), 64>;
+
 }
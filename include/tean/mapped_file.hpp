@@ -0,0 +1,91 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef> /// for size_t, std::byte
+#include <filesystem> /// for std::filesystem::path
+#include <span> /// for std::span
+#include <utility> /// for std::exchange
+
+namespace tean
+{
+
+/// Shared read-write mapping of a file, stores into the mapped bytes reach the file without any explicit write
+class [[nodiscard]] mapped_file final
+{
+public:
+   [[maybe_unused, nodiscard]] mapped_file() noexcept = default;
+
+   [[maybe_unused, nodiscard]] mapped_file(mapped_file &&inOther) noexcept :
+      m_data{std::exchange(inOther.m_data, nullptr),},
+      m_size{std::exchange(inOther.m_size, 0),}
+   {}
+
+   mapped_file(mapped_file const &) = delete;
+
+   ~mapped_file()
+   {
+      close();
+   }
+
+   [[maybe_unused]] mapped_file &operator = (mapped_file &&inOther) noexcept
+   {
+      if (this != &inOther)
+      {
+         close();
+         m_data = std::exchange(inOther.m_data, nullptr);
+         m_size = std::exchange(inOther.m_size, 0);
+      }
+      return *this;
+   }
+
+   mapped_file &operator = (mapped_file const &) = delete;
+
+   [[maybe_unused, nodiscard]] std::span<std::byte> bytes() const noexcept
+   {
+      return std::span<std::byte>{m_data, m_size,};
+   }
+
+   void close() noexcept;
+
+   [[maybe_unused, nodiscard]] bool is_open() const noexcept
+   {
+      return nullptr != m_data;
+   }
+
+   /// Maps the first inSize bytes of the file, a missing or shorter file is created or extended with zero bytes
+   [[nodiscard]] bool open(std::filesystem::path const &inPath, size_t inSize) noexcept;
+
+   /// Blocks until the mapped bytes are written back to the file
+   [[nodiscard]] bool sync() noexcept;
+
+private:
+   std::byte *m_data{nullptr,};
+   size_t m_size{0,};
+};
+
+}
@@ -25,26 +25,374 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::ring_buffer, tean::window_view
+
+#include <algorithm> /// for std::max, std::min, std::ranges::all_of
+#include <array> /// for std::array
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan
+#include <cstddef> /// for size_t
 #include <cstdint> /// for uint32_t, uint64_t
-#include <memory> /// for std::unique_ptr
-#include <utility> /// for std::pair
+#include <limits> /// for std::numeric_limits
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <span> /// for std::span
 
 namespace tean
 {
 
-class [[nodiscard]] maximum_in_period final
+template<uint32_t period = static_cast<uint32_t>(-1), uint32_t inline_capacity = 0>
+class maximum_in_period;
+
+template<uint32_t period, uint32_t inline_capacity>
+class [[maybe_unused]] maximum_in_period final
+{
+   static_assert(1 < period);
+   static_assert(0 == inline_capacity);
+
+public:
+   static constexpr inline auto lookback_period{period - 1,};
+
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile,
+   /// the committed deque is only walked past the values the hypothetical ones push out of the window
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(maximum_in_period const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_maximumIndicesHead{inIndicator.m_maximumIndicesHead,},
+         m_maximumIndicesSize{inIndicator.m_maximumIndicesSize,}
+#if (not defined(NDEBUG))
+         , m_prevSequenceNumber{inIndicator.m_prevSequenceNumber,}
+#endif
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+#if (not defined(NDEBUG))
+         assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         assert(true == std::isfinite(inValue));
+         assert(false == std::isnan(inValue));
+         assert(period > m_valuesNumber);
+         auto const &values{m_indicator->m_values,};
+         /// The j-th hypothetical value pushes out the committed values up to the j-th oldest slot
+         while ((0 < m_maximumIndicesSize) && (m_valuesNumber >= values.wrap(m_indicator->m_maximumIndices[m_maximumIndicesHead] + period - values.cursor())))
+         {
+            m_maximumIndicesHead = values.wrap(m_maximumIndicesHead + 1);
+            --m_maximumIndicesSize;
+         }
+         m_maximum = ((0 == m_valuesNumber) || (m_maximum < inValue)) ? inValue : m_maximum;
+         ++m_valuesNumber;
+         auto maximum{m_maximum,};
+         if ((period > m_valuesNumber) && (m_valuesNumber <= inSequenceNumber))
+         {
+            /// The input of the latest calc is not in the deque yet, it leaves the window with the last hypothetical value
+            maximum = std::max(values.newest(), maximum);
+         }
+         return (0 == m_maximumIndicesSize) ? maximum : std::max(values[m_indicator->m_maximumIndices[m_maximumIndicesHead]], maximum);
+      }
+
+   private:
+      maximum_in_period const *m_indicator;
+      uint32_t m_maximumIndicesHead;
+      uint32_t m_maximumIndicesSize;
+      uint32_t m_valuesNumber{0,};
+      double m_maximum{0,};
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+   };
+
+   [[maybe_unused, nodiscard]] constexpr maximum_in_period() noexcept
+   {
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
+   }
+
+   [[maybe_unused, nodiscard]] maximum_in_period(maximum_in_period &&) noexcept = default;
+   [[maybe_unused, nodiscard]] maximum_in_period(maximum_in_period const &) = default;
+
+   [[maybe_unused]] maximum_in_period &operator = (maximum_in_period &&) noexcept = default;
+   [[maybe_unused]] maximum_in_period &operator = (maximum_in_period const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value in O(1),
+   /// the input of the latest calc only joins the deque with the next calc
+   [[maybe_unused, nodiscard]] constexpr double amend([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      m_values.newest() = inValue;
+      return (0 == m_maximumIndicesSize) ? inValue : std::max(m_values[m_maximumIndices[m_maximumIndicesHead]], inValue);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      if (0 == inSequenceNumber) [[unlikely]]
+      {
+         m_values.push(inValue);
+         return inValue;
+      }
+      return do_calc(inValue);
+   }
+
+   [[maybe_unused]] constexpr void calc(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<double> const outValues) noexcept
+   {
+      assert(inValues.size() == outValues.size());
+      assert(true == std::ranges::all_of(inValues, [] (double const inValue) { return std::isfinite(inValue); }));
+      /// Windows overlapping values preceding the batch are served by the streaming path
+      auto const streamingSize{std::min<size_t>(lookback_period, inValues.size()),};
+      for (size_t valueIndex{0,}; valueIndex < streamingSize; ++valueIndex)
+      {
+         outValues[valueIndex] = calc(inSequenceNumber + valueIndex, inValues[valueIndex]);
+      }
+      if (inValues.size() < period)
+      {
+         return;
+      }
+      do_van_herk_gil_werman(inValues, outValues);
+      /// Rebuild the streaming state from the last period of the batch
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber + inValues.size() - 1;
+#endif
+      m_maximumIndicesHead = 0;
+      m_maximumIndicesSize = 0;
+      m_values.seek(static_cast<uint32_t>((inSequenceNumber + inValues.size()) % period));
+      for (auto const value : inValues.template last<period>())
+      {
+         m_values.push(value);
+      }
+      for (uint32_t valueIndex{0,}; valueIndex < lookback_period; ++valueIndex)
+      {
+         do_push(m_values.wrap(m_values.cursor() + valueIndex));
+      }
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if ((true == inReader.read_header(inSequenceNumber)) && (true == m_values.load(inReader)) && (true == inReader.read_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, period)))
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      auto maximumIndicesHead{m_maximumIndicesHead,};
+      auto maximumIndicesSize{m_maximumIndicesSize,};
+      if ((0 < maximumIndicesSize) && (m_values.cursor() == m_maximumIndices[maximumIndicesHead]))
+      {
+         maximumIndicesHead = m_values.wrap(maximumIndicesHead + 1);
+         --maximumIndicesSize;
+      }
+      /// The input of the latest calc is not in the deque yet
+      auto const maximum{(0 < inSequenceNumber) ? std::max(m_values.newest(), inValue) : inValue,};
+      return (0 == maximumIndicesSize)
+         ? maximum
+         : std::max(m_values[m_maximumIndices[maximumIndicesHead]], maximum)
+      ;
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = 0;
+#endif
+      m_maximumIndicesHead = 0;
+      m_maximumIndicesSize = 0;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      m_values.save(outWriter);
+      outWriter.write_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, period);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward and zero volume
+   /// bars repeat the latest value, decay only bars would put zero prices into the window and are rejected, the missing bars cannot be amended
+   [[maybe_unused]] constexpr void skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+      m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+      assert(0 < inSequenceNumber);
+      assert(0 < inGap);
+      assert(gap_fill::decay_only != inFill);
+      auto const value{m_values.newest(),};
+      for (auto valuesNumber{std::min<uint64_t>(inGap, period),}; 0 < valuesNumber; --valuesNumber)
+      {
+         [[maybe_unused]] auto const maximumValue{do_calc(value),};
+      }
+      if (inGap > period)
+      {
+         /// The window only holds copies of the value, so the rest of the gap just moves the cursor and the newest committed copy heads the deque
+         m_values.seek(static_cast<uint32_t>((inSequenceNumber + inGap) % period));
+         m_maximumIndicesHead = 0;
+         m_maximumIndicesSize = 1;
+         m_maximumIndices[0] = m_values.wrap(m_values.cursor() + lookback_period - 1);
+      }
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
+private:
+   ring_buffer<double, period> m_values{};
+   std::array<uint32_t, period> m_maximumIndices{};
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber{0,};
+#endif
+   uint32_t m_maximumIndicesHead{0,};
+   uint32_t m_maximumIndicesSize{0,};
+
+   /// Commits the input of the latest calc to the deque and takes the next one, which stays out of it until the next calc
+   [[nodiscard]] constexpr double do_calc(double const inValue) noexcept
+   {
+      do_push(m_values.wrap(m_values.cursor() + lookback_period));
+      if (m_values.cursor() == m_maximumIndices[m_maximumIndicesHead])
+      {
+         m_maximumIndicesHead = m_values.wrap(m_maximumIndicesHead + 1);
+         --m_maximumIndicesSize;
+      }
+      m_values.push(inValue);
+      return std::max(m_values[m_maximumIndices[m_maximumIndicesHead]], inValue);
+   }
+
+   constexpr void do_push(uint32_t const inIndex) noexcept
+   {
+      while ((0 < m_maximumIndicesSize) && (m_values[m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize - 1)]] <= m_values[inIndex]))
+      {
+         --m_maximumIndicesSize;
+      }
+      m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize)] = inIndex;
+      ++m_maximumIndicesSize;
+   }
+
+   static constexpr void do_van_herk_gil_werman(std::span<double const> const inValues, std::span<double> const outValues) noexcept
+   {
+      /// Windows of output values [blockBegin + period - 1, blockEnd + period - 1) span the block and the next one,
+      /// the block suffix maximum is stored in-place and then merged with the prefix maximum of the next block
+      for (size_t blockBegin{0,}; (blockBegin + period) <= inValues.size(); blockBegin += period)
+      {
+         auto const blockEnd{blockBegin + period,};
+         auto suffixMaximum{std::numeric_limits<double>::lowest(),};
+         for (auto valueIndex{blockEnd,}; blockBegin != valueIndex--; )
+         {
+            suffixMaximum = std::max(suffixMaximum, inValues[valueIndex]);
+            if (auto const outIndex{valueIndex + lookback_period,}; outIndex < outValues.size())
+            {
+               outValues[outIndex] = suffixMaximum;
+            }
+         }
+         auto prefixMaximum{std::numeric_limits<double>::lowest(),};
+         for (auto valueIndex{blockEnd,}, valueEnd{std::min<size_t>(blockEnd + lookback_period, inValues.size()),}; valueIndex < valueEnd; ++valueIndex)
+         {
+            prefixMaximum = std::max(prefixMaximum, inValues[valueIndex]);
+            outValues[valueIndex] = std::max(outValues[valueIndex], prefixMaximum);
+         }
+      }
+   }
+};
+
+/// Windows of up to inline_capacity values are kept inside the object, the library instantiates inline capacities 0, 8, 16, 32 and 64
+template<uint32_t inline_capacity>
+class [[maybe_unused]] maximum_in_period<static_cast<uint32_t>(-1), inline_capacity> final
 {
+   static_assert(
+      (0 == inline_capacity) || (8 == inline_capacity) || (16 == inline_capacity) || (32 == inline_capacity) || (64 == inline_capacity),
+      "the runtime maximum_in_period is only instantiated with inline capacities 0, 8, 16, 32 and 64"
+   );
+
 public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile,
+   /// the committed deque is only walked past the values the hypothetical ones push out of the window
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+      [[nodiscard]] explicit lookahead_type(maximum_in_period const &inIndicator) noexcept;
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue) noexcept;
+
+   private:
+      maximum_in_period const *m_indicator;
+      uint32_t m_maximumIndicesHead;
+      uint32_t m_maximumIndicesSize;
+      uint32_t m_valuesNumber;
+      double m_maximum;
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+   };
+
    maximum_in_period() = delete;
-   maximum_in_period(maximum_in_period &&) = delete;
-   maximum_in_period(maximum_in_period const &) = delete;
-   [[nodiscard]] explicit maximum_in_period(uint32_t inPeriod);
+   [[maybe_unused, nodiscard]] maximum_in_period(maximum_in_period &&) noexcept = default;
+   [[maybe_unused, nodiscard]] maximum_in_period(maximum_in_period const &) = default;
+   [[nodiscard]] explicit maximum_in_period(uint32_t inPeriod, std::pmr::memory_resource *inMemoryResource = std::pmr::get_default_resource());
 
-   maximum_in_period &operator = (maximum_in_period &&) = delete;
-   maximum_in_period &operator = (maximum_in_period const &) = delete;
+   [[maybe_unused]] maximum_in_period &operator = (maximum_in_period &&) noexcept = default;
+   [[maybe_unused]] maximum_in_period &operator = (maximum_in_period const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value in O(1),
+   /// the input of the latest calc only joins the deque with the next calc
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inValue) noexcept;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue) noexcept;
 
+   void calc(uint64_t inSequenceNumber, std::span<double const> inValues, std::span<double> outValues) noexcept;
+
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -59,16 +407,38 @@ public:
 
    void reset() noexcept;
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward and zero volume
+   /// bars repeat the latest value, decay only bars would put zero prices into the window and are rejected, the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
-   std::unique_ptr<double[]> const m_values;
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   ring_buffer<double, static_cast<uint32_t>(-1), inline_capacity> m_values;
+   ring_buffer<uint32_t, static_cast<uint32_t>(-1), inline_capacity> m_maximumIndices;
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
 #endif
-   uint32_t m_maximumValueIndex;
+   uint32_t m_maximumIndicesHead;
+   uint32_t m_maximumIndicesSize;
+
+   /// Commits the input of the latest calc to the deque and takes the next one, which stays out of it until the next calc
+   [[nodiscard]] double do_calc(double inValue) noexcept;
 
-   [[nodiscard]] std::pair<uint32_t, double> get_maximum(uint32_t inIndex, double inValue) const noexcept;
+   void do_push(uint32_t inIndex) noexcept;
 };
 
+extern template class maximum_in_period<static_cast<uint32_t>(-1), 0>;
+extern template class maximum_in_period<static_cast<uint32_t>(-1), 8>;
+extern template class maximum_in_period<static_cast<uint32_t>(-1), 16>;
+extern template class maximum_in_period<static_cast<uint32_t>(-1), 32>;
+extern template class maximum_in_period<static_cast<uint32_t>(-1), 64>;
+
 }
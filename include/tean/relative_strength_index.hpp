@@ -25,24 +25,354 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+
+#include <algorithm> /// for std::max, std::ranges::all_of, std::ranges::fill, std::ranges::transform
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
+#include <limits> /// for std::numeric_limits
+#include <span> /// for std::span
 
 namespace tean
 {
 
-class [[nodiscard]] relative_strength_index final
+template<uint32_t period = static_cast<uint32_t>(-1)>
+class relative_strength_index;
+
+template<uint32_t fixed_period>
+class [[maybe_unused]] relative_strength_index final
 {
+   static_assert(1 < fixed_period);
+
+   static constexpr inline auto reciprocal_period{1.0 / fixed_period,};
+
 public:
+   static constexpr inline auto lookback_period{fixed_period,};
+
+   /// The state is a handful of scalars, so a copy evaluates any number of hypothetical values without allocating
+   using lookahead_type = relative_strength_index;
+
+   [[maybe_unused, nodiscard]] constexpr relative_strength_index() noexcept = default;
+   [[maybe_unused, nodiscard]] relative_strength_index(relative_strength_index &&) noexcept = default;
+   [[maybe_unused, nodiscard]] relative_strength_index(relative_strength_index const &) = default;
+
+   [[maybe_unused]] relative_strength_index &operator = (relative_strength_index &&) noexcept = default;
+   [[maybe_unused]] relative_strength_index &operator = (relative_strength_index const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      /// A skip leaves no calc to amend
+      assert((false == std::isnan(m_prevSmoothGain)) && (false == std::isnan(m_prevSmoothLoss)));
+      m_smoothGain = m_prevSmoothGain;
+      m_smoothLoss = m_prevSmoothLoss;
+      m_value = m_prevValue;
+      if (lookback_period < inSequenceNumber) [[likely]]
+      {
+         return do_regular_calc(inValue);
+      }
+      return do_lookback_calc(inSequenceNumber, inValue);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      m_prevSmoothGain = m_smoothGain;
+      m_prevSmoothLoss = m_smoothLoss;
+      m_prevValue = m_value;
+      if (lookback_period < inSequenceNumber) [[likely]]
+      {
+         return do_regular_calc(inValue);
+      }
+      return do_lookback_calc(inSequenceNumber, inValue);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(fixed_period))
+         && (true == inReader.read(m_smoothGain))
+         && (true == inReader.read(m_smoothLoss))
+         && (true == inReader.read(m_value))
+         && (true == inReader.read(m_prevSmoothGain))
+         && (true == inReader.read(m_prevSmoothLoss))
+         && (true == inReader.read(m_prevValue))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
+   [[maybe_unused, nodiscard]] static constexpr uint32_t period() noexcept
+   {
+      return fixed_period;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      if (lookback_period < inSequenceNumber) [[likely]]
+      {
+         return do_regular_pick(inValue);
+      }
+      if (lookback_period == inSequenceNumber) [[unlikely]]
+      {
+         return do_lookback_pick(inValue);
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   /// Same as pick for every candidate value against the same committed state, the smoothed gain and loss are loaded once
+   [[maybe_unused]] constexpr void pick_many(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<double> const outValues) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(inValues.size() == outValues.size());
+      assert(true == std::ranges::all_of(inValues, [] (double const inValue) { return std::isfinite(inValue); }));
+      if (lookback_period < inSequenceNumber) [[likely]]
+      {
+         /// Locals keep the loop free of reloads through the output span, max in place of the sign branch keeps it vectorizable
+         auto const value{m_value,};
+         auto const smoothGain{m_smoothGain,};
+         auto const smoothLoss{m_smoothLoss,};
+         for (size_t valueIndex{0,}; valueIndex < inValues.size(); ++valueIndex)
+         {
+            auto const delta{inValues[valueIndex] - value,};
+            outValues[valueIndex] = smooth_to_relative_strength_index(
+               smoothGain + (std::max(delta, 0.0) - smoothGain) * reciprocal_period,
+               smoothLoss + (std::max(-delta, 0.0) - smoothLoss) * reciprocal_period
+            );
+         }
+         return;
+      }
+      if (lookback_period == inSequenceNumber) [[unlikely]]
+      {
+         std::ranges::transform(inValues, outValues.begin(), [this] (double const inValue) { return do_lookback_pick(inValue); });
+         return;
+      }
+      std::ranges::fill(outValues, std::numeric_limits<double>::signaling_NaN());
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = 0;
+#endif
+      m_smoothGain = 0;
+      m_smoothLoss = 0;
+      m_value = std::numeric_limits<double>::signaling_NaN();
+      m_prevSmoothGain = 0;
+      m_prevSmoothLoss = 0;
+      m_prevValue = std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(fixed_period);
+      outWriter.write(m_smoothGain);
+      outWriter.write(m_smoothLoss);
+      outWriter.write(m_value);
+      outWriter.write(m_prevSmoothGain);
+      outWriter.write(m_prevSmoothLoss);
+      outWriter.write(m_prevValue);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, carried forward and zero volume bars
+   /// repeat the latest close and decay only bars add no change, so under every fill the missing bars neither gain nor lose
+   /// and the smoothed gain and loss decay by (1 - 1 / period) per bar, the missing bars cannot be amended
+   [[maybe_unused]] void skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+      m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+      assert(0 < inSequenceNumber);
+      assert(0 < inGap);
+      m_prevSmoothGain = std::numeric_limits<double>::signaling_NaN();
+      m_prevSmoothLoss = std::numeric_limits<double>::signaling_NaN();
+      auto smoothedNumber{inGap,};
+      if (lookback_period >= inSequenceNumber)
+      {
+         if (lookback_period >= (inSequenceNumber + inGap))
+         {
+            return;
+         }
+         /// The gap completes the seed averages
+         smoothedNumber = inSequenceNumber + inGap - 1 - lookback_period;
+         m_smoothGain *= reciprocal_period;
+         m_smoothLoss *= reciprocal_period;
+      }
+      auto const decay{std::pow(1.0 - reciprocal_period, static_cast<double>(smoothedNumber)),};
+      m_smoothGain *= decay;
+      m_smoothLoss *= decay;
+   }
+
+   /// Value whose pick yields the given relative strength index, NaN when out of reach,
+   /// an infinity when the level is only approached asymptotically (0 and 100 after a mixed history)
+   [[maybe_unused, nodiscard]] constexpr double solve(uint64_t const inSequenceNumber, double const inRelativeStrengthIndex) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert((0 <= inRelativeStrengthIndex) && (100 >= inRelativeStrengthIndex));
+      if (lookback_period < inSequenceNumber) [[likely]]
+      {
+         return solve_delta(m_smoothGain - m_smoothGain * reciprocal_period, m_smoothLoss - m_smoothLoss * reciprocal_period, inRelativeStrengthIndex);
+      }
+      if (lookback_period == inSequenceNumber) [[unlikely]]
+      {
+         return solve_delta(m_smoothGain * reciprocal_period, m_smoothLoss * reciprocal_period, inRelativeStrengthIndex);
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+private:
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber{0,};
+#endif
+   double m_smoothGain{0,};
+   double m_smoothLoss{0,};
+   double m_value{std::numeric_limits<double>::signaling_NaN(),};
+   /// The state preceding the latest calc, an amended calc starts over from it
+   double m_prevSmoothGain{0,};
+   double m_prevSmoothLoss{0,};
+   double m_prevValue{std::numeric_limits<double>::signaling_NaN(),};
+
+   [[nodiscard]] static constexpr double smooth_to_relative_strength_index(double const inSmoothGain, double const inSmoothLoss) noexcept
+   {
+      auto const smoothTotal{inSmoothGain + inSmoothLoss,};
+      /// A zero total has a zero gain, so dividing by one yields zero and keeps candidate loops branchless
+      return 100.0 * (inSmoothGain / (smoothTotal + static_cast<double>(0.0 == smoothTotal)));
+   }
+
+   [[nodiscard]] constexpr double do_lookback_calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      if (0 < inSequenceNumber) [[likely]]
+      {
+         auto const delta{inValue - m_value,};
+         if (0 < delta)
+         {
+            m_smoothGain += delta;
+         }
+         else
+         {
+            m_smoothLoss -= delta;
+         }
+      }
+      m_value = inValue;
+      if (lookback_period == inSequenceNumber) [[unlikely]]
+      {
+         m_smoothGain *= reciprocal_period;
+         m_smoothLoss *= reciprocal_period;
+         return smooth_to_relative_strength_index(m_smoothGain, m_smoothLoss);
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[nodiscard]] constexpr double do_lookback_pick(double const inValue) const noexcept
+   {
+      auto const delta{inValue - m_value,};
+      return (0 < delta)
+         ? smooth_to_relative_strength_index((m_smoothGain + delta) * reciprocal_period, m_smoothLoss * reciprocal_period)
+         : smooth_to_relative_strength_index(m_smoothGain * reciprocal_period, (m_smoothLoss - delta) * reciprocal_period)
+      ;
+   }
+
+   [[nodiscard]] constexpr double do_regular_calc(double const inValue) noexcept
+   {
+      auto const delta{inValue - m_value,};
+      m_smoothGain += ((0 < delta) ? (delta - m_smoothGain) : -m_smoothGain) * reciprocal_period;
+      m_smoothLoss += ((0 < delta) ? -m_smoothLoss : (-delta - m_smoothLoss)) * reciprocal_period;
+      m_value = inValue;
+      return smooth_to_relative_strength_index(m_smoothGain, m_smoothLoss);
+   }
+
+   [[nodiscard]] constexpr double do_regular_pick(double const inValue) const noexcept
+   {
+      auto const delta{inValue - m_value,};
+      return smooth_to_relative_strength_index(
+         m_smoothGain + ((0 < delta) ? (delta - m_smoothGain) : -m_smoothGain) * reciprocal_period,
+         m_smoothLoss + ((0 < delta) ? -m_smoothLoss : (-delta - m_smoothLoss)) * reciprocal_period
+      );
+   }
+
+   /// The smoothed gain and loss of the next pick are the given baselines plus the positive or negative move weighted by the reciprocal period,
+   /// so the move follows from ratio = gain / (gain + loss)
+   [[nodiscard]] constexpr double solve_delta(double const inBaseGain, double const inBaseLoss, double const inRelativeStrengthIndex) const noexcept
+   {
+      auto const ratio{inRelativeStrengthIndex / 100.0,};
+      auto const excess{ratio * (inBaseGain + inBaseLoss) - inBaseGain,};
+      if (0 < excess)
+      {
+         return m_value + excess / ((1.0 - ratio) * reciprocal_period);
+      }
+      if (0 > excess)
+      {
+         return m_value + excess / (ratio * reciprocal_period);
+      }
+      /// A flat history only yields zero
+      return ((0 == (inBaseGain + inBaseLoss)) && (0 < ratio)) ? std::numeric_limits<double>::signaling_NaN() : m_value;
+   }
+};
+
+template<>
+class [[maybe_unused]] relative_strength_index<static_cast<uint32_t>(-1)> final
+{
+public:
+   /// The state is a handful of scalars, so a copy evaluates any number of hypothetical values without allocating
+   using lookahead_type = relative_strength_index;
+
    relative_strength_index() = delete;
-   relative_strength_index(relative_strength_index &&) = delete;
-   relative_strength_index(relative_strength_index const &) = delete;
+   [[maybe_unused, nodiscard]] relative_strength_index(relative_strength_index &&) noexcept = default;
+   [[maybe_unused, nodiscard]] relative_strength_index(relative_strength_index const &) = default;
    [[nodiscard]] explicit relative_strength_index(uint32_t inPeriod) noexcept;
 
-   relative_strength_index &operator = (relative_strength_index &&) = delete;
-   relative_strength_index &operator = (relative_strength_index const &) = delete;
+   [[maybe_unused]] relative_strength_index &operator = (relative_strength_index &&) noexcept = default;
+   [[maybe_unused]] relative_strength_index &operator = (relative_strength_index const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inValue) noexcept;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue) noexcept;
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return *this;
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_period;
@@ -55,16 +385,32 @@ public:
 
    [[nodiscard]] double pick(uint64_t inSequenceNumber, double inValue) const noexcept;
 
+   void pick_many(uint64_t inSequenceNumber, std::span<double const> inValues, std::span<double> outValues) const noexcept;
+
    void reset() noexcept;
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in closed form, carried forward and zero volume bars
+   /// repeat the latest close and decay only bars add no change, so under every fill the smoothed gain and loss decay by (1 - 1 / period)
+   /// per bar, the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
+   /// Value whose pick yields the given relative strength index, NaN when out of reach,
+   /// an infinity when the level is only approached asymptotically (0 and 100 after a mixed history)
+   [[nodiscard]] double solve(uint64_t inSequenceNumber, double inRelativeStrengthIndex) const noexcept;
+
 private:
-   uint32_t const m_period;
+   uint32_t m_period;
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
 #endif
    double m_smoothGain;
    double m_smoothLoss;
    double m_value;
+   double m_prevSmoothGain;
+   double m_prevSmoothLoss;
+   double m_prevValue;
 
    [[nodiscard]] double do_lookback_calc(uint64_t inSequenceNumber, double inValue) noexcept;
 
@@ -73,6 +419,8 @@ private:
    [[nodiscard]] double do_regular_calc(double inValue) noexcept;
 
    [[nodiscard]] double do_regular_pick(double inValue) const noexcept;
+
+   [[nodiscard]] double solve_delta(double inBaseGain, double inBaseLoss, double inRelativeStrengthIndex) const noexcept;
 };
 
 }
@@ -0,0 +1,406 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+
+#include <algorithm> /// for std::ranges::fill
+#include <array> /// for std::array
+#include <cassert> /// for assert
+#include <cstddef> /// for size_t
+#include <cstdint> /// for uint32_t
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <span> /// for std::span
+#include <utility> /// for std::exchange, std::move
+#include <vector> /// for std::pmr::vector
+
+namespace tean
+{
+
+/// Ring contents in chronological order, the older segment starts at the cursor and the newer one ends right before it
+template<typename value_type>
+struct [[maybe_unused, nodiscard]] window_view final
+{
+   [[maybe_unused]] std::span<value_type const> older{};
+   [[maybe_unused]] std::span<value_type const> newer{};
+
+   [[maybe_unused, nodiscard]] constexpr size_t size() const noexcept
+   {
+      return older.size() + newer.size();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr value_type const &operator [] (size_t const inIndex) const noexcept
+   {
+      assert(size() > inIndex);
+      return (older.size() > inIndex) ? older[inIndex] : newer[inIndex - older.size()];
+   }
+};
+
+/// Fixed capacity ring with a wrapping cursor, the cursor points to the oldest slot which is overwritten next
+template<typename value_type, uint32_t capacity = static_cast<uint32_t>(-1), uint32_t inline_capacity = 0>
+class ring_buffer;
+
+template<typename value_type, uint32_t capacity, uint32_t inline_capacity>
+class [[maybe_unused]] ring_buffer final
+{
+   static_assert(0 < capacity);
+   static_assert(0 == inline_capacity);
+
+public:
+   [[maybe_unused, nodiscard]] constexpr ring_buffer() noexcept = default;
+   [[maybe_unused, nodiscard]] constexpr ring_buffer(ring_buffer &&) noexcept = default;
+   [[maybe_unused, nodiscard]] constexpr ring_buffer(ring_buffer const &) noexcept = default;
+
+   [[maybe_unused]] constexpr ring_buffer &operator = (ring_buffer &&) noexcept = default;
+   [[maybe_unused]] constexpr ring_buffer &operator = (ring_buffer const &) noexcept = default;
+
+   [[maybe_unused, nodiscard]] constexpr value_type &operator [] (uint32_t const inIndex) noexcept
+   {
+      assert(capacity > inIndex);
+      return m_values[inIndex];
+   }
+
+   [[maybe_unused, nodiscard]] constexpr value_type const &operator [] (uint32_t const inIndex) const noexcept
+   {
+      assert(capacity > inIndex);
+      return m_values[inIndex];
+   }
+
+   [[maybe_unused]] constexpr void advance() noexcept
+   {
+      m_cursor = wrap(m_cursor + 1);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t cursor() const noexcept
+   {
+      return m_cursor;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr value_type exchange(value_type const inValue) noexcept
+   {
+      auto const prevValue{m_values[m_cursor],};
+      m_values[m_cursor] = inValue;
+      advance();
+      return prevValue;
+   }
+
+   [[maybe_unused, nodiscard]] bool load(state_reader &inReader) noexcept
+   {
+      if ((false == inReader.expect(capacity)) || (false == inReader.read(m_cursor)))
+      {
+         return false;
+      }
+      if (capacity <= m_cursor)
+      {
+         m_cursor = 0;
+         return inReader.fail();
+      }
+      return inReader.read_values(std::span<value_type>{m_values,});
+   }
+
+   /// The slot written last, the one right before the cursor
+   [[maybe_unused, nodiscard]] constexpr value_type &newest() noexcept
+   {
+      return m_values[wrap(m_cursor + capacity - 1)];
+   }
+
+   [[maybe_unused, nodiscard]] constexpr value_type const &newest() const noexcept
+   {
+      return m_values[wrap(m_cursor + capacity - 1)];
+   }
+
+   [[maybe_unused, nodiscard]] constexpr value_type &oldest() noexcept
+   {
+      return m_values[m_cursor];
+   }
+
+   [[maybe_unused, nodiscard]] constexpr value_type const &oldest() const noexcept
+   {
+      return m_values[m_cursor];
+   }
+
+   [[maybe_unused]] constexpr void push(value_type const inValue) noexcept
+   {
+      m_values[m_cursor] = inValue;
+      advance();
+   }
+
+   [[maybe_unused]] constexpr void reset(value_type const inValue) noexcept
+   {
+      std::ranges::fill(m_values, inValue);
+      m_cursor = 0;
+   }
+
+   /// Capacity, cursor and values, a fixed and a runtime ring of the same capacity share the layout
+   [[maybe_unused]] void save(state_writer &outWriter) const
+   {
+      outWriter.write(capacity);
+      outWriter.write(m_cursor);
+      outWriter.write_values(std::span<value_type const>{m_values,});
+   }
+
+   [[maybe_unused]] constexpr void seek(uint32_t const inCursor) noexcept
+   {
+      assert(capacity > inCursor);
+      m_cursor = inCursor;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t size() const noexcept
+   {
+      return capacity;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr std::span<value_type const, capacity> values() const noexcept
+   {
+      return std::span<value_type const, capacity>{m_values,};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<value_type> window() const noexcept
+   {
+      auto const values{std::span<value_type const>{m_values,},};
+      return window_view<value_type>
+      {
+         .older = values.subspan(m_cursor),
+         .newer = values.first(m_cursor),
+      };
+   }
+
+   [[maybe_unused, nodiscard]] static constexpr uint32_t wrap(uint32_t const inIndex) noexcept
+   {
+      assert((2 * capacity) > inIndex);
+      if constexpr (0 == (capacity & (capacity - 1)))
+      {
+         return inIndex & (capacity - 1);
+      }
+      else
+      {
+         return (capacity > inIndex) ? inIndex : (inIndex - capacity);
+      }
+   }
+
+private:
+   std::array<value_type, capacity> m_values{};
+   uint32_t m_cursor{0,};
+};
+
+/// Runtime capacity ring, capacities up to inline_capacity are kept inside the object and larger ones on the heap
+template<typename value_type, uint32_t inline_capacity>
+class [[maybe_unused]] ring_buffer<value_type, static_cast<uint32_t>(-1), inline_capacity> final
+{
+public:
+   ring_buffer() = delete;
+
+   /// Leaves the source empty, it may only be assigned to or destroyed afterwards
+   [[maybe_unused, nodiscard]] ring_buffer(ring_buffer &&inOther) noexcept :
+      m_capacity{std::exchange(inOther.m_capacity, 0),},
+      m_cursor{std::exchange(inOther.m_cursor, 0),},
+      m_inlineValues{inOther.m_inlineValues,},
+      m_heapValues{std::move(inOther.m_heapValues),}
+   {
+      m_values = storage();
+      inOther.m_values = inOther.storage();
+   }
+
+   /// Copies allocate from the default memory resource, as std::pmr containers do
+   [[maybe_unused, nodiscard]] ring_buffer(ring_buffer const &inOther) :
+      m_capacity{inOther.m_capacity,},
+      m_cursor{inOther.m_cursor,},
+      m_inlineValues{inOther.m_inlineValues,},
+      m_heapValues{inOther.m_heapValues,}
+   {
+      m_values = storage();
+   }
+
+   [[maybe_unused, nodiscard]] explicit ring_buffer(uint32_t const inCapacity, std::pmr::memory_resource *const inMemoryResource = std::pmr::get_default_resource()) :
+      m_capacity{inCapacity,},
+      m_heapValues((inline_capacity < inCapacity) ? inCapacity : 0, inMemoryResource)
+   {
+      assert(0 < size());
+      m_values = storage();
+   }
+
+   /// Heap storage of the same memory resource is taken over, the one of another memory resource is copied element-wise
+   /// into the storage of this ring, which reuses it and only allocates when this ring is smaller than the source one
+   [[maybe_unused]] ring_buffer &operator = (ring_buffer &&inOther) noexcept
+   {
+      m_capacity = std::exchange(inOther.m_capacity, 0);
+      m_cursor = std::exchange(inOther.m_cursor, 0);
+      m_inlineValues = inOther.m_inlineValues;
+      if (m_heapValues.get_allocator() == inOther.m_heapValues.get_allocator()) [[likely]]
+      {
+         m_heapValues = std::move(inOther.m_heapValues);
+      }
+      else
+      {
+         m_heapValues.assign(inOther.m_heapValues.begin(), inOther.m_heapValues.end());
+         inOther.m_heapValues.clear();
+      }
+      m_values = storage();
+      inOther.m_values = inOther.storage();
+      return *this;
+   }
+
+   [[maybe_unused]] ring_buffer &operator = (ring_buffer const &inOther)
+   {
+      m_capacity = inOther.m_capacity;
+      m_cursor = inOther.m_cursor;
+      m_inlineValues = inOther.m_inlineValues;
+      m_heapValues = inOther.m_heapValues;
+      m_values = storage();
+      return *this;
+   }
+
+   [[maybe_unused, nodiscard]] value_type &operator [] (uint32_t const inIndex) noexcept
+   {
+      assert(size() > inIndex);
+      return m_values[inIndex];
+   }
+
+   [[maybe_unused, nodiscard]] value_type const &operator [] (uint32_t const inIndex) const noexcept
+   {
+      assert(size() > inIndex);
+      return m_values[inIndex];
+   }
+
+   [[maybe_unused]] void advance() noexcept
+   {
+      m_cursor = wrap(m_cursor + 1);
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t cursor() const noexcept
+   {
+      return m_cursor;
+   }
+
+   [[maybe_unused, nodiscard]] value_type exchange(value_type const inValue) noexcept
+   {
+      auto const prevValue{m_values[m_cursor],};
+      m_values[m_cursor] = inValue;
+      advance();
+      return prevValue;
+   }
+
+   [[maybe_unused, nodiscard]] bool load(state_reader &inReader) noexcept
+   {
+      if ((false == inReader.expect(size())) || (false == inReader.read(m_cursor)))
+      {
+         return false;
+      }
+      if (size() <= m_cursor)
+      {
+         m_cursor = 0;
+         return inReader.fail();
+      }
+      return inReader.read_values(std::span<value_type>{m_values, size(),});
+   }
+
+   [[maybe_unused, nodiscard]] value_type &newest() noexcept
+   {
+      return m_values[wrap(m_cursor + size() - 1)];
+   }
+
+   [[maybe_unused, nodiscard]] value_type const &newest() const noexcept
+   {
+      return m_values[wrap(m_cursor + size() - 1)];
+   }
+
+   [[maybe_unused, nodiscard]] value_type &oldest() noexcept
+   {
+      return m_values[m_cursor];
+   }
+
+   [[maybe_unused, nodiscard]] value_type const &oldest() const noexcept
+   {
+      return m_values[m_cursor];
+   }
+
+   [[maybe_unused]] void push(value_type const inValue) noexcept
+   {
+      m_values[m_cursor] = inValue;
+      advance();
+   }
+
+   [[maybe_unused]] void reset(value_type const inValue) noexcept
+   {
+      std::ranges::fill(std::span{m_values, size(),}, inValue);
+      m_cursor = 0;
+   }
+
+   [[maybe_unused]] void save(state_writer &outWriter) const
+   {
+      outWriter.write(size());
+      outWriter.write(m_cursor);
+      outWriter.write_values(values());
+   }
+
+   [[maybe_unused]] void seek(uint32_t const inCursor) noexcept
+   {
+      assert(size() > inCursor);
+      m_cursor = inCursor;
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t size() const noexcept
+   {
+      return m_capacity;
+   }
+
+   [[maybe_unused, nodiscard]] std::span<value_type const> values() const noexcept
+   {
+      return std::span<value_type const>{m_values, size(),};
+   }
+
+   [[maybe_unused, nodiscard]] window_view<value_type> window() const noexcept
+   {
+      auto const values{this->values(),};
+      return window_view<value_type>
+      {
+         .older = values.subspan(m_cursor),
+         .newer = values.first(m_cursor),
+      };
+   }
+
+   /// Unlike the fixed ring there is no mask path: the compare and subtract below compiles to a conditional move,
+   /// while a power of two mask known only at runtime would need a stored mask and a branch to pick it
+   [[maybe_unused, nodiscard]] uint32_t wrap(uint32_t const inIndex) const noexcept
+   {
+      assert((2 * size()) > inIndex);
+      return (size() > inIndex) ? inIndex : (inIndex - size());
+   }
+
+private:
+   value_type *m_values{nullptr,};
+   uint32_t m_capacity;
+   uint32_t m_cursor{0,};
+   std::array<value_type, inline_capacity> m_inlineValues{};
+   std::pmr::vector<value_type> m_heapValues;
+
+   [[nodiscard]] value_type *storage() noexcept
+   {
+      return (inline_capacity < m_capacity) ? m_heapValues.data() : m_inlineValues.data();
+   }
+};
+
+}
@@ -25,26 +25,213 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::window_view
 #include "tean/sum_over_period.hpp" /// for tean::sum_over_period
 
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan
 #include <cstdint> /// for uint32_t, uint64_t
+#include <limits> /// for std::numeric_limits
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
 
 namespace tean
 {
 
-class [[nodiscard]] simple_moving_average final
+template<uint32_t period = static_cast<uint32_t>(-1)>
+class simple_moving_average;
+
+template<uint32_t period>
+class [[maybe_unused]] simple_moving_average final
 {
+   static_assert(1 < period);
+
+   static constexpr inline auto reciprocal_period{1.0 / period,};
+
 public:
+   static constexpr inline auto lookback_period{sum_over_period<period>::lookback_period,};
+
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(simple_moving_average const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_sumOverPeriod{inIndicator.m_sumOverPeriod.lookahead(),}
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         return m_indicator->sum_over_period_to_average(inSequenceNumber, m_sumOverPeriod.calc(inSequenceNumber, inValue));
+      }
+
+   private:
+      simple_moving_average const *m_indicator;
+      typename sum_over_period<period>::lookahead_type m_sumOverPeriod;
+   };
+
+   [[maybe_unused, nodiscard]] constexpr simple_moving_average() noexcept = default;
+   [[maybe_unused, nodiscard]] simple_moving_average(simple_moving_average &&) noexcept = default;
+   [[maybe_unused, nodiscard]] simple_moving_average(simple_moving_average const &) = default;
+
+   [[maybe_unused]] simple_moving_average &operator = (simple_moving_average &&) noexcept = default;
+   [[maybe_unused]] simple_moving_average &operator = (simple_moving_average const &) = default;
+
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return sum_over_period_to_average(inSequenceNumber, m_sumOverPeriod.amend(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue, double &outSumOverPeriod) noexcept
+   {
+      outSumOverPeriod = m_sumOverPeriod.amend(inSequenceNumber, inValue);
+      return sum_over_period_to_average(inSequenceNumber, outSumOverPeriod);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return sum_over_period_to_average(inSequenceNumber, m_sumOverPeriod.calc(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue, double &outSumOverPeriod) noexcept
+   {
+      outSumOverPeriod = m_sumOverPeriod.calc(inSequenceNumber, inValue);
+      return sum_over_period_to_average(inSequenceNumber, outSumOverPeriod);
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return m_sumOverPeriod.load(inSequenceNumber, inReader);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+      return sum_over_period_to_average(inSequenceNumber, m_sumOverPeriod.pick(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue, double &outSumOverPeriod) const noexcept
+   {
+      outSumOverPeriod = m_sumOverPeriod.pick(inSequenceNumber, inValue);
+      return sum_over_period_to_average(inSequenceNumber, outSumOverPeriod);
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+      m_sumOverPeriod.reset();
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      m_sumOverPeriod.save(inSequenceNumber, outWriter);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)),
+   /// carried forward and zero volume bars repeat the latest value, decay only bars would put zero prices into the window and are rejected
+   [[maybe_unused]] constexpr void skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+   {
+      assert(0 < inSequenceNumber);
+      assert(gap_fill::decay_only != inFill);
+      auto const window{m_sumOverPeriod.window(),};
+      m_sumOverPeriod.skip(inSequenceNumber, inGap, window[window.size() - 1]);
+   }
+
+   /// Value whose pick yields the given average
+   [[maybe_unused, nodiscard]] constexpr double solve(uint64_t const inSequenceNumber, double const inAverage) const noexcept
+   {
+      assert(true == std::isfinite(inAverage));
+      assert(false == std::isnan(inAverage));
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         return m_sumOverPeriod.solve(inSequenceNumber, inAverage * period);
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_sumOverPeriod.window();
+   }
+
+private:
+   sum_over_period<period> m_sumOverPeriod{};
+
+   [[maybe_unused, nodiscard]] constexpr double sum_over_period_to_average(uint64_t const inSequenceNumber, double const inSumOverPeriod) const noexcept
+   {
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         assert(true == std::isfinite(inSumOverPeriod));
+         assert(false == std::isnan(inSumOverPeriod));
+         return inSumOverPeriod * reciprocal_period;
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+};
+
+template<>
+class [[maybe_unused]] simple_moving_average<static_cast<uint32_t>(-1)> final
+{
+public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit lookahead_type(simple_moving_average const &inIndicator) noexcept :
+         m_indicator(std::addressof(inIndicator)),
+         m_sumOverPeriod(inIndicator.m_sumOverPeriod.lookahead())
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         return m_indicator->do_pick(inSequenceNumber, m_sumOverPeriod.calc(inSequenceNumber, inValue));
+      }
+
+   private:
+      simple_moving_average const *m_indicator;
+      sum_over_period<>::lookahead_type m_sumOverPeriod;
+   };
+
    simple_moving_average() = delete;
-   simple_moving_average(simple_moving_average &&) = delete;
-   simple_moving_average(simple_moving_average const &) = delete;
+   [[maybe_unused, nodiscard]] simple_moving_average(simple_moving_average &&) noexcept = default;
+   [[maybe_unused, nodiscard]] simple_moving_average(simple_moving_average const &) = default;
 
-   [[maybe_unused, nodiscard]] explicit simple_moving_average(uint32_t const inPeriod) :
-      m_sumOverPeriod(inPeriod)
+   [[maybe_unused, nodiscard]] explicit simple_moving_average(uint32_t const inPeriod, std::pmr::memory_resource *const inMemoryResource = std::pmr::get_default_resource()) :
+      m_sumOverPeriod(inPeriod, 0, inMemoryResource)
    {}
 
-   simple_moving_average &operator = (simple_moving_average &&) = delete;
-   simple_moving_average &operator = (simple_moving_average const &) = delete;
+   [[maybe_unused]] simple_moving_average &operator = (simple_moving_average &&) noexcept = default;
+   [[maybe_unused]] simple_moving_average &operator = (simple_moving_average const &) = default;
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return do_calc(inSequenceNumber, m_sumOverPeriod.amend(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inValue, double &outSumOverPeriod) noexcept
+   {
+      outSumOverPeriod = m_sumOverPeriod.amend(inSequenceNumber, inValue);
+      return do_calc(inSequenceNumber, outSumOverPeriod);
+   }
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
@@ -57,6 +244,16 @@ public:
       return do_calc(inSequenceNumber, outSumOverPeriod);
    }
 
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return m_sumOverPeriod.load(inSequenceNumber, inReader);
+   }
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_sumOverPeriod.lookback_period();
@@ -83,8 +280,40 @@ public:
       m_sumOverPeriod.reset();
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      m_sumOverPeriod.save(inSequenceNumber, outWriter);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)),
+   /// carried forward and zero volume bars repeat the latest value, decay only bars would put zero prices into the window and are rejected
+   [[maybe_unused]] void skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+   {
+      assert(0 < inSequenceNumber);
+      assert(gap_fill::decay_only != inFill);
+      auto const window{m_sumOverPeriod.window(),};
+      m_sumOverPeriod.skip(inSequenceNumber, inGap, window[window.size() - 1]);
+   }
+
+   /// Value whose pick yields the given average
+   [[maybe_unused, nodiscard]] double solve(uint64_t const inSequenceNumber, double const inAverage) const noexcept
+   {
+      assert(true == std::isfinite(inAverage));
+      assert(false == std::isnan(inAverage));
+      if (lookback_period() <= inSequenceNumber) [[likely]]
+      {
+         return m_sumOverPeriod.solve(inSequenceNumber, inAverage * static_cast<double>(period()));
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_sumOverPeriod.window();
+   }
+
 private:
-   sum_over_period m_sumOverPeriod;
+   sum_over_period<> m_sumOverPeriod;
 
    [[nodiscard]] double do_calc(uint64_t inSequenceNumber, double inSumOverPeriod) noexcept;
 
@@ -25,12 +25,18 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::window_view
 #include "tean/variance.hpp" /// for tean::variance
 
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::sqrt
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <span> /// for std::span
 
 namespace tean
 {
@@ -44,12 +50,53 @@ class [[maybe_unused]] standard_deviation final
 public:
    static constexpr inline auto lookback_period{variance<period>::lookback_period,};
 
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(standard_deviation const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_variance{inIndicator.m_variance.lookahead(),}
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         return m_indicator->variance_to_standard_deviation(inSequenceNumber, m_variance.calc(inSequenceNumber, inValue));
+      }
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+      {
+         return m_indicator->variance_to_standard_deviation(inSequenceNumber, m_variance.calc(inSequenceNumber, inValue, outMean));
+      }
+
+   private:
+      standard_deviation const *m_indicator;
+      typename variance<period>::lookahead_type m_variance;
+   };
+
    [[maybe_unused, nodiscard]] constexpr standard_deviation() noexcept = default;
-   standard_deviation(standard_deviation &&) = delete;
-   standard_deviation(standard_deviation const &) = delete;
+   [[maybe_unused, nodiscard]] standard_deviation(standard_deviation &&) noexcept = default;
+   [[maybe_unused, nodiscard]] standard_deviation(standard_deviation const &) = default;
 
-   standard_deviation &operator = (standard_deviation &&) = delete;
-   standard_deviation &operator = (standard_deviation const &) = delete;
+   [[maybe_unused]] standard_deviation &operator = (standard_deviation &&) noexcept = default;
+   [[maybe_unused]] standard_deviation &operator = (standard_deviation const &) = default;
+
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return variance_to_standard_deviation(inSequenceNumber, m_variance.amend(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+   {
+      return variance_to_standard_deviation(inSequenceNumber, m_variance.amend(inSequenceNumber, inValue, outMean));
+   }
 
    [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
@@ -61,6 +108,16 @@ public:
       return variance_to_standard_deviation(inSequenceNumber, m_variance.calc(inSequenceNumber, inValue, outMean));
    }
 
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return m_variance.load(inSequenceNumber, inReader);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
    {
       return variance_to_standard_deviation(inSequenceNumber, m_variance.pick(inSequenceNumber, inValue));
@@ -71,11 +128,51 @@ public:
       return variance_to_standard_deviation(inSequenceNumber, m_variance.pick(inSequenceNumber, inValue, outMean));
    }
 
+   [[maybe_unused]] constexpr void pick_many(
+      uint64_t const inSequenceNumber,
+      std::span<double const> const inValues,
+      std::span<double> const outValues,
+      std::span<double> const outMeans
+   ) const noexcept
+   {
+      m_variance.pick_many(inSequenceNumber, inValues, outValues, outMeans);
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         for (auto &value : outValues)
+         {
+            assert(true == std::isfinite(value));
+            value = (0 >= value) ? 0.0 : std::sqrt(value);
+         }
+      }
+   }
+
    [[maybe_unused]] constexpr void reset() noexcept
    {
       m_variance.reset();
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      m_variance.save(inSequenceNumber, outWriter);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number, see variance::skip
+   [[maybe_unused]] constexpr void skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+   {
+      m_variance.skip(inSequenceNumber, inGap, inFill);
+   }
+
+   /// Value whose z-score within the window it completes equals the given one, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] constexpr double solve_z_score(uint64_t const inSequenceNumber, double const inZScore) const noexcept
+   {
+      return m_variance.solve_z_score(inSequenceNumber, inZScore);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_variance.window();
+   }
+
 private:
    variance<period> m_variance{};
 
@@ -95,16 +192,57 @@ template<>
 class [[maybe_unused]] standard_deviation<static_cast<uint32_t>(-1)> final
 {
 public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit lookahead_type(standard_deviation const &inIndicator) noexcept :
+         m_indicator(std::addressof(inIndicator)),
+         m_variance(inIndicator.m_variance.lookahead())
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         return m_indicator->variance_to_standard_deviation(inSequenceNumber, m_variance.calc(inSequenceNumber, inValue));
+      }
+
+      [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+      {
+         return m_indicator->variance_to_standard_deviation(inSequenceNumber, m_variance.calc(inSequenceNumber, inValue, outMean));
+      }
+
+   private:
+      standard_deviation const *m_indicator;
+      variance<>::lookahead_type m_variance;
+   };
+
    standard_deviation() = delete;
-   standard_deviation(standard_deviation &&) = delete;
-   standard_deviation(standard_deviation const &) = delete;
+   [[maybe_unused, nodiscard]] standard_deviation(standard_deviation &&) noexcept = default;
+   [[maybe_unused, nodiscard]] standard_deviation(standard_deviation const &) = default;
 
-   [[maybe_unused, nodiscard]] explicit standard_deviation(uint32_t const inPeriod) noexcept :
-      m_variance(inPeriod)
+   [[maybe_unused, nodiscard]] explicit standard_deviation(uint32_t const inPeriod, std::pmr::memory_resource *const inMemoryResource = std::pmr::get_default_resource()) noexcept :
+      m_variance(inPeriod, 0, inMemoryResource)
    {}
 
-   standard_deviation &operator = (standard_deviation &&) = delete;
-   standard_deviation &operator = (standard_deviation const &) = delete;
+   [[maybe_unused]] standard_deviation &operator = (standard_deviation &&) noexcept = default;
+   [[maybe_unused]] standard_deviation &operator = (standard_deviation const &) = default;
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      return variance_to_standard_deviation(inSequenceNumber, m_variance.amend(inSequenceNumber, inValue));
+   }
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+   {
+      return variance_to_standard_deviation(inSequenceNumber, m_variance.amend(inSequenceNumber, inValue, outMean));
+   }
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
@@ -116,6 +254,16 @@ public:
       return variance_to_standard_deviation(inSequenceNumber, m_variance.calc(inSequenceNumber, inValue, outMean));
    }
 
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return m_variance.load(inSequenceNumber, inReader);
+   }
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_variance.lookback_period();
@@ -136,11 +284,51 @@ public:
       return variance_to_standard_deviation(inSequenceNumber, m_variance.pick(inSequenceNumber, inValue, outMean));
    }
 
+   [[maybe_unused]] void pick_many(
+      uint64_t const inSequenceNumber,
+      std::span<double const> const inValues,
+      std::span<double> const outValues,
+      std::span<double> const outMeans
+   ) const noexcept
+   {
+      m_variance.pick_many(inSequenceNumber, inValues, outValues, outMeans);
+      if (lookback_period() <= inSequenceNumber) [[likely]]
+      {
+         for (auto &value : outValues)
+         {
+            assert(true == std::isfinite(value));
+            value = (0 >= value) ? 0.0 : std::sqrt(value);
+         }
+      }
+   }
+
    [[maybe_unused]] void reset() noexcept
    {
       m_variance.reset();
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      m_variance.save(inSequenceNumber, outWriter);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number, see variance::skip
+   [[maybe_unused]] void skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+   {
+      m_variance.skip(inSequenceNumber, inGap, inFill);
+   }
+
+   /// Value whose z-score within the window it completes equals the given one, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] double solve_z_score(uint64_t const inSequenceNumber, double const inZScore) const noexcept
+   {
+      return m_variance.solve_z_score(inSequenceNumber, inZScore);
+   }
+
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_variance.window();
+   }
+
 private:
    variance<> m_variance;
 
@@ -25,25 +25,352 @@
 
 #pragma once
 
+#include "tean/compensated_sum.hpp" /// for tean::compensated_add
+#include "tean/ring_buffer.hpp" /// for tean::ring_buffer, tean::window_view
+
+#include <algorithm> /// for std::min
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan
 #include <cstdint> /// for uint32_t, uint64_t
-#include <memory> /// for std::unique_ptr
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <utility> /// for std::exchange
 
 namespace tean
 {
 
-class [[nodiscard]] sum_over_period final
+template<uint32_t period = static_cast<uint32_t>(-1), uint32_t inline_capacity = 0>
+class sum_over_period;
+
+template<uint32_t period, uint32_t inline_capacity>
+class [[maybe_unused]] sum_over_period final
 {
+   static_assert(1 < period);
+   static_assert(0 == inline_capacity);
+
 public:
+   static constexpr inline auto lookback_period{period - 1,};
+
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(sum_over_period const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_sum{inIndicator.m_sum,},
+         m_sumCompensation{inIndicator.m_sumCompensation,}
+#if (not defined(NDEBUG))
+         , m_prevSequenceNumber{inIndicator.m_prevSequenceNumber,}
+#endif
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr double calc([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+#if (not defined(NDEBUG))
+         assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         assert(true == std::isfinite(inValue));
+         assert(false == std::isnan(inValue));
+         assert(period > m_valuesNumber);
+         /// The j-th hypothetical value evicts the j-th oldest committed one
+         auto const &values{m_indicator->m_values,};
+         auto const prevValue{values[values.wrap(values.cursor() + m_valuesNumber)],};
+         ++m_valuesNumber;
+         if (0 == m_indicator->m_resummationPeriod) [[likely]]
+         {
+            m_sum += inValue - prevValue;
+            return m_sum;
+         }
+         compensated_add(m_sum, m_sumCompensation, inValue);
+         compensated_add(m_sum, m_sumCompensation, -prevValue);
+         return m_sum + m_sumCompensation;
+      }
+
+   private:
+      sum_over_period const *m_indicator;
+      double m_sum;
+      double m_sumCompensation;
+      uint32_t m_valuesNumber{0,};
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+   };
+
+   [[maybe_unused, nodiscard]] constexpr sum_over_period() noexcept = default;
+
+   [[maybe_unused, nodiscard]] explicit constexpr sum_over_period(uint32_t const inResummationPeriod) noexcept :
+      m_resummationPeriod{inResummationPeriod,},
+      m_resummationCountdown{inResummationPeriod,}
+   {}
+
+   [[maybe_unused, nodiscard]] sum_over_period(sum_over_period &&) noexcept = default;
+   [[maybe_unused, nodiscard]] sum_over_period(sum_over_period const &) = default;
+
+   [[maybe_unused]] sum_over_period &operator = (sum_over_period &&) noexcept = default;
+   [[maybe_unused]] sum_over_period &operator = (sum_over_period const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] constexpr double amend([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      auto const prevValue{std::exchange(m_values.newest(), inValue),};
+      if (0 == m_resummationPeriod) [[likely]]
+      {
+         m_sum += inValue - prevValue;
+         return m_sum;
+      }
+      compensated_add(m_sum, m_sumCompensation, inValue);
+      compensated_add(m_sum, m_sumCompensation, -prevValue);
+      return m_sum + m_sumCompensation;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double calc([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      auto const prevValue{m_values.exchange(inValue),};
+      if (0 == m_resummationPeriod) [[likely]]
+      {
+         m_sum += inValue - prevValue;
+         return m_sum;
+      }
+      compensated_add(m_sum, m_sumCompensation, inValue);
+      compensated_add(m_sum, m_sumCompensation, -prevValue);
+      if (0 == --m_resummationCountdown) [[unlikely]]
+      {
+         do_resum();
+      }
+      return m_sum + m_sumCompensation;
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(m_resummationPeriod))
+         && (true == m_values.load(inReader))
+         && (true == inReader.read(m_resummationCountdown))
+         && (true == inReader.read(m_sum))
+         && (true == inReader.read(m_sumCompensation))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double pick([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      if (0 == m_resummationPeriod) [[likely]]
+      {
+         return inValue - m_values.oldest() + m_sum;
+      }
+      auto sum{m_sum,};
+      auto sumCompensation{m_sumCompensation,};
+      compensated_add(sum, sumCompensation, inValue);
+      compensated_add(sum, sumCompensation, -m_values.oldest());
+      return sum + sumCompensation;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t resummation_period() const noexcept
+   {
+      return m_resummationPeriod;
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+      m_values.reset(0.0);
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = 0;
+#endif
+      m_sum = 0;
+      m_sumCompensation = 0;
+      m_resummationCountdown = m_resummationPeriod;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(m_resummationPeriod);
+      m_values.save(outWriter);
+      outWriter.write(m_resummationCountdown);
+      outWriter.write(m_sum);
+      outWriter.write(m_sumCompensation);
+   }
+
+   /// Consumes the given value for every missing sequence number of a gap starting at the given one, once the gap covers
+   /// the period the window only holds copies of the value and the rest of the gap leaves the sum as is, so it costs O(min(gap, period))
+   [[maybe_unused]] constexpr void skip([[maybe_unused]] uint64_t const inSequenceNumber, uint64_t const inGap, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+      assert(0 < inGap);
+      assert(true == std::isfinite(inValue));
+      assert(false == std::isnan(inValue));
+      auto const valuesNumber{static_cast<uint32_t>(std::min<uint64_t>(inGap, period)),};
+      for (uint32_t valueIndex{0,}; valueIndex < valuesNumber; ++valueIndex)
+      {
+         auto const prevValue{m_values.exchange(inValue),};
+         if (0 == m_resummationPeriod) [[likely]]
+         {
+            m_sum += inValue - prevValue;
+            continue;
+         }
+         compensated_add(m_sum, m_sumCompensation, inValue);
+         compensated_add(m_sum, m_sumCompensation, -prevValue);
+         if (0 == --m_resummationCountdown) [[unlikely]]
+         {
+            do_resum();
+         }
+      }
+      if ((0 != m_resummationPeriod) && (inGap > valuesNumber))
+      {
+         /// The rest of the gap exchanges equal values, only the resummation schedule moves on
+         auto const restNumber{inGap - valuesNumber,};
+         if (m_resummationCountdown <= restNumber)
+         {
+            do_resum();
+         }
+         else
+         {
+            m_resummationCountdown -= static_cast<uint32_t>(restNumber);
+         }
+      }
+   }
+
+   /// Value whose pick yields the given sum
+   [[maybe_unused, nodiscard]] constexpr double solve([[maybe_unused]] uint64_t const inSequenceNumber, double const inSumOverPeriod) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inSumOverPeriod));
+      assert(false == std::isnan(inSumOverPeriod));
+      if (0 == m_resummationPeriod) [[likely]]
+      {
+         return inSumOverPeriod - m_sum + m_values.oldest();
+      }
+      auto sum{m_sum,};
+      auto sumCompensation{m_sumCompensation,};
+      compensated_add(sum, sumCompensation, -m_values.oldest());
+      return inSumOverPeriod - (sum + sumCompensation);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
+private:
+   ring_buffer<double, period> m_values{};
+   uint32_t m_resummationPeriod{0,};
+   uint32_t m_resummationCountdown{0,};
+   double m_sum{0,};
+   double m_sumCompensation{0,};
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber{0,};
+#endif
+
+   constexpr void do_resum() noexcept
+   {
+      m_sum = 0;
+      m_sumCompensation = 0;
+      for (auto const value : m_values.values())
+      {
+         compensated_add(m_sum, m_sumCompensation, value);
+      }
+      m_resummationCountdown = m_resummationPeriod;
+   }
+};
+
+/// Windows of up to inline_capacity values are kept inside the object, the library instantiates inline capacities 0, 8, 16, 32 and 64
+template<uint32_t inline_capacity>
+class [[maybe_unused]] sum_over_period<static_cast<uint32_t>(-1), inline_capacity> final
+{
+   static_assert(
+      (0 == inline_capacity) || (8 == inline_capacity) || (16 == inline_capacity) || (32 == inline_capacity) || (64 == inline_capacity),
+      "the runtime sum_over_period is only instantiated with inline capacities 0, 8, 16, 32 and 64"
+   );
+
+public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+      [[nodiscard]] explicit lookahead_type(sum_over_period const &inIndicator) noexcept;
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue) noexcept;
+
+   private:
+      sum_over_period const *m_indicator;
+      double m_sum;
+      double m_sumCompensation;
+      uint32_t m_valuesNumber;
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+   };
+
    sum_over_period() = delete;
-   sum_over_period(sum_over_period &&) = delete;
-   sum_over_period(sum_over_period const &) = delete;
-   [[nodiscard]] explicit sum_over_period(uint32_t inPeriod);
+   [[maybe_unused, nodiscard]] sum_over_period(sum_over_period &&) noexcept = default;
+   [[maybe_unused, nodiscard]] sum_over_period(sum_over_period const &) = default;
+   [[nodiscard]] explicit sum_over_period(uint32_t inPeriod, uint32_t inResummationPeriod = 0, std::pmr::memory_resource *inMemoryResource = std::pmr::get_default_resource());
+
+   [[maybe_unused]] sum_over_period &operator = (sum_over_period &&) noexcept = default;
+   [[maybe_unused]] sum_over_period &operator = (sum_over_period const &) = default;
 
-   sum_over_period &operator = (sum_over_period &&) = delete;
-   sum_over_period &operator = (sum_over_period const &) = delete;
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inValue) noexcept;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue) noexcept;
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -58,14 +385,42 @@ public:
 
    void reset() noexcept;
 
+   [[maybe_unused, nodiscard]] uint32_t resummation_period() const noexcept
+   {
+      return m_resummationPeriod;
+   }
+
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Consumes the given value for every missing sequence number of a gap starting at the given one in O(min(gap, period))
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, double inValue) noexcept;
+
+   [[nodiscard]] double solve(uint64_t inSequenceNumber, double inSumOverPeriod) const noexcept;
+
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
-   std::unique_ptr<double[]> const m_values;
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   uint32_t m_resummationPeriod;
+   ring_buffer<double, static_cast<uint32_t>(-1), inline_capacity> m_values;
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
 #endif
    double m_sum;
+   double m_sumCompensation;
+   uint32_t m_resummationCountdown;
+
+   void do_resum() noexcept;
 };
 
+extern template class sum_over_period<static_cast<uint32_t>(-1), 0>;
+extern template class sum_over_period<static_cast<uint32_t>(-1), 8>;
+extern template class sum_over_period<static_cast<uint32_t>(-1), 16>;
+extern template class sum_over_period<static_cast<uint32_t>(-1), 32>;
+extern template class sum_over_period<static_cast<uint32_t>(-1), 64>;
+
 }
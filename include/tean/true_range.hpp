@@ -25,6 +25,9 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+
 #include <cstdint> /// for uint32_t, uint64_t
 
 namespace tean
@@ -37,17 +40,24 @@ public:
 #if (not defined(NDEBUG))
       m_prevSequenceNumber(0),
 #endif
-      m_close(0.0)
+      m_close(0.0),
+      m_prevClose(0.0),
+      m_range(0.0)
    {}
 
-   true_range(true_range &&) = delete;
-   true_range(true_range const &) = delete;
+   [[maybe_unused, nodiscard]] true_range(true_range &&) noexcept = default;
+   [[maybe_unused, nodiscard]] true_range(true_range const &) = default;
+
+   [[maybe_unused]] true_range &operator = (true_range &&) noexcept = default;
+   [[maybe_unused]] true_range &operator = (true_range const &) = default;
 
-   true_range &operator = (true_range &&) = delete;
-   true_range &operator = (true_range const &) = delete;
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) noexcept;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) noexcept;
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
    [[maybe_unused, nodiscard]] static constexpr uint32_t lookback_period() noexcept
    {
       return 1;
@@ -61,13 +71,26 @@ public:
       m_prevSequenceNumber = 0;
 #endif
       m_close = 0.0;
+      m_prevClose = 0.0;
+      m_range = 0.0;
    }
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number and returns the true range of each of them:
+   /// carried forward bars repeat the latest bar, whose close lies within it, so their true range is its high - low,
+   /// zero volume bars are flat at the latest close and decay only bars add nothing, so theirs is zero, the missing bars cannot be amended
+   [[nodiscard]] double skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
 private:
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
 #endif
    double m_close;
+   /// The close preceding the latest calc, an amended calc starts over from it
+   double m_prevClose;
+   /// The high - low of the latest bar, which carried forward bars repeat
+   double m_range;
 
    [[nodiscard]] double do_pick(uint64_t inSequenceNumber, double inHigh, double inLow) const noexcept;
 };
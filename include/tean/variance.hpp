@@ -25,40 +25,162 @@
 
 #pragma once
 
-#include <algorithm> /// for std::ranges::fill
-#include <array> /// for std::array
+#include "tean/compensated_sum.hpp" /// for tean::compensated_add
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::ring_buffer, tean::window_view
+
+#include <algorithm> /// for std::min, std::ranges::all_of, std::ranges::fill
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite
+#include <cmath> /// for std::isfinite, std::sqrt
 #include <cstdint> /// for int32_t, uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <memory> /// for std::unique_ptr
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <span> /// for std::span
+#include <utility> /// for std::exchange
 
 namespace tean
 {
 
-template<uint32_t period = static_cast<uint32_t>(-1)>
+template<uint32_t period = static_cast<uint32_t>(-1), uint32_t inline_capacity = 0>
 class variance;
 
-template<uint32_t period>
+template<uint32_t period, uint32_t inline_capacity>
 class [[maybe_unused]] variance
 {
    static_assert(1 < period);
+   static_assert(0 == inline_capacity);
 
 public:
    static constexpr inline auto lookback_period{period - 1,};
 
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(variance const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_sum{inIndicator.m_sum,},
+         m_sumOfSquares{inIndicator.m_sumOfSquares,},
+         m_sumCompensation{inIndicator.m_sumCompensation,},
+         m_sumOfSquaresCompensation{inIndicator.m_sumOfSquaresCompensation,}
+#if (not defined(NDEBUG))
+         , m_prevSequenceNumber{inIndicator.m_prevSequenceNumber,}
+#endif
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         return calc(inSequenceNumber, inValue, mean);
+      }
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+      {
+#if (not defined(NDEBUG))
+         assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         assert(true == std::isfinite(inValue));
+         assert(period > m_valuesNumber);
+         /// A regular calc evicts the oldest value after it is done, so the eviction is deferred to the following value
+         if ((0 < m_valuesNumber) && (lookback_period < inSequenceNumber))
+         {
+            auto const &values{m_indicator->m_values,};
+            auto const prevValue{values[values.wrap(values.cursor() + m_valuesNumber - 1)],};
+            do_add(-prevValue, -prevValue * prevValue);
+         }
+         ++m_valuesNumber;
+         do_add(inValue, inValue * inValue);
+         if (lookback_period <= inSequenceNumber) [[likely]]
+         {
+            outMean = (m_sum + m_sumCompensation) / period;
+            auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation) / period,};
+            return meanOfSquares - outMean * outMean;
+         }
+         outMean = std::numeric_limits<double>::signaling_NaN();
+         return std::numeric_limits<double>::signaling_NaN();
+      }
+
+   private:
+      variance const *m_indicator;
+      double m_sum;
+      double m_sumOfSquares;
+      double m_sumCompensation;
+      double m_sumOfSquaresCompensation;
+      uint32_t m_valuesNumber{0,};
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+
+      constexpr void do_add(double const inValue, double const inSquare) noexcept
+      {
+         if (0 == m_indicator->m_resummationPeriod) [[likely]]
+         {
+            m_sum += inValue;
+            m_sumOfSquares += inSquare;
+         }
+         else
+         {
+            compensated_add(m_sum, m_sumCompensation, inValue);
+            compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, inSquare);
+         }
+      }
+   };
+
    [[maybe_unused, nodiscard]] constexpr variance() noexcept
    {
 #if (not defined(NDEBUG))
-      std::ranges::fill(m_values, std::numeric_limits<double>::signaling_NaN());
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
+#endif
+   }
+
+   [[maybe_unused, nodiscard]] explicit constexpr variance(uint32_t const inResummationPeriod) noexcept :
+      m_resummationPeriod{inResummationPeriod,},
+      m_resummationCountdown{inResummationPeriod,}
+   {
+#if (not defined(NDEBUG))
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
 #endif
    }
 
-   variance(variance &&) = delete;
-   variance(variance const &) = delete;
+   [[maybe_unused, nodiscard]] variance(variance &&) noexcept = default;
+   [[maybe_unused, nodiscard]] variance(variance const &) = default;
+
+   [[maybe_unused]] variance &operator = (variance &&) noexcept = default;
+   [[maybe_unused]] variance &operator = (variance const &) = default;
 
-   variance &operator = (variance &&) = delete;
-   variance &operator = (variance const &) = delete;
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      return amend(inSequenceNumber, inValue, mean);
+   }
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      assert(true == std::isfinite(inValue));
+      do_replace(std::exchange(m_values.newest(), inValue), inValue);
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         outMean = (m_sum + m_sumCompensation + m_evictedValue) / period;
+         auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation + m_evictedValue * m_evictedValue) / period,};
+         return meanOfSquares - outMean * outMean;
+      }
+      outMean = std::numeric_limits<double>::signaling_NaN();
+      return std::numeric_limits<double>::signaling_NaN();
+   }
 
    [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
@@ -75,13 +197,40 @@ public:
       assert(true == std::isfinite(inValue));
       if (lookback_period <= inSequenceNumber) [[likely]]
       {
-         return do_regular_calc(inSequenceNumber, inValue, outMean);
+         return do_regular_calc(inValue, outMean);
       }
-      do_lookback_calc(inSequenceNumber, inValue);
+      do_lookback_calc(inValue);
       outMean = std::numeric_limits<double>::signaling_NaN();
       return std::numeric_limits<double>::signaling_NaN();
    }
 
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(m_resummationPeriod))
+         && (true == m_values.load(inReader))
+         && (true == inReader.read(m_resummationCountdown))
+         && (true == inReader.read(m_sum))
+         && (true == inReader.read(m_sumOfSquares))
+         && (true == inReader.read(m_sumCompensation))
+         && (true == inReader.read(m_sumOfSquaresCompensation))
+         && (true == inReader.read(m_evictedValue))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
    {
       double mean{};
@@ -96,64 +245,303 @@ public:
       assert(true == std::isfinite(inValue));
       if (lookback_period <= inSequenceNumber) [[likely]]
       {
-         outMean = (m_sum + inValue) / period;
-         auto const meanOfSquares{(m_sumOfSquares + inValue * inValue) / period,};
+         outMean = (m_sum + m_sumCompensation + inValue) / period;
+         auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation + inValue * inValue) / period,};
          return meanOfSquares - outMean * outMean;
       }
       outMean = std::numeric_limits<double>::signaling_NaN();
       return std::numeric_limits<double>::signaling_NaN();
    }
 
+   /// Same as pick for every candidate value against the same committed state, the sums are loaded once
+   [[maybe_unused]] constexpr void pick_many(
+      uint64_t const inSequenceNumber,
+      std::span<double const> const inValues,
+      std::span<double> const outValues,
+      std::span<double> const outMeans
+   ) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(inValues.size() == outValues.size());
+      assert(inValues.size() == outMeans.size());
+      assert(true == std::ranges::all_of(inValues, [] (double const inValue) { return std::isfinite(inValue); }));
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         /// Locals keep the loop free of reloads through the output spans
+         auto const sum{m_sum + m_sumCompensation,};
+         auto const sumOfSquares{m_sumOfSquares + m_sumOfSquaresCompensation,};
+         for (size_t valueIndex{0,}; valueIndex < inValues.size(); ++valueIndex)
+         {
+            auto const value{inValues[valueIndex],};
+            auto const mean{(sum + value) / period,};
+            outMeans[valueIndex] = mean;
+            outValues[valueIndex] = (sumOfSquares + value * value) / period - mean * mean;
+         }
+         return;
+      }
+      std::ranges::fill(outMeans, std::numeric_limits<double>::signaling_NaN());
+      std::ranges::fill(outValues, std::numeric_limits<double>::signaling_NaN());
+   }
+
+   [[maybe_unused, nodiscard]] constexpr uint32_t resummation_period() const noexcept
+   {
+      return m_resummationPeriod;
+   }
+
    [[maybe_unused]] constexpr void reset() noexcept
    {
       m_sum = 0;
       m_sumOfSquares = 0;
+      m_sumCompensation = 0;
+      m_sumOfSquaresCompensation = 0;
+      m_resummationCountdown = m_resummationPeriod;
+      m_values.seek(0);
 #if (not defined(NDEBUG))
-      std::ranges::fill(m_values, std::numeric_limits<double>::signaling_NaN());
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
       m_prevSequenceNumber = 0;
 #endif
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(m_resummationPeriod);
+      m_values.save(outWriter);
+      outWriter.write(m_resummationCountdown);
+      outWriter.write(m_sum);
+      outWriter.write(m_sumOfSquares);
+      outWriter.write(m_sumCompensation);
+      outWriter.write(m_sumOfSquaresCompensation);
+      outWriter.write(m_evictedValue);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward and zero volume
+   /// bars repeat the latest value, decay only bars would put zero prices into the window and are rejected, once the gap covers
+   /// the period the window only holds copies of the value and the rest of the gap leaves the sums as is, the missing bars cannot be amended
+   [[maybe_unused]] constexpr void skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+      m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+      assert(0 < inSequenceNumber);
+      assert(0 < inGap);
+      assert(gap_fill::decay_only != inFill);
+      auto const value{m_values.newest(),};
+      auto const valuesNumber{std::min<uint64_t>(inGap, period),};
+      for (auto sequenceNumber{inSequenceNumber,}; sequenceNumber < (inSequenceNumber + valuesNumber); ++sequenceNumber)
+      {
+         if (lookback_period <= sequenceNumber) [[likely]]
+         {
+            double mean{};
+            [[maybe_unused]] auto const varianceValue{do_regular_calc(value, mean),};
+         }
+         else
+         {
+            do_lookback_calc(value);
+         }
+      }
+      if ((0 != m_resummationPeriod) && (inGap > valuesNumber))
+      {
+         /// The rest of the gap exchanges equal values, only the resummation schedule moves on
+         auto const restNumber{inGap - valuesNumber,};
+         if (m_resummationCountdown <= restNumber)
+         {
+            do_resum();
+         }
+         else
+         {
+            m_resummationCountdown -= static_cast<uint32_t>(restNumber);
+         }
+      }
+   }
+
+   /// Value whose z-score within the window it completes equals the given one, NaN when out of reach:
+   /// the magnitude stays below sqrt(period - 1) and a flat window only reaches zero
+   [[maybe_unused, nodiscard]] constexpr double solve_z_score(uint64_t const inSequenceNumber, double const inZScore) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inZScore));
+      assert(false == std::isnan(inZScore));
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         /// A value d away from the mean of the n - 1 retained values, whose squared deviations add up to m,
+         /// has z = d (n - 1) / sqrt(n m + d^2 (n - 1)), hence d^2 = z^2 n m / ((n - 1) (n - 1 - z^2))
+         constexpr auto retainedNumber{static_cast<double>(lookback_period),};
+         auto const retainedSum{m_sum + m_sumCompensation,};
+         auto const retainedMean{retainedSum / retainedNumber,};
+         auto const retainedSquaredDeviations{std::max(m_sumOfSquares + m_sumOfSquaresCompensation - retainedSum * retainedMean, 0.0),};
+         auto const reach{retainedNumber - inZScore * inZScore,};
+         if ((0.0 == inZScore) || ((0 < reach) && (0 < retainedSquaredDeviations)))
+         {
+            return retainedMean + inZScore * std::sqrt(period * retainedSquaredDeviations / (retainedNumber * reach));
+         }
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   /// Only the period - 1 newest values are kept, the ones that remain in the next window
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
 private:
    double m_sum{0,};
    double m_sumOfSquares{0,};
-   std::array<double, lookback_period> m_values{};
+   double m_sumCompensation{0,};
+   double m_sumOfSquaresCompensation{0,};
+   /// The value which left the window in the latest regular calc, an amended calc brings it back
+   double m_evictedValue{0,};
+   uint32_t m_resummationPeriod{0,};
+   uint32_t m_resummationCountdown{0,};
+   ring_buffer<double, lookback_period> m_values{};
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber{0,};
 #endif
 
-   constexpr void do_lookback_calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+   constexpr void do_add(double const inValue) noexcept
+   {
+      if (0 == m_resummationPeriod) [[likely]]
+      {
+         m_sum += inValue;
+         m_sumOfSquares += inValue * inValue;
+      }
+      else
+      {
+         compensated_add(m_sum, m_sumCompensation, inValue);
+         compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, inValue * inValue);
+      }
+   }
+
+   constexpr void do_lookback_calc(double const inValue) noexcept
    {
-      m_sum += inValue;
-      m_sumOfSquares += inValue * inValue;
-      m_values[inSequenceNumber % lookback_period] = inValue;
+      do_add(inValue);
+      m_values.push(inValue);
    }
 
-   [[nodiscard]] constexpr double do_regular_calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+   [[nodiscard]] constexpr double do_regular_calc(double const inValue, double &outMean) noexcept
    {
-      m_sum += inValue;
-      m_sumOfSquares += inValue * inValue;
-      outMean = m_sum / period;
-      auto const meanOfSquares{m_sumOfSquares / period,};
-      auto &prevValue{m_values[inSequenceNumber % lookback_period],};
-      m_sum -= prevValue;
-      m_sumOfSquares -= prevValue * prevValue;
-      prevValue = inValue;
+      do_add(inValue);
+      outMean = (m_sum + m_sumCompensation) / period;
+      auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation) / period,};
+      auto const prevValue{m_values.exchange(inValue),};
+      m_evictedValue = prevValue;
+      if (0 == m_resummationPeriod) [[likely]]
+      {
+         m_sum -= prevValue;
+         m_sumOfSquares -= prevValue * prevValue;
+      }
+      else
+      {
+         compensated_add(m_sum, m_sumCompensation, -prevValue);
+         compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, -prevValue * prevValue);
+         if (0 == --m_resummationCountdown) [[unlikely]]
+         {
+            do_resum();
+         }
+      }
       return meanOfSquares - outMean * outMean;
    }
+
+   constexpr void do_replace(double const inPrevValue, double const inValue) noexcept
+   {
+      if (0 == m_resummationPeriod) [[likely]]
+      {
+         m_sum += inValue - inPrevValue;
+         m_sumOfSquares += inValue * inValue - inPrevValue * inPrevValue;
+      }
+      else
+      {
+         compensated_add(m_sum, m_sumCompensation, inValue);
+         compensated_add(m_sum, m_sumCompensation, -inPrevValue);
+         compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, inValue * inValue);
+         compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, -inPrevValue * inPrevValue);
+      }
+   }
+
+   constexpr void do_resum() noexcept
+   {
+      m_sum = 0;
+      m_sumOfSquares = 0;
+      m_sumCompensation = 0;
+      m_sumOfSquaresCompensation = 0;
+      for (auto const value : m_values.values())
+      {
+         compensated_add(m_sum, m_sumCompensation, value);
+         compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, value * value);
+      }
+      m_resummationCountdown = m_resummationPeriod;
+   }
 };
 
-template<>
-class [[maybe_unused]] variance<static_cast<uint32_t>(-1)> final
+/// Windows of up to inline_capacity values are kept inside the object, the library instantiates inline capacities 0, 8, 16, 32 and 64
+template<uint32_t inline_capacity>
+class [[maybe_unused]] variance<static_cast<uint32_t>(-1), inline_capacity> final
 {
+   static_assert(
+      (0 == inline_capacity) || (8 == inline_capacity) || (16 == inline_capacity) || (32 == inline_capacity) || (64 == inline_capacity),
+      "the runtime variance is only instantiated with inline capacities 0, 8, 16, 32 and 64"
+   );
+
 public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+      [[nodiscard]] explicit lookahead_type(variance const &inIndicator) noexcept;
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         return calc(inSequenceNumber, inValue, mean);
+      }
+
+      [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue, double &outMean) noexcept;
+
+   private:
+      variance const *m_indicator;
+      double m_sum;
+      double m_sumOfSquares;
+      double m_sumCompensation;
+      double m_sumOfSquaresCompensation;
+      uint32_t m_valuesNumber;
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+
+      void do_add(double inValue, double inSquare) noexcept;
+   };
+
    variance() = delete;
-   variance(variance &&) = delete;
-   variance(variance const &) = delete;
-   [[nodiscard]] explicit variance(uint32_t inPeriod);
+   [[maybe_unused, nodiscard]] variance(variance &&) noexcept = default;
+   [[maybe_unused, nodiscard]] variance(variance const &) = default;
+   [[nodiscard]] explicit variance(uint32_t inPeriod, uint32_t inResummationPeriod = 0, std::pmr::memory_resource *inMemoryResource = std::pmr::get_default_resource());
+
+   [[maybe_unused]] variance &operator = (variance &&) noexcept = default;
+   [[maybe_unused]] variance &operator = (variance const &) = default;
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      return amend(inSequenceNumber, inValue, mean);
+   }
 
-   variance &operator = (variance &&) = delete;
-   variance &operator = (variance const &) = delete;
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inValue, double &outMean) noexcept;
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
@@ -163,6 +551,13 @@ public:
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inValue, double &outMean) noexcept;
 
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -181,21 +576,59 @@ public:
 
    [[nodiscard]] double pick(uint64_t inSequenceNumber, double inValue, double &outMean) const noexcept;
 
+   void pick_many(uint64_t inSequenceNumber, std::span<double const> inValues, std::span<double> outValues, std::span<double> outMeans) const noexcept;
+
    void reset() noexcept;
 
+   [[maybe_unused, nodiscard]] uint32_t resummation_period() const noexcept
+   {
+      return m_resummationPeriod;
+   }
+
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward and zero volume
+   /// bars repeat the latest value, decay only bars would put zero prices into the window and are rejected, the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
+   [[nodiscard]] double solve_z_score(uint64_t inSequenceNumber, double inZScore) const noexcept;
+
+   /// Only the period - 1 newest values are kept, the ones that remain in the next window
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   uint32_t m_resummationPeriod;
+   uint32_t m_resummationCountdown;
    double m_sum{0,};
    double m_sumOfSquares{0,};
-   std::unique_ptr<double[]> const m_values;
+   double m_sumCompensation{0,};
+   double m_sumOfSquaresCompensation{0,};
+   double m_evictedValue{0,};
+   ring_buffer<double, static_cast<uint32_t>(-1), inline_capacity> m_values;
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber{0,};
 #endif
 
-   void do_lookback_calc(uint64_t inSequenceNumber, double inValue) noexcept;
+   void do_add(double inValue) noexcept;
 
-   [[nodiscard]] double do_regular_calc(uint64_t inSequenceNumber, double inValue, double &outMean) noexcept;
+   void do_lookback_calc(double inValue) noexcept;
+
+   [[nodiscard]] double do_regular_calc(double inValue, double &outMean) noexcept;
+
+   void do_replace(double inPrevValue, double inValue) noexcept;
+
+   void do_resum() noexcept;
 };
 
+extern template class variance<static_cast<uint32_t>(-1), 0>;
+extern template class variance<static_cast<uint32_t>(-1), 8>;
+extern template class variance<static_cast<uint32_t>(-1), 16>;
+extern template class variance<static_cast<uint32_t>(-1), 32>;
+extern template class variance<static_cast<uint32_t>(-1), 64>;
+
 }
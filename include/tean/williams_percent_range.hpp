@@ -25,26 +25,600 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::ring_buffer
+
+#include <algorithm> /// for std::max, std::min, std::ranges::all_of, std::ranges::fill
+#include <array> /// for std::array
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::isnan
+#include <cstddef> /// for size_t
 #include <cstdint> /// for uint32_t, uint64_t
-#include <memory> /// for std::unique_ptr
-#include <utility> /// for std::pair
+#include <limits> /// for std::numeric_limits
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <span> /// for std::span
 
 namespace tean
 {
 
-class [[nodiscard]] williams_percent_range final
+template<uint32_t period = static_cast<uint32_t>(-1), uint32_t inline_capacity = 0>
+class williams_percent_range;
+
+template<uint32_t period, uint32_t inline_capacity>
+class [[maybe_unused]] williams_percent_range final
 {
+   static_assert(1 < period);
+   static_assert(0 == inline_capacity);
+
 public:
+   static constexpr inline auto lookback_period{period - 1,};
+
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile,
+   /// the committed deques are only walked past the values the hypothetical ones push out of the window
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(williams_percent_range const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_highestHighIndicesHead{inIndicator.m_highestHighIndicesHead,},
+         m_highestHighIndicesSize{inIndicator.m_highestHighIndicesSize,},
+         m_lowestLowIndicesHead{inIndicator.m_lowestLowIndicesHead,},
+         m_lowestLowIndicesSize{inIndicator.m_lowestLowIndicesSize,}
+#if (not defined(NDEBUG))
+         , m_prevSequenceNumber{inIndicator.m_prevSequenceNumber,}
+#endif
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+      {
+#if (not defined(NDEBUG))
+         assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         assert(true == std::isfinite(inHigh));
+         assert(false == std::isnan(inHigh));
+         assert(true == std::isfinite(inLow));
+         assert(false == std::isnan(inLow));
+         assert(true == std::isfinite(inClose));
+         assert(false == std::isnan(inClose));
+         assert(inHigh >= inLow);
+         assert(inHigh >= inClose);
+         assert(inClose >= inLow);
+         assert(period > m_valuesNumber);
+         auto const &values{m_indicator->m_values,};
+         /// The j-th hypothetical value pushes out the committed values up to the j-th oldest slot
+         while ((0 < m_highestHighIndicesSize) && (m_valuesNumber >= values.wrap(m_indicator->m_highestHighIndices[m_highestHighIndicesHead] + period - values.cursor())))
+         {
+            m_highestHighIndicesHead = values.wrap(m_highestHighIndicesHead + 1);
+            --m_highestHighIndicesSize;
+         }
+         while ((0 < m_lowestLowIndicesSize) && (m_valuesNumber >= values.wrap(m_indicator->m_lowestLowIndices[m_lowestLowIndicesHead] + period - values.cursor())))
+         {
+            m_lowestLowIndicesHead = values.wrap(m_lowestLowIndicesHead + 1);
+            --m_lowestLowIndicesSize;
+         }
+         m_highestHigh = ((0 == m_valuesNumber) || (m_highestHigh < inHigh)) ? inHigh : m_highestHigh;
+         m_lowestLow = ((0 == m_valuesNumber) || (inLow < m_lowestLow)) ? inLow : m_lowestLow;
+         ++m_valuesNumber;
+         if (lookback_period <= inSequenceNumber) [[likely]]
+         {
+            auto highestHigh{m_highestHigh,};
+            auto lowestLow{m_lowestLow,};
+            if (period > m_valuesNumber)
+            {
+               /// The bar of the latest calc is not in the deques yet, it leaves the window with the last hypothetical bar
+               highestHigh = std::max(values.newest().high, highestHigh);
+               lowestLow = std::min(values.newest().low, lowestLow);
+            }
+            return williams_percent_range::percent_range(
+               (0 == m_highestHighIndicesSize) ? highestHigh : std::max(values[m_indicator->m_highestHighIndices[m_highestHighIndicesHead]].high, highestHigh),
+               (0 == m_lowestLowIndicesSize) ? lowestLow : std::min(values[m_indicator->m_lowestLowIndices[m_lowestLowIndicesHead]].low, lowestLow),
+               inClose
+            );
+         }
+         return std::numeric_limits<double>::signaling_NaN();
+      }
+
+   private:
+      williams_percent_range const *m_indicator;
+      uint32_t m_highestHighIndicesHead;
+      uint32_t m_highestHighIndicesSize;
+      uint32_t m_lowestLowIndicesHead;
+      uint32_t m_lowestLowIndicesSize;
+      uint32_t m_valuesNumber{0,};
+      double m_highestHigh{0,};
+      double m_lowestLow{0,};
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+   };
+
+   [[maybe_unused, nodiscard]] constexpr williams_percent_range() noexcept
+   {
+#if (not defined(NDEBUG))
+      m_values.reset(high_low{.high = std::numeric_limits<double>::signaling_NaN(), .low = std::numeric_limits<double>::signaling_NaN()});
+#endif
+   }
+
+   [[maybe_unused, nodiscard]] williams_percent_range(williams_percent_range &&) noexcept = default;
+   [[maybe_unused, nodiscard]] williams_percent_range(williams_percent_range const &) = default;
+
+   [[maybe_unused]] williams_percent_range &operator = (williams_percent_range &&) noexcept = default;
+   [[maybe_unused]] williams_percent_range &operator = (williams_percent_range const &) = default;
+
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value in O(1),
+   /// the bar of the latest calc only joins the deques with the next calc
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      assert(true == std::isfinite(inHigh));
+      assert(false == std::isnan(inHigh));
+      assert(true == std::isfinite(inLow));
+      assert(false == std::isnan(inLow));
+      assert(true == std::isfinite(inClose));
+      assert(false == std::isnan(inClose));
+      assert(inHigh >= inLow);
+      assert(inHigh >= inClose);
+      assert(inClose >= inLow);
+      m_values.newest() = high_low{.high = inHigh, .low = inLow};
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         return percent_range(
+            std::max(m_values[m_highestHighIndices[m_highestHighIndicesHead]].high, inHigh),
+            std::min(m_values[m_lowestLowIndices[m_lowestLowIndicesHead]].low, inLow),
+            inClose
+         );
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inHigh));
+      assert(false == std::isnan(inHigh));
+      assert(true == std::isfinite(inLow));
+      assert(false == std::isnan(inLow));
+      assert(true == std::isfinite(inClose));
+      assert(false == std::isnan(inClose));
+      assert(inHigh >= inLow);
+      assert(inHigh >= inClose);
+      assert(inClose >= inLow);
+      if (0 == inSequenceNumber) [[unlikely]]
+      {
+         m_values.push(high_low{.high = inHigh, .low = inLow});
+         return std::numeric_limits<double>::signaling_NaN();
+      }
+      do_calc(inHigh, inLow);
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         return percent_range(
+            std::max(m_values[m_highestHighIndices[m_highestHighIndicesHead]].high, inHigh),
+            std::min(m_values[m_lowestLowIndices[m_lowestLowIndicesHead]].low, inLow),
+            inClose
+         );
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused]] constexpr void calc(
+      uint64_t const inSequenceNumber,
+      std::span<double const> const inHighs,
+      std::span<double const> const inLows,
+      std::span<double const> const inCloses,
+      std::span<double> const outValues
+   ) noexcept
+   {
+      assert(inHighs.size() == outValues.size());
+      assert(inLows.size() == outValues.size());
+      assert(inCloses.size() == outValues.size());
+      assert(true == std::ranges::all_of(inHighs, [] (double const inHigh) { return std::isfinite(inHigh); }));
+      assert(true == std::ranges::all_of(inLows, [] (double const inLow) { return std::isfinite(inLow); }));
+      assert(true == std::ranges::all_of(inCloses, [] (double const inClose) { return std::isfinite(inClose); }));
+      /// Windows overlapping values preceding the batch are served by the streaming path
+      auto const streamingSize{std::min<size_t>(lookback_period, outValues.size()),};
+      for (size_t valueIndex{0,}; valueIndex < streamingSize; ++valueIndex)
+      {
+         outValues[valueIndex] = calc(inSequenceNumber + valueIndex, inHighs[valueIndex], inLows[valueIndex], inCloses[valueIndex]);
+      }
+      if (outValues.size() < period)
+      {
+         return;
+      }
+      /// van Herk/Gil-Werman: block suffix highs are stored in-place, block suffix lows use the values ring as scratch,
+      /// both are merged with the prefix highs/lows of the next block
+      for (size_t blockBegin{0,}; (blockBegin + period) <= outValues.size(); blockBegin += period)
+      {
+         auto const blockEnd{blockBegin + period,};
+         auto suffixHigh{std::numeric_limits<double>::lowest(),};
+         auto suffixLow{std::numeric_limits<double>::max(),};
+         for (auto valueIndex{blockEnd,}; blockBegin != valueIndex--; )
+         {
+            suffixHigh = std::max(suffixHigh, inHighs[valueIndex]);
+            suffixLow = std::min(suffixLow, inLows[valueIndex]);
+            if (auto const outIndex{valueIndex + lookback_period,}; outIndex < outValues.size())
+            {
+               outValues[outIndex] = suffixHigh;
+            }
+            m_values[valueIndex - blockBegin].low = suffixLow;
+         }
+         outValues[blockEnd - 1] = percent_range(suffixHigh, suffixLow, inCloses[blockEnd - 1]);
+         auto prefixHigh{std::numeric_limits<double>::lowest(),};
+         auto prefixLow{std::numeric_limits<double>::max(),};
+         for (auto valueIndex{blockEnd,}, valueEnd{std::min<size_t>(blockEnd + lookback_period, outValues.size()),}; valueIndex < valueEnd; ++valueIndex)
+         {
+            prefixHigh = std::max(prefixHigh, inHighs[valueIndex]);
+            prefixLow = std::min(prefixLow, inLows[valueIndex]);
+            outValues[valueIndex] = percent_range(
+               std::max(outValues[valueIndex], prefixHigh),
+               std::min(m_values[valueIndex - blockEnd + 1].low, prefixLow),
+               inCloses[valueIndex]
+            );
+         }
+      }
+      /// Rebuild the streaming state from the last period of the batch
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber + outValues.size() - 1;
+#endif
+      m_highestHighIndicesHead = 0;
+      m_highestHighIndicesSize = 0;
+      m_lowestLowIndicesHead = 0;
+      m_lowestLowIndicesSize = 0;
+      m_values.seek(static_cast<uint32_t>((inSequenceNumber + outValues.size()) % period));
+      for (auto valueIndex{outValues.size() - period,}; valueIndex < outValues.size(); ++valueIndex)
+      {
+         m_values.push(high_low{.high = inHighs[valueIndex], .low = inLows[valueIndex]});
+      }
+      for (uint32_t valueIndex{0,}; valueIndex < lookback_period; ++valueIndex)
+      {
+         do_push_high(m_values.wrap(m_values.cursor() + valueIndex));
+         do_push_low(m_values.wrap(m_values.cursor() + valueIndex));
+      }
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == m_values.load(inReader))
+         && (true == inReader.read_deque(m_highestHighIndices, m_highestHighIndicesHead, m_highestHighIndicesSize, period))
+         && (true == inReader.read_deque(m_lowestLowIndices, m_lowestLowIndicesHead, m_lowestLowIndicesSize, period))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return false;
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inHigh));
+      assert(false == std::isnan(inHigh));
+      assert(true == std::isfinite(inLow));
+      assert(false == std::isnan(inLow));
+      assert(true == std::isfinite(inClose));
+      assert(false == std::isnan(inClose));
+      assert(inHigh >= inLow);
+      assert(inHigh >= inClose);
+      assert(inClose >= inLow);
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         return percent_range(get_highest_high(inHigh), get_lowest_low(inLow), inClose);
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   /// Same as pick for every candidate close of the forming bar, which widens to cover the candidate,
+   /// the window extremes are resolved once for all candidates
+   [[maybe_unused]] constexpr void pick_many(
+      uint64_t const inSequenceNumber,
+      double const inHigh,
+      double const inLow,
+      std::span<double const> const inCloses,
+      std::span<double> const outValues
+   ) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inHigh));
+      assert(false == std::isnan(inHigh));
+      assert(true == std::isfinite(inLow));
+      assert(false == std::isnan(inLow));
+      assert(inHigh >= inLow);
+      assert(inCloses.size() == outValues.size());
+      assert(true == std::ranges::all_of(inCloses, [] (double const inClose) { return std::isfinite(inClose); }));
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         auto const highestHigh{get_highest_high(inHigh),};
+         auto const lowestLow{get_lowest_low(inLow),};
+         for (size_t valueIndex{0,}; valueIndex < inCloses.size(); ++valueIndex)
+         {
+            auto const close{inCloses[valueIndex],};
+            outValues[valueIndex] = percent_range(std::max(highestHigh, close), std::min(lowestLow, close), close);
+         }
+         return;
+      }
+      std::ranges::fill(outValues, std::numeric_limits<double>::signaling_NaN());
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+      m_values.seek(0);
+#if (not defined(NDEBUG))
+      m_values.reset(high_low{.high = std::numeric_limits<double>::signaling_NaN(), .low = std::numeric_limits<double>::signaling_NaN()});
+      m_prevSequenceNumber = 0;
+#endif
+      m_highestHighIndicesHead = 0;
+      m_highestHighIndicesSize = 0;
+      m_lowestLowIndicesHead = 0;
+      m_lowestLowIndicesSize = 0;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      m_values.save(outWriter);
+      outWriter.write_deque(m_highestHighIndices, m_highestHighIndicesHead, m_highestHighIndicesSize, period);
+      outWriter.write_deque(m_lowestLowIndices, m_lowestLowIndicesHead, m_lowestLowIndicesSize, period);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward bars repeat
+   /// the latest high and low, zero volume bars would need the latest close, which the window does not keep, and decay only bars
+   /// would put zero prices into the window, so both are rejected, the missing bars cannot be amended
+   [[maybe_unused]] constexpr void skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+      m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+      assert(0 < inSequenceNumber);
+      assert(0 < inGap);
+      assert(gap_fill::carry_forward == inFill);
+      auto const value{m_values.newest(),};
+      for (auto valuesNumber{std::min<uint64_t>(inGap, period),}; 0 < valuesNumber; --valuesNumber)
+      {
+         do_calc(value.high, value.low);
+      }
+      if (inGap > period)
+      {
+         /// The window only holds copies of the bar, so the rest of the gap just moves the cursor and the newest committed copy heads the deques
+         m_values.seek(static_cast<uint32_t>((inSequenceNumber + inGap) % period));
+         m_highestHighIndicesHead = 0;
+         m_highestHighIndicesSize = 1;
+         m_highestHighIndices[0] = m_values.wrap(m_values.cursor() + lookback_period - 1);
+         m_lowestLowIndicesHead = 0;
+         m_lowestLowIndicesSize = 1;
+         m_lowestLowIndices[0] = m_highestHighIndices[0];
+      }
+   }
+
+   /// Close of the forming bar whose pick yields the given percent range, NaN when the window is flat and the target is not 0,
+   /// the close always lies within the window extremes but may fall outside the forming bar, which pick_many widens to cover it
+   [[maybe_unused, nodiscard]] constexpr double solve(
+      uint64_t const inSequenceNumber,
+      double const inHigh,
+      double const inLow,
+      double const inPercentRange
+   ) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inHigh));
+      assert(false == std::isnan(inHigh));
+      assert(true == std::isfinite(inLow));
+      assert(false == std::isnan(inLow));
+      assert(inHigh >= inLow);
+      assert((-100 <= inPercentRange) && (0 >= inPercentRange));
+      if (lookback_period <= inSequenceNumber) [[likely]]
+      {
+         auto const highestHigh{get_highest_high(inHigh),};
+         auto const lowestLow{get_lowest_low(inLow),};
+         if ((highestHigh > lowestLow) || (0 == inPercentRange))
+         {
+            return highestHigh + inPercentRange * (highestHigh - lowestLow) / 100.0;
+         }
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+private:
+   struct [[nodiscard]] high_low final
+   {
+      double high;
+      double low;
+   };
+
+   ring_buffer<high_low, period> m_values{};
+   std::array<uint32_t, period> m_highestHighIndices{};
+   std::array<uint32_t, period> m_lowestLowIndices{};
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber{0,};
+#endif
+   uint32_t m_highestHighIndicesHead{0,};
+   uint32_t m_highestHighIndicesSize{0,};
+   uint32_t m_lowestLowIndicesHead{0,};
+   uint32_t m_lowestLowIndicesSize{0,};
+
+   /// Commits the bar of the latest calc to both deques and takes the next one, which stays out of them until the next calc
+   constexpr void do_calc(double const inHigh, double const inLow) noexcept
+   {
+      auto const newestIndex{m_values.wrap(m_values.cursor() + lookback_period),};
+      do_push_high(newestIndex);
+      if (m_values.cursor() == m_highestHighIndices[m_highestHighIndicesHead])
+      {
+         m_highestHighIndicesHead = m_values.wrap(m_highestHighIndicesHead + 1);
+         --m_highestHighIndicesSize;
+      }
+      do_push_low(newestIndex);
+      if (m_values.cursor() == m_lowestLowIndices[m_lowestLowIndicesHead])
+      {
+         m_lowestLowIndicesHead = m_values.wrap(m_lowestLowIndicesHead + 1);
+         --m_lowestLowIndicesSize;
+      }
+      m_values.push(high_low{.high = inHigh, .low = inLow});
+   }
+
+   constexpr void do_push_high(uint32_t const inIndex) noexcept
+   {
+      while ((0 < m_highestHighIndicesSize) && (m_values[m_highestHighIndices[m_values.wrap(m_highestHighIndicesHead + m_highestHighIndicesSize - 1)]].high <= m_values[inIndex].high))
+      {
+         --m_highestHighIndicesSize;
+      }
+      m_highestHighIndices[m_values.wrap(m_highestHighIndicesHead + m_highestHighIndicesSize)] = inIndex;
+      ++m_highestHighIndicesSize;
+   }
+
+   constexpr void do_push_low(uint32_t const inIndex) noexcept
+   {
+      while ((0 < m_lowestLowIndicesSize) && (m_values[m_lowestLowIndices[m_values.wrap(m_lowestLowIndicesHead + m_lowestLowIndicesSize - 1)]].low >= m_values[inIndex].low))
+      {
+         --m_lowestLowIndicesSize;
+      }
+      m_lowestLowIndices[m_values.wrap(m_lowestLowIndicesHead + m_lowestLowIndicesSize)] = inIndex;
+      ++m_lowestLowIndicesSize;
+   }
+
+   [[nodiscard]] constexpr double get_highest_high(double const inHigh) const noexcept
+   {
+      auto highestHighIndicesHead{m_highestHighIndicesHead,};
+      auto highestHighIndicesSize{m_highestHighIndicesSize,};
+      if ((0 < highestHighIndicesSize) && (m_values.cursor() == m_highestHighIndices[highestHighIndicesHead]))
+      {
+         highestHighIndicesHead = m_values.wrap(highestHighIndicesHead + 1);
+         --highestHighIndicesSize;
+      }
+      /// The bar of the latest calc is not in the deque yet
+      auto const highestHigh{std::max(m_values.newest().high, inHigh),};
+      return (0 == highestHighIndicesSize)
+         ? highestHigh
+         : std::max(m_values[m_highestHighIndices[highestHighIndicesHead]].high, highestHigh)
+      ;
+   }
+
+   [[nodiscard]] constexpr double get_lowest_low(double const inLow) const noexcept
+   {
+      auto lowestLowIndicesHead{m_lowestLowIndicesHead,};
+      auto lowestLowIndicesSize{m_lowestLowIndicesSize,};
+      if ((0 < lowestLowIndicesSize) && (m_values.cursor() == m_lowestLowIndices[lowestLowIndicesHead]))
+      {
+         lowestLowIndicesHead = m_values.wrap(lowestLowIndicesHead + 1);
+         --lowestLowIndicesSize;
+      }
+      /// The bar of the latest calc is not in the deque yet
+      auto const lowestLow{std::min(m_values.newest().low, inLow),};
+      return (0 == lowestLowIndicesSize)
+         ? lowestLow
+         : std::min(m_values[m_lowestLowIndices[lowestLowIndicesHead]].low, lowestLow)
+      ;
+   }
+
+   [[nodiscard]] static constexpr double percent_range(double const inHighestHigh, double const inLowestLow, double const inClose) noexcept
+   {
+      assert(inHighestHigh >= inLowestLow);
+      auto const delta{inHighestHigh - inLowestLow,};
+      /// A flat range has the close at the highest high, so dividing by one yields zero and keeps candidate loops branchless
+      return 100.0 * (inClose - inHighestHigh) / (delta + static_cast<double>(0.0 == delta));
+   }
+};
+
+/// Windows of up to inline_capacity values are kept inside the object, the library instantiates inline capacities 0, 8, 16, 32 and 64
+template<uint32_t inline_capacity>
+class [[maybe_unused]] williams_percent_range<static_cast<uint32_t>(-1), inline_capacity> final
+{
+   static_assert(
+      (0 == inline_capacity) || (8 == inline_capacity) || (16 == inline_capacity) || (32 == inline_capacity) || (64 == inline_capacity),
+      "the runtime williams_percent_range is only instantiated with inline capacities 0, 8, 16, 32 and 64"
+   );
+
+public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile,
+   /// the committed deques are only walked past the values the hypothetical ones push out of the window
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+      [[nodiscard]] explicit lookahead_type(williams_percent_range const &inIndicator) noexcept;
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[nodiscard]] double calc(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) noexcept;
+
+   private:
+      williams_percent_range const *m_indicator;
+      uint32_t m_highestHighIndicesHead;
+      uint32_t m_highestHighIndicesSize;
+      uint32_t m_lowestLowIndicesHead;
+      uint32_t m_lowestLowIndicesSize;
+      uint32_t m_valuesNumber;
+      double m_highestHigh;
+      double m_lowestLow;
+#if (not defined(NDEBUG))
+      uint64_t m_prevSequenceNumber;
+#endif
+   };
+
    williams_percent_range() = delete;
-   williams_percent_range(williams_percent_range &&) = delete;
-   williams_percent_range(williams_percent_range const &) = delete;
-   [[nodiscard]] explicit williams_percent_range(uint32_t inPeriod);
+   [[maybe_unused, nodiscard]] williams_percent_range(williams_percent_range &&) noexcept = default;
+   [[maybe_unused, nodiscard]] williams_percent_range(williams_percent_range const &) = default;
+   [[nodiscard]] explicit williams_percent_range(uint32_t inPeriod, std::pmr::memory_resource *inMemoryResource = std::pmr::get_default_resource());
+
+   [[maybe_unused]] williams_percent_range &operator = (williams_percent_range &&) noexcept = default;
+   [[maybe_unused]] williams_percent_range &operator = (williams_percent_range const &) = default;
 
-   williams_percent_range &operator = (williams_percent_range &&) = delete;
-   williams_percent_range &operator = (williams_percent_range const &) = delete;
+   /// Replaces the input of the latest calc, which had the same sequence number, and returns the revised value in O(1),
+   /// the bar of the latest calc only joins the deques with the next calc
+   [[nodiscard]] double amend(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) noexcept;
 
    [[nodiscard]] double calc(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) noexcept;
 
+   void calc(
+      uint64_t inSequenceNumber,
+      std::span<double const> inHighs,
+      std::span<double const> inLows,
+      std::span<double const> inCloses,
+      std::span<double> outValues
+   ) noexcept;
+
+   [[nodiscard]] bool load(uint64_t inSequenceNumber, state_reader &inReader) noexcept;
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_lookbackPeriod;
@@ -57,30 +631,57 @@ public:
 
    [[nodiscard]] double pick(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) const noexcept;
 
+   void pick_many(uint64_t inSequenceNumber, double inHigh, double inLow, std::span<double const> inCloses, std::span<double> outValues) const noexcept;
+
    void reset() noexcept;
 
+   void save(uint64_t inSequenceNumber, state_writer &outWriter) const;
+
+   /// Advances over a gap of missing bars starting at the given sequence number in O(min(gap, period)), carried forward bars repeat
+   /// the latest high and low, zero volume bars would need the latest close, which the window does not keep, and decay only bars
+   /// would put zero prices into the window, so both are rejected, the missing bars cannot be amended
+   void skip(uint64_t inSequenceNumber, uint64_t inGap, gap_fill inFill) noexcept;
+
+   /// Close of the forming bar whose pick yields the given percent range, NaN when the window is flat and the target is not 0,
+   /// the close always lies within the window extremes but may fall outside the forming bar, which pick_many widens to cover it
+   [[nodiscard]] double solve(uint64_t inSequenceNumber, double inHigh, double inLow, double inPercentRange) const noexcept;
+
 private:
-   uint32_t const m_period;
-   uint32_t const m_lookbackPeriod;
-   std::unique_ptr<double[]> const m_highValues;
-   std::unique_ptr<double[]> const m_lowValues;
+   struct [[nodiscard]] high_low final
+   {
+      double high;
+      double low;
+   };
+
+   uint32_t m_period;
+   uint32_t m_lookbackPeriod;
+   ring_buffer<high_low, static_cast<uint32_t>(-1), inline_capacity> m_values;
+   ring_buffer<uint32_t, static_cast<uint32_t>(-1), inline_capacity> m_highestHighIndices;
+   ring_buffer<uint32_t, static_cast<uint32_t>(-1), inline_capacity> m_lowestLowIndices;
 #if (not defined(NDEBUG))
    uint64_t m_prevSequenceNumber;
 #endif
-   uint32_t m_highestHighIndex;
-   uint32_t m_lowestLowIndex;
-
-   [[nodiscard]] double do_lookback_calc(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) noexcept;
+   uint32_t m_highestHighIndicesHead;
+   uint32_t m_highestHighIndicesSize;
+   uint32_t m_lowestLowIndicesHead;
+   uint32_t m_lowestLowIndicesSize;
 
-   [[nodiscard]] double do_lookback_pick(double inHigh, double inLow, double inClose) const noexcept;
+   /// Commits the bar of the latest calc to both deques and takes the next one, which stays out of them until the next calc
+   void do_calc(double inHigh, double inLow) noexcept;
 
-   [[nodiscard]] double do_regular_calc(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) noexcept;
+   void do_push_high(uint32_t inIndex) noexcept;
 
-   [[nodiscard]] double do_regular_pick(uint64_t inSequenceNumber, double inHigh, double inLow, double inClose) const noexcept;
+   void do_push_low(uint32_t inIndex) noexcept;
 
-   [[nodiscard]] std::pair<uint32_t, double> get_highest_high(uint32_t inIndex, double inValue) const noexcept;
+   [[nodiscard]] double get_highest_high(uint32_t inValueIndex, double inHigh) const noexcept;
 
-   [[nodiscard]] std::pair<uint32_t, double> get_lowest_low(uint32_t inIndex, double inValue) const noexcept;
+   [[nodiscard]] double get_lowest_low(uint32_t inValueIndex, double inLow) const noexcept;
 };
 
+extern template class williams_percent_range<static_cast<uint32_t>(-1), 0>;
+extern template class williams_percent_range<static_cast<uint32_t>(-1), 8>;
+extern template class williams_percent_range<static_cast<uint32_t>(-1), 16>;
+extern template class williams_percent_range<static_cast<uint32_t>(-1), 32>;
+extern template class williams_percent_range<static_cast<uint32_t>(-1), 64>;
+
 }
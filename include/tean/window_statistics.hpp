@@ -0,0 +1,691 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/linear_regression.hpp" /// for tean::linear_regression_result
+#include "tean/ring_buffer.hpp" /// for tean::ring_buffer, tean::window_view
+
+#include <algorithm> /// for std::max, std::min
+#include <array> /// for std::array
+#include <cassert> /// for assert
+#include <cmath> /// for std::isfinite, std::sqrt
+#include <cstdint> /// for uint32_t, uint64_t
+#include <limits> /// for std::numeric_limits
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+
+namespace tean
+{
+
+enum class window_statistics_features : uint32_t
+{
+   sum = 1 << 0,
+   sum_of_squares = 1 << 1,
+   sum_xy = 1 << 2,
+   maximum = 1 << 3,
+   minimum = 1 << 4,
+   all = sum | sum_of_squares | sum_xy | maximum | minimum,
+};
+
+[[maybe_unused, nodiscard]] constexpr window_statistics_features operator | (window_statistics_features const inLeft, window_statistics_features const inRight) noexcept
+{
+   return static_cast<window_statistics_features>(static_cast<uint32_t>(inLeft) | static_cast<uint32_t>(inRight));
+}
+
+[[maybe_unused, nodiscard]] constexpr bool has_window_statistics_feature(window_statistics_features const inFeatures, window_statistics_features const inFeature) noexcept
+{
+   return 0 != (static_cast<uint32_t>(inFeatures) & static_cast<uint32_t>(inFeature));
+}
+
+/// The statistics of the window as a pick sees them
+struct window_statistics_result final
+{
+   double sum{std::numeric_limits<double>::signaling_NaN(),};
+   double mean{std::numeric_limits<double>::signaling_NaN(),};
+   double variance{std::numeric_limits<double>::signaling_NaN(),};
+   double standard_deviation{std::numeric_limits<double>::signaling_NaN(),};
+   double z_score{std::numeric_limits<double>::signaling_NaN(),};
+   double maximum{std::numeric_limits<double>::signaling_NaN(),};
+   double minimum{std::numeric_limits<double>::signaling_NaN(),};
+   linear_regression_result linear_regression{};
+};
+
+/// One window shared by the statistics of a series: the mean, variance, standard deviation, z-score, extremums and
+/// linear regression are read from the same ring and running sums, only the requested sums and extremums are tracked
+template<uint32_t period = static_cast<uint32_t>(-1), window_statistics_features features = window_statistics_features::all>
+class window_statistics;
+
+template<uint32_t period, window_statistics_features features>
+class [[maybe_unused]] window_statistics final
+{
+   static_assert(1 < period);
+
+   static constexpr inline auto track_sum_of_squares{has_window_statistics_feature(features, window_statistics_features::sum_of_squares),};
+   static constexpr inline auto track_sum_xy{has_window_statistics_feature(features, window_statistics_features::sum_xy),};
+   static constexpr inline auto track_sum{track_sum_of_squares || track_sum_xy || has_window_statistics_feature(features, window_statistics_features::sum),};
+   static constexpr inline auto track_maximum{has_window_statistics_feature(features, window_statistics_features::maximum),};
+   static constexpr inline auto track_minimum{has_window_statistics_feature(features, window_statistics_features::minimum),};
+   static constexpr inline auto reciprocal_period{1.0 / period,};
+   static constexpr inline auto sum_x{period * (period - 1) * 0.5,};
+   static constexpr inline auto sum_square_x{(period * (period - 1) * (2 * period - 1)) / 6.0,};
+   static constexpr inline auto divisor{sum_x * sum_x - period * sum_square_x,};
+
+public:
+   static constexpr inline auto lookback_period{period - 1,};
+
+   [[maybe_unused, nodiscard]] constexpr window_statistics() noexcept
+   {
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
+   }
+
+   [[maybe_unused, nodiscard]] window_statistics(window_statistics &&) noexcept = default;
+   [[maybe_unused, nodiscard]] window_statistics(window_statistics const &) = default;
+
+   [[maybe_unused]] window_statistics &operator = (window_statistics &&) noexcept = default;
+   [[maybe_unused]] window_statistics &operator = (window_statistics const &) = default;
+
+   [[maybe_unused]] constexpr void calc([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inValue));
+      if constexpr (true == track_maximum)
+      {
+         if ((0 < m_maximumIndicesSize) && (m_values.cursor() == m_maximumIndices[m_maximumIndicesHead]))
+         {
+            m_maximumIndicesHead = m_values.wrap(m_maximumIndicesHead + 1);
+            --m_maximumIndicesSize;
+         }
+         while ((0 < m_maximumIndicesSize) && (m_values[m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize - 1)]] <= inValue))
+         {
+            --m_maximumIndicesSize;
+         }
+         m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize)] = m_values.cursor();
+         ++m_maximumIndicesSize;
+      }
+      if constexpr (true == track_minimum)
+      {
+         if ((0 < m_minimumIndicesSize) && (m_values.cursor() == m_minimumIndices[m_minimumIndicesHead]))
+         {
+            m_minimumIndicesHead = m_values.wrap(m_minimumIndicesHead + 1);
+            --m_minimumIndicesSize;
+         }
+         while ((0 < m_minimumIndicesSize) && (m_values[m_minimumIndices[m_values.wrap(m_minimumIndicesHead + m_minimumIndicesSize - 1)]] >= inValue))
+         {
+            --m_minimumIndicesSize;
+         }
+         m_minimumIndices[m_values.wrap(m_minimumIndicesHead + m_minimumIndicesSize)] = m_values.cursor();
+         ++m_minimumIndicesSize;
+      }
+      auto const prevValue{(period == m_size) ? m_values.oldest() : 0.0,};
+      m_values.push(inValue);
+      if (period != m_size) [[unlikely]]
+      {
+         ++m_size;
+      }
+      /// Every value in the window moves one step further from the newest one, the oldest value leaves at x = period
+      if constexpr (true == track_sum_xy)
+      {
+         m_sumXY += m_sum - period * prevValue;
+      }
+      if constexpr (true == track_sum)
+      {
+         m_sum += inValue - prevValue;
+      }
+      if constexpr (true == track_sum_of_squares)
+      {
+         m_sumOfSquares += inValue * inValue - prevValue * prevValue;
+      }
+   }
+
+   [[maybe_unused, nodiscard]] constexpr linear_regression_result linear_regression() const noexcept
+      requires(true == track_sum_xy)
+   {
+      if (period == m_size) [[likely]]
+      {
+         auto const slope{(period * m_sumXY - sum_x * m_sum) / divisor,};
+         return linear_regression_result
+         {
+            .intercept = (m_sum - slope * sum_x) * reciprocal_period,
+            .slope = slope,
+         };
+      }
+      return linear_regression_result{};
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(static_cast<uint32_t>(features)))
+         && (true == m_values.load(inReader))
+         && (true == inReader.read(m_size))
+         && (period >= m_size)
+         && (true == inReader.read_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, track_maximum ? period : 0))
+         && (true == inReader.read_deque(m_minimumIndices, m_minimumIndicesHead, m_minimumIndicesSize, track_minimum ? period : 0))
+         && (true == inReader.read(m_sum))
+         && (true == inReader.read(m_sumOfSquares))
+         && (true == inReader.read(m_sumXY))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return inReader.fail();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double maximum() const noexcept
+      requires(true == track_maximum)
+   {
+      return (period == m_size) ? m_values[m_maximumIndices[m_maximumIndicesHead]] : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double mean() const noexcept
+      requires(true == track_sum)
+   {
+      return (period == m_size) ? (m_sum * reciprocal_period) : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double minimum() const noexcept
+      requires(true == track_minimum)
+   {
+      return (period == m_size) ? m_values[m_minimumIndices[m_minimumIndicesHead]] : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double newest() const noexcept
+   {
+      return (0 == m_size) ? std::numeric_limits<double>::signaling_NaN() : m_values[m_values.wrap(m_values.cursor() + lookback_period)];
+   }
+
+   /// Evaluates the tracked statistics as if the value were passed to calc, the statistics of untracked features stay NaN
+   [[maybe_unused, nodiscard]] constexpr window_statistics_result pick([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inValue));
+      window_statistics_result result{};
+      if ((period - 1) > m_size) [[unlikely]]
+      {
+         return result;
+      }
+      /// Only the oldest value leaves the window, and only from the head of a deque
+      if constexpr (true == track_maximum)
+      {
+         auto maximumIndicesHead{m_maximumIndicesHead,};
+         auto maximumIndicesSize{m_maximumIndicesSize,};
+         if ((0 < maximumIndicesSize) && (m_values.cursor() == m_maximumIndices[maximumIndicesHead]))
+         {
+            maximumIndicesHead = m_values.wrap(maximumIndicesHead + 1);
+            --maximumIndicesSize;
+         }
+         result.maximum = (0 == maximumIndicesSize) ? inValue : std::max(m_values[m_maximumIndices[maximumIndicesHead]], inValue);
+      }
+      if constexpr (true == track_minimum)
+      {
+         auto minimumIndicesHead{m_minimumIndicesHead,};
+         auto minimumIndicesSize{m_minimumIndicesSize,};
+         if ((0 < minimumIndicesSize) && (m_values.cursor() == m_minimumIndices[minimumIndicesHead]))
+         {
+            minimumIndicesHead = m_values.wrap(minimumIndicesHead + 1);
+            --minimumIndicesSize;
+         }
+         result.minimum = (0 == minimumIndicesSize) ? inValue : std::min(m_values[m_minimumIndices[minimumIndicesHead]], inValue);
+      }
+      if constexpr (true == track_sum)
+      {
+         auto const prevValue{(period == m_size) ? m_values.oldest() : 0.0,};
+         auto const sum{m_sum + (inValue - prevValue),};
+         result.sum = sum;
+         result.mean = sum * reciprocal_period;
+         if constexpr (true == track_sum_of_squares)
+         {
+            auto const sumOfSquares{m_sumOfSquares + (inValue * inValue - prevValue * prevValue),};
+            result.variance = sumOfSquares * reciprocal_period - result.mean * result.mean;
+            result.standard_deviation = (0 >= result.variance) ? 0.0 : std::sqrt(result.variance);
+            result.z_score = (0 >= result.variance) ? 0.0 : ((inValue - result.mean) / result.standard_deviation);
+         }
+         if constexpr (true == track_sum_xy)
+         {
+            auto const sumXY{m_sumXY + (m_sum - period * prevValue),};
+            auto const slope{(period * sumXY - sum_x * sum) / divisor,};
+            result.linear_regression = linear_regression_result
+            {
+               .intercept = (sum - slope * sum_x) * reciprocal_period,
+               .slope = slope,
+            };
+         }
+      }
+      return result;
+   }
+
+   [[maybe_unused]] constexpr void reset() noexcept
+   {
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = 0;
+#endif
+      m_size = 0;
+      m_maximumIndicesHead = 0;
+      m_maximumIndicesSize = 0;
+      m_minimumIndicesHead = 0;
+      m_minimumIndicesSize = 0;
+      m_sum = 0;
+      m_sumOfSquares = 0;
+      m_sumXY = 0;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(static_cast<uint32_t>(features));
+      m_values.save(outWriter);
+      outWriter.write(m_size);
+      outWriter.write_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, track_maximum ? period : 0);
+      outWriter.write_deque(m_minimumIndices, m_minimumIndicesHead, m_minimumIndicesSize, track_minimum ? period : 0);
+      outWriter.write(m_sum);
+      outWriter.write(m_sumOfSquares);
+      outWriter.write(m_sumXY);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double standard_deviation() const noexcept
+      requires(true == track_sum_of_squares)
+   {
+      auto const variance{this->variance(),};
+      return (0 >= variance) ? 0.0 : std::sqrt(variance);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double sum() const noexcept
+      requires(true == track_sum)
+   {
+      return (period == m_size) ? m_sum : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double variance() const noexcept
+      requires(true == track_sum_of_squares)
+   {
+      if (period == m_size) [[likely]]
+      {
+         auto const mean{m_sum * reciprocal_period,};
+         return m_sumOfSquares * reciprocal_period - mean * mean;
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr double z_score() const noexcept
+      requires(true == track_sum_of_squares)
+   {
+      if (period == m_size) [[likely]]
+      {
+         auto const variance{this->variance(),};
+         return (0 >= variance) ? 0.0 : ((newest() - m_sum * reciprocal_period) / std::sqrt(variance));
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
+private:
+   ring_buffer<double, period> m_values{};
+   std::array<uint32_t, track_maximum ? period : 0> m_maximumIndices{};
+   std::array<uint32_t, track_minimum ? period : 0> m_minimumIndices{};
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber{0,};
+#endif
+   uint32_t m_size{0,};
+   uint32_t m_maximumIndicesHead{0,};
+   uint32_t m_maximumIndicesSize{0,};
+   uint32_t m_minimumIndicesHead{0,};
+   uint32_t m_minimumIndicesSize{0,};
+   double m_sum{0,};
+   double m_sumOfSquares{0,};
+   double m_sumXY{0,};
+};
+
+template<window_statistics_features features>
+class [[maybe_unused]] window_statistics<static_cast<uint32_t>(-1), features> final
+{
+   static constexpr inline auto track_sum_of_squares{has_window_statistics_feature(features, window_statistics_features::sum_of_squares),};
+   static constexpr inline auto track_sum_xy{has_window_statistics_feature(features, window_statistics_features::sum_xy),};
+   static constexpr inline auto track_sum{track_sum_of_squares || track_sum_xy || has_window_statistics_feature(features, window_statistics_features::sum),};
+   static constexpr inline auto track_maximum{has_window_statistics_feature(features, window_statistics_features::maximum),};
+   static constexpr inline auto track_minimum{has_window_statistics_feature(features, window_statistics_features::minimum),};
+
+public:
+   window_statistics() = delete;
+   [[maybe_unused, nodiscard]] window_statistics(window_statistics &&) noexcept = default;
+   [[maybe_unused, nodiscard]] window_statistics(window_statistics const &) = default;
+
+   [[maybe_unused, nodiscard]] explicit window_statistics(uint32_t const inPeriod, std::pmr::memory_resource *const inMemoryResource = std::pmr::get_default_resource()) :
+      m_period{inPeriod,},
+      m_reciprocalPeriod{1.0 / inPeriod,},
+      m_sumX{inPeriod * (inPeriod - 1) * 0.5,},
+      m_divisor{m_sumX * m_sumX - inPeriod * ((inPeriod * (inPeriod - 1) * (2.0 * inPeriod - 1)) / 6.0),},
+      m_values{inPeriod, inMemoryResource,},
+      m_maximumIndices{track_maximum ? inPeriod : 1, inMemoryResource,},
+      m_minimumIndices{track_minimum ? inPeriod : 1, inMemoryResource,}
+   {
+      assert(1 < period());
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
+   }
+
+   [[maybe_unused]] window_statistics &operator = (window_statistics &&) noexcept = default;
+   [[maybe_unused]] window_statistics &operator = (window_statistics const &) = default;
+
+   [[maybe_unused]] void calc([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      assert(true == std::isfinite(inValue));
+      if constexpr (true == track_maximum)
+      {
+         if ((0 < m_maximumIndicesSize) && (m_values.cursor() == m_maximumIndices[m_maximumIndicesHead]))
+         {
+            m_maximumIndicesHead = m_values.wrap(m_maximumIndicesHead + 1);
+            --m_maximumIndicesSize;
+         }
+         while ((0 < m_maximumIndicesSize) && (m_values[m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize - 1)]] <= inValue))
+         {
+            --m_maximumIndicesSize;
+         }
+         m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize)] = m_values.cursor();
+         ++m_maximumIndicesSize;
+      }
+      if constexpr (true == track_minimum)
+      {
+         if ((0 < m_minimumIndicesSize) && (m_values.cursor() == m_minimumIndices[m_minimumIndicesHead]))
+         {
+            m_minimumIndicesHead = m_values.wrap(m_minimumIndicesHead + 1);
+            --m_minimumIndicesSize;
+         }
+         while ((0 < m_minimumIndicesSize) && (m_values[m_minimumIndices[m_values.wrap(m_minimumIndicesHead + m_minimumIndicesSize - 1)]] >= inValue))
+         {
+            --m_minimumIndicesSize;
+         }
+         m_minimumIndices[m_values.wrap(m_minimumIndicesHead + m_minimumIndicesSize)] = m_values.cursor();
+         ++m_minimumIndicesSize;
+      }
+      auto const prevValue{(period() == m_size) ? m_values.oldest() : 0.0,};
+      m_values.push(inValue);
+      if (period() != m_size) [[unlikely]]
+      {
+         ++m_size;
+      }
+      if constexpr (true == track_sum_xy)
+      {
+         m_sumXY += m_sum - period() * prevValue;
+      }
+      if constexpr (true == track_sum)
+      {
+         m_sum += inValue - prevValue;
+      }
+      if constexpr (true == track_sum_of_squares)
+      {
+         m_sumOfSquares += inValue * inValue - prevValue * prevValue;
+      }
+   }
+
+   [[maybe_unused, nodiscard]] linear_regression_result linear_regression() const noexcept
+      requires(true == track_sum_xy)
+   {
+      if (period() == m_size) [[likely]]
+      {
+         auto const slope{(period() * m_sumXY - m_sumX * m_sum) / m_divisor,};
+         return linear_regression_result
+         {
+            .intercept = (m_sum - slope * m_sumX) * m_reciprocalPeriod,
+            .slope = slope,
+         };
+      }
+      return linear_regression_result{};
+   }
+
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      if (
+         (true == inReader.read_header(inSequenceNumber))
+         && (true == inReader.expect(static_cast<uint32_t>(features)))
+         && (true == m_values.load(inReader))
+         && (true == inReader.read(m_size))
+         && (period() >= m_size)
+         && (true == inReader.read_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, track_maximum ? period() : 0))
+         && (true == inReader.read_deque(m_minimumIndices, m_minimumIndicesHead, m_minimumIndicesSize, track_minimum ? period() : 0))
+         && (true == inReader.read(m_sum))
+         && (true == inReader.read(m_sumOfSquares))
+         && (true == inReader.read(m_sumXY))
+      )
+      {
+#if (not defined(NDEBUG))
+         m_prevSequenceNumber = inSequenceNumber;
+#endif
+         return true;
+      }
+      return inReader.fail();
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
+   {
+      return m_period - 1;
+   }
+
+   [[maybe_unused, nodiscard]] double maximum() const noexcept
+      requires(true == track_maximum)
+   {
+      return (period() == m_size) ? m_values[m_maximumIndices[m_maximumIndicesHead]] : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] double mean() const noexcept
+      requires(true == track_sum)
+   {
+      return (period() == m_size) ? (m_sum * m_reciprocalPeriod) : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] double minimum() const noexcept
+      requires(true == track_minimum)
+   {
+      return (period() == m_size) ? m_values[m_minimumIndices[m_minimumIndicesHead]] : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] double newest() const noexcept
+   {
+      return (0 == m_size) ? std::numeric_limits<double>::signaling_NaN() : m_values[m_values.wrap(m_values.cursor() + lookback_period())];
+   }
+
+   [[maybe_unused, nodiscard]] uint32_t period() const noexcept
+   {
+      return m_period;
+   }
+
+   /// Evaluates the tracked statistics as if the value were passed to calc, the statistics of untracked features stay NaN
+   [[maybe_unused, nodiscard]] window_statistics_result pick([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) const noexcept
+   {
+#if (not defined(NDEBUG))
+      assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+      assert(true == std::isfinite(inValue));
+      window_statistics_result result{};
+      if ((period() - 1) > m_size) [[unlikely]]
+      {
+         return result;
+      }
+      /// Only the oldest value leaves the window, and only from the head of a deque
+      if constexpr (true == track_maximum)
+      {
+         auto maximumIndicesHead{m_maximumIndicesHead,};
+         auto maximumIndicesSize{m_maximumIndicesSize,};
+         if ((0 < maximumIndicesSize) && (m_values.cursor() == m_maximumIndices[maximumIndicesHead]))
+         {
+            maximumIndicesHead = m_values.wrap(maximumIndicesHead + 1);
+            --maximumIndicesSize;
+         }
+         result.maximum = (0 == maximumIndicesSize) ? inValue : std::max(m_values[m_maximumIndices[maximumIndicesHead]], inValue);
+      }
+      if constexpr (true == track_minimum)
+      {
+         auto minimumIndicesHead{m_minimumIndicesHead,};
+         auto minimumIndicesSize{m_minimumIndicesSize,};
+         if ((0 < minimumIndicesSize) && (m_values.cursor() == m_minimumIndices[minimumIndicesHead]))
+         {
+            minimumIndicesHead = m_values.wrap(minimumIndicesHead + 1);
+            --minimumIndicesSize;
+         }
+         result.minimum = (0 == minimumIndicesSize) ? inValue : std::min(m_values[m_minimumIndices[minimumIndicesHead]], inValue);
+      }
+      if constexpr (true == track_sum)
+      {
+         auto const prevValue{(period() == m_size) ? m_values.oldest() : 0.0,};
+         auto const sum{m_sum + (inValue - prevValue),};
+         result.sum = sum;
+         result.mean = sum * m_reciprocalPeriod;
+         if constexpr (true == track_sum_of_squares)
+         {
+            auto const sumOfSquares{m_sumOfSquares + (inValue * inValue - prevValue * prevValue),};
+            result.variance = sumOfSquares * m_reciprocalPeriod - result.mean * result.mean;
+            result.standard_deviation = (0 >= result.variance) ? 0.0 : std::sqrt(result.variance);
+            result.z_score = (0 >= result.variance) ? 0.0 : ((inValue - result.mean) / result.standard_deviation);
+         }
+         if constexpr (true == track_sum_xy)
+         {
+            auto const sumXY{m_sumXY + (m_sum - period() * prevValue),};
+            auto const slope{(period() * sumXY - m_sumX * sum) / m_divisor,};
+            result.linear_regression = linear_regression_result
+            {
+               .intercept = (sum - slope * m_sumX) * m_reciprocalPeriod,
+               .slope = slope,
+            };
+         }
+      }
+      return result;
+   }
+
+   [[maybe_unused]] void reset() noexcept
+   {
+      m_values.reset(std::numeric_limits<double>::signaling_NaN());
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = 0;
+#endif
+      m_size = 0;
+      m_maximumIndicesHead = 0;
+      m_maximumIndicesSize = 0;
+      m_minimumIndicesHead = 0;
+      m_minimumIndicesSize = 0;
+      m_sum = 0;
+      m_sumOfSquares = 0;
+      m_sumXY = 0;
+   }
+
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+#if (not defined(NDEBUG))
+      assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+      outWriter.write_header(inSequenceNumber);
+      outWriter.write(static_cast<uint32_t>(features));
+      m_values.save(outWriter);
+      outWriter.write(m_size);
+      outWriter.write_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, track_maximum ? period() : 0);
+      outWriter.write_deque(m_minimumIndices, m_minimumIndicesHead, m_minimumIndicesSize, track_minimum ? period() : 0);
+      outWriter.write(m_sum);
+      outWriter.write(m_sumOfSquares);
+      outWriter.write(m_sumXY);
+   }
+
+   [[maybe_unused, nodiscard]] double standard_deviation() const noexcept
+      requires(true == track_sum_of_squares)
+   {
+      auto const variance{this->variance(),};
+      return (0 >= variance) ? 0.0 : std::sqrt(variance);
+   }
+
+   [[maybe_unused, nodiscard]] double sum() const noexcept
+      requires(true == track_sum)
+   {
+      return (period() == m_size) ? m_sum : std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] double variance() const noexcept
+      requires(true == track_sum_of_squares)
+   {
+      if (period() == m_size) [[likely]]
+      {
+         auto const mean{m_sum * m_reciprocalPeriod,};
+         return m_sumOfSquares * m_reciprocalPeriod - mean * mean;
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] double z_score() const noexcept
+      requires(true == track_sum_of_squares)
+   {
+      if (period() == m_size) [[likely]]
+      {
+         auto const variance{this->variance(),};
+         return (0 >= variance) ? 0.0 : ((newest() - m_sum * m_reciprocalPeriod) / std::sqrt(variance));
+      }
+      return std::numeric_limits<double>::signaling_NaN();
+   }
+
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_values.window();
+   }
+
+private:
+   uint32_t m_period;
+   double m_reciprocalPeriod;
+   double m_sumX;
+   double m_divisor;
+   ring_buffer<double> m_values;
+   /// Untracked extrema keep a single unused slot
+   ring_buffer<uint32_t> m_maximumIndices;
+   ring_buffer<uint32_t> m_minimumIndices;
+#if (not defined(NDEBUG))
+   uint64_t m_prevSequenceNumber{0,};
+#endif
+   uint32_t m_size{0,};
+   uint32_t m_maximumIndicesHead{0,};
+   uint32_t m_maximumIndicesSize{0,};
+   uint32_t m_minimumIndicesHead{0,};
+   uint32_t m_minimumIndicesSize{0,};
+   double m_sum{0,};
+   double m_sumOfSquares{0,};
+   double m_sumXY{0,};
+};
+
+}
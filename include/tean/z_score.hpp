@@ -25,12 +25,20 @@
 
 #pragma once
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/ring_buffer.hpp" /// for tean::window_view
 #include "tean/variance.hpp" ///< for tean::variance
 
+#include <algorithm> /// for std::min
+#include <array> /// for std::array
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::sqrt
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::get_default_resource, std::pmr::memory_resource
+#include <span> /// for std::span
 
 namespace tean
 {
@@ -44,12 +52,47 @@ class [[maybe_unused]] z_score final
 public:
    static constexpr inline auto lookback_period{variance<period>::lookback_period,};
 
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit constexpr lookahead_type(z_score const &inIndicator) noexcept :
+         m_indicator{std::addressof(inIndicator),},
+         m_variance{inIndicator.m_variance.lookahead(),}
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         auto const variance{m_variance.calc(inSequenceNumber, inValue, mean),};
+         return m_indicator->variance_to_z_score(inSequenceNumber, inValue, mean, variance);
+      }
+
+   private:
+      z_score const * m_indicator;
+      typename variance<period>::lookahead_type m_variance;
+   };
+
    [[maybe_unused, nodiscard]] constexpr z_score() noexcept = default;
-   z_score(z_score &&) = delete;
-   z_score(z_score const &) = delete;
+   [[maybe_unused, nodiscard]] z_score(z_score &&) noexcept = default;
+   [[maybe_unused, nodiscard]] z_score(z_score const &) = default;
+
+   [[maybe_unused]] z_score &operator = (z_score &&) noexcept = default;
+   [[maybe_unused]] z_score &operator = (z_score const &) = default;
 
-   z_score &operator = (z_score &&) = delete;
-   z_score &operator = (z_score const &) = delete;
+   [[maybe_unused, nodiscard]] constexpr double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const variance{m_variance.amend(inSequenceNumber, inValue, mean),};
+      return variance_to_z_score(inSequenceNumber, inValue, mean, variance);
+   }
 
    [[maybe_unused, nodiscard]] constexpr double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
@@ -58,6 +101,16 @@ public:
       return variance_to_z_score(inSequenceNumber, inValue, mean, variance);
    }
 
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return m_variance.load(inSequenceNumber, inReader);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] constexpr double pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
    {
       double mean{};
@@ -65,11 +118,57 @@ public:
       return variance_to_z_score(inSequenceNumber, inValue, mean, variance);
    }
 
+   [[maybe_unused]] constexpr void pick_many(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<double> const outValues) const noexcept
+   {
+      assert(inValues.size() == outValues.size());
+      /// Means are staged in a stack chunk, the variances go straight to the output
+      std::array<double, 64> means{};
+      for (size_t chunkBegin{0,}; chunkBegin < inValues.size(); chunkBegin += means.size())
+      {
+         auto const chunkSize{std::min(means.size(), inValues.size() - chunkBegin),};
+         auto const chunkValues{inValues.subspan(chunkBegin, chunkSize),};
+         auto const chunkOutValues{outValues.subspan(chunkBegin, chunkSize),};
+         m_variance.pick_many(inSequenceNumber, chunkValues, chunkOutValues, std::span{means}.first(chunkSize));
+         if (lookback_period > inSequenceNumber) [[unlikely]]
+         {
+            continue;
+         }
+         for (size_t valueIndex{0,}; valueIndex < chunkSize; ++valueIndex)
+         {
+            auto const variance{chunkOutValues[valueIndex],};
+            assert(true == std::isfinite(variance));
+            chunkOutValues[valueIndex] = (0 >= variance) ? 0.0 : ((chunkValues[valueIndex] - means[valueIndex]) / std::sqrt(variance));
+         }
+      }
+   }
+
    [[maybe_unused]] constexpr void reset() noexcept
    {
       m_variance.reset();
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      m_variance.save(inSequenceNumber, outWriter);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number, see variance::skip
+   [[maybe_unused]] constexpr void skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+   {
+      m_variance.skip(inSequenceNumber, inGap, inFill);
+   }
+
+   /// Value whose pick yields the given z-score, NaN when out of reach, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] constexpr double solve(uint64_t const inSequenceNumber, double const inZScore) const noexcept
+   {
+      return m_variance.solve_z_score(inSequenceNumber, inZScore);
+   }
+
+   [[maybe_unused, nodiscard]] constexpr window_view<double> window() const noexcept
+   {
+      return m_variance.window();
+   }
+
 private:
    variance<period> m_variance;
 
@@ -94,16 +193,51 @@ template<>
 class [[maybe_unused]] z_score<static_cast<uint32_t>(-1)> final
 {
 public:
+   /// Evaluates up to period hypothetical values following the latest calc, the indicator must stay unchanged meanwhile
+   class [[nodiscard]] lookahead_type final
+   {
+   public:
+      lookahead_type() = delete;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type &&) noexcept = default;
+      [[maybe_unused, nodiscard]] lookahead_type(lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] explicit lookahead_type(z_score const &inIndicator) noexcept :
+         m_indicator(std::addressof(inIndicator)),
+         m_variance(inIndicator.m_variance.lookahead())
+      {}
+
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type &&) noexcept = default;
+      [[maybe_unused]] lookahead_type &operator = (lookahead_type const &) noexcept = default;
+
+      [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+      {
+         double mean{};
+         auto const variance{m_variance.calc(inSequenceNumber, inValue, mean),};
+         return m_indicator->variance_to_z_score(inSequenceNumber, inValue, mean, variance);
+      }
+
+   private:
+      z_score const * m_indicator;
+      variance<>::lookahead_type m_variance;
+   };
+
    z_score() = delete;
-   z_score(z_score &&) = delete;
-   z_score(z_score const &) = delete;
+   [[maybe_unused, nodiscard]] z_score(z_score &&) noexcept = default;
+   [[maybe_unused, nodiscard]] z_score(z_score const &) = default;
 
-   [[maybe_unused, nodiscard]] explicit z_score(uint32_t const inPeriod) noexcept :
-      m_variance(inPeriod)
+   [[maybe_unused, nodiscard]] explicit z_score(uint32_t const inPeriod, std::pmr::memory_resource *const inMemoryResource = std::pmr::get_default_resource()) noexcept :
+      m_variance(inPeriod, 0, inMemoryResource)
    {}
 
-   z_score &operator = (z_score &&) = delete;
-   z_score &operator = (z_score const &) = delete;
+   [[maybe_unused]] z_score &operator = (z_score &&) noexcept = default;
+   [[maybe_unused]] z_score &operator = (z_score const &) = default;
+
+   [[maybe_unused, nodiscard]] double amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+   {
+      double mean{};
+      auto const variance{m_variance.amend(inSequenceNumber, inValue, mean),};
+      return variance_to_z_score(inSequenceNumber, inValue, mean, variance);
+   }
 
    [[maybe_unused, nodiscard]] double calc(uint64_t const inSequenceNumber, double const inValue) noexcept
    {
@@ -112,6 +246,16 @@ public:
       return variance_to_z_score(inSequenceNumber, inValue, mean, variance);
    }
 
+   [[maybe_unused, nodiscard]] bool load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+   {
+      return m_variance.load(inSequenceNumber, inReader);
+   }
+
+   [[maybe_unused, nodiscard]] lookahead_type lookahead() const noexcept
+   {
+      return lookahead_type{*this,};
+   }
+
    [[maybe_unused, nodiscard]] uint32_t lookback_period() const noexcept
    {
       return m_variance.lookback_period();
@@ -129,11 +273,57 @@ public:
       return variance_to_z_score(inSequenceNumber, inValue, mean, variance);
    }
 
+   [[maybe_unused]] void pick_many(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<double> const outValues) const noexcept
+   {
+      assert(inValues.size() == outValues.size());
+      /// Means are staged in a stack chunk, the variances go straight to the output
+      std::array<double, 64> means{};
+      for (size_t chunkBegin{0,}; chunkBegin < inValues.size(); chunkBegin += means.size())
+      {
+         auto const chunkSize{std::min(means.size(), inValues.size() - chunkBegin),};
+         auto const chunkValues{inValues.subspan(chunkBegin, chunkSize),};
+         auto const chunkOutValues{outValues.subspan(chunkBegin, chunkSize),};
+         m_variance.pick_many(inSequenceNumber, chunkValues, chunkOutValues, std::span{means}.first(chunkSize));
+         if (lookback_period() > inSequenceNumber) [[unlikely]]
+         {
+            continue;
+         }
+         for (size_t valueIndex{0,}; valueIndex < chunkSize; ++valueIndex)
+         {
+            auto const variance{chunkOutValues[valueIndex],};
+            assert(true == std::isfinite(variance));
+            chunkOutValues[valueIndex] = (0 >= variance) ? 0.0 : ((chunkValues[valueIndex] - means[valueIndex]) / std::sqrt(variance));
+         }
+      }
+   }
+
    [[maybe_unused]] void reset() noexcept
    {
       m_variance.reset();
    }
 
+   [[maybe_unused]] void save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+   {
+      m_variance.save(inSequenceNumber, outWriter);
+   }
+
+   /// Advances over a gap of missing bars starting at the given sequence number, see variance::skip
+   [[maybe_unused]] void skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+   {
+      m_variance.skip(inSequenceNumber, inGap, inFill);
+   }
+
+   /// Value whose pick yields the given z-score, NaN when out of reach, see variance::solve_z_score
+   [[maybe_unused, nodiscard]] double solve(uint64_t const inSequenceNumber, double const inZScore) const noexcept
+   {
+      return m_variance.solve_z_score(inSequenceNumber, inZScore);
+   }
+
+   [[maybe_unused, nodiscard]] window_view<double> window() const noexcept
+   {
+      return m_variance.window();
+   }
+
 private:
    variance<> m_variance;
 
@@ -24,6 +24,7 @@
 */
 
 #include "tean/accumulation_distribution_line.hpp" /// for tean::accumulation_distribution_line
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::isnan
@@ -32,6 +33,27 @@
 namespace tean
 {
 
+double accumulation_distribution_line::amend([[maybe_unused]] uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inHigh));
+   assert(false == std::isnan(inHigh));
+   assert(true == std::isfinite(inLow));
+   assert(false == std::isnan(inLow));
+   assert(true == std::isfinite(inClose));
+   assert(false == std::isnan(inClose));
+   assert(true == std::isfinite(inVolume));
+   assert(false == std::isnan(inVolume));
+   assert(inHigh >= inLow);
+   assert(inHigh >= inClose);
+   assert(inClose >= inLow);
+   assert(0.0 <= inVolume);
+   m_value = m_prevValue;
+   return do_calc(inHigh, inLow, inClose, inVolume);
+}
+
 double accumulation_distribution_line::calc([[maybe_unused]] uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) noexcept
 {
 #if (not defined(NDEBUG))
@@ -50,15 +72,20 @@ double accumulation_distribution_line::calc([[maybe_unused]] uint64_t const inSe
    assert(inHigh >= inClose);
    assert(inClose >= inLow);
    assert(0.0 <= inVolume);
-   auto const body = inHigh - inLow;
-   if (0.0 < body)
+   m_prevValue = m_value;
+   return do_calc(inHigh, inLow, inClose, inVolume);
+}
+
+bool accumulation_distribution_line::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if ((true == inReader.read_header(inSequenceNumber)) && (true == inReader.read(m_value)) && (true == inReader.read(m_prevValue)))
    {
-      auto const value = inVolume * ((inClose - inLow) - (inHigh - inClose)) / body;
-      assert(true == std::isfinite(value));
-      assert(false == std::isnan(value));
-      m_value += value;
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
    }
-   return m_value;
+   return false;
 }
 
 double accumulation_distribution_line::pick([[maybe_unused]] uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose, double const inVolume) const noexcept
@@ -89,4 +116,49 @@ double accumulation_distribution_line::pick([[maybe_unused]] uint64_t const inSe
    return m_value;
 }
 
+void accumulation_distribution_line::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_value);
+   outWriter.write(m_prevValue);
+}
+
+double accumulation_distribution_line::skip([[maybe_unused]] uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+{
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   if (gap_fill::carry_forward == inFill)
+   {
+      /// The line keeps the money flow volume of the latest bar, so it stays the difference between the value and the previous one
+      auto const moneyFlowVolume = money_flow_volume();
+      m_prevValue = m_value + moneyFlowVolume * static_cast<double>(inGap - 1);
+      m_value = m_prevValue + moneyFlowVolume;
+   }
+   else
+   {
+      m_prevValue = m_value;
+   }
+   return m_value;
+}
+
+double accumulation_distribution_line::do_calc(double const inHigh, double const inLow, double const inClose, double const inVolume) noexcept
+{
+   auto const body = inHigh - inLow;
+   if (0.0 < body)
+   {
+      auto const value = inVolume * ((inClose - inLow) - (inHigh - inClose)) / body;
+      assert(true == std::isfinite(value));
+      assert(false == std::isnan(value));
+      m_value += value;
+   }
+   return m_value;
+}
+
 }
@@ -24,30 +24,33 @@
 */
 
 #include "tean/accumulation_distribution_oscillator.hpp" /// for tean::accumulation_distribution_oscillator
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite, std::isnan
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
 
 namespace tean
 {
 
-accumulation_distribution_oscillator::accumulation_distribution_oscillator(uint32_t const inFastPeriod, uint32_t const inSlowPeriod, uint32_t const inUntrustedPeriod) noexcept :
+accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)>::accumulation_distribution_oscillator(uint32_t const inFastPeriod, uint32_t const inSlowPeriod, uint32_t const inUntrustedPeriod) noexcept :
    m_period(inSlowPeriod),
    m_lookbackPeriod(inUntrustedPeriod + inSlowPeriod - 1),
    m_fastSmoothingFactor(2.0 / static_cast<double>(inFastPeriod + 1)),
    m_slowSmoothingFactor(2.0 / static_cast<double>(inSlowPeriod + 1)),
    m_accumulationDistributionLine(),
    m_fastMovingAverage(0.0),
-   m_slowMovingAverage(0.0)
+   m_slowMovingAverage(0.0),
+   m_prevFastMovingAverage(0.0),
+   m_prevSlowMovingAverage(0.0)
 {
    assert(1 < inFastPeriod);
    assert(inFastPeriod < inSlowPeriod);
    assert((inSlowPeriod - 1) <= lookback_period());
 }
 
-double accumulation_distribution_oscillator::do_calc(uint64_t const inSequenceNumber, double const inAccumulationDistribution) noexcept
+double accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)>::do_calc(uint64_t const inSequenceNumber, double const inAccumulationDistribution) noexcept
 {
    assert(true == std::isfinite(inAccumulationDistribution));
    assert(false == std::isnan(inAccumulationDistribution));
@@ -68,7 +71,7 @@ double accumulation_distribution_oscillator::do_calc(uint64_t const inSequenceNu
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-double accumulation_distribution_oscillator::do_pick(uint64_t const inSequenceNumber, double const inAccumulationDistribution) const noexcept
+double accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)>::do_pick(uint64_t const inSequenceNumber, double const inAccumulationDistribution) const noexcept
 {
    assert(true == std::isfinite(inAccumulationDistribution));
    assert(false == std::isnan(inAccumulationDistribution));
@@ -81,4 +84,56 @@ double accumulation_distribution_oscillator::do_pick(uint64_t const inSequenceNu
    return std::numeric_limits<double>::signaling_NaN();
 }
 
+double accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)>::do_skip(
+   double const inMovingAverage,
+   double const inSmoothingFactor,
+   double const inAccumulationDistribution,
+   double const inMoneyFlowVolume,
+   uint64_t const inGap
+) noexcept
+{
+   auto const lag = inMoneyFlowVolume * (1.0 - inSmoothingFactor) / inSmoothingFactor;
+   auto const prevAccumulationDistribution = inAccumulationDistribution - inMoneyFlowVolume * static_cast<double>(inGap);
+   auto const decay = std::pow(1.0 - inSmoothingFactor, static_cast<double>(inGap));
+   return inAccumulationDistribution - lag + decay * (inMovingAverage - prevAccumulationDistribution + lag);
+}
+
+bool accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   return (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_lookbackPeriod))
+      && (true == inReader.expect(m_fastSmoothingFactor))
+      && (true == inReader.expect(m_slowSmoothingFactor))
+      && (true == m_accumulationDistributionLine.load(inSequenceNumber, inReader))
+      && (true == inReader.read(m_fastMovingAverage))
+      && (true == inReader.read(m_slowMovingAverage))
+      && (true == inReader.read(m_prevFastMovingAverage))
+      && (true == inReader.read(m_prevSlowMovingAverage))
+   );
+}
+
+void accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_lookbackPeriod);
+   outWriter.write(m_fastSmoothingFactor);
+   outWriter.write(m_slowSmoothingFactor);
+   m_accumulationDistributionLine.save(inSequenceNumber, outWriter);
+   outWriter.write(m_fastMovingAverage);
+   outWriter.write(m_slowMovingAverage);
+   outWriter.write(m_prevFastMovingAverage);
+   outWriter.write(m_prevSlowMovingAverage);
+}
+
+void accumulation_distribution_oscillator<static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+{
+   m_prevFastMovingAverage = std::numeric_limits<double>::signaling_NaN();
+   m_prevSlowMovingAverage = std::numeric_limits<double>::signaling_NaN();
+   auto const accumulationDistribution = m_accumulationDistributionLine.skip(inSequenceNumber, inGap, inFill);
+   auto const moneyFlowVolume = m_accumulationDistributionLine.money_flow_volume();
+   m_fastMovingAverage = do_skip(m_fastMovingAverage, m_fastSmoothingFactor, accumulationDistribution, moneyFlowVolume, inGap);
+   m_slowMovingAverage = do_skip(m_slowMovingAverage, m_slowSmoothingFactor, accumulationDistribution, moneyFlowVolume, inGap);
+}
+
 }
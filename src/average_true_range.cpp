@@ -24,26 +24,29 @@
 */
 
 #include "tean/average_true_range.hpp" /// for tean::average_true_range
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 #include "tean/true_range.hpp" /// for tean::true_range
 
+#include <algorithm> /// for std::min
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite, std::isnan
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
 
 namespace tean
 {
 
-average_true_range::average_true_range(uint32_t const inPeriod, uint32_t const inUntrustedPeriod) noexcept :
+average_true_range<static_cast<uint32_t>(-1)>::average_true_range(uint32_t const inPeriod, uint32_t const inUntrustedPeriod) noexcept :
    m_period(inPeriod),
    m_lookbackPeriod(inUntrustedPeriod + inPeriod),
    m_trueRange(),
-   m_value(0.0)
+   m_value(0.0),
+   m_prevValue(0.0)
 {
    assert(m_trueRange.lookback_period() < period());
 }
 
-double average_true_range::do_calc(uint64_t const inSequenceNumber, double const inTrueRange) noexcept
+double average_true_range<static_cast<uint32_t>(-1)>::do_calc(uint64_t const inSequenceNumber, double const inTrueRange) noexcept
 {
    if (m_trueRange.lookback_period() <= inSequenceNumber) [[likely]]
    {
@@ -77,7 +80,7 @@ double average_true_range::do_calc(uint64_t const inSequenceNumber, double const
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-double average_true_range::do_pick(uint64_t const inSequenceNumber, double const inTrueRange) const noexcept
+double average_true_range<static_cast<uint32_t>(-1)>::do_pick(uint64_t const inSequenceNumber, double const inTrueRange) const noexcept
 {
    if (lookback_period() <= inSequenceNumber) [[likely]]
    {
@@ -93,4 +96,49 @@ double average_true_range::do_pick(uint64_t const inSequenceNumber, double const
    return std::numeric_limits<double>::signaling_NaN();
 }
 
+bool average_true_range<static_cast<uint32_t>(-1)>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   return (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_period))
+      && (true == inReader.expect(m_lookbackPeriod))
+      && (true == m_trueRange.load(inSequenceNumber, inReader))
+      && (true == inReader.read(m_value))
+      && (true == inReader.read(m_prevValue))
+   );
+}
+
+void average_true_range<static_cast<uint32_t>(-1)>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_period);
+   outWriter.write(m_lookbackPeriod);
+   m_trueRange.save(inSequenceNumber, outWriter);
+   outWriter.write(m_value);
+   outWriter.write(m_prevValue);
+}
+
+void average_true_range<static_cast<uint32_t>(-1)>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+{
+   m_prevValue = std::numeric_limits<double>::signaling_NaN();
+   auto const trueRange = m_trueRange.skip(inSequenceNumber, inGap, inFill);
+   auto smoothedNumber = inGap;
+   if (period() >= inSequenceNumber)
+   {
+      /// The seed sums the true ranges up to the period-th bar
+      auto const seedNumber = std::min<uint64_t>(inGap, period() + 1 - inSequenceNumber);
+      smoothedNumber -= seedNumber;
+      m_value += trueRange * static_cast<double>(seedNumber);
+      if (period() < (inSequenceNumber + seedNumber))
+      {
+         m_value /= static_cast<double>(period());
+      }
+   }
+   if (0 < smoothedNumber)
+   {
+      auto const decay = std::pow(1.0 - 1.0 / static_cast<double>(period()), static_cast<double>(smoothedNumber));
+      m_value = trueRange + decay * (m_value - trueRange);
+   }
+}
+
 }
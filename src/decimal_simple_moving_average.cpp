@@ -0,0 +1,52 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "tean/decimal_simple_moving_average.hpp" /// for tean::decimal_simple_moving_average
+
+#include <cstdint> /// for int64_t, uint64_t
+#include <limits> /// for std::numeric_limits
+
+namespace tean
+{
+
+double decimal_simple_moving_average::do_calc(uint64_t const inSequenceNumber, int64_t const inSumOverPeriod) noexcept
+{
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      return static_cast<double>(inSumOverPeriod) / m_divisor;
+   }
+   return std::numeric_limits<double>::signaling_NaN();
+}
+
+double decimal_simple_moving_average::do_pick(uint64_t const inSequenceNumber, int64_t const inSumOverPeriod) const noexcept
+{
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      return static_cast<double>(inSumOverPeriod) / m_divisor;
+   }
+   return std::numeric_limits<double>::signaling_NaN();
+}
+
+}
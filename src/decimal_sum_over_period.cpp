@@ -0,0 +1,109 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "tean/decimal.hpp" /// for tean::scale_to_divisor
+#include "tean/decimal_sum_over_period.hpp" /// for tean::decimal_sum_over_period
+
+#include <cassert> /// for assert
+#include <cstdint> /// for int64_t, uint32_t, uint64_t, uint8_t
+#include <memory_resource> /// for std::pmr::memory_resource
+
+namespace tean
+{
+
+decimal_sum_over_period::decimal_sum_over_period(uint32_t const inPeriod, uint8_t const inScale, std::pmr::memory_resource *const inMemoryResource) :
+   m_period(inPeriod),
+   m_lookbackPeriod(inPeriod - 1),
+   m_scale(inScale),
+   m_divisor(scale_to_divisor(inScale)),
+   m_values(inPeriod, inMemoryResource),
+#if (not defined(NDEBUG))
+   m_prevSequenceNumber(0),
+#endif
+   m_sum(0)
+{
+   assert(1 < period());
+   m_values.reset(0);
+}
+
+double decimal_sum_over_period::calc([[maybe_unused]] uint64_t const inSequenceNumber, int64_t const inValue, int64_t &outSum) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   auto const prevValue = m_values.exchange(inValue);
+   m_sum += inValue - prevValue;
+   outSum = m_sum;
+   return static_cast<double>(m_sum) / m_divisor;
+}
+
+bool decimal_sum_over_period::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_scale))
+      && (true == m_values.load(inReader))
+      && (true == inReader.read(m_sum))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
+double decimal_sum_over_period::pick([[maybe_unused]] uint64_t const inSequenceNumber, int64_t const inValue, int64_t &outSum) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   outSum = inValue - m_values.oldest() + m_sum;
+   return static_cast<double>(outSum) / m_divisor;
+}
+
+void decimal_sum_over_period::reset() noexcept
+{
+   m_values.reset(0);
+#if (not defined(NDEBUG))
+   m_prevSequenceNumber = 0;
+#endif
+   m_sum = 0;
+}
+
+void decimal_sum_over_period::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_scale);
+   m_values.save(outWriter);
+   outWriter.write(m_sum);
+}
+
+}
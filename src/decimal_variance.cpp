@@ -0,0 +1,133 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "tean/decimal.hpp" /// for tean::int128_t, tean::scale_to_divisor
+#include "tean/decimal_variance.hpp" /// for tean::decimal_variance
+
+#include <cassert> /// for assert
+#include <cstdint> /// for int64_t, uint32_t, uint64_t, uint8_t
+#include <limits> /// for std::numeric_limits
+#include <memory_resource> /// for std::pmr::memory_resource
+
+namespace tean
+{
+
+decimal_variance::decimal_variance(uint32_t const inPeriod, uint8_t const inScale, std::pmr::memory_resource *const inMemoryResource) :
+   m_period{inPeriod,},
+   m_lookbackPeriod{inPeriod - 1,},
+   m_scale{inScale,},
+   m_meanDivisor{inPeriod * scale_to_divisor(inScale),},
+   m_varianceDivisor{inPeriod * scale_to_divisor(inScale) * inPeriod * scale_to_divisor(inScale),},
+   m_values{inPeriod - 1, inMemoryResource,}
+{
+   assert(1 < period());
+}
+
+double decimal_variance::calc(uint64_t const inSequenceNumber, int64_t const inValue, double &outMean) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(((-std::numeric_limits<int64_t>::max() / period()) <= inValue) && ((std::numeric_limits<int64_t>::max() / period()) >= inValue));
+   m_sum += inValue;
+   m_sumOfSquares += static_cast<int128_t>(inValue) * inValue;
+   /// The ring holds the n - 1 values preceding the next one, the oldest leaves the sums once the window is complete
+   auto const prevValue{m_values.exchange(inValue),};
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      auto const result{do_calc(m_sum, m_sumOfSquares, outMean),};
+      m_sum -= prevValue;
+      m_sumOfSquares -= static_cast<int128_t>(prevValue) * prevValue;
+      return result;
+   }
+   outMean = std::numeric_limits<double>::signaling_NaN();
+   return std::numeric_limits<double>::signaling_NaN();
+}
+
+bool decimal_variance::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_scale))
+      && (true == m_values.load(inReader))
+      && (true == inReader.read(m_sum))
+      && (true == inReader.read(m_sumOfSquares))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
+double decimal_variance::pick(uint64_t const inSequenceNumber, int64_t const inValue, double &outMean) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(((-std::numeric_limits<int64_t>::max() / period()) <= inValue) && ((std::numeric_limits<int64_t>::max() / period()) >= inValue));
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      return do_calc(m_sum + inValue, m_sumOfSquares + static_cast<int128_t>(inValue) * inValue, outMean);
+   }
+   outMean = std::numeric_limits<double>::signaling_NaN();
+   return std::numeric_limits<double>::signaling_NaN();
+}
+
+void decimal_variance::reset() noexcept
+{
+   m_values.reset(0);
+   m_sum = 0;
+   m_sumOfSquares = 0;
+#if (not defined(NDEBUG))
+   m_prevSequenceNumber = 0;
+#endif
+}
+
+void decimal_variance::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_scale);
+   m_values.save(outWriter);
+   outWriter.write(m_sum);
+   outWriter.write(m_sumOfSquares);
+}
+
+double decimal_variance::do_calc(int64_t const inSum, int128_t const inSumOfSquares, double &outMean) const noexcept
+{
+   /// period * sum(x^2) - sum(x)^2 is exact in the integer domain and never negative
+   auto const numerator{inSumOfSquares * period() - static_cast<int128_t>(inSum) * inSum,};
+   assert(0 <= numerator);
+   outMean = static_cast<double>(inSum) / m_meanDivisor;
+   return static_cast<double>(numerator) / m_varianceDivisor;
+}
+
+}
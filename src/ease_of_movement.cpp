@@ -58,6 +58,18 @@ double ease_of_movement::calc(uint64_t const inSequenceNumber, double const inHi
    return emv;
 }
 
+bool ease_of_movement::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if ((true == inReader.read_header(inSequenceNumber)) && (true == inReader.read(m_mean)))
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
 double ease_of_movement::pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inVolume) const noexcept
 {
 #if (not defined(NDEBUG))
@@ -80,4 +92,13 @@ double ease_of_movement::pick(uint64_t const inSequenceNumber, double const inHi
    return std::numeric_limits<double>::signaling_NaN();
 }
 
+void ease_of_movement::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_mean);
+}
+
 }
@@ -25,29 +25,45 @@
 
 #include "tean/exponential_moving_average.hpp" /// for tean::exponential_moving_average
 
+#include <algorithm> /// for std::min
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite, std::isnan
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
 
 namespace tean
 {
 
-exponential_moving_average::exponential_moving_average(uint32_t const inPeriod, uint32_t const inUntrustedPeriod, double const inSmoothing) noexcept :
+exponential_moving_average<static_cast<uint32_t>(-1)>::exponential_moving_average(uint32_t const inPeriod, uint32_t const inUntrustedPeriod, double const inSmoothing) noexcept :
    m_period(inPeriod),
    m_lookbackPeriod(inUntrustedPeriod + inPeriod - 1),
    m_smoothingFactor(inSmoothing / static_cast<double>(inPeriod + 1)),
 #if (not defined(NDEBUG))
    m_prevSequenceNumber(0),
 #endif
-   m_value(0.0)
+   m_value(0.0),
+   m_prevValue(0.0),
+   m_latestValue(0.0)
 {
    assert(true == std::isfinite(inSmoothing));
    assert(false == std::isnan(inSmoothing));
    assert(1 < period());
 }
 
-double exponential_moving_average::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+double exponential_moving_average<static_cast<uint32_t>(-1)>::amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   /// A skip leaves no calc to amend
+   assert(false == std::isnan(m_prevValue));
+   m_value = m_prevValue;
+   return do_calc(inSequenceNumber, inValue);
+}
+
+double exponential_moving_average<static_cast<uint32_t>(-1)>::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -55,6 +71,13 @@ double exponential_moving_average::calc(uint64_t const inSequenceNumber, double
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
+   m_prevValue = m_value;
+   return do_calc(inSequenceNumber, inValue);
+}
+
+double exponential_moving_average<static_cast<uint32_t>(-1)>::do_calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+   m_latestValue = inValue;
    if (period() <= inSequenceNumber) [[likely]]
    {
       m_value += m_smoothingFactor * (inValue - m_value);
@@ -78,7 +101,27 @@ double exponential_moving_average::calc(uint64_t const inSequenceNumber, double
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-double exponential_moving_average::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+bool exponential_moving_average<static_cast<uint32_t>(-1)>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_period))
+      && (true == inReader.expect(m_lookbackPeriod))
+      && (true == inReader.expect(m_smoothingFactor))
+      && (true == inReader.read(m_value))
+      && (true == inReader.read(m_prevValue))
+      && (true == inReader.read(m_latestValue))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
+double exponential_moving_average<static_cast<uint32_t>(-1)>::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -96,4 +139,46 @@ double exponential_moving_average::pick(uint64_t const inSequenceNumber, double
    return std::numeric_limits<double>::signaling_NaN();
 }
 
+void exponential_moving_average<static_cast<uint32_t>(-1)>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_period);
+   outWriter.write(m_lookbackPeriod);
+   outWriter.write(m_smoothingFactor);
+   outWriter.write(m_value);
+   outWriter.write(m_prevValue);
+   outWriter.write(m_latestValue);
+}
+
+void exponential_moving_average<static_cast<uint32_t>(-1)>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, gap_fill const inFill) noexcept
+{
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   m_prevValue = std::numeric_limits<double>::signaling_NaN();
+   m_latestValue = (gap_fill::decay_only == inFill) ? 0.0 : m_latestValue;
+   auto smoothedNumber = inGap;
+   if (period() > inSequenceNumber)
+   {
+      /// The seed sums the first period inputs
+      auto const seedNumber = std::min<uint64_t>(inGap, period() - inSequenceNumber);
+      smoothedNumber -= seedNumber;
+      m_value += m_latestValue * static_cast<double>(seedNumber);
+      if (period() == (inSequenceNumber + seedNumber))
+      {
+         m_value /= static_cast<double>(period());
+      }
+   }
+   if (0 < smoothedNumber)
+   {
+      m_value = m_latestValue + std::pow(1.0 - m_smoothingFactor, static_cast<double>(smoothedNumber)) * (m_value - m_latestValue);
+   }
+}
+
 }
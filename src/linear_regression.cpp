@@ -24,14 +24,16 @@
 */
 
 #include "tean/linear_regression.hpp" /// for tean::linear_regression
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
-#include <algorithm> /// for std::ranges::fill
+#include <algorithm> /// for std::max, std::min
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite
-#include <cstdint> /// for int32_t, uint32_t, uint64_t
+#include <cmath> /// for std::isfinite, std::sqrt
+#include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <memory> /// for std::make_unique
-#include <span> /// for std::span
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::memory_resource
+#include <utility> /// for std::exchange
 
 namespace tean
 {
@@ -51,58 +53,330 @@ static double period_to_sum_square_x(uint32_t const inPeriod) noexcept
 
 }
 
-linear_regression<static_cast<uint32_t>(-1)>::linear_regression(uint32_t const inPeriod) :
+template<uint32_t inline_capacity>
+linear_regression<static_cast<uint32_t>(-1), inline_capacity>::linear_regression(uint32_t const inPeriod, uint32_t const inResummationPeriod, std::pmr::memory_resource *const inMemoryResource) :
    m_period{inPeriod,},
    m_lookbackPeriod{inPeriod - 1,},
+   m_resummationPeriod{inResummationPeriod,},
    m_sumX{period_to_sum_x(inPeriod),},
    m_divisor{period_to_sum_x(inPeriod) * period_to_sum_x(inPeriod) - inPeriod * period_to_sum_square_x(inPeriod),},
-   m_yValues{std::make_unique<double[]>(inPeriod),}
+   m_yValues{inPeriod, inMemoryResource,}
 {
    assert(1 < period());
+   assert(0 < resummation_period());
 #if (not defined(NDEBUG))
-   std::ranges::fill(std::span{m_yValues.get(), period(),}, std::numeric_limits<double>::signaling_NaN());
+   m_yValues.reset(std::numeric_limits<double>::signaling_NaN());
 #endif
 }
 
-linear_regression_result linear_regression<static_cast<uint32_t>(-1)>::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+template<uint32_t inline_capacity>
+linear_regression_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::amend(uint64_t const inSequenceNumber, double const inValue) noexcept
 {
-#if (not defined(NDEBUG))
-   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
-   m_prevSequenceNumber = inSequenceNumber;
-#endif
-   assert(true == std::isfinite(inValue));
-   m_yValues[inSequenceNumber % period()] = inValue;
-   if (lookback_period() <= inSequenceNumber) [[likely]]
+   if (true == do_amend(inSequenceNumber, inValue)) [[likely]]
+   {
+      return do_calc(m_sumY, m_sumXY);
+   }
+   return linear_regression_result{};
+}
+
+template<uint32_t inline_capacity>
+linear_regression_extended_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::amend_extended(
+   uint64_t const inSequenceNumber,
+   double const inValue,
+   double const inChannelWidth
+) noexcept
+{
+   assert(true == std::isfinite(inChannelWidth));
+   if (true == do_amend(inSequenceNumber, inValue)) [[likely]]
+   {
+      return do_calc_extended(m_sumY, m_sumXY, m_sumSquareY, inChannelWidth);
+   }
+   return linear_regression_extended_result{};
+}
+
+template<uint32_t inline_capacity>
+linear_regression_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+   if (true == do_update(inSequenceNumber, inValue)) [[likely]]
    {
-      return do_calc(inSequenceNumber);
+      return do_calc(m_sumY, m_sumXY);
    }
    return linear_regression_result{};
 }
 
-void linear_regression<static_cast<uint32_t>(-1)>::reset() noexcept
+template<uint32_t inline_capacity>
+linear_regression_extended_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::calc_extended(
+   uint64_t const inSequenceNumber,
+   double const inValue,
+   double const inChannelWidth
+) noexcept
+{
+   assert(true == std::isfinite(inChannelWidth));
+   if (true == do_update(inSequenceNumber, inValue)) [[likely]]
+   {
+      return do_calc_extended(m_sumY, m_sumXY, m_sumSquareY, inChannelWidth);
+   }
+   return linear_regression_extended_result{};
+}
+
+template<uint32_t inline_capacity>
+bool linear_regression<static_cast<uint32_t>(-1), inline_capacity>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_resummationPeriod))
+      && (true == m_yValues.load(inReader))
+      && (true == inReader.read(m_resummationCountdown))
+      && (true == inReader.read(m_sumY))
+      && (true == inReader.read(m_sumXY))
+      && (true == inReader.read(m_sumSquareY))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
+template<uint32_t inline_capacity>
+void linear_regression<static_cast<uint32_t>(-1), inline_capacity>::reset() noexcept
 {
+   m_yValues.seek(0);
 #if (not defined(NDEBUG))
-   std::ranges::fill(std::span{m_yValues.get(), period(),}, std::numeric_limits<double>::signaling_NaN());
+   m_yValues.reset(std::numeric_limits<double>::signaling_NaN());
    m_prevSequenceNumber = 0;
 #endif
 }
 
-linear_regression_result linear_regression<static_cast<uint32_t>(-1)>::do_calc(uint64_t const inSequenceNumber) noexcept
+template<uint32_t inline_capacity>
+void linear_regression<static_cast<uint32_t>(-1), inline_capacity>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_resummationPeriod);
+   m_yValues.save(outWriter);
+   outWriter.write(m_resummationCountdown);
+   outWriter.write(m_sumY);
+   outWriter.write(m_sumXY);
+   outWriter.write(m_sumSquareY);
+}
+
+template<uint32_t inline_capacity>
+void linear_regression<static_cast<uint32_t>(-1), inline_capacity>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+{
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   assert(gap_fill::decay_only != inFill);
+   auto const yValue{m_yValues.newest(),};
+   auto const yValuesNumber{std::min<uint64_t>(inGap, period()),};
+   for (auto sequenceNumber{inSequenceNumber,}; sequenceNumber < (inSequenceNumber + yValuesNumber); ++sequenceNumber)
+   {
+      [[maybe_unused]] auto const ready{do_update(sequenceNumber, yValue),};
+   }
+   if (inGap > yValuesNumber)
+   {
+      /// Once the window only holds copies of the value, the rest of the gap leaves the sums as is and only the resummation schedule moves on
+      auto const restNumber{inGap - yValuesNumber,};
+      if (m_resummationCountdown <= restNumber)
+      {
+         do_sum();
+      }
+      else
+      {
+         m_resummationCountdown -= static_cast<uint32_t>(restNumber);
+      }
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   }
+}
+
+template<uint32_t inline_capacity>
+bool linear_regression<static_cast<uint32_t>(-1), inline_capacity>::do_amend(uint64_t const inSequenceNumber, double const inValue) noexcept
 {
-   double sumY{0,};
-   double sumXY{0,};
-   for (auto x{static_cast<int32_t>(period()),}; 0 != x--; )
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inValue));
+   auto const yValue{std::exchange(m_yValues.newest(), inValue),};
+   if (lookback_period() <= inSequenceNumber) [[likely]]
    {
-      auto const y{m_yValues[(inSequenceNumber - x) % period()],};
-      sumY += y;
-      sumXY += x * y;
+      m_sumY += inValue - yValue;
+      m_sumSquareY += inValue * inValue - yValue * yValue;
+      return true;
    }
-   auto const slope{(period() * sumXY - m_sumX * sumY) / m_divisor,};
+   return false;
+}
+
+template<uint32_t inline_capacity>
+linear_regression_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::do_calc(double const inSumY, double const inSumXY) const noexcept
+{
+   auto const slope{(period() * inSumXY - m_sumX * inSumY) / m_divisor,};
    return linear_regression_result
    {
-      .intercept = (sumY - slope * m_sumX) / period(),
+      .intercept = (inSumY - slope * m_sumX) / period(),
       .slope = slope,
    };
 }
 
+template<uint32_t inline_capacity>
+linear_regression_extended_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::do_calc_extended(
+   double const inSumY,
+   double const inSumXY,
+   double const inSumSquareY,
+   double const inChannelWidth
+) const noexcept
+{
+   auto const result{do_calc(inSumY, inSumXY),};
+   auto const squareDeviationX{-m_divisor / period(),};
+   auto const deviationXY{inSumXY - m_sumX * inSumY / period(),};
+   auto const squareDeviationY{std::max(inSumSquareY - inSumY * inSumY / period(), 0.0),};
+   auto const squareError{std::max(squareDeviationY - deviationXY * deviationXY / squareDeviationX, 0.0),};
+   auto const standardError{(2 < period()) ? std::sqrt(squareError / (period() - 2)) : 0.0,};
+   auto const value{result.intercept + result.slope * lookback_period(),};
+   return linear_regression_extended_result
+   {
+      .intercept = result.intercept,
+      .slope = result.slope,
+      .value = value,
+      .forecast = result.intercept + result.slope * period(),
+      .r_squared = (0 < squareDeviationY) ? (1.0 - squareError / squareDeviationY) : 0.0,
+      .standard_error = standardError,
+      .upper_channel = value + inChannelWidth * standardError,
+      .lower_channel = value - inChannelWidth * standardError,
+   };
+}
+
+template<uint32_t inline_capacity>
+void linear_regression<static_cast<uint32_t>(-1), inline_capacity>::do_sum() noexcept
+{
+   m_resummationCountdown = resummation_period();
+   m_sumY = 0;
+   m_sumXY = 0;
+   m_sumSquareY = 0;
+   for (uint32_t valueIndex{0,}; valueIndex < period(); ++valueIndex)
+   {
+      auto const x{lookback_period() - valueIndex,};
+      auto const y{m_yValues[m_yValues.wrap(m_yValues.cursor() + valueIndex)],};
+      m_sumY += y;
+      m_sumXY += x * y;
+      m_sumSquareY += y * y;
+   }
+}
+
+template<uint32_t inline_capacity>
+bool linear_regression<static_cast<uint32_t>(-1), inline_capacity>::do_update(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(true == std::isfinite(inValue));
+   auto const yValue{m_yValues.exchange(inValue),};
+   if ((lookback_period() < inSequenceNumber) && (0 != --m_resummationCountdown)) [[likely]]
+   {
+      m_sumXY += m_sumY - period() * yValue;
+      m_sumY += inValue - yValue;
+      m_sumSquareY += inValue * inValue - yValue * yValue;
+      return true;
+   }
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      do_sum();
+      return true;
+   }
+   return false;
+}
+
+template<uint32_t inline_capacity>
+linear_regression<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::lookahead_type(linear_regression const &inIndicator) noexcept :
+   m_indicator{std::addressof(inIndicator),},
+   m_sumY{inIndicator.m_sumY,},
+   m_sumXY{inIndicator.m_sumXY,},
+   m_sumSquareY{inIndicator.m_sumSquareY,},
+   m_valuesNumber{0,}
+#if (not defined(NDEBUG))
+   , m_prevSequenceNumber{inIndicator.m_prevSequenceNumber,}
+#endif
+{}
+
+template<uint32_t inline_capacity>
+linear_regression_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+   if (true == do_update(inSequenceNumber, inValue)) [[likely]]
+   {
+      return m_indicator->do_calc(m_sumY, m_sumXY);
+   }
+   return linear_regression_result{};
+}
+
+template<uint32_t inline_capacity>
+linear_regression_extended_result linear_regression<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::calc_extended(
+   uint64_t const inSequenceNumber,
+   double const inValue,
+   double const inChannelWidth
+) noexcept
+{
+   assert(true == std::isfinite(inChannelWidth));
+   if (true == do_update(inSequenceNumber, inValue)) [[likely]]
+   {
+      return m_indicator->do_calc_extended(m_sumY, m_sumXY, m_sumSquareY, inChannelWidth);
+   }
+   return linear_regression_extended_result{};
+}
+
+template<uint32_t inline_capacity>
+void linear_regression<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::do_push(double const inValue) noexcept
+{
+   m_sumXY += m_sumY;
+   m_sumY += inValue;
+   m_sumSquareY += inValue * inValue;
+}
+
+template<uint32_t inline_capacity>
+bool linear_regression<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::do_update(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(m_indicator->period() > m_valuesNumber);
+   auto const &yValues{m_indicator->m_yValues,};
+   if (m_indicator->lookback_period() < inSequenceNumber) [[likely]]
+   {
+      /// The j-th hypothetical value evicts the j-th oldest committed one
+      auto const yValue{yValues[yValues.wrap(yValues.cursor() + m_valuesNumber)],};
+      ++m_valuesNumber;
+      m_sumXY += m_sumY - m_indicator->period() * yValue;
+      m_sumY += inValue - yValue;
+      m_sumSquareY += inValue * inValue - yValue * yValue;
+      return true;
+   }
+   if (0 == m_valuesNumber)
+   {
+      /// The sums are only kept once the window is full, until then the values committed so far fill the ring from its origin
+      m_sumY = 0;
+      m_sumXY = 0;
+      m_sumSquareY = 0;
+      for (uint32_t valueIndex{0,}; valueIndex < inSequenceNumber; ++valueIndex)
+      {
+         do_push(yValues[valueIndex]);
+      }
+   }
+   ++m_valuesNumber;
+   do_push(inValue);
+   return m_indicator->lookback_period() == inSequenceNumber;
+}
+
+template class linear_regression<static_cast<uint32_t>(-1), 0>;
+template class linear_regression<static_cast<uint32_t>(-1), 8>;
+template class linear_regression<static_cast<uint32_t>(-1), 16>;
+template class linear_regression<static_cast<uint32_t>(-1), 32>;
+template class linear_regression<static_cast<uint32_t>(-1), 64>;
+
 }
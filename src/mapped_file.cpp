@@ -0,0 +1,128 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+
+#include "tean/mapped_file.hpp" /// for tean::mapped_file
+
+#include <cstddef> /// for size_t, std::byte
+#include <cstdint> /// for uint64_t
+#include <filesystem> /// for std::filesystem::path
+
+#if (defined(_WIN32))
+#  define NOMINMAX
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h> /// for CloseHandle, CreateFileMappingW, CreateFileW, FlushViewOfFile, MapViewOfFile, UnmapViewOfFile
+#else
+#  include <fcntl.h> /// for O_CLOEXEC, O_CREAT, O_RDWR, open
+#  include <sys/mman.h> /// for MAP_FAILED, MAP_SHARED, mmap, msync, munmap, MS_SYNC, PROT_READ, PROT_WRITE
+#  include <sys/stat.h> /// for fstat, stat
+#  include <unistd.h> /// for close, ftruncate
+#endif
+
+namespace tean
+{
+
+void mapped_file::close() noexcept
+{
+   if (nullptr == m_data)
+   {
+      return;
+   }
+#if (defined(_WIN32))
+   ::UnmapViewOfFile(m_data);
+#else
+   ::munmap(m_data, m_size);
+#endif
+   m_data = nullptr;
+   m_size = 0;
+}
+
+bool mapped_file::open(std::filesystem::path const &inPath, size_t const inSize) noexcept
+{
+   close();
+   if (0 == inSize)
+   {
+      return false;
+   }
+#if (defined(_WIN32))
+   auto const file = ::CreateFileW(inPath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (INVALID_HANDLE_VALUE == file)
+   {
+      return false;
+   }
+   /// A mapping larger than the file extends the file with zero bytes
+   auto const mappingSize = static_cast<uint64_t>(inSize);
+   auto const mapping = ::CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize), nullptr);
+   ::CloseHandle(file);
+   if (nullptr == mapping)
+   {
+      return false;
+   }
+   auto *const data = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, inSize);
+   /// The view keeps the mapping alive
+   ::CloseHandle(mapping);
+   if (nullptr == data)
+   {
+      return false;
+   }
+#else
+   auto const file = ::open(inPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+   if (-1 == file)
+   {
+      return false;
+   }
+   struct stat fileStatus{};
+   if ((0 != ::fstat(file, &fileStatus)) || ((static_cast<uint64_t>(fileStatus.st_size) < inSize) && (0 != ::ftruncate(file, static_cast<off_t>(inSize)))))
+   {
+      ::close(file);
+      return false;
+   }
+   auto *const data = ::mmap(nullptr, inSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+   /// The mapping keeps the file open
+   ::close(file);
+   if (MAP_FAILED == data)
+   {
+      return false;
+   }
+#endif
+   m_data = static_cast<std::byte *>(data);
+   m_size = inSize;
+   return true;
+}
+
+bool mapped_file::sync() noexcept
+{
+   if (nullptr == m_data)
+   {
+      return false;
+   }
+#if (defined(_WIN32))
+   return 0 != ::FlushViewOfFile(m_data, m_size);
+#else
+   return 0 == ::msync(m_data, m_size, MS_SYNC);
+#endif
+}
+
+}
@@ -24,33 +24,83 @@
 */
 
 #include "tean/maximum_in_period.hpp" /// for tean::maximum_in_period
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
-#include <algorithm> /// for std::fill, std::max
+#include <algorithm> /// for std::max, std::min, std::ranges::all_of
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::isnan
+#include <cstddef> /// for size_t
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <memory> /// for std::make_unique
-#include <tuple> /// for std::tie
-#include <utility> /// for std::pair
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::memory_resource
+#include <span> /// for std::span
 
 namespace tean
 {
 
-maximum_in_period::maximum_in_period(uint32_t const inPeriod) :
+namespace
+{
+
+static void van_herk_gil_werman(std::span<double const> const inValues, uint32_t const inPeriod, std::span<double> const outValues) noexcept
+{
+   assert(inPeriod <= inValues.size());
+   assert(inValues.size() == outValues.size());
+   /// Windows of output values [blockBegin + inPeriod - 1, blockEnd + inPeriod - 1) span the block and the next one,
+   /// the block suffix maximum is stored in-place and then merged with the prefix maximum of the next block
+   for (size_t blockBegin = 0; (blockBegin + inPeriod) <= inValues.size(); blockBegin += inPeriod)
+   {
+      auto const blockEnd = blockBegin + inPeriod;
+      auto suffixMaximum = std::numeric_limits<double>::lowest();
+      for (auto valueIndex = blockEnd; blockBegin != valueIndex--; )
+      {
+         suffixMaximum = std::max(suffixMaximum, inValues[valueIndex]);
+         if (auto const outIndex = valueIndex + inPeriod - 1; outIndex < outValues.size())
+         {
+            outValues[outIndex] = suffixMaximum;
+         }
+      }
+      auto prefixMaximum = std::numeric_limits<double>::lowest();
+      for (auto valueIndex = blockEnd, valueEnd = std::min(blockEnd + inPeriod - 1, inValues.size()); valueIndex < valueEnd; ++valueIndex)
+      {
+         prefixMaximum = std::max(prefixMaximum, inValues[valueIndex]);
+         outValues[valueIndex] = std::max(outValues[valueIndex], prefixMaximum);
+      }
+   }
+}
+
+}
+
+template<uint32_t inline_capacity>
+maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::maximum_in_period(uint32_t const inPeriod, std::pmr::memory_resource *const inMemoryResource) :
    m_period(inPeriod),
    m_lookbackPeriod(inPeriod - 1),
-   m_values(std::make_unique<double[]>(inPeriod)),
+   m_values(inPeriod, inMemoryResource),
+   m_maximumIndices(inPeriod, inMemoryResource),
 #if (not defined(NDEBUG))
    m_prevSequenceNumber(0),
 #endif
-   m_maximumValueIndex(0)
+   m_maximumIndicesHead(0),
+   m_maximumIndicesSize(0)
 {
    assert(1 < period());
-   std::fill(m_values.get(), m_values.get() + period(), std::numeric_limits<double>::signaling_NaN());
+   m_values.reset(std::numeric_limits<double>::signaling_NaN());
+}
+
+template<uint32_t inline_capacity>
+double maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::amend([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   m_values.newest() = inValue;
+   return (0 == m_maximumIndicesSize) ? inValue : std::max(m_values[m_maximumIndices[m_maximumIndicesHead]], inValue);
 }
 
-double maximum_in_period::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+template<uint32_t inline_capacity>
+double maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -58,73 +108,198 @@ double maximum_in_period::calc(uint64_t const inSequenceNumber, double const inV
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
-   if (lookback_period() <= inSequenceNumber) [[likely]]
+   if (0 == inSequenceNumber) [[unlikely]]
+   {
+      m_values.push(inValue);
+      return inValue;
+   }
+   return do_calc(inValue);
+}
+
+template<uint32_t inline_capacity>
+void maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::calc(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<double> const outValues) noexcept
+{
+   assert(inValues.size() == outValues.size());
+   assert(true == std::ranges::all_of(inValues, [] (double const inValue) { return std::isfinite(inValue); }));
+   /// Windows overlapping values preceding the batch are served by the streaming path
+   auto const streamingSize = std::min<size_t>(lookback_period(), inValues.size());
+   for (size_t valueIndex = 0; valueIndex < streamingSize; ++valueIndex)
    {
-      auto const valueIndex = static_cast<uint32_t>(inSequenceNumber % period());
-      double maximumValue;
-      std::tie(m_maximumValueIndex, maximumValue) = get_maximum(valueIndex, inValue);
-      m_values[valueIndex] = inValue;
-      return maximumValue;
+      outValues[valueIndex] = calc(inSequenceNumber + valueIndex, inValues[valueIndex]);
    }
-   m_values[inSequenceNumber] = inValue;
-   auto const prevMaximumValue = m_values[m_maximumValueIndex];
-   if (prevMaximumValue <= inValue)
+   if (inValues.size() < period())
    {
-      m_maximumValueIndex = static_cast<uint32_t>(inSequenceNumber);
-      return inValue;
+      return;
+   }
+   van_herk_gil_werman(inValues, period(), outValues);
+   /// Rebuild the streaming state from the last period of the batch
+#if (not defined(NDEBUG))
+   m_prevSequenceNumber = inSequenceNumber + inValues.size() - 1;
+#endif
+   m_maximumIndicesHead = 0;
+   m_maximumIndicesSize = 0;
+   m_values.seek(static_cast<uint32_t>((inSequenceNumber + inValues.size()) % period()));
+   for (auto const value : inValues.last(period()))
+   {
+      m_values.push(value);
+   }
+   for (uint32_t valueIndex = 0; valueIndex < lookback_period(); ++valueIndex)
+   {
+      do_push(m_values.wrap(m_values.cursor() + valueIndex));
+   }
+}
+
+template<uint32_t inline_capacity>
+bool maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if ((true == inReader.read_header(inSequenceNumber)) && (true == m_values.load(inReader)) && (true == inReader.read_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, period())))
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
    }
-   return prevMaximumValue;
+   return false;
 }
 
-double maximum_in_period::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+template<uint32_t inline_capacity>
+double maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
-   if (lookback_period() <= inSequenceNumber) [[likely]]
+   auto maximumIndicesHead = m_maximumIndicesHead;
+   auto maximumIndicesSize = m_maximumIndicesSize;
+   if ((0 < maximumIndicesSize) && (m_values.cursor() == m_maximumIndices[maximumIndicesHead]))
    {
-      return get_maximum(static_cast<uint32_t>(inSequenceNumber % period()), inValue).second;
+      maximumIndicesHead = m_values.wrap(maximumIndicesHead + 1);
+      --maximumIndicesSize;
    }
-   return (0 == inSequenceNumber)
-      ? inValue
-      : std::max(m_values[m_maximumValueIndex], inValue)
+   /// The input of the latest calc is not in the deque yet
+   auto const maximum = (0 < inSequenceNumber) ? std::max(m_values.newest(), inValue) : inValue;
+   return (0 == maximumIndicesSize)
+      ? maximum
+      : std::max(m_values[m_maximumIndices[maximumIndicesHead]], maximum)
    ;
 }
 
-void maximum_in_period::reset() noexcept
+template<uint32_t inline_capacity>
+void maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::reset() noexcept
 {
-   std::fill(m_values.get(), m_values.get() + period(), std::numeric_limits<double>::signaling_NaN());
+   m_values.reset(std::numeric_limits<double>::signaling_NaN());
 #if (not defined(NDEBUG))
    m_prevSequenceNumber = 0;
 #endif
-   m_maximumValueIndex = 0;
+   m_maximumIndicesHead = 0;
+   m_maximumIndicesSize = 0;
+}
+
+template<uint32_t inline_capacity>
+void maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   m_values.save(outWriter);
+   outWriter.write_deque(m_maximumIndices, m_maximumIndicesHead, m_maximumIndicesSize, period());
 }
 
-std::pair<uint32_t, double> maximum_in_period::get_maximum(uint32_t const inIndex, double const inValue) const noexcept
+template<uint32_t inline_capacity>
+void maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
 {
-   auto const prevMaximumValue = m_values[m_maximumValueIndex];
-   if (prevMaximumValue <= inValue)
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   assert(gap_fill::decay_only != inFill);
+   auto const value = m_values.newest();
+   for (auto valuesNumber = std::min<uint64_t>(inGap, period()); 0 < valuesNumber; --valuesNumber)
    {
-      return {inIndex, inValue};
+      [[maybe_unused]] auto const maximumValue = do_calc(value);
    }
-   if (inIndex == m_maximumValueIndex)
+   if (inGap > period())
    {
-      auto maximumValueIndex = inIndex;
-      auto maximumValue = inValue;
-      for (uint32_t valueIndex = 0; valueIndex < period(); ++valueIndex)
-      {
-         auto const value = m_values[valueIndex];
-         if ((maximumValue < value) && (inIndex != valueIndex))
-         {
-            maximumValueIndex = valueIndex;
-            maximumValue = value;
-         }
-      }
-      return {maximumValueIndex, maximumValue};
+      /// The window only holds copies of the value, so the rest of the gap just moves the cursor and the newest committed copy heads the deque
+      m_values.seek(static_cast<uint32_t>((inSequenceNumber + inGap) % period()));
+      m_maximumIndicesHead = 0;
+      m_maximumIndicesSize = 1;
+      m_maximumIndices[0] = m_values.wrap(m_values.cursor() + lookback_period() - 1);
+   }
+}
+
+template<uint32_t inline_capacity>
+double maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::do_calc(double const inValue) noexcept
+{
+   do_push(m_values.wrap(m_values.cursor() + lookback_period()));
+   if (m_values.cursor() == m_maximumIndices[m_maximumIndicesHead])
+   {
+      m_maximumIndicesHead = m_values.wrap(m_maximumIndicesHead + 1);
+      --m_maximumIndicesSize;
+   }
+   m_values.push(inValue);
+   return std::max(m_values[m_maximumIndices[m_maximumIndicesHead]], inValue);
+}
+
+template<uint32_t inline_capacity>
+void maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::do_push(uint32_t const inIndex) noexcept
+{
+   while ((0 < m_maximumIndicesSize) && (m_values[m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize - 1)]] <= m_values[inIndex]))
+   {
+      --m_maximumIndicesSize;
+   }
+   m_maximumIndices[m_values.wrap(m_maximumIndicesHead + m_maximumIndicesSize)] = inIndex;
+   ++m_maximumIndicesSize;
+}
+
+template<uint32_t inline_capacity>
+maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::lookahead_type(maximum_in_period const &inIndicator) noexcept :
+   m_indicator(std::addressof(inIndicator)),
+   m_maximumIndicesHead(inIndicator.m_maximumIndicesHead),
+   m_maximumIndicesSize(inIndicator.m_maximumIndicesSize),
+   m_valuesNumber(0),
+   m_maximum(0.0)
+#if (not defined(NDEBUG))
+   , m_prevSequenceNumber(inIndicator.m_prevSequenceNumber)
+#endif
+{}
+
+template<uint32_t inline_capacity>
+double maximum_in_period<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   assert(m_indicator->period() > m_valuesNumber);
+   auto const &values = m_indicator->m_values;
+   /// The j-th hypothetical value pushes out the committed values up to the j-th oldest slot
+   while ((0 < m_maximumIndicesSize) && (m_valuesNumber >= values.wrap(m_indicator->m_maximumIndices[m_maximumIndicesHead] + m_indicator->period() - values.cursor())))
+   {
+      m_maximumIndicesHead = values.wrap(m_maximumIndicesHead + 1);
+      --m_maximumIndicesSize;
    }
-   return {m_maximumValueIndex, prevMaximumValue};
+   m_maximum = ((0 == m_valuesNumber) || (m_maximum < inValue)) ? inValue : m_maximum;
+   ++m_valuesNumber;
+   auto maximum = m_maximum;
+   if ((m_indicator->period() > m_valuesNumber) && (m_valuesNumber <= inSequenceNumber))
+   {
+      /// The input of the latest calc is not in the deque yet, it leaves the window with the last hypothetical value
+      maximum = std::max(values.newest(), maximum);
+   }
+   return (0 == m_maximumIndicesSize) ? maximum : std::max(values[m_indicator->m_maximumIndices[m_maximumIndicesHead]], maximum);
 }
 
+template class maximum_in_period<static_cast<uint32_t>(-1), 0>;
+template class maximum_in_period<static_cast<uint32_t>(-1), 8>;
+template class maximum_in_period<static_cast<uint32_t>(-1), 16>;
+template class maximum_in_period<static_cast<uint32_t>(-1), 32>;
+template class maximum_in_period<static_cast<uint32_t>(-1), 64>;
+
 }
@@ -24,33 +24,83 @@
 */
 
 #include "tean/minimum_in_period.hpp" /// for tean::minimum_in_period
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
-#include <algorithm> /// for std::fill, std::min
+#include <algorithm> /// for std::min, std::ranges::all_of
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::isnan
+#include <cstddef> /// for size_t
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <memory> /// for std::make_unique
-#include <tuple> /// for std::tie
-#include <utility> /// for std::pair
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::memory_resource
+#include <span> /// for std::span
 
 namespace tean
 {
 
-minimum_in_period::minimum_in_period(uint32_t const inPeriod) :
+namespace
+{
+
+static void van_herk_gil_werman(std::span<double const> const inValues, uint32_t const inPeriod, std::span<double> const outValues) noexcept
+{
+   assert(inPeriod <= inValues.size());
+   assert(inValues.size() == outValues.size());
+   /// Windows of output values [blockBegin + inPeriod - 1, blockEnd + inPeriod - 1) span the block and the next one,
+   /// the block suffix minimum is stored in-place and then merged with the prefix minimum of the next block
+   for (size_t blockBegin = 0; (blockBegin + inPeriod) <= inValues.size(); blockBegin += inPeriod)
+   {
+      auto const blockEnd = blockBegin + inPeriod;
+      auto suffixMinimum = std::numeric_limits<double>::max();
+      for (auto valueIndex = blockEnd; blockBegin != valueIndex--; )
+      {
+         suffixMinimum = std::min(suffixMinimum, inValues[valueIndex]);
+         if (auto const outIndex = valueIndex + inPeriod - 1; outIndex < outValues.size())
+         {
+            outValues[outIndex] = suffixMinimum;
+         }
+      }
+      auto prefixMinimum = std::numeric_limits<double>::max();
+      for (auto valueIndex = blockEnd, valueEnd = std::min(blockEnd + inPeriod - 1, inValues.size()); valueIndex < valueEnd; ++valueIndex)
+      {
+         prefixMinimum = std::min(prefixMinimum, inValues[valueIndex]);
+         outValues[valueIndex] = std::min(outValues[valueIndex], prefixMinimum);
+      }
+   }
+}
+
+}
+
+template<uint32_t inline_capacity>
+minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::minimum_in_period(uint32_t const inPeriod, std::pmr::memory_resource *const inMemoryResource) :
    m_period(inPeriod),
    m_lookbackPeriod(inPeriod - 1),
-   m_values(std::make_unique<double[]>(inPeriod)),
+   m_values(inPeriod, inMemoryResource),
+   m_minimumIndices(inPeriod, inMemoryResource),
 #if (not defined(NDEBUG))
    m_prevSequenceNumber(0),
 #endif
-   m_minimumValueIndex(0)
+   m_minimumIndicesHead(0),
+   m_minimumIndicesSize(0)
 {
    assert(1 < period());
-   std::fill(m_values.get(), m_values.get() + period(), std::numeric_limits<double>::signaling_NaN());
+   m_values.reset(std::numeric_limits<double>::signaling_NaN());
+}
+
+template<uint32_t inline_capacity>
+double minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::amend([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   m_values.newest() = inValue;
+   return (0 == m_minimumIndicesSize) ? inValue : std::min(m_values[m_minimumIndices[m_minimumIndicesHead]], inValue);
 }
 
-double minimum_in_period::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+template<uint32_t inline_capacity>
+double minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -58,73 +108,198 @@ double minimum_in_period::calc(uint64_t const inSequenceNumber, double const inV
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
-   if (lookback_period() <= inSequenceNumber) [[likely]]
+   if (0 == inSequenceNumber) [[unlikely]]
+   {
+      m_values.push(inValue);
+      return inValue;
+   }
+   return do_calc(inValue);
+}
+
+template<uint32_t inline_capacity>
+void minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::calc(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<double> const outValues) noexcept
+{
+   assert(inValues.size() == outValues.size());
+   assert(true == std::ranges::all_of(inValues, [] (double const inValue) { return std::isfinite(inValue); }));
+   /// Windows overlapping values preceding the batch are served by the streaming path
+   auto const streamingSize = std::min<size_t>(lookback_period(), inValues.size());
+   for (size_t valueIndex = 0; valueIndex < streamingSize; ++valueIndex)
    {
-      auto const valueIndex = static_cast<uint32_t>(inSequenceNumber % period());
-      double minimumValue;
-      std::tie(m_minimumValueIndex, minimumValue) = get_minimum(valueIndex, inValue);
-      m_values[valueIndex] = inValue;
-      return minimumValue;
+      outValues[valueIndex] = calc(inSequenceNumber + valueIndex, inValues[valueIndex]);
    }
-   m_values[inSequenceNumber] = inValue;
-   auto const prevMinimumValue = m_values[m_minimumValueIndex];
-   if (inValue <= prevMinimumValue)
+   if (inValues.size() < period())
    {
-      m_minimumValueIndex = static_cast<uint32_t>(inSequenceNumber);
-      return inValue;
+      return;
+   }
+   van_herk_gil_werman(inValues, period(), outValues);
+   /// Rebuild the streaming state from the last period of the batch
+#if (not defined(NDEBUG))
+   m_prevSequenceNumber = inSequenceNumber + inValues.size() - 1;
+#endif
+   m_minimumIndicesHead = 0;
+   m_minimumIndicesSize = 0;
+   m_values.seek(static_cast<uint32_t>((inSequenceNumber + inValues.size()) % period()));
+   for (auto const value : inValues.last(period()))
+   {
+      m_values.push(value);
+   }
+   for (uint32_t valueIndex = 0; valueIndex < lookback_period(); ++valueIndex)
+   {
+      do_push(m_values.wrap(m_values.cursor() + valueIndex));
+   }
+}
+
+template<uint32_t inline_capacity>
+bool minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if ((true == inReader.read_header(inSequenceNumber)) && (true == m_values.load(inReader)) && (true == inReader.read_deque(m_minimumIndices, m_minimumIndicesHead, m_minimumIndicesSize, period())))
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
    }
-   return prevMinimumValue;
+   return false;
 }
 
-double minimum_in_period::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+template<uint32_t inline_capacity>
+double minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
-   if (lookback_period() <= inSequenceNumber) [[likely]]
+   auto minimumIndicesHead = m_minimumIndicesHead;
+   auto minimumIndicesSize = m_minimumIndicesSize;
+   if ((0 < minimumIndicesSize) && (m_values.cursor() == m_minimumIndices[minimumIndicesHead]))
    {
-      return get_minimum(static_cast<uint32_t>(inSequenceNumber % period()), inValue).second;
+      minimumIndicesHead = m_values.wrap(minimumIndicesHead + 1);
+      --minimumIndicesSize;
    }
-   return (0 == inSequenceNumber)
-      ? inValue
-      : std::min(m_values[m_minimumValueIndex], inValue)
+   /// The input of the latest calc is not in the deque yet
+   auto const minimum = (0 < inSequenceNumber) ? std::min(m_values.newest(), inValue) : inValue;
+   return (0 == minimumIndicesSize)
+      ? minimum
+      : std::min(m_values[m_minimumIndices[minimumIndicesHead]], minimum)
    ;
 }
 
-void minimum_in_period::reset() noexcept
+template<uint32_t inline_capacity>
+void minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::reset() noexcept
 {
-   std::fill(m_values.get(), m_values.get() + period(), std::numeric_limits<double>::signaling_NaN());
+   m_values.reset(std::numeric_limits<double>::signaling_NaN());
 #if (not defined(NDEBUG))
    m_prevSequenceNumber = 0;
 #endif
-   m_minimumValueIndex = 0;
+   m_minimumIndicesHead = 0;
+   m_minimumIndicesSize = 0;
+}
+
+template<uint32_t inline_capacity>
+void minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   m_values.save(outWriter);
+   outWriter.write_deque(m_minimumIndices, m_minimumIndicesHead, m_minimumIndicesSize, period());
 }
 
-std::pair<uint32_t, double> minimum_in_period::get_minimum(uint32_t const inIndex, double const inValue) const noexcept
+template<uint32_t inline_capacity>
+void minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
 {
-   auto const prevMinimumValue = m_values[m_minimumValueIndex];
-   if (inValue <= prevMinimumValue)
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   assert(gap_fill::decay_only != inFill);
+   auto const value = m_values.newest();
+   for (auto valuesNumber = std::min<uint64_t>(inGap, period()); 0 < valuesNumber; --valuesNumber)
    {
-      return {inIndex, inValue};
+      [[maybe_unused]] auto const minimumValue = do_calc(value);
    }
-   if (inIndex == m_minimumValueIndex)
+   if (inGap > period())
    {
-      auto minimumValueIndex = inIndex;
-      auto minimumValue = inValue;
-      for (uint32_t valueIndex = 0; valueIndex < period(); ++valueIndex)
-      {
-         auto const value = m_values[valueIndex];
-         if ((value < minimumValue) && (inIndex != valueIndex))
-         {
-            minimumValueIndex = valueIndex;
-            minimumValue = value;
-         }
-      }
-      return {minimumValueIndex, minimumValue};
+      /// The window only holds copies of the value, so the rest of the gap just moves the cursor and the newest committed copy heads the deque
+      m_values.seek(static_cast<uint32_t>((inSequenceNumber + inGap) % period()));
+      m_minimumIndicesHead = 0;
+      m_minimumIndicesSize = 1;
+      m_minimumIndices[0] = m_values.wrap(m_values.cursor() + lookback_period() - 1);
+   }
+}
+
+template<uint32_t inline_capacity>
+double minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::do_calc(double const inValue) noexcept
+{
+   do_push(m_values.wrap(m_values.cursor() + lookback_period()));
+   if (m_values.cursor() == m_minimumIndices[m_minimumIndicesHead])
+   {
+      m_minimumIndicesHead = m_values.wrap(m_minimumIndicesHead + 1);
+      --m_minimumIndicesSize;
+   }
+   m_values.push(inValue);
+   return std::min(m_values[m_minimumIndices[m_minimumIndicesHead]], inValue);
+}
+
+template<uint32_t inline_capacity>
+void minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::do_push(uint32_t const inIndex) noexcept
+{
+   while ((0 < m_minimumIndicesSize) && (m_values[inIndex] <= m_values[m_minimumIndices[m_values.wrap(m_minimumIndicesHead + m_minimumIndicesSize - 1)]]))
+   {
+      --m_minimumIndicesSize;
+   }
+   m_minimumIndices[m_values.wrap(m_minimumIndicesHead + m_minimumIndicesSize)] = inIndex;
+   ++m_minimumIndicesSize;
+}
+
+template<uint32_t inline_capacity>
+minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::lookahead_type(minimum_in_period const &inIndicator) noexcept :
+   m_indicator(std::addressof(inIndicator)),
+   m_minimumIndicesHead(inIndicator.m_minimumIndicesHead),
+   m_minimumIndicesSize(inIndicator.m_minimumIndicesSize),
+   m_valuesNumber(0),
+   m_minimum(0.0)
+#if (not defined(NDEBUG))
+   , m_prevSequenceNumber(inIndicator.m_prevSequenceNumber)
+#endif
+{}
+
+template<uint32_t inline_capacity>
+double minimum_in_period<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   assert(m_indicator->period() > m_valuesNumber);
+   auto const &values = m_indicator->m_values;
+   /// The j-th hypothetical value pushes out the committed values up to the j-th oldest slot
+   while ((0 < m_minimumIndicesSize) && (m_valuesNumber >= values.wrap(m_indicator->m_minimumIndices[m_minimumIndicesHead] + m_indicator->period() - values.cursor())))
+   {
+      m_minimumIndicesHead = values.wrap(m_minimumIndicesHead + 1);
+      --m_minimumIndicesSize;
    }
-   return {m_minimumValueIndex, prevMinimumValue};
+   m_minimum = ((0 == m_valuesNumber) || (inValue < m_minimum)) ? inValue : m_minimum;
+   ++m_valuesNumber;
+   auto minimum = m_minimum;
+   if ((m_indicator->period() > m_valuesNumber) && (m_valuesNumber <= inSequenceNumber))
+   {
+      /// The input of the latest calc is not in the deque yet, it leaves the window with the last hypothetical value
+      minimum = std::min(values.newest(), minimum);
+   }
+   return (0 == m_minimumIndicesSize) ? minimum : std::min(values[m_indicator->m_minimumIndices[m_minimumIndicesHead]], minimum);
 }
 
+template class minimum_in_period<static_cast<uint32_t>(-1), 0>;
+template class minimum_in_period<static_cast<uint32_t>(-1), 8>;
+template class minimum_in_period<static_cast<uint32_t>(-1), 16>;
+template class minimum_in_period<static_cast<uint32_t>(-1), 32>;
+template class minimum_in_period<static_cast<uint32_t>(-1), 64>;
+
 }
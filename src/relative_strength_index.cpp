@@ -25,27 +25,51 @@
 
 #include "tean/relative_strength_index.hpp" /// for tean::relative_strength_index
 
+#include <algorithm> /// for std::max, std::ranges::all_of, std::ranges::fill, std::ranges::transform
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite, std::isnan
+#include <cmath> /// for std::isfinite, std::isnan, std::pow
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
+#include <span> /// for std::span
 
 namespace tean
 {
 
-relative_strength_index::relative_strength_index(uint32_t const inPeriod) noexcept :
+relative_strength_index<static_cast<uint32_t>(-1)>::relative_strength_index(uint32_t const inPeriod) noexcept :
    m_period(inPeriod),
 #if (not defined(NDEBUG))
    m_prevSequenceNumber(0),
 #endif
    m_smoothGain(0.0),
    m_smoothLoss(0.0),
-   m_value(std::numeric_limits<double>::signaling_NaN())
+   m_value(std::numeric_limits<double>::signaling_NaN()),
+   m_prevSmoothGain(0.0),
+   m_prevSmoothLoss(0.0),
+   m_prevValue(std::numeric_limits<double>::signaling_NaN())
 {
    assert(1 < period());
 }
 
-double relative_strength_index::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+double relative_strength_index<static_cast<uint32_t>(-1)>::amend(uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   /// A skip leaves no calc to amend
+   assert((false == std::isnan(m_prevSmoothGain)) && (false == std::isnan(m_prevSmoothLoss)));
+   m_smoothGain = m_prevSmoothGain;
+   m_smoothLoss = m_prevSmoothLoss;
+   m_value = m_prevValue;
+   if (lookback_period() < inSequenceNumber) [[likely]]
+   {
+      return do_regular_calc(inValue);
+   }
+   return do_lookback_calc(inSequenceNumber, inValue);
+}
+
+double relative_strength_index<static_cast<uint32_t>(-1)>::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -53,6 +77,9 @@ double relative_strength_index::calc(uint64_t const inSequenceNumber, double con
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
+   m_prevSmoothGain = m_smoothGain;
+   m_prevSmoothLoss = m_smoothLoss;
+   m_prevValue = m_value;
    if (lookback_period() < inSequenceNumber) [[likely]]
    {
       return do_regular_calc(inValue);
@@ -60,7 +87,28 @@ double relative_strength_index::calc(uint64_t const inSequenceNumber, double con
    return do_lookback_calc(inSequenceNumber, inValue);
 }
 
-double relative_strength_index::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+bool relative_strength_index<static_cast<uint32_t>(-1)>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_period))
+      && (true == inReader.read(m_smoothGain))
+      && (true == inReader.read(m_smoothLoss))
+      && (true == inReader.read(m_value))
+      && (true == inReader.read(m_prevSmoothGain))
+      && (true == inReader.read(m_prevSmoothLoss))
+      && (true == inReader.read(m_prevValue))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
+double relative_strength_index<static_cast<uint32_t>(-1)>::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -78,7 +126,39 @@ double relative_strength_index::pick(uint64_t const inSequenceNumber, double con
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-void relative_strength_index::reset() noexcept
+void relative_strength_index<static_cast<uint32_t>(-1)>::pick_many(uint64_t const inSequenceNumber, std::span<double const> const inValues, std::span<double> const outValues) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(inValues.size() == outValues.size());
+   assert(true == std::ranges::all_of(inValues, [] (double const inValue) { return std::isfinite(inValue); }));
+   if (lookback_period() < inSequenceNumber) [[likely]]
+   {
+      /// Locals keep the loop free of reloads through the output span, max in place of the sign branch keeps it vectorizable
+      auto const value = m_value;
+      auto const smoothGain = m_smoothGain;
+      auto const smoothLoss = m_smoothLoss;
+      auto const smoothPeriod = static_cast<double>(period());
+      for (size_t valueIndex = 0; valueIndex < inValues.size(); ++valueIndex)
+      {
+         auto const delta = inValues[valueIndex] - value;
+         auto const nextSmoothGain = smoothGain + (std::max(delta, 0.0) - smoothGain) / smoothPeriod;
+         auto const nextSmoothLoss = smoothLoss + (std::max(-delta, 0.0) - smoothLoss) / smoothPeriod;
+         auto const smoothTotal = nextSmoothGain + nextSmoothLoss;
+         outValues[valueIndex] = 100.0 * (nextSmoothGain / (smoothTotal + static_cast<double>(0.0 == smoothTotal)));
+      }
+      return;
+   }
+   if (lookback_period() == inSequenceNumber) [[unlikely]]
+   {
+      std::ranges::transform(inValues, outValues.begin(), [this] (double const inValue) { return do_lookback_pick(inValue); });
+      return;
+   }
+   std::ranges::fill(outValues, std::numeric_limits<double>::signaling_NaN());
+}
+
+void relative_strength_index<static_cast<uint32_t>(-1)>::reset() noexcept
 {
 #if (not defined(NDEBUG))
    m_prevSequenceNumber = 0;
@@ -86,9 +166,75 @@ void relative_strength_index::reset() noexcept
    m_smoothGain = 0.0;
    m_smoothLoss = 0.0;
    m_value = std::numeric_limits<double>::signaling_NaN();
+   m_prevSmoothGain = 0.0;
+   m_prevSmoothLoss = 0.0;
+   m_prevValue = std::numeric_limits<double>::signaling_NaN();
 }
 
-double relative_strength_index::do_lookback_calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+void relative_strength_index<static_cast<uint32_t>(-1)>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_period);
+   outWriter.write(m_smoothGain);
+   outWriter.write(m_smoothLoss);
+   outWriter.write(m_value);
+   outWriter.write(m_prevSmoothGain);
+   outWriter.write(m_prevSmoothLoss);
+   outWriter.write(m_prevValue);
+}
+
+void relative_strength_index<static_cast<uint32_t>(-1)>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+{
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   m_prevSmoothGain = std::numeric_limits<double>::signaling_NaN();
+   m_prevSmoothLoss = std::numeric_limits<double>::signaling_NaN();
+   auto smoothedNumber = inGap;
+   if (lookback_period() >= inSequenceNumber)
+   {
+      if (lookback_period() >= (inSequenceNumber + inGap))
+      {
+         return;
+      }
+      /// The gap completes the seed averages
+      smoothedNumber = inSequenceNumber + inGap - 1 - lookback_period();
+      m_smoothGain /= static_cast<double>(period());
+      m_smoothLoss /= static_cast<double>(period());
+   }
+   auto const decay = std::pow(1.0 - 1.0 / static_cast<double>(period()), static_cast<double>(smoothedNumber));
+   m_smoothGain *= decay;
+   m_smoothLoss *= decay;
+}
+
+double relative_strength_index<static_cast<uint32_t>(-1)>::solve(uint64_t const inSequenceNumber, double const inRelativeStrengthIndex) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert((0 <= inRelativeStrengthIndex) && (100 >= inRelativeStrengthIndex));
+   if (lookback_period() < inSequenceNumber) [[likely]]
+   {
+      return solve_delta(
+         m_smoothGain - m_smoothGain / static_cast<double>(period()),
+         m_smoothLoss - m_smoothLoss / static_cast<double>(period()),
+         inRelativeStrengthIndex
+      );
+   }
+   if (lookback_period() == inSequenceNumber) [[unlikely]]
+   {
+      return solve_delta(m_smoothGain / static_cast<double>(period()), m_smoothLoss / static_cast<double>(period()), inRelativeStrengthIndex);
+   }
+   return std::numeric_limits<double>::signaling_NaN();
+}
+
+double relative_strength_index<static_cast<uint32_t>(-1)>::do_lookback_calc(uint64_t const inSequenceNumber, double const inValue) noexcept
 {
    if (0 < inSequenceNumber) [[likely]]
    {
@@ -113,7 +259,7 @@ double relative_strength_index::do_lookback_calc(uint64_t const inSequenceNumber
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-double relative_strength_index::do_lookback_pick(double const inValue) const noexcept
+double relative_strength_index<static_cast<uint32_t>(-1)>::do_lookback_pick(double const inValue) const noexcept
 {
    auto const delta = inValue - m_value;
    double smoothGain;
@@ -132,7 +278,7 @@ double relative_strength_index::do_lookback_pick(double const inValue) const noe
    return (0.0 == smoothTotal) ? 0.0 : (100.0 * (smoothGain / smoothTotal));
 }
 
-double relative_strength_index::do_regular_calc(double const inValue) noexcept
+double relative_strength_index<static_cast<uint32_t>(-1)>::do_regular_calc(double const inValue) noexcept
 {
    auto const delta = inValue - m_value;
    if (0 < delta)
@@ -150,7 +296,7 @@ double relative_strength_index::do_regular_calc(double const inValue) noexcept
    return (0.0 == smoothTotal) ? 0.0 : (100.0 * (m_smoothGain / smoothTotal));
 }
 
-double relative_strength_index::do_regular_pick(double const inValue) const noexcept
+double relative_strength_index<static_cast<uint32_t>(-1)>::do_regular_pick(double const inValue) const noexcept
 {
    auto const delta = inValue - m_value;
    double smoothGain;
@@ -169,4 +315,22 @@ double relative_strength_index::do_regular_pick(double const inValue) const noex
    return (0.0 == smoothTotal) ? 0.0 : (100.0 * (smoothGain / smoothTotal));
 }
 
+/// The smoothed gain and loss of the next pick are the given baselines plus the positive or negative move divided by the period,
+/// so the move follows from ratio = gain / (gain + loss)
+double relative_strength_index<static_cast<uint32_t>(-1)>::solve_delta(double const inBaseGain, double const inBaseLoss, double const inRelativeStrengthIndex) const noexcept
+{
+   auto const ratio = inRelativeStrengthIndex / 100.0;
+   auto const excess = ratio * (inBaseGain + inBaseLoss) - inBaseGain;
+   if (0 < excess)
+   {
+      return m_value + excess * static_cast<double>(period()) / (1.0 - ratio);
+   }
+   if (0 > excess)
+   {
+      return m_value + excess * static_cast<double>(period()) / ratio;
+   }
+   /// A flat history only yields zero
+   return ((0 == (inBaseGain + inBaseLoss)) && (0 < ratio)) ? std::numeric_limits<double>::signaling_NaN() : m_value;
+}
+
 }
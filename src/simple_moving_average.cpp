@@ -27,13 +27,13 @@
 
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::isnan
-#include <cstdint> /// for uint64_t
+#include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
 
 namespace tean
 {
 
-double simple_moving_average::do_calc(uint64_t const inSequenceNumber, double const inSumOverPeriod) noexcept
+double simple_moving_average<static_cast<uint32_t>(-1)>::do_calc(uint64_t const inSequenceNumber, double const inSumOverPeriod) noexcept
 {
    if (lookback_period() <= inSequenceNumber) [[likely]]
    {
@@ -44,7 +44,7 @@ double simple_moving_average::do_calc(uint64_t const inSequenceNumber, double co
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-double simple_moving_average::do_pick(uint64_t const inSequenceNumber, double const inSumOverPeriod) const noexcept
+double simple_moving_average<static_cast<uint32_t>(-1)>::do_pick(uint64_t const inSequenceNumber, double const inSumOverPeriod) const noexcept
 {
    if (lookback_period() <= inSequenceNumber) [[likely]]
    {
@@ -24,30 +24,57 @@
 */
 
 #include "tean/sum_over_period.hpp" /// for tean::sum_over_period
+#include "tean/compensated_sum.hpp" /// for tean::compensated_add
 
-#include <algorithm> /// for std::fill
+#include <algorithm> /// for std::min
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::isnan
 #include <cstdint> /// for uint32_t, uint64_t
-#include <memory> /// for std::make_unique
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::memory_resource
+#include <utility> /// for std::exchange
 
 namespace tean
 {
 
-sum_over_period::sum_over_period(uint32_t const inPeriod) :
+template<uint32_t inline_capacity>
+sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::sum_over_period(uint32_t const inPeriod, uint32_t const inResummationPeriod, std::pmr::memory_resource *const inMemoryResource) :
    m_period(inPeriod),
    m_lookbackPeriod(inPeriod - 1),
-   m_values(std::make_unique<double[]>(inPeriod)),
+   m_resummationPeriod(inResummationPeriod),
+   m_values(inPeriod, inMemoryResource),
 #if (not defined(NDEBUG))
    m_prevSequenceNumber(0),
 #endif
-   m_sum(0.0)
+   m_sum(0.0),
+   m_sumCompensation(0.0),
+   m_resummationCountdown(inResummationPeriod)
 {
    assert(1 < period());
-   std::fill(m_values.get(), m_values.get() + period(), 0.0);
+   m_values.reset(0.0);
 }
 
-double sum_over_period::calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+template<uint32_t inline_capacity>
+double sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::amend([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   auto const prevValue = std::exchange(m_values.newest(), inValue);
+   if (0 == resummation_period()) [[likely]]
+   {
+      m_sum += inValue - prevValue;
+      return m_sum;
+   }
+   compensated_add(m_sum, m_sumCompensation, inValue);
+   compensated_add(m_sum, m_sumCompensation, -prevValue);
+   return m_sum + m_sumCompensation;
+}
+
+template<uint32_t inline_capacity>
+double sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::calc([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -55,29 +82,195 @@ double sum_over_period::calc(uint64_t const inSequenceNumber, double const inVal
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
-   auto &prevValue = m_values[inSequenceNumber % period()];
-   m_sum += inValue - prevValue;
-   prevValue = inValue;
-   return m_sum;
+   auto const prevValue = m_values.exchange(inValue);
+   if (0 == resummation_period()) [[likely]]
+   {
+      m_sum += inValue - prevValue;
+      return m_sum;
+   }
+   compensated_add(m_sum, m_sumCompensation, inValue);
+   compensated_add(m_sum, m_sumCompensation, -prevValue);
+   if (0 == --m_resummationCountdown) [[unlikely]]
+   {
+      do_resum();
+   }
+   return m_sum + m_sumCompensation;
+}
+
+template<uint32_t inline_capacity>
+bool sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_resummationPeriod))
+      && (true == m_values.load(inReader))
+      && (true == inReader.read(m_resummationCountdown))
+      && (true == inReader.read(m_sum))
+      && (true == inReader.read(m_sumCompensation))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
 }
 
-double sum_over_period::pick(uint64_t const inSequenceNumber, double const inValue) const noexcept
+template<uint32_t inline_capacity>
+double sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::pick([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) const noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
 #endif
    assert(true == std::isfinite(inValue));
    assert(false == std::isnan(inValue));
-   return inValue - m_values[inSequenceNumber % period()] + m_sum;
+   if (0 == resummation_period()) [[likely]]
+   {
+      return inValue - m_values.oldest() + m_sum;
+   }
+   auto sum = m_sum;
+   auto sumCompensation = m_sumCompensation;
+   compensated_add(sum, sumCompensation, inValue);
+   compensated_add(sum, sumCompensation, -m_values.oldest());
+   return sum + sumCompensation;
 }
 
-void sum_over_period::reset() noexcept
+template<uint32_t inline_capacity>
+void sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::reset() noexcept
 {
-   std::fill(m_values.get(), m_values.get() + period(), 0.0);
+   m_values.reset(0.0);
 #if (not defined(NDEBUG))
    m_prevSequenceNumber = 0;
 #endif
    m_sum = 0.0;
+   m_sumCompensation = 0.0;
+   m_resummationCountdown = resummation_period();
+}
+
+template<uint32_t inline_capacity>
+void sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_resummationPeriod);
+   m_values.save(outWriter);
+   outWriter.write(m_resummationCountdown);
+   outWriter.write(m_sum);
+   outWriter.write(m_sumCompensation);
+}
+
+template<uint32_t inline_capacity>
+void sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::skip([[maybe_unused]] uint64_t const inSequenceNumber, uint64_t const inGap, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inGap);
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   auto const valuesNumber = static_cast<uint32_t>(std::min<uint64_t>(inGap, period()));
+   for (uint32_t valueIndex = 0; valueIndex < valuesNumber; ++valueIndex)
+   {
+      auto const prevValue = m_values.exchange(inValue);
+      if (0 == resummation_period()) [[likely]]
+      {
+         m_sum += inValue - prevValue;
+         continue;
+      }
+      compensated_add(m_sum, m_sumCompensation, inValue);
+      compensated_add(m_sum, m_sumCompensation, -prevValue);
+      if (0 == --m_resummationCountdown) [[unlikely]]
+      {
+         do_resum();
+      }
+   }
+   if ((0 != resummation_period()) && (inGap > valuesNumber))
+   {
+      /// The rest of the gap exchanges equal values, only the resummation schedule moves on
+      auto const restNumber = inGap - valuesNumber;
+      if (m_resummationCountdown <= restNumber)
+      {
+         do_resum();
+      }
+      else
+      {
+         m_resummationCountdown -= static_cast<uint32_t>(restNumber);
+      }
+   }
+}
+
+template<uint32_t inline_capacity>
+double sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::solve([[maybe_unused]] uint64_t const inSequenceNumber, double const inSumOverPeriod) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(true == std::isfinite(inSumOverPeriod));
+   assert(false == std::isnan(inSumOverPeriod));
+   if (0 == resummation_period()) [[likely]]
+   {
+      return inSumOverPeriod - m_sum + m_values.oldest();
+   }
+   auto sum = m_sum;
+   auto sumCompensation = m_sumCompensation;
+   compensated_add(sum, sumCompensation, -m_values.oldest());
+   return inSumOverPeriod - (sum + sumCompensation);
+}
+
+template<uint32_t inline_capacity>
+void sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::do_resum() noexcept
+{
+   m_sum = 0.0;
+   m_sumCompensation = 0.0;
+   for (auto const value : m_values.values())
+   {
+      compensated_add(m_sum, m_sumCompensation, value);
+   }
+   m_resummationCountdown = resummation_period();
+}
+
+template<uint32_t inline_capacity>
+sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::lookahead_type(sum_over_period const &inIndicator) noexcept :
+   m_indicator(std::addressof(inIndicator)),
+   m_sum(inIndicator.m_sum),
+   m_sumCompensation(inIndicator.m_sumCompensation),
+   m_valuesNumber(0)
+#if (not defined(NDEBUG))
+   , m_prevSequenceNumber(inIndicator.m_prevSequenceNumber)
+#endif
+{}
+
+template<uint32_t inline_capacity>
+double sum_over_period<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::calc([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(false == std::isnan(inValue));
+   assert(m_indicator->period() > m_valuesNumber);
+   auto const &values = m_indicator->m_values;
+   auto const prevValue = values[values.wrap(values.cursor() + m_valuesNumber)];
+   ++m_valuesNumber;
+   if (0 == m_indicator->resummation_period()) [[likely]]
+   {
+      m_sum += inValue - prevValue;
+      return m_sum;
+   }
+   compensated_add(m_sum, m_sumCompensation, inValue);
+   compensated_add(m_sum, m_sumCompensation, -prevValue);
+   return m_sum + m_sumCompensation;
 }
 
+template class sum_over_period<static_cast<uint32_t>(-1), 0>;
+template class sum_over_period<static_cast<uint32_t>(-1), 8>;
+template class sum_over_period<static_cast<uint32_t>(-1), 16>;
+template class sum_over_period<static_cast<uint32_t>(-1), 32>;
+template class sum_over_period<static_cast<uint32_t>(-1), 64>;
+
 }
@@ -24,6 +24,7 @@
 */
 
 #include "tean/true_range.hpp" /// for tean::true_range
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
 #include <algorithm> /// for std::max
 #include <cassert> /// for assert
@@ -35,6 +36,27 @@
 namespace tean
 {
 
+double true_range::amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inHigh));
+   assert(false == std::isnan(inHigh));
+   assert(true == std::isfinite(inLow));
+   assert(false == std::isnan(inLow));
+   assert(true == std::isfinite(inClose));
+   assert(false == std::isnan(inClose));
+   assert(inHigh >= inLow);
+   assert(inHigh >= inClose);
+   assert(inClose >= inLow);
+   m_close = m_prevClose;
+   auto const result = do_pick(inSequenceNumber, inHigh, inLow);
+   m_close = inClose;
+   m_range = inHigh - inLow;
+   return result;
+}
+
 double true_range::calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
 {
 #if (not defined(NDEBUG))
@@ -50,11 +72,25 @@ double true_range::calc(uint64_t const inSequenceNumber, double const inHigh, do
    assert(inHigh >= inLow);
    assert(inHigh >= inClose);
    assert(inClose >= inLow);
+   m_prevClose = m_close;
    auto const result = do_pick(inSequenceNumber, inHigh, inLow);
    m_close = inClose;
+   m_range = inHigh - inLow;
    return result;
 }
 
+bool true_range::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if ((true == inReader.read_header(inSequenceNumber)) && (true == inReader.read(m_close)) && (true == inReader.read(m_prevClose)) && (true == inReader.read(m_range)))
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
 double true_range::pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, [[maybe_unused]] double const inClose) const noexcept
 {
 #if (not defined(NDEBUG))
@@ -87,4 +123,28 @@ double true_range::do_pick(uint64_t const inSequenceNumber, double const inHigh,
    return std::numeric_limits<double>::signaling_NaN();
 }
 
+void true_range::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_close);
+   outWriter.write(m_prevClose);
+   outWriter.write(m_range);
+}
+
+double true_range::skip([[maybe_unused]] uint64_t const inSequenceNumber, [[maybe_unused]] uint64_t const inGap, gap_fill const inFill) noexcept
+{
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   m_prevClose = m_close;
+   m_range = (gap_fill::carry_forward == inFill) ? m_range : 0.0;
+   return m_range;
+}
+
 }
@@ -24,30 +24,56 @@
 */
 
 #include "tean/variance.hpp" /// for tean::variance
+#include "tean/compensated_sum.hpp" /// for tean::compensated_add
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
-#include <algorithm> /// for std::ranges::fill
+#include <algorithm> /// for std::min, std::ranges::all_of, std::ranges::fill
 #include <cassert> /// for assert
-#include <cmath> /// for std::isfinite
+#include <cmath> /// for std::isfinite, std::sqrt
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <memory> /// for std::make_unique
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::memory_resource
 #include <span> /// for std::span
+#include <utility> /// for std::exchange
 
 namespace tean
 {
 
-variance<static_cast<uint32_t>(-1)>::variance(uint32_t const inPeriod) :
+template<uint32_t inline_capacity>
+variance<static_cast<uint32_t>(-1), inline_capacity>::variance(uint32_t const inPeriod, uint32_t const inResummationPeriod, std::pmr::memory_resource *const inMemoryResource) :
    m_period(inPeriod),
    m_lookbackPeriod(inPeriod - 1),
-   m_values(std::make_unique<double[]>(inPeriod - 1))
+   m_resummationPeriod(inResummationPeriod),
+   m_resummationCountdown(inResummationPeriod),
+   m_values(inPeriod - 1, inMemoryResource)
 {
    assert(1 < period());
 #if (not defined(NDEBUG))
-   std::ranges::fill(std::span{m_values.get(), lookback_period(),}, std::numeric_limits<double>::signaling_NaN());
+   m_values.reset(std::numeric_limits<double>::signaling_NaN());
 #endif
 }
 
-double variance<static_cast<uint32_t>(-1)>::calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+template<uint32_t inline_capacity>
+double variance<static_cast<uint32_t>(-1), inline_capacity>::amend([[maybe_unused]] uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   assert(true == std::isfinite(inValue));
+   do_replace(std::exchange(m_values.newest(), inValue), inValue);
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      outMean = (m_sum + m_sumCompensation + m_evictedValue) / period();
+      auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation + m_evictedValue * m_evictedValue) / period(),};
+      return meanOfSquares - outMean * outMean;
+   }
+   outMean = std::numeric_limits<double>::signaling_NaN();
+   return std::numeric_limits<double>::signaling_NaN();
+}
+
+template<uint32_t inline_capacity>
+double variance<static_cast<uint32_t>(-1), inline_capacity>::calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -56,14 +82,38 @@ double variance<static_cast<uint32_t>(-1)>::calc(uint64_t const inSequenceNumber
    assert(true == std::isfinite(inValue));
    if (lookback_period() <= inSequenceNumber) [[likely]]
    {
-      return do_regular_calc(inSequenceNumber, inValue, outMean);
+      return do_regular_calc(inValue, outMean);
    }
-   do_lookback_calc(inSequenceNumber, inValue);
+   do_lookback_calc(inValue);
    outMean = std::numeric_limits<double>::signaling_NaN();
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-double variance<static_cast<uint32_t>(-1)>::pick(uint64_t const inSequenceNumber, double const inValue, double &outMean) const noexcept
+template<uint32_t inline_capacity>
+bool variance<static_cast<uint32_t>(-1), inline_capacity>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == inReader.expect(m_resummationPeriod))
+      && (true == m_values.load(inReader))
+      && (true == inReader.read(m_resummationCountdown))
+      && (true == inReader.read(m_sum))
+      && (true == inReader.read(m_sumOfSquares))
+      && (true == inReader.read(m_sumCompensation))
+      && (true == inReader.read(m_sumOfSquaresCompensation))
+      && (true == inReader.read(m_evictedValue))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
+template<uint32_t inline_capacity>
+double variance<static_cast<uint32_t>(-1), inline_capacity>::pick(uint64_t const inSequenceNumber, double const inValue, double &outMean) const noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
@@ -71,42 +121,282 @@ double variance<static_cast<uint32_t>(-1)>::pick(uint64_t const inSequenceNumber
    assert(true == std::isfinite(inValue));
    if (lookback_period() <= inSequenceNumber) [[likely]]
    {
-      outMean = (m_sum + inValue) / period();
-      auto const meanOfSquares{(m_sumOfSquares + inValue * inValue) / period(),};
+      outMean = (m_sum + m_sumCompensation + inValue) / period();
+      auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation + inValue * inValue) / period(),};
       return meanOfSquares - outMean * outMean;
    }
    outMean = std::numeric_limits<double>::signaling_NaN();
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-void variance<static_cast<uint32_t>(-1)>::reset() noexcept
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::pick_many(
+   uint64_t const inSequenceNumber,
+   std::span<double const> const inValues,
+   std::span<double> const outValues,
+   std::span<double> const outMeans
+) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(inValues.size() == outValues.size());
+   assert(inValues.size() == outMeans.size());
+   assert(true == std::ranges::all_of(inValues, [] (double const inValue) { return std::isfinite(inValue); }));
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      /// Locals keep the loop free of reloads through the output spans
+      auto const sum{m_sum + m_sumCompensation,};
+      auto const sumOfSquares{m_sumOfSquares + m_sumOfSquaresCompensation,};
+      auto const valuesNumber{static_cast<double>(period()),};
+      for (size_t valueIndex{0,}; valueIndex < inValues.size(); ++valueIndex)
+      {
+         auto const value{inValues[valueIndex],};
+         auto const mean{(sum + value) / valuesNumber,};
+         outMeans[valueIndex] = mean;
+         outValues[valueIndex] = (sumOfSquares + value * value) / valuesNumber - mean * mean;
+      }
+      return;
+   }
+   std::ranges::fill(outMeans, std::numeric_limits<double>::signaling_NaN());
+   std::ranges::fill(outValues, std::numeric_limits<double>::signaling_NaN());
+}
+
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::reset() noexcept
 {
    m_sum = 0;
    m_sumOfSquares = 0;
+   m_sumCompensation = 0;
+   m_sumOfSquaresCompensation = 0;
+   m_resummationCountdown = resummation_period();
+   m_values.seek(0);
 #if (not defined(NDEBUG))
-   std::ranges::fill(std::span{m_values.get(), lookback_period(),}, std::numeric_limits<double>::signaling_NaN());
+   m_values.reset(std::numeric_limits<double>::signaling_NaN());
    m_prevSequenceNumber = 0;
 #endif
 }
 
-void variance<static_cast<uint32_t>(-1)>::do_lookback_calc(uint64_t const inSequenceNumber, double const inValue) noexcept
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   outWriter.write(m_resummationPeriod);
+   m_values.save(outWriter);
+   outWriter.write(m_resummationCountdown);
+   outWriter.write(m_sum);
+   outWriter.write(m_sumOfSquares);
+   outWriter.write(m_sumCompensation);
+   outWriter.write(m_sumOfSquaresCompensation);
+   outWriter.write(m_evictedValue);
+}
+
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+{
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   assert(gap_fill::decay_only != inFill);
+   auto const value = m_values.newest();
+   auto const valuesNumber = std::min<uint64_t>(inGap, period());
+   for (auto sequenceNumber = inSequenceNumber; sequenceNumber < (inSequenceNumber + valuesNumber); ++sequenceNumber)
+   {
+      if (lookback_period() <= sequenceNumber) [[likely]]
+      {
+         double mean{};
+         [[maybe_unused]] auto const varianceValue = do_regular_calc(value, mean);
+      }
+      else
+      {
+         do_lookback_calc(value);
+      }
+   }
+   if ((0 != resummation_period()) && (inGap > valuesNumber))
+   {
+      /// Once the window only holds copies of the value, the rest of the gap exchanges equal values and only the resummation schedule moves on
+      auto const restNumber = inGap - valuesNumber;
+      if (m_resummationCountdown <= restNumber)
+      {
+         do_resum();
+      }
+      else
+      {
+         m_resummationCountdown -= static_cast<uint32_t>(restNumber);
+      }
+   }
+}
+
+template<uint32_t inline_capacity>
+double variance<static_cast<uint32_t>(-1), inline_capacity>::solve_z_score(uint64_t const inSequenceNumber, double const inZScore) const noexcept
 {
-   m_sum += inValue;
-   m_sumOfSquares += inValue * inValue;
-   m_values[inSequenceNumber % lookback_period()] = inValue;
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(true == std::isfinite(inZScore));
+   assert(false == std::isnan(inZScore));
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      /// A value d away from the mean of the n - 1 retained values, whose squared deviations add up to m,
+      /// has z = d (n - 1) / sqrt(n m + d^2 (n - 1)), hence d^2 = z^2 n m / ((n - 1) (n - 1 - z^2))
+      auto const retainedNumber{static_cast<double>(lookback_period()),};
+      auto const retainedSum{m_sum + m_sumCompensation,};
+      auto const retainedMean{retainedSum / retainedNumber,};
+      auto const retainedSquaredDeviations{std::max(m_sumOfSquares + m_sumOfSquaresCompensation - retainedSum * retainedMean, 0.0),};
+      auto const reach{retainedNumber - inZScore * inZScore,};
+      if ((0.0 == inZScore) || ((0 < reach) && (0 < retainedSquaredDeviations)))
+      {
+         return retainedMean + inZScore * std::sqrt(static_cast<double>(period()) * retainedSquaredDeviations / (retainedNumber * reach));
+      }
+   }
+   return std::numeric_limits<double>::signaling_NaN();
 }
 
-double variance<static_cast<uint32_t>(-1)>::do_regular_calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::do_add(double const inValue) noexcept
 {
-   m_sum += inValue;
-   m_sumOfSquares += inValue * inValue;
-   outMean = m_sum / period();
-   auto const meanOfSquares{m_sumOfSquares / period(),};
-   auto &prevValue{m_values[inSequenceNumber % lookback_period()],};
-   m_sum -= prevValue;
-   m_sumOfSquares -= prevValue * prevValue;
-   prevValue = inValue;
+   if (0 == resummation_period()) [[likely]]
+   {
+      m_sum += inValue;
+      m_sumOfSquares += inValue * inValue;
+   }
+   else
+   {
+      compensated_add(m_sum, m_sumCompensation, inValue);
+      compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, inValue * inValue);
+   }
+}
+
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::do_lookback_calc(double const inValue) noexcept
+{
+   do_add(inValue);
+   m_values.push(inValue);
+}
+
+template<uint32_t inline_capacity>
+double variance<static_cast<uint32_t>(-1), inline_capacity>::do_regular_calc(double const inValue, double &outMean) noexcept
+{
+   do_add(inValue);
+   outMean = (m_sum + m_sumCompensation) / period();
+   auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation) / period(),};
+   auto const prevValue{m_values.exchange(inValue),};
+   m_evictedValue = prevValue;
+   if (0 == resummation_period()) [[likely]]
+   {
+      m_sum -= prevValue;
+      m_sumOfSquares -= prevValue * prevValue;
+   }
+   else
+   {
+      compensated_add(m_sum, m_sumCompensation, -prevValue);
+      compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, -prevValue * prevValue);
+      if (0 == --m_resummationCountdown) [[unlikely]]
+      {
+         do_resum();
+      }
+   }
    return meanOfSquares - outMean * outMean;
 }
 
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::do_replace(double const inPrevValue, double const inValue) noexcept
+{
+   if (0 == resummation_period()) [[likely]]
+   {
+      m_sum += inValue - inPrevValue;
+      m_sumOfSquares += inValue * inValue - inPrevValue * inPrevValue;
+   }
+   else
+   {
+      compensated_add(m_sum, m_sumCompensation, inValue);
+      compensated_add(m_sum, m_sumCompensation, -inPrevValue);
+      compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, inValue * inValue);
+      compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, -inPrevValue * inPrevValue);
+   }
+}
+
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::do_resum() noexcept
+{
+   m_sum = 0;
+   m_sumOfSquares = 0;
+   m_sumCompensation = 0;
+   m_sumOfSquaresCompensation = 0;
+   for (auto const value : m_values.values())
+   {
+      compensated_add(m_sum, m_sumCompensation, value);
+      compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, value * value);
+   }
+   m_resummationCountdown = resummation_period();
+}
+
+template<uint32_t inline_capacity>
+variance<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::lookahead_type(variance const &inIndicator) noexcept :
+   m_indicator(std::addressof(inIndicator)),
+   m_sum(inIndicator.m_sum),
+   m_sumOfSquares(inIndicator.m_sumOfSquares),
+   m_sumCompensation(inIndicator.m_sumCompensation),
+   m_sumOfSquaresCompensation(inIndicator.m_sumOfSquaresCompensation),
+   m_valuesNumber(0)
+#if (not defined(NDEBUG))
+   , m_prevSequenceNumber(inIndicator.m_prevSequenceNumber)
+#endif
+{}
+
+template<uint32_t inline_capacity>
+double variance<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::calc(uint64_t const inSequenceNumber, double const inValue, double &outMean) noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(true == std::isfinite(inValue));
+   assert(m_indicator->period() > m_valuesNumber);
+   /// A regular calc evicts the oldest value after it is done, so the eviction is deferred to the following value
+   if ((0 < m_valuesNumber) && (m_indicator->lookback_period() < inSequenceNumber))
+   {
+      auto const &values{m_indicator->m_values,};
+      auto const prevValue{values[values.wrap(values.cursor() + m_valuesNumber - 1)],};
+      do_add(-prevValue, -prevValue * prevValue);
+   }
+   ++m_valuesNumber;
+   do_add(inValue, inValue * inValue);
+   if (m_indicator->lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      outMean = (m_sum + m_sumCompensation) / m_indicator->period();
+      auto const meanOfSquares{(m_sumOfSquares + m_sumOfSquaresCompensation) / m_indicator->period(),};
+      return meanOfSquares - outMean * outMean;
+   }
+   outMean = std::numeric_limits<double>::signaling_NaN();
+   return std::numeric_limits<double>::signaling_NaN();
+}
+
+template<uint32_t inline_capacity>
+void variance<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::do_add(double const inValue, double const inSquare) noexcept
+{
+   if (0 == m_indicator->resummation_period()) [[likely]]
+   {
+      m_sum += inValue;
+      m_sumOfSquares += inSquare;
+   }
+   else
+   {
+      compensated_add(m_sum, m_sumCompensation, inValue);
+      compensated_add(m_sumOfSquares, m_sumOfSquaresCompensation, inSquare);
+   }
+}
+
+template class variance<static_cast<uint32_t>(-1), 0>;
+template class variance<static_cast<uint32_t>(-1), 8>;
+template class variance<static_cast<uint32_t>(-1), 16>;
+template class variance<static_cast<uint32_t>(-1), 32>;
+template class variance<static_cast<uint32_t>(-1), 64>;
+
 }
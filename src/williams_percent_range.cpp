@@ -24,42 +24,60 @@
 */
 
 #include "tean/williams_percent_range.hpp" /// for tean::williams_percent_range
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
-#include <algorithm> /// for std::fill
+#include <algorithm> /// for std::max, std::min, std::ranges::all_of, std::ranges::fill
 #include <cassert> /// for assert
 #include <cmath> /// for std::isfinite, std::isnan
+#include <cstddef> /// for size_t
 #include <cstdint> /// for uint32_t, uint64_t
 #include <limits> /// for std::numeric_limits
-#include <memory> /// for std::make_unique
-#include <tuple> /// for std::tie
-#include <utility> /// for std::pair
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::memory_resource
+#include <span> /// for std::span
 
 namespace tean
 {
 
-williams_percent_range::williams_percent_range(uint32_t const inPeriod) :
+namespace
+{
+
+static double percent_range(double const inHighestHigh, double const inLowestLow, double const inClose) noexcept
+{
+   assert(inHighestHigh >= inLowestLow);
+   auto const delta = (inHighestHigh - inLowestLow);
+   /// A flat range has the close at the highest high, so dividing by one yields zero and keeps candidate loops branchless
+   return 100.0 * (inClose - inHighestHigh) / (delta + static_cast<double>(0.0 == delta));
+}
+
+}
+
+template<uint32_t inline_capacity>
+williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::williams_percent_range(uint32_t const inPeriod, std::pmr::memory_resource *const inMemoryResource) :
    m_period(inPeriod),
    m_lookbackPeriod(inPeriod - 1),
-   m_highValues(std::make_unique<double[]>(inPeriod)),
-   m_lowValues(std::make_unique<double[]>(inPeriod)),
+   m_values(inPeriod, inMemoryResource),
+   m_highestHighIndices(inPeriod, inMemoryResource),
+   m_lowestLowIndices(inPeriod, inMemoryResource),
 #if (not defined(NDEBUG))
    m_prevSequenceNumber(0),
 #endif
-   m_highestHighIndex(0),
-   m_lowestLowIndex(0)
+   m_highestHighIndicesHead(0),
+   m_highestHighIndicesSize(0),
+   m_lowestLowIndicesHead(0),
+   m_lowestLowIndicesSize(0)
 {
    assert(1 < period());
 #if (not defined(NDEBUG))
-   std::fill(m_highValues.get(), m_highValues.get() + period(), std::numeric_limits<double>::signaling_NaN());
-   std::fill(m_lowValues.get(), m_lowValues.get() + period(), std::numeric_limits<double>::signaling_NaN());
+   m_values.reset(high_low{.high = std::numeric_limits<double>::signaling_NaN(), .low = std::numeric_limits<double>::signaling_NaN()});
 #endif
 }
 
-double williams_percent_range::calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+template<uint32_t inline_capacity>
+double williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::amend(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
 {
 #if (not defined(NDEBUG))
-   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
-   m_prevSequenceNumber = inSequenceNumber;
+   assert(m_prevSequenceNumber == inSequenceNumber);
 #endif
    assert(true == std::isfinite(inHigh));
    assert(false == std::isnan(inHigh));
@@ -70,17 +88,24 @@ double williams_percent_range::calc(uint64_t const inSequenceNumber, double cons
    assert(inHigh >= inLow);
    assert(inHigh >= inClose);
    assert(inClose >= inLow);
-   if (lookback_period() < inSequenceNumber) [[likely]]
+   m_values.newest() = high_low{.high = inHigh, .low = inLow};
+   if (lookback_period() <= inSequenceNumber) [[likely]]
    {
-      return do_regular_calc(inSequenceNumber, inHigh, inLow, inClose);
+      return percent_range(
+         std::max(m_values[m_highestHighIndices[m_highestHighIndicesHead]].high, inHigh),
+         std::min(m_values[m_lowestLowIndices[m_lowestLowIndicesHead]].low, inLow),
+         inClose
+      );
    }
-   return do_lookback_calc(inSequenceNumber, inHigh, inLow, inClose);
+   return std::numeric_limits<double>::signaling_NaN();
 }
 
-double williams_percent_range::pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) const noexcept
+template<uint32_t inline_capacity>
+double williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
 {
 #if (not defined(NDEBUG))
    assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
 #endif
    assert(true == std::isfinite(inHigh));
    assert(false == std::isnan(inHigh));
@@ -91,155 +116,403 @@ double williams_percent_range::pick(uint64_t const inSequenceNumber, double cons
    assert(inHigh >= inLow);
    assert(inHigh >= inClose);
    assert(inClose >= inLow);
-   if (lookback_period() < inSequenceNumber) [[likely]]
+   if (0 == inSequenceNumber) [[unlikely]]
    {
-      return do_regular_pick(inSequenceNumber, inHigh, inLow, inClose);
+      m_values.push(high_low{.high = inHigh, .low = inLow});
+      return std::numeric_limits<double>::signaling_NaN();
    }
-   if (lookback_period() == inSequenceNumber) [[unlikely]]
+   do_calc(inHigh, inLow);
+   if (lookback_period() <= inSequenceNumber) [[likely]]
    {
-      return do_lookback_pick(inHigh, inLow, inClose);
+      return percent_range(
+         std::max(m_values[m_highestHighIndices[m_highestHighIndicesHead]].high, inHigh),
+         std::min(m_values[m_lowestLowIndices[m_lowestLowIndicesHead]].low, inLow),
+         inClose
+      );
    }
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-void williams_percent_range::reset() noexcept
-{
-#if (not defined(NDEBUG))
-   std::fill(m_highValues.get(), m_highValues.get() + period(), std::numeric_limits<double>::signaling_NaN());
-   std::fill(m_lowValues.get(), m_lowValues.get() + period(), std::numeric_limits<double>::signaling_NaN());
-   m_prevSequenceNumber = 0;
-#endif
-   m_highestHighIndex = 0;
-   m_lowestLowIndex = 0;
-}
-
-double williams_percent_range::do_lookback_calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::calc(
+   uint64_t const inSequenceNumber,
+   std::span<double const> const inHighs,
+   std::span<double const> const inLows,
+   std::span<double const> const inCloses,
+   std::span<double> const outValues
+) noexcept
 {
-   auto const arrayIndex = static_cast<uint32_t>(inSequenceNumber % period());
-   m_highValues[arrayIndex] = inHigh;
-   m_lowValues[arrayIndex] = inLow;
-   if (lookback_period() == inSequenceNumber) [[unlikely]]
+   assert(inHighs.size() == outValues.size());
+   assert(inLows.size() == outValues.size());
+   assert(inCloses.size() == outValues.size());
+   assert(true == std::ranges::all_of(inHighs, [] (double const inHigh) { return std::isfinite(inHigh); }));
+   assert(true == std::ranges::all_of(inLows, [] (double const inLow) { return std::isfinite(inLow); }));
+   assert(true == std::ranges::all_of(inCloses, [] (double const inClose) { return std::isfinite(inClose); }));
+   /// Windows overlapping values preceding the batch are served by the streaming path
+   auto const streamingSize = std::min<size_t>(lookback_period(), outValues.size());
+   for (size_t valueIndex = 0; valueIndex < streamingSize; ++valueIndex)
    {
-      m_highestHighIndex = 0;
-      auto highestHigh = m_highValues[0];
-      for (uint32_t highValuesIndex = 1; highValuesIndex < period(); ++highValuesIndex)
+      outValues[valueIndex] = calc(inSequenceNumber + valueIndex, inHighs[valueIndex], inLows[valueIndex], inCloses[valueIndex]);
+   }
+   if (outValues.size() < period())
+   {
+      return;
+   }
+   /// van Herk/Gil-Werman: block suffix highs are stored in-place, block suffix lows use the values ring as scratch,
+   /// both are merged with the prefix highs/lows of the next block
+   for (size_t blockBegin = 0; (blockBegin + period()) <= outValues.size(); blockBegin += period())
+   {
+      auto const blockEnd = blockBegin + period();
+      auto suffixHigh = std::numeric_limits<double>::lowest();
+      auto suffixLow = std::numeric_limits<double>::max();
+      for (auto valueIndex = blockEnd; blockBegin != valueIndex--; )
       {
-         if (m_highValues[highValuesIndex] > highestHigh)
+         suffixHigh = std::max(suffixHigh, inHighs[valueIndex]);
+         suffixLow = std::min(suffixLow, inLows[valueIndex]);
+         if (auto const outIndex = valueIndex + lookback_period(); outIndex < outValues.size())
          {
-            m_highestHighIndex = highValuesIndex;
-            highestHigh = m_highValues[highValuesIndex];
+            outValues[outIndex] = suffixHigh;
          }
+         m_values[valueIndex - blockBegin].low = suffixLow;
       }
-      m_lowestLowIndex = 0;
-      auto lowestLow = m_lowValues[0];
-      for (uint32_t lowValuesIndex = 1; lowValuesIndex < period(); ++lowValuesIndex)
+      outValues[blockEnd - 1] = percent_range(suffixHigh, suffixLow, inCloses[blockEnd - 1]);
+      auto prefixHigh = std::numeric_limits<double>::lowest();
+      auto prefixLow = std::numeric_limits<double>::max();
+      for (auto valueIndex = blockEnd, valueEnd = std::min<size_t>(blockEnd + lookback_period(), outValues.size()); valueIndex < valueEnd; ++valueIndex)
       {
-         if (m_lowValues[lowValuesIndex] < lowestLow)
-         {
-            m_lowestLowIndex = lowValuesIndex;
-            lowestLow = m_lowValues[lowValuesIndex];
-         }
+         prefixHigh = std::max(prefixHigh, inHighs[valueIndex]);
+         prefixLow = std::min(prefixLow, inLows[valueIndex]);
+         outValues[valueIndex] = percent_range(
+            std::max(outValues[valueIndex], prefixHigh),
+            std::min(m_values[valueIndex - blockEnd + 1].low, prefixLow),
+            inCloses[valueIndex]
+         );
       }
-      assert(highestHigh >= lowestLow);
-      auto const delta = (highestHigh - lowestLow);
-      return (0.0 == delta) ? 0.0 : (-100.0 * (highestHigh - inClose) / delta);
+   }
+   /// Rebuild the streaming state from the last period of the batch
+#if (not defined(NDEBUG))
+   m_prevSequenceNumber = inSequenceNumber + outValues.size() - 1;
+#endif
+   m_highestHighIndicesHead = 0;
+   m_highestHighIndicesSize = 0;
+   m_lowestLowIndicesHead = 0;
+   m_lowestLowIndicesSize = 0;
+   m_values.seek(static_cast<uint32_t>((inSequenceNumber + outValues.size()) % period()));
+   for (auto valueIndex = outValues.size() - period(); valueIndex < outValues.size(); ++valueIndex)
+   {
+      m_values.push(high_low{.high = inHighs[valueIndex], .low = inLows[valueIndex]});
+   }
+   for (uint32_t valueIndex = 0; valueIndex < lookback_period(); ++valueIndex)
+   {
+      do_push_high(m_values.wrap(m_values.cursor() + valueIndex));
+      do_push_low(m_values.wrap(m_values.cursor() + valueIndex));
+   }
+}
+
+template<uint32_t inline_capacity>
+bool williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::load(uint64_t const inSequenceNumber, state_reader &inReader) noexcept
+{
+   if (
+      (true == inReader.read_header(inSequenceNumber))
+      && (true == m_values.load(inReader))
+      && (true == inReader.read_deque(m_highestHighIndices, m_highestHighIndicesHead, m_highestHighIndicesSize, period()))
+      && (true == inReader.read_deque(m_lowestLowIndices, m_lowestLowIndicesHead, m_lowestLowIndicesSize, period()))
+   )
+   {
+#if (not defined(NDEBUG))
+      m_prevSequenceNumber = inSequenceNumber;
+#endif
+      return true;
+   }
+   return false;
+}
+
+template<uint32_t inline_capacity>
+double williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(true == std::isfinite(inHigh));
+   assert(false == std::isnan(inHigh));
+   assert(true == std::isfinite(inLow));
+   assert(false == std::isnan(inLow));
+   assert(true == std::isfinite(inClose));
+   assert(false == std::isnan(inClose));
+   assert(inHigh >= inLow);
+   assert(inHigh >= inClose);
+   assert(inClose >= inLow);
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      return percent_range(get_highest_high(m_values.cursor(), inHigh), get_lowest_low(m_values.cursor(), inLow), inClose);
    }
    return std::numeric_limits<double>::signaling_NaN();
 }
 
-double williams_percent_range::do_lookback_pick(double const inHigh, double const inLow, double const inClose) const noexcept
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::pick_many(
+   uint64_t const inSequenceNumber,
+   double const inHigh,
+   double const inLow,
+   std::span<double const> const inCloses,
+   std::span<double> const outValues
+) const noexcept
 {
-   auto highestHigh = inHigh;
-   for (uint32_t highValuesIndex = 0; highValuesIndex < lookback_period(); ++highValuesIndex)
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(true == std::isfinite(inHigh));
+   assert(false == std::isnan(inHigh));
+   assert(true == std::isfinite(inLow));
+   assert(false == std::isnan(inLow));
+   assert(inHigh >= inLow);
+   assert(inCloses.size() == outValues.size());
+   assert(true == std::ranges::all_of(inCloses, [] (double const inClose) { return std::isfinite(inClose); }));
+   if (lookback_period() <= inSequenceNumber) [[likely]]
    {
-      if (m_highValues[highValuesIndex] > highestHigh)
+      /// The forming bar widens to cover each candidate close, the window extremes are resolved once for all candidates
+      auto const highestHigh = get_highest_high(m_values.cursor(), inHigh);
+      auto const lowestLow = get_lowest_low(m_values.cursor(), inLow);
+      for (size_t valueIndex = 0; valueIndex < inCloses.size(); ++valueIndex)
       {
-         highestHigh = m_highValues[highValuesIndex];
+         auto const close = inCloses[valueIndex];
+         outValues[valueIndex] = percent_range(std::max(highestHigh, close), std::min(lowestLow, close), close);
       }
+      return;
    }
-   auto lowestLow = inLow;
-   for (uint32_t lowValuesIndex = 0; lowValuesIndex < lookback_period(); ++lowValuesIndex)
+   std::ranges::fill(outValues, std::numeric_limits<double>::signaling_NaN());
+}
+
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::reset() noexcept
+{
+   m_values.seek(0);
+#if (not defined(NDEBUG))
+   m_values.reset(high_low{.high = std::numeric_limits<double>::signaling_NaN(), .low = std::numeric_limits<double>::signaling_NaN()});
+   m_prevSequenceNumber = 0;
+#endif
+   m_highestHighIndicesHead = 0;
+   m_highestHighIndicesSize = 0;
+   m_lowestLowIndicesHead = 0;
+   m_lowestLowIndicesSize = 0;
+}
+
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::save(uint64_t const inSequenceNumber, state_writer &outWriter) const
+{
+#if (not defined(NDEBUG))
+   assert(m_prevSequenceNumber == inSequenceNumber);
+#endif
+   outWriter.write_header(inSequenceNumber);
+   m_values.save(outWriter);
+   outWriter.write_deque(m_highestHighIndices, m_highestHighIndicesHead, m_highestHighIndicesSize, period());
+   outWriter.write_deque(m_lowestLowIndices, m_lowestLowIndicesHead, m_lowestLowIndicesSize, period());
+}
+
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::skip(uint64_t const inSequenceNumber, uint64_t const inGap, [[maybe_unused]] gap_fill const inFill) noexcept
+{
+#if (not defined(NDEBUG))
+   assert((m_prevSequenceNumber + 1) == inSequenceNumber);
+   m_prevSequenceNumber = inSequenceNumber + inGap - 1;
+#endif
+   assert(0 < inSequenceNumber);
+   assert(0 < inGap);
+   assert(gap_fill::carry_forward == inFill);
+   auto const value = m_values.newest();
+   for (auto valuesNumber = std::min<uint64_t>(inGap, period()); 0 < valuesNumber; --valuesNumber)
+   {
+      do_calc(value.high, value.low);
+   }
+   if (inGap > period())
    {
-      if (m_lowValues[lowValuesIndex] < lowestLow)
+      /// The window only holds copies of the bar, so the rest of the gap just moves the cursor and the newest committed copy heads the deques
+      m_values.seek(static_cast<uint32_t>((inSequenceNumber + inGap) % period()));
+      m_highestHighIndicesHead = 0;
+      m_highestHighIndicesSize = 1;
+      m_highestHighIndices[0] = m_values.wrap(m_values.cursor() + lookback_period() - 1);
+      m_lowestLowIndicesHead = 0;
+      m_lowestLowIndicesSize = 1;
+      m_lowestLowIndices[0] = m_highestHighIndices[0];
+   }
+}
+
+template<uint32_t inline_capacity>
+double williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::solve(
+   uint64_t const inSequenceNumber,
+   double const inHigh,
+   double const inLow,
+   double const inPercentRange
+) const noexcept
+{
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+#endif
+   assert(true == std::isfinite(inHigh));
+   assert(false == std::isnan(inHigh));
+   assert(true == std::isfinite(inLow));
+   assert(false == std::isnan(inLow));
+   assert(inHigh >= inLow);
+   assert((-100 <= inPercentRange) && (0 >= inPercentRange));
+   if (lookback_period() <= inSequenceNumber) [[likely]]
+   {
+      auto const highestHigh = get_highest_high(m_values.cursor(), inHigh);
+      auto const lowestLow = get_lowest_low(m_values.cursor(), inLow);
+      if ((highestHigh > lowestLow) || (0 == inPercentRange))
       {
-         lowestLow = m_lowValues[lowValuesIndex];
+         return highestHigh + inPercentRange * (highestHigh - lowestLow) / 100.0;
       }
    }
-   assert(highestHigh >= lowestLow);
-   auto const delta = (highestHigh - lowestLow);
-   return (0.0 == delta) ? 0.0 : (-100.0 * (highestHigh - inClose) / delta);
+   return std::numeric_limits<double>::signaling_NaN();
 }
 
-double williams_percent_range::do_regular_calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::do_calc(double const inHigh, double const inLow) noexcept
 {
-   double highestHigh;
-   double lowestLow;
+   auto const newestIndex = m_values.wrap(m_values.cursor() + lookback_period());
+   do_push_high(newestIndex);
+   if (m_values.cursor() == m_highestHighIndices[m_highestHighIndicesHead])
+   {
+      m_highestHighIndicesHead = m_values.wrap(m_highestHighIndicesHead + 1);
+      --m_highestHighIndicesSize;
+   }
+   do_push_low(newestIndex);
+   if (m_values.cursor() == m_lowestLowIndices[m_lowestLowIndicesHead])
    {
-      auto const arrayIndex = static_cast<uint32_t>(inSequenceNumber % period());
-      std::tie(m_highestHighIndex, highestHigh) = get_highest_high(arrayIndex, inHigh);
-      m_highValues[arrayIndex] = inHigh;
-      std::tie(m_lowestLowIndex, lowestLow) = get_lowest_low(arrayIndex, inLow);
-      m_lowValues[arrayIndex] = inLow;
+      m_lowestLowIndicesHead = m_values.wrap(m_lowestLowIndicesHead + 1);
+      --m_lowestLowIndicesSize;
    }
-   assert(highestHigh >= lowestLow);
-   auto const delta = (highestHigh - lowestLow);
-   return (0.0 == delta) ? 0.0 : (-100.0 * (highestHigh - inClose) / delta);
+   m_values.push(high_low{.high = inHigh, .low = inLow});
 }
 
-double williams_percent_range::do_regular_pick(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) const noexcept
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::do_push_high(uint32_t const inIndex) noexcept
 {
-   auto const arrayIndex = static_cast<uint32_t>(inSequenceNumber % period());
-   auto const highestHigh = get_highest_high(arrayIndex, inHigh).second;
-   auto const lowestLow = get_lowest_low(arrayIndex, inLow).second;
-   assert(highestHigh >= lowestLow);
-   auto const delta = (highestHigh - lowestLow);
-   return (0.0 == delta) ? 0.0 : (-100.0 * (highestHigh - inClose) / delta);
+   while ((0 < m_highestHighIndicesSize) && (m_values[m_highestHighIndices[m_values.wrap(m_highestHighIndicesHead + m_highestHighIndicesSize - 1)]].high <= m_values[inIndex].high))
+   {
+      --m_highestHighIndicesSize;
+   }
+   m_highestHighIndices[m_values.wrap(m_highestHighIndicesHead + m_highestHighIndicesSize)] = inIndex;
+   ++m_highestHighIndicesSize;
 }
 
-std::pair<uint32_t, double> williams_percent_range::get_highest_high(uint32_t const inIndex, double const inValue) const noexcept
+template<uint32_t inline_capacity>
+void williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::do_push_low(uint32_t const inIndex) noexcept
 {
-   if (inValue >= m_highValues[m_highestHighIndex])
+   while ((0 < m_lowestLowIndicesSize) && (m_values[m_lowestLowIndices[m_values.wrap(m_lowestLowIndicesHead + m_lowestLowIndicesSize - 1)]].low >= m_values[inIndex].low))
    {
-      return {inIndex, inValue};
+      --m_lowestLowIndicesSize;
    }
-   if (inIndex == m_highestHighIndex)
+   m_lowestLowIndices[m_values.wrap(m_lowestLowIndicesHead + m_lowestLowIndicesSize)] = inIndex;
+   ++m_lowestLowIndicesSize;
+}
+
+template<uint32_t inline_capacity>
+double williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::get_highest_high(uint32_t const inValueIndex, double const inHigh) const noexcept
+{
+   auto highestHighIndicesHead = m_highestHighIndicesHead;
+   auto highestHighIndicesSize = m_highestHighIndicesSize;
+   if ((0 < highestHighIndicesSize) && (inValueIndex == m_highestHighIndices[highestHighIndicesHead]))
    {
-      auto highestHighIndex = inIndex;
-      auto highestHigh = inValue;
-      for (uint32_t highValuesIndex = 0; highValuesIndex < period(); ++highValuesIndex)
-      {
-         if ((inIndex != highValuesIndex) && (m_highValues[highValuesIndex] > highestHigh))
-         {
-            highestHighIndex = highValuesIndex;
-            highestHigh = m_highValues[highValuesIndex];
-         }
-      }
-      return {highestHighIndex, highestHigh};
+      highestHighIndicesHead = m_values.wrap(highestHighIndicesHead + 1);
+      --highestHighIndicesSize;
+   }
+   /// The bar of the latest calc is not in the deque yet
+   auto const highestHigh = std::max(m_values.newest().high, inHigh);
+   return (0 == highestHighIndicesSize)
+      ? highestHigh
+      : std::max(m_values[m_highestHighIndices[highestHighIndicesHead]].high, highestHigh)
+   ;
+}
+
+template<uint32_t inline_capacity>
+double williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::get_lowest_low(uint32_t const inValueIndex, double const inLow) const noexcept
+{
+   auto lowestLowIndicesHead = m_lowestLowIndicesHead;
+   auto lowestLowIndicesSize = m_lowestLowIndicesSize;
+   if ((0 < lowestLowIndicesSize) && (inValueIndex == m_lowestLowIndices[lowestLowIndicesHead]))
+   {
+      lowestLowIndicesHead = m_values.wrap(lowestLowIndicesHead + 1);
+      --lowestLowIndicesSize;
    }
-   return {m_highestHighIndex, m_highValues[m_highestHighIndex]};
+   /// The bar of the latest calc is not in the deque yet
+   auto const lowestLow = std::min(m_values.newest().low, inLow);
+   return (0 == lowestLowIndicesSize)
+      ? lowestLow
+      : std::min(m_values[m_lowestLowIndices[lowestLowIndicesHead]].low, lowestLow)
+   ;
 }
 
-std::pair<uint32_t, double> williams_percent_range::get_lowest_low(uint32_t const inIndex, double const inValue) const noexcept
+template<uint32_t inline_capacity>
+williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::lookahead_type(williams_percent_range const &inIndicator) noexcept :
+   m_indicator(std::addressof(inIndicator)),
+   m_highestHighIndicesHead(inIndicator.m_highestHighIndicesHead),
+   m_highestHighIndicesSize(inIndicator.m_highestHighIndicesSize),
+   m_lowestLowIndicesHead(inIndicator.m_lowestLowIndicesHead),
+   m_lowestLowIndicesSize(inIndicator.m_lowestLowIndicesSize),
+   m_valuesNumber(0),
+   m_highestHigh(0.0),
+   m_lowestLow(0.0)
+#if (not defined(NDEBUG))
+   , m_prevSequenceNumber(inIndicator.m_prevSequenceNumber)
+#endif
+{}
+
+template<uint32_t inline_capacity>
+double williams_percent_range<static_cast<uint32_t>(-1), inline_capacity>::lookahead_type::calc(uint64_t const inSequenceNumber, double const inHigh, double const inLow, double const inClose) noexcept
 {
-   if (inValue <= m_lowValues[m_lowestLowIndex])
+#if (not defined(NDEBUG))
+   assert(((m_prevSequenceNumber + 1) == inSequenceNumber) || ((0 == m_prevSequenceNumber) && (0 == inSequenceNumber)));
+   m_prevSequenceNumber = inSequenceNumber;
+#endif
+   assert(true == std::isfinite(inHigh));
+   assert(false == std::isnan(inHigh));
+   assert(true == std::isfinite(inLow));
+   assert(false == std::isnan(inLow));
+   assert(true == std::isfinite(inClose));
+   assert(false == std::isnan(inClose));
+   assert(inHigh >= inLow);
+   assert(inHigh >= inClose);
+   assert(inClose >= inLow);
+   assert(m_indicator->period() > m_valuesNumber);
+   auto const &values = m_indicator->m_values;
+   /// The j-th hypothetical value pushes out the committed values up to the j-th oldest slot
+   while ((0 < m_highestHighIndicesSize) && (m_valuesNumber >= values.wrap(m_indicator->m_highestHighIndices[m_highestHighIndicesHead] + m_indicator->period() - values.cursor())))
+   {
+      m_highestHighIndicesHead = values.wrap(m_highestHighIndicesHead + 1);
+      --m_highestHighIndicesSize;
+   }
+   while ((0 < m_lowestLowIndicesSize) && (m_valuesNumber >= values.wrap(m_indicator->m_lowestLowIndices[m_lowestLowIndicesHead] + m_indicator->period() - values.cursor())))
    {
-      return {inIndex, inValue};
+      m_lowestLowIndicesHead = values.wrap(m_lowestLowIndicesHead + 1);
+      --m_lowestLowIndicesSize;
    }
-   if (inIndex == m_lowestLowIndex)
+   m_highestHigh = ((0 == m_valuesNumber) || (m_highestHigh < inHigh)) ? inHigh : m_highestHigh;
+   m_lowestLow = ((0 == m_valuesNumber) || (inLow < m_lowestLow)) ? inLow : m_lowestLow;
+   ++m_valuesNumber;
+   if (m_indicator->lookback_period() <= inSequenceNumber) [[likely]]
    {
-      auto lowestLowIndex = inIndex;
-      auto lowestLow = inValue;
-      for (uint32_t lowValuesIndex = 0; lowValuesIndex < period(); ++lowValuesIndex)
+      auto highestHigh = m_highestHigh;
+      auto lowestLow = m_lowestLow;
+      if (m_indicator->period() > m_valuesNumber)
       {
-         if ((inIndex != lowValuesIndex) && (m_lowValues[lowValuesIndex] < lowestLow))
-         {
-            lowestLowIndex = lowValuesIndex;
-            lowestLow = m_lowValues[lowValuesIndex];
-         }
+         /// The bar of the latest calc is not in the deques yet, it leaves the window with the last hypothetical bar
+         highestHigh = std::max(values.newest().high, highestHigh);
+         lowestLow = std::min(values.newest().low, lowestLow);
       }
-      return {lowestLowIndex, lowestLow};
+      return percent_range(
+         (0 == m_highestHighIndicesSize) ? highestHigh : std::max(values[m_indicator->m_highestHighIndices[m_highestHighIndicesHead]].high, highestHigh),
+         (0 == m_lowestLowIndicesSize) ? lowestLow : std::min(values[m_indicator->m_lowestLowIndices[m_lowestLowIndicesHead]].low, lowestLow),
+         inClose
+      );
    }
-   return {m_lowestLowIndex, m_lowValues[m_lowestLowIndex]};
+   return std::numeric_limits<double>::signaling_NaN();
 }
 
+template class williams_percent_range<static_cast<uint32_t>(-1), 0>;
+template class williams_percent_range<static_cast<uint32_t>(-1), 8>;
+template class williams_percent_range<static_cast<uint32_t>(-1), 16>;
+template class williams_percent_range<static_cast<uint32_t>(-1), 32>;
+template class williams_percent_range<static_cast<uint32_t>(-1), 64>;
+
 }
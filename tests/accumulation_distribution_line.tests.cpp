@@ -27,17 +27,20 @@
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
 #include "tean/accumulation_distribution_line.hpp" /// for the test target
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE
 #include <indicators.h> /// for ti_ad, ti_ad_start, TI_OKAY
 #include <ta_func.h> /// for TA_AD, TA_SUCCESS
 
 #include <algorithm> /// for std::fill
+#include <array> /// for std::array
 #include <cmath> /// for std::isnan
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -122,4 +125,86 @@ TEST_F(TeAn, AccumulationDistributionLine)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 6}));
 }
 
+void test_accumulation_distribution_line_skip(TeAn &fixture, accumulation_distribution_line &testIndicator, accumulation_distribution_line &testExpectedIndicator, uint32_t const testIterationsNumber)
+{
+   auto testPrevPrices = std::array<double, 4>{};
+   uint64_t testSequenceNumber = 0;
+   while (testIterationsNumber > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward bars repeat the latest bar, zero volume and decay only bars are flat at the latest close and have no volume
+         auto const testGap = fixture.random_number<uint64_t>(1, 50);
+         auto const testFill = static_cast<gap_fill>(fixture.random_number<int>(0, 2));
+         auto const testSkipValue = testIndicator.skip(testSequenceNumber, testGap, testFill);
+         if (gap_fill::carry_forward != testFill)
+         {
+            testPrevPrices = std::array<double, 4>{testPrevPrices[2], testPrevPrices[2], testPrevPrices[2], 0.0,};
+         }
+         auto testExpectedSkipValue = std::numeric_limits<double>::signaling_NaN();
+         for (uint64_t testGapIndex = 0; testGapIndex < testGap; ++testGapIndex)
+         {
+            testExpectedSkipValue = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2], testPrevPrices[3]);
+         }
+         ASSERT_NEAR(testExpectedSkipValue, testSkipValue, 1e-6);
+         testSequenceNumber += testGap;
+         continue;
+      }
+      auto const testClosePrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      testPrevPrices = std::array<double, 4>
+      {
+         testClosePrice + fixture.random_number<int64_t>(0, 50),
+         testClosePrice - fixture.random_number<int64_t>(0, 50),
+         testClosePrice,
+         static_cast<double>(fixture.random_number<int64_t>(10, 100)),
+      };
+      auto const testExpectedValue = testExpectedIndicator.calc(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2], testPrevPrices[3]);
+      auto const testValue = testIndicator.calc(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2], testPrevPrices[3]);
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, 1e-6);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, AccumulationDistributionLineSkip)
+{
+   accumulation_distribution_line testIndicator;
+   accumulation_distribution_line testExpectedIndicator;
+   ASSERT_NO_FATAL_FAILURE(test_accumulation_distribution_line_skip(*this, testIndicator, testExpectedIndicator, 1000));
+}
+
+TEST_F(TeAn, AccumulationDistributionLineAmend)
+{
+   auto const testPrices = [&] ()
+   {
+      auto const testClosePrice = static_cast<double>(random_number<int64_t>(100, 1000));
+      return std::array<double, 4>
+      {
+         testClosePrice + random_number<int64_t>(0, 50),
+         testClosePrice - random_number<int64_t>(0, 50),
+         testClosePrice,
+         static_cast<double>(random_number<int64_t>(10, 100)),
+      };
+   };
+   accumulation_distribution_line testIndicator;
+   accumulation_distribution_line testExpectedIndicator;
+   for (uint32_t testIteration = 0; testIteration < 1000; ++testIteration)
+   {
+      /// An amended calc must match a calc with the final bar, the line restarts from the value preceding the bar
+      auto testPrice = testPrices();
+      std::ignore = testIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]);
+      testPrice = testPrices();
+      auto testValue = testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]);
+      for (auto testAmendsNumber = random_number<uint32_t>(0, 3); 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testPrice = testPrices();
+         testValue = testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]);
+      }
+      ASSERT_NEAR(testExpectedIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]), testValue, 1e-6);
+   }
+}
+
 }
@@ -28,15 +28,18 @@
 
 #include "tean/accumulation_distribution_oscillator.hpp" /// for the test target
 #include "tean/accumulation_distribution_line.hpp" /// for tean::accumulation_distribution_line
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <ta_func.h> /// for TA_ADOSC, TA_ADOSC_Lookback, TA_FUNC_UNST_EMA, TA_SUCCESS, TA_SetUnstablePeriod
 
+#include <array> /// for std::array
 #include <cmath> /// for std::isnan, std::sqrt
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::vector
 
 namespace tean::tests
@@ -56,7 +59,7 @@ TEST_F(TeAn, AccumulationDistributionOscillator)
          auto const testFastPeriod = static_cast<uint32_t>(std::sqrt(testSlowPeriod));
          auto const testIterationsNumber = testSlowPeriod * 10;
          auto const testUnstablePeriod = random_number<uint32_t>(0, testSlowPeriod);
-         accumulation_distribution_oscillator testIndicator{testFastPeriod, testSlowPeriod, testUnstablePeriod};
+         accumulation_distribution_oscillator<> testIndicator{testFastPeriod, testSlowPeriod, testUnstablePeriod};
          ASSERT_EQ(testSlowPeriod, testIndicator.period());
          auto testHighPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          auto testLowPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
@@ -167,4 +170,215 @@ TEST_F(TeAn, AccumulationDistributionOscillator)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 6}));
 }
 
+
+template<uint32_t test_slow_period>
+void test_fixed_accumulation_distribution_oscillator_step(TeAn &fixture, decimal const testPriceStep, decimal const testLotSize)
+{
+   constexpr auto testFastPeriod{test_slow_period / 3 + 1,};
+   constexpr auto testIterationsNumber{test_slow_period * 10,};
+   auto const testUnstablePeriod{fixture.random_number<uint32_t>(0, test_slow_period),};
+   accumulation_distribution_oscillator<testFastPeriod, test_slow_period> testIndicator{testUnstablePeriod,};
+   accumulation_distribution_oscillator<> testRuntimeIndicator{testFastPeriod, test_slow_period, testUnstablePeriod,};
+   ASSERT_EQ(testIndicator.lookback_period(), testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   double const testLotSizeValue{testLotSize,};
+   for (uint32_t testIteration{0,}; testIteration < (testIndicator.lookback_period() + testIterationsNumber); ++testIteration)
+   {
+      auto const testClosePrice{testPriceStepValue * fixture.random_number<int64_t>(power_of_ten[testPriceStep.scale], power_of_ten[testPriceStep.scale + 2]),};
+      auto const testHighPrice{testClosePrice + testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      auto const testLowPrice{testClosePrice - testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      auto const testTradedVolume{testLotSizeValue * fixture.random_number<int64_t>(10, 100),};
+      auto const testPickValue{testIndicator.pick(testIteration, testHighPrice, testLowPrice, testClosePrice, testTradedVolume),};
+      auto const testCalcValue{testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice, testTradedVolume),};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice, testTradedVolume),};
+      if (testIndicator.lookback_period() > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickValue));
+         ASSERT_TRUE(std::isnan(testCalcValue));
+         ASSERT_TRUE(std::isnan(testRuntimeValue));
+         continue;
+      }
+      ASSERT_DOUBLE_EQ(testPickValue, testRuntimeValue);
+      ASSERT_DOUBLE_EQ(testCalcValue, testRuntimeValue);
+   }
+}
+
+template<uint32_t test_slow_period>
+void test_fixed_accumulation_distribution_oscillator(TeAn &fixture, decimal const testPriceStep, decimal const testLotSize)
+{
+   test_fixed_accumulation_distribution_oscillator_step<test_slow_period>(fixture, testPriceStep, testLotSize);
+   if constexpr (4 < test_slow_period)
+   {
+      test_fixed_accumulation_distribution_oscillator<test_slow_period - 1>(fixture, testPriceStep, testLotSize);
+   }
+}
+
+TEST_F(TeAn, AccumulationDistributionOscillatorFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_accumulation_distribution_oscillator<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 0}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_accumulation_distribution_oscillator<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 6}));
+}
+
+template<typename indicator>
+void test_accumulation_distribution_oscillator_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testIterationsNumber)
+{
+   auto testPrevPrices{std::array<double, 4>{},};
+   uint64_t testSequenceNumber{0,};
+   while (testIterationsNumber > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward bars repeat the latest bar, zero volume and decay only bars are flat at the latest close and have no volume
+         auto const testGap{fixture.random_number<uint64_t>(1, testIterationsNumber / 4),};
+         auto const testFill{static_cast<gap_fill>(fixture.random_number<int>(0, 2)),};
+         testIndicator.skip(testSequenceNumber, testGap, testFill);
+         if (gap_fill::carry_forward != testFill)
+         {
+            testPrevPrices = std::array<double, 4>{testPrevPrices[2], testPrevPrices[2], testPrevPrices[2], 0.0,};
+         }
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2], testPrevPrices[3]);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      auto const testClosePrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      testPrevPrices = std::array<double, 4>
+      {
+         testClosePrice + fixture.random_number<int64_t>(0, 50),
+         testClosePrice - fixture.random_number<int64_t>(0, 50),
+         testClosePrice,
+         static_cast<double>(fixture.random_number<int64_t>(10, 100)),
+      };
+      auto const testExpectedValue{testExpectedIndicator.calc(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2], testPrevPrices[3]),};
+      auto const testValue{testIndicator.calc(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2], testPrevPrices[3]),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, 1e-6);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, AccumulationDistributionOscillatorSkip)
+{
+   constexpr uint32_t testFixedFastPeriod{3,};
+   constexpr uint32_t testFixedSlowPeriod{10,};
+   for (uint32_t testSlowPeriod{3,}; testSlowPeriod <= 50; ++testSlowPeriod)
+   {
+      auto const testFastPeriod{random_number<uint32_t>(2, testSlowPeriod - 1),};
+      accumulation_distribution_oscillator<> testIndicator{testFastPeriod, testSlowPeriod, 0,};
+      accumulation_distribution_oscillator<> testExpectedIndicator{testFastPeriod, testSlowPeriod, 0,};
+      ASSERT_NO_FATAL_FAILURE(test_accumulation_distribution_oscillator_skip(*this, testIndicator, testExpectedIndicator, testSlowPeriod * 8));
+   }
+   accumulation_distribution_oscillator<testFixedFastPeriod, testFixedSlowPeriod> testFixedIndicator{0,};
+   accumulation_distribution_oscillator<testFixedFastPeriod, testFixedSlowPeriod> testExpectedFixedIndicator{0,};
+   ASSERT_NO_FATAL_FAILURE(test_accumulation_distribution_oscillator_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedSlowPeriod * 8));
+}
+
+template<typename indicator>
+void test_accumulation_distribution_oscillator_amend(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testIterationsNumber)
+{
+   auto const testPrices = [&] ()
+   {
+      auto const testClosePrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      return std::array<double, 4>
+      {
+         testClosePrice + fixture.random_number<int64_t>(0, 50),
+         testClosePrice - fixture.random_number<int64_t>(0, 50),
+         testClosePrice,
+         static_cast<double>(fixture.random_number<int64_t>(10, 100)),
+      };
+   };
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      /// An amended calc must match a calc with the final bar, both averages restart from their preceding values
+      auto testPrice{testPrices(),};
+      std::ignore = testIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]);
+      testPrice = testPrices();
+      auto testValue{testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]),};
+      for (auto testAmendsNumber{fixture.random_number<uint32_t>(0, 3),}; 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testPrice = testPrices();
+         testValue = testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]);
+      }
+      auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, 1e-6);
+      }
+   }
+}
+
+TEST_F(TeAn, AccumulationDistributionOscillatorAmend)
+{
+   constexpr uint32_t testFixedFastPeriod{3,};
+   constexpr uint32_t testFixedSlowPeriod{10,};
+   for (uint32_t testSlowPeriod{3,}; testSlowPeriod <= 50; ++testSlowPeriod)
+   {
+      auto const testFastPeriod{random_number<uint32_t>(2, testSlowPeriod - 1),};
+      auto const testUnstablePeriod{random_number<uint32_t>(0, testSlowPeriod),};
+      accumulation_distribution_oscillator<> testIndicator{testFastPeriod, testSlowPeriod, testUnstablePeriod,};
+      accumulation_distribution_oscillator<> testExpectedIndicator{testFastPeriod, testSlowPeriod, testUnstablePeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_accumulation_distribution_oscillator_amend(*this, testIndicator, testExpectedIndicator, testSlowPeriod * 8));
+   }
+   accumulation_distribution_oscillator<testFixedFastPeriod, testFixedSlowPeriod> testFixedIndicator{0,};
+   accumulation_distribution_oscillator<testFixedFastPeriod, testFixedSlowPeriod> testExpectedFixedIndicator{0,};
+   ASSERT_NO_FATAL_FAILURE(test_accumulation_distribution_oscillator_amend(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedSlowPeriod * 8));
+}
+
+template<typename indicator>
+void test_accumulation_distribution_oscillator_lookahead(TeAn &fixture, indicator &testIndicator, uint32_t const testSlowPeriod)
+{
+   auto const testPrices = [&] ()
+   {
+      auto const testClosePrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      return std::array<double, 4>
+      {
+         testClosePrice + fixture.random_number<int64_t>(0, 50),
+         testClosePrice - fixture.random_number<int64_t>(0, 50),
+         testClosePrice,
+         static_cast<double>(fixture.random_number<int64_t>(10, 100)),
+      };
+   };
+   for (uint32_t testIteration{0,}; testIteration < (testSlowPeriod * 8); ++testIteration)
+   {
+      /// Every hypothetical continuation must match a copy that commits the same bars, and leave the indicator intact
+      auto testLookahead{testIndicator.lookahead(),};
+      indicator testExpectedIndicator{testIndicator,};
+      auto const testLookaheadsNumber{fixture.random_number<uint32_t>(1, testSlowPeriod),};
+      for (uint32_t testLookaheadIndex{0,}; testLookaheadIndex < testLookaheadsNumber; ++testLookaheadIndex)
+      {
+         auto const testPrice{testPrices(),};
+         auto const testExpectedValue{testExpectedIndicator.calc(testIteration + testLookaheadIndex, testPrice[0], testPrice[1], testPrice[2], testPrice[3]),};
+         auto const testValue{testLookahead.calc(testIteration + testLookaheadIndex, testPrice[0], testPrice[1], testPrice[2], testPrice[3]),};
+         ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+         if (false == std::isnan(testExpectedValue))
+         {
+            ASSERT_EQ(testExpectedValue, testValue);
+         }
+      }
+      auto const testPrice{testPrices(),};
+      std::ignore = testIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2], testPrice[3]);
+   }
+}
+
+TEST_F(TeAn, AccumulationDistributionOscillatorLookahead)
+{
+   constexpr uint32_t testFixedFastPeriod{3,};
+   constexpr uint32_t testFixedSlowPeriod{10,};
+   for (uint32_t testSlowPeriod{3,}; testSlowPeriod <= 50; ++testSlowPeriod)
+   {
+      auto const testFastPeriod{random_number<uint32_t>(2, testSlowPeriod - 1),};
+      accumulation_distribution_oscillator<> testIndicator{testFastPeriod, testSlowPeriod, random_number<uint32_t>(0, testSlowPeriod),};
+      ASSERT_NO_FATAL_FAILURE(test_accumulation_distribution_oscillator_lookahead(*this, testIndicator, testSlowPeriod));
+   }
+   accumulation_distribution_oscillator<testFixedFastPeriod, testFixedSlowPeriod> testFixedIndicator{0,};
+   ASSERT_NO_FATAL_FAILURE(test_accumulation_distribution_oscillator_lookahead(*this, testFixedIndicator, testFixedSlowPeriod));
+}
+
 }
@@ -26,18 +26,21 @@
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::power_of_ten
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 #include "tean/average_true_range.hpp" /// for the test target
 #include "tean/true_range.hpp" /// for tean::true_range
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleEq, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <ta_func.h> /// for TA_ATR, TA_ATR_Lookback, TA_FUNC_UNST_ATR, TA_SetUnstablePeriod, TA_SUCCESS
 
 #include <algorithm> /// for std::min
+#include <array> /// for std::array
 #include <cmath> /// for std::isnan
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::vector
 
 namespace tean::tests
@@ -55,7 +58,7 @@ TEST_F(TeAn, AverageTrueRange)
       {
          auto const testIterationsNumber = testPeriod * 10;
          auto const testUnstablePeriod = random_number<uint32_t>(0, testPeriod);
-         average_true_range testIndicator{testPeriod, testUnstablePeriod};
+         average_true_range<> testIndicator{testPeriod, testUnstablePeriod};
          ASSERT_EQ(testPeriod, testIndicator.period());
          auto testHighPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          auto testLowPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
@@ -165,4 +168,216 @@ TEST_F(TeAn, AverageTrueRange)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+
+template<uint32_t test_period>
+void test_fixed_average_true_range_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testIterationsNumber{test_period * 10,};
+   auto const testUnstablePeriod{fixture.random_number<uint32_t>(0, test_period),};
+   average_true_range<test_period> testIndicator{testUnstablePeriod,};
+   average_true_range<> testRuntimeIndicator{test_period, testUnstablePeriod,};
+   ASSERT_EQ(testIndicator.lookback_period(), testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testIteration{0,}; testIteration < (testIndicator.lookback_period() + testIterationsNumber); ++testIteration)
+   {
+      auto const testClosePrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testHighPrice{testClosePrice + testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      auto const testLowPrice{testClosePrice - testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      auto const testPickValue{testIndicator.pick(testIteration, testHighPrice, testLowPrice, testClosePrice),};
+      auto const testCalcValue{testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice),};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice),};
+      if (testIndicator.lookback_period() > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickValue));
+         ASSERT_TRUE(std::isnan(testCalcValue));
+         ASSERT_TRUE(std::isnan(testRuntimeValue));
+         continue;
+      }
+      ASSERT_NEAR(testPickValue, testRuntimeValue, testPriceStepValue * 1e-6);
+      ASSERT_NEAR(testCalcValue, testRuntimeValue, testPriceStepValue * 1e-6);
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_average_true_range(TeAn &fixture, decimal const testPriceStep)
+{
+   test_fixed_average_true_range_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_average_true_range<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, AverageTrueRangeFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_average_true_range<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_average_true_range<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_average_true_range_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevPrices{std::array<double, 3>{},};
+   uint64_t testSequenceNumber{0,};
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward bars repeat the latest bar, zero volume and decay only bars are flat at the latest close
+         auto const testGap{fixture.random_number<uint64_t>(1, testPeriod * 3),};
+         auto const testFill{static_cast<gap_fill>(fixture.random_number<int>(0, 2)),};
+         testIndicator.skip(testSequenceNumber, testGap, testFill);
+         if (gap_fill::carry_forward != testFill)
+         {
+            testPrevPrices = std::array<double, 3>{testPrevPrices[2], testPrevPrices[2], testPrevPrices[2],};
+         }
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2]);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      auto const testClosePrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      testPrevPrices = std::array<double, 3>
+      {
+         testClosePrice + fixture.random_number<int64_t>(0, 50),
+         testClosePrice - fixture.random_number<int64_t>(0, 50),
+         testClosePrice,
+      };
+      auto const testExpectedValue{testExpectedIndicator.calc(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2]),};
+      auto const testValue{testIndicator.calc(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2]),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, testExpectedValue * 1e-9);
+      }
+      if (0 == fixture.random_number<uint32_t>(0, 2))
+      {
+         /// A skip leaves nothing to amend, yet the calc that follows it can be amended
+         testPrevPrices[0] += fixture.random_number<int64_t>(0, 10);
+         auto const testExpectedAmendedValue{testExpectedIndicator.amend(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2]),};
+         auto const testAmendedValue{testIndicator.amend(testSequenceNumber, testPrevPrices[0], testPrevPrices[1], testPrevPrices[2]),};
+         ASSERT_EQ(std::isnan(testExpectedAmendedValue), std::isnan(testAmendedValue));
+         if (false == std::isnan(testExpectedAmendedValue))
+         {
+            ASSERT_NEAR(testExpectedAmendedValue, testAmendedValue, testExpectedAmendedValue * 1e-9);
+         }
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, AverageTrueRangeSkip)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testUnstablePeriod{random_number<uint32_t>(0, testPeriod),};
+      average_true_range<> testIndicator{testPeriod, testUnstablePeriod,};
+      average_true_range<> testExpectedIndicator{testPeriod, testUnstablePeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_average_true_range_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   average_true_range<testFixedPeriod> testFixedIndicator{0,};
+   average_true_range<testFixedPeriod> testExpectedFixedIndicator{0,};
+   ASSERT_NO_FATAL_FAILURE(test_average_true_range_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator>
+void test_average_true_range_amend(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto const testPrices = [&] ()
+   {
+      auto const testClosePrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      return std::array<double, 3>
+      {
+         testClosePrice + fixture.random_number<int64_t>(0, 50),
+         testClosePrice - fixture.random_number<int64_t>(0, 50),
+         testClosePrice,
+      };
+   };
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// An amended calc must match a calc with the final bar, the true range keeps the preceding close across amends
+      auto testPrice{testPrices(),};
+      std::ignore = testIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+      testPrice = testPrices();
+      auto testValue{testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2]),};
+      for (auto testAmendsNumber{fixture.random_number<uint32_t>(0, 3),}; 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testPrice = testPrices();
+         testValue = testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+      }
+      auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2]),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, testExpectedValue * 1e-9);
+      }
+   }
+}
+
+TEST_F(TeAn, AverageTrueRangeAmend)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testUnstablePeriod{random_number<uint32_t>(0, testPeriod),};
+      average_true_range<> testIndicator{testPeriod, testUnstablePeriod,};
+      average_true_range<> testExpectedIndicator{testPeriod, testUnstablePeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_average_true_range_amend(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   average_true_range<testFixedPeriod> testFixedIndicator{0,};
+   average_true_range<testFixedPeriod> testExpectedFixedIndicator{0,};
+   ASSERT_NO_FATAL_FAILURE(test_average_true_range_amend(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator>
+void test_average_true_range_lookahead(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod)
+{
+   auto const testPrices = [&] ()
+   {
+      auto const testClosePrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      return std::array<double, 3>
+      {
+         testClosePrice + fixture.random_number<int64_t>(0, 50),
+         testClosePrice - fixture.random_number<int64_t>(0, 50),
+         testClosePrice,
+      };
+   };
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// Every hypothetical continuation must match a copy that commits the same bars, and leave the indicator intact
+      auto testLookahead{testIndicator.lookahead(),};
+      indicator testExpectedIndicator{testIndicator,};
+      auto const testLookaheadsNumber{fixture.random_number<uint32_t>(1, testPeriod),};
+      for (uint32_t testLookaheadIndex{0,}; testLookaheadIndex < testLookaheadsNumber; ++testLookaheadIndex)
+      {
+         auto const testPrice{testPrices(),};
+         auto const testExpectedValue{testExpectedIndicator.calc(testIteration + testLookaheadIndex, testPrice[0], testPrice[1], testPrice[2]),};
+         auto const testValue{testLookahead.calc(testIteration + testLookaheadIndex, testPrice[0], testPrice[1], testPrice[2]),};
+         ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+         if (false == std::isnan(testExpectedValue))
+         {
+            ASSERT_EQ(testExpectedValue, testValue);
+         }
+      }
+      auto const testPrice{testPrices(),};
+      std::ignore = testIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+   }
+}
+
+TEST_F(TeAn, AverageTrueRangeLookahead)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      average_true_range<> testIndicator{testPeriod, random_number<uint32_t>(0, testPeriod),};
+      ASSERT_NO_FATAL_FAILURE(test_average_true_range_lookahead(*this, testIndicator, testPeriod));
+   }
+   average_true_range<testFixedPeriod> testFixedIndicator{0,};
+   ASSERT_NO_FATAL_FAILURE(test_average_true_range_lookahead(*this, testFixedIndicator, testFixedPeriod));
+}
+
 }
@@ -24,21 +24,27 @@
 */
 
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "memory_resource.tests.hpp" /// for tean::tests::counting_memory_resource
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
 #include "tean/bollinger_bands.hpp" /// for the test target
 #include "tean/exponential_moving_average.hpp" /// for tean::exponential_moving_average
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 #include "tean/simple_moving_average.hpp" /// for tean::simple_moving_average
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <ta_func.h> /// for TA_BBANDS, TA_BBANDS_Lookback, TA_FUNC_UNST_EMA, TA_SetUnstablePeriod, TA_SUCCESS
 
-#include <cmath> /// for std::isnan
+#include <cmath> /// for std::abs, std::isfinite, std::isnan
+#include <cstddef> /// for size_t, std::byte
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique, std::unique_ptr
-#include <type_traits> /// for std::remove_cvref_t
+#include <memory_resource> /// for std::pmr::null_memory_resource, std::pmr::set_default_resource
+#include <tuple> /// for std::ignore
+#include <type_traits> /// for std::is_constructible_v, std::is_copy_assignable_v, std::is_copy_constructible_v, std::is_nothrow_move_assignable_v, std::is_nothrow_move_constructible_v, std::remove_cvref_t
+#include <utility> /// for std::move
 #include <vector> /// for std::vector
 
 namespace tean::tests
@@ -51,7 +57,7 @@ template<typename moving_average>
 class bollinger_bands_test_traits;
 
 template<>
-class [[nodiscard]] bollinger_bands_test_traits<exponential_moving_average> final
+class [[nodiscard]] bollinger_bands_test_traits<exponential_moving_average<>> final
 {
 public: static constexpr TA_MAType ta_ma_type = TA_MAType::TA_MAType_EMA;
 
@@ -67,10 +73,10 @@ public:
    bollinger_bands_test_traits &operator = (bollinger_bands_test_traits &&) = delete;
    bollinger_bands_test_traits &operator = (bollinger_bands_test_traits const &) = delete;
 
-   [[nodiscard]] std::unique_ptr<bollinger_bands<exponential_moving_average>> create_indicator(uint32_t const period, double const upperBandMultiplier, double const lowerBandMultiplier)
+   [[nodiscard]] std::unique_ptr<bollinger_bands<exponential_moving_average<>>> create_indicator(uint32_t const period, double const upperBandMultiplier, double const lowerBandMultiplier)
    {
       TA_SetUnstablePeriod(TA_FUNC_UNST_EMA, static_cast<int>(m_unstablePeriod));
-      return std::make_unique<bollinger_bands<exponential_moving_average>>(period, upperBandMultiplier, lowerBandMultiplier, m_unstablePeriod);
+      return std::make_unique<bollinger_bands<exponential_moving_average<>>>(period, upperBandMultiplier, lowerBandMultiplier, m_unstablePeriod);
    }
 
 private:
@@ -78,7 +84,7 @@ private:
 };
 
 template<>
-class [[nodiscard]] bollinger_bands_test_traits<simple_moving_average>
+class [[nodiscard]] bollinger_bands_test_traits<simple_moving_average<>>
 {
 public: static constexpr TA_MAType ta_ma_type = TA_MAType::TA_MAType_SMA;
 
@@ -90,9 +96,9 @@ public:
    bollinger_bands_test_traits &operator = (bollinger_bands_test_traits &&) = delete;
    bollinger_bands_test_traits &operator = (bollinger_bands_test_traits const &) = delete;
 
-   [[nodiscard]] std::unique_ptr<bollinger_bands<simple_moving_average>> create_indicator(uint32_t const period, double const upperBandMultiplier, double const lowerBandMultiplier)
+   [[nodiscard]] std::unique_ptr<bollinger_bands<simple_moving_average<>>> create_indicator(uint32_t const period, double const upperBandMultiplier, double const lowerBandMultiplier)
    {
-      return std::make_unique<bollinger_bands<simple_moving_average>>(period, upperBandMultiplier, lowerBandMultiplier);
+      return std::make_unique<bollinger_bands<simple_moving_average<>>>(period, upperBandMultiplier, lowerBandMultiplier);
    }
 };
 
@@ -226,7 +232,7 @@ TEST_F(TeAn, BollingerBands)
          decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12},
          testBandMultiplier,
          testBandMultiplier,
-         bollinger_bands_test_traits<exponential_moving_average>{random_number<uint32_t>(0, 10)}
+         bollinger_bands_test_traits<exponential_moving_average<>>{random_number<uint32_t>(0, 10)}
       )
    );
    ASSERT_NO_FATAL_FAILURE(
@@ -234,7 +240,7 @@ TEST_F(TeAn, BollingerBands)
          decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00},
          testBandMultiplier,
          testBandMultiplier,
-         bollinger_bands_test_traits<exponential_moving_average>{random_number<uint32_t>(0, 10)}
+         bollinger_bands_test_traits<exponential_moving_average<>>{random_number<uint32_t>(0, 10)}
       )
    );
    ASSERT_NO_FATAL_FAILURE(
@@ -242,7 +248,7 @@ TEST_F(TeAn, BollingerBands)
          decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12},
          testBandMultiplier,
          testBandMultiplier,
-         bollinger_bands_test_traits<simple_moving_average>{}
+         bollinger_bands_test_traits<simple_moving_average<>>{}
       )
    );
    ASSERT_NO_FATAL_FAILURE(
@@ -250,9 +256,499 @@ TEST_F(TeAn, BollingerBands)
          decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00},
          testBandMultiplier,
          testBandMultiplier,
-         bollinger_bands_test_traits<simple_moving_average>{}
+         bollinger_bands_test_traits<simple_moving_average<>>{}
       )
    );
 }
 
+
+template<uint32_t test_period>
+void test_fixed_bollinger_bands_step(TeAn &fixture, decimal const testPriceStep, double const upperBandMultiplier, double const lowerBandMultiplier)
+{
+   constexpr auto testIterationsNumber{test_period * 10,};
+   auto const testPricePrecision{inverted_power_of_ten[testPriceStep.scale / 2] * inverted_power_of_ten[3],};
+   bollinger_bands<simple_moving_average<test_period>> testIndicator{upperBandMultiplier, lowerBandMultiplier,};
+   bollinger_bands<simple_moving_average<>> testRuntimeIndicator{test_period, upperBandMultiplier, lowerBandMultiplier,};
+   simple_moving_average<test_period> testAdditionalIndicator{};
+   ASSERT_EQ(bollinger_bands<simple_moving_average<test_period>>::lookback_period, testRuntimeIndicator.lookback_period());
+   ASSERT_EQ(simple_moving_average<test_period>::lookback_period, testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testPickValue{testIndicator.pick(testIteration, testPrice),};
+      auto const testCalcValue{testIndicator.calc(testIteration, testPrice),};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testPrice),};
+      auto const testAdditionalValue{testAdditionalIndicator.calc(testIteration, testPrice),};
+      if (simple_moving_average<test_period>::lookback_period > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickValue.upper));
+         ASSERT_TRUE(std::isnan(testPickValue.middle));
+         ASSERT_TRUE(std::isnan(testPickValue.lower));
+         ASSERT_TRUE(std::isnan(testCalcValue.upper));
+         ASSERT_TRUE(std::isnan(testCalcValue.middle));
+         ASSERT_TRUE(std::isnan(testCalcValue.lower));
+         ASSERT_TRUE(std::isnan(testRuntimeValue.middle));
+         continue;
+      }
+      ASSERT_THAT(testPickValue.upper, testing::DoubleNear(testCalcValue.upper, testPricePrecision));
+      ASSERT_THAT(testPickValue.middle, testing::DoubleNear(testCalcValue.middle, testPricePrecision));
+      ASSERT_THAT(testPickValue.lower, testing::DoubleNear(testCalcValue.lower, testPricePrecision));
+      ASSERT_THAT(testCalcValue.upper, testing::DoubleNear(testRuntimeValue.upper, testPricePrecision));
+      ASSERT_THAT(testCalcValue.middle, testing::DoubleNear(testRuntimeValue.middle, testPricePrecision));
+      ASSERT_THAT(testCalcValue.lower, testing::DoubleNear(testRuntimeValue.lower, testPricePrecision));
+      ASSERT_THAT(testCalcValue.middle, testing::DoubleNear(testAdditionalValue, testPricePrecision));
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_bollinger_bands(TeAn &fixture, decimal const testPriceStep, double const upperBandMultiplier, double const lowerBandMultiplier)
+{
+   test_fixed_bollinger_bands_step<test_period>(fixture, testPriceStep, upperBandMultiplier, lowerBandMultiplier);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_bollinger_bands<test_period - 1>(fixture, testPriceStep, upperBandMultiplier, lowerBandMultiplier);
+   }
+}
+
+TEST_F(TeAn, BollingerBandsFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   auto const testBandMultiplier{random_number<double>(1.0, 3.0),};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_bollinger_bands<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}, testBandMultiplier, testBandMultiplier));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_bollinger_bands<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}, testBandMultiplier, testBandMultiplier));
+}
+
+TEST_F(TeAn, BollingerBandsFixedExponentialMovingAverage)
+{
+   constexpr uint32_t testPeriod{5,};
+   /// The period of a fixed moving average is not an argument, so it cannot end up as the untrusted period
+   static_assert(false == std::is_constructible_v<bollinger_bands<exponential_moving_average<testPeriod>>, uint32_t, double, double>);
+   static_assert(testPeriod == exponential_moving_average<testPeriod>::period());
+   auto const testUntrustedPeriod{random_number<uint32_t>(0, 10),};
+   auto const testBandMultiplier{random_number<double>(1.0, 3.0),};
+   /// The deviation window is fixed along with the moving average, so the bands never touch the heap
+   auto *const testDefaultResource{std::pmr::set_default_resource(std::pmr::null_memory_resource()),};
+   bollinger_bands<exponential_moving_average<testPeriod>> testIndicator{testBandMultiplier, testBandMultiplier, testUntrustedPeriod,};
+   std::pmr::set_default_resource(testDefaultResource);
+   bollinger_bands<exponential_moving_average<>> testExpectedIndicator{testPeriod, testBandMultiplier, testBandMultiplier, testUntrustedPeriod,};
+   ASSERT_EQ(testPeriod, testIndicator.period());
+   ASSERT_EQ(testExpectedIndicator.lookback_period(), testIndicator.lookback_period());
+   for (uint32_t testIteration{0,}; testIteration < (testIndicator.lookback_period() + testPeriod * 10); ++testIteration)
+   {
+      auto const testPrice{0.01 * random_number<int64_t>(100, 1000),};
+      auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice),};
+      auto const testValue{testIndicator.calc(testIteration, testPrice),};
+      ASSERT_EQ(std::isnan(testExpectedValue.middle), std::isnan(testValue.middle));
+      if (false == std::isnan(testExpectedValue.middle))
+      {
+         ASSERT_DOUBLE_EQ(testExpectedValue.upper, testValue.upper);
+         ASSERT_DOUBLE_EQ(testExpectedValue.middle, testValue.middle);
+         ASSERT_DOUBLE_EQ(testExpectedValue.lower, testValue.lower);
+      }
+   }
+}
+
+template<typename indicator>
+void test_extended_bollinger_bands_step(TeAn &fixture, decimal const testPriceStep, indicator &testIndicator, uint32_t const testLookbackPeriod)
+{
+   auto const testIterationsNumber{testLookbackPeriod * 10 + 10,};
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testPickValue{testIndicator.pick(testIteration, testPrice),};
+      auto const testPickExtendedValue{testIndicator.pick_extended(testIteration, testPrice),};
+      auto const testCalcExtendedValue{testIndicator.calc_extended(testIteration, testPrice),};
+      if (testLookbackPeriod > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickExtendedValue.middle));
+         ASSERT_TRUE(std::isnan(testPickExtendedValue.percent_b));
+         ASSERT_TRUE(std::isnan(testPickExtendedValue.bandwidth));
+         ASSERT_TRUE(std::isnan(testCalcExtendedValue.middle));
+         ASSERT_TRUE(std::isnan(testCalcExtendedValue.percent_b));
+         ASSERT_TRUE(std::isnan(testCalcExtendedValue.bandwidth));
+         continue;
+      }
+      ASSERT_EQ(testPickValue.upper, testPickExtendedValue.upper);
+      ASSERT_EQ(testPickValue.middle, testPickExtendedValue.middle);
+      ASSERT_EQ(testPickValue.lower, testPickExtendedValue.lower);
+      ASSERT_DOUBLE_EQ(testPickExtendedValue.upper, testCalcExtendedValue.upper);
+      ASSERT_DOUBLE_EQ(testPickExtendedValue.middle, testCalcExtendedValue.middle);
+      ASSERT_DOUBLE_EQ(testPickExtendedValue.lower, testCalcExtendedValue.lower);
+      auto const testWidth{testCalcExtendedValue.upper - testCalcExtendedValue.lower,};
+      if (0 == testWidth)
+      {
+         ASSERT_EQ(0.5, testCalcExtendedValue.percent_b);
+      }
+      else
+      {
+         ASSERT_DOUBLE_EQ((testPrice - testCalcExtendedValue.lower) / testWidth, testCalcExtendedValue.percent_b);
+      }
+      ASSERT_DOUBLE_EQ(testWidth / testCalcExtendedValue.middle, testCalcExtendedValue.bandwidth);
+   }
+}
+
+template<uint32_t test_period>
+void test_extended_bollinger_bands(TeAn &fixture, decimal const testPriceStep, double const upperBandMultiplier, double const lowerBandMultiplier)
+{
+   {
+      bollinger_bands<simple_moving_average<test_period>> testIndicator{upperBandMultiplier, lowerBandMultiplier,};
+      ASSERT_NO_FATAL_FAILURE(test_extended_bollinger_bands_step(fixture, testPriceStep, testIndicator, testIndicator.lookback_period));
+   }
+   {
+      bollinger_bands<simple_moving_average<>> testIndicator{test_period, upperBandMultiplier, lowerBandMultiplier,};
+      ASSERT_NO_FATAL_FAILURE(test_extended_bollinger_bands_step(fixture, testPriceStep, testIndicator, testIndicator.lookback_period()));
+   }
+   {
+      bollinger_bands<exponential_moving_average<>> testIndicator{test_period, upperBandMultiplier, lowerBandMultiplier, fixture.random_number<uint32_t>(0, 10),};
+      ASSERT_NO_FATAL_FAILURE(test_extended_bollinger_bands_step(fixture, testPriceStep, testIndicator, testIndicator.lookback_period()));
+   }
+   if constexpr (2 < test_period)
+   {
+      test_extended_bollinger_bands<test_period - 1>(fixture, testPriceStep, upperBandMultiplier, lowerBandMultiplier);
+   }
+}
+
+TEST_F(TeAn, BollingerBandsExtended)
+{
+   constexpr uint32_t testMaxPeriod{50,};
+   auto const testUpperBandMultiplier{random_number<double>(1.0, 3.0),};
+   auto const testLowerBandMultiplier{random_number<double>(1.0, 3.0),};
+   ASSERT_NO_FATAL_FAILURE(test_extended_bollinger_bands<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}, testUpperBandMultiplier, testLowerBandMultiplier));
+   ASSERT_NO_FATAL_FAILURE(test_extended_bollinger_bands<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}, testUpperBandMultiplier, testLowerBandMultiplier));
+}
+
+template<typename indicator, typename... indicator_args>
+void test_copyable_bollinger_bands(TeAn &fixture, decimal const testPriceStep, uint32_t const testPeriod, indicator_args const... testIndicatorArgs)
+{
+   static_assert(true == std::is_nothrow_move_constructible_v<indicator>);
+   static_assert(true == std::is_nothrow_move_assignable_v<indicator>);
+   static_assert(true == std::is_copy_constructible_v<indicator>);
+   static_assert(true == std::is_copy_assignable_v<indicator>);
+   auto const testIndicatorsNumber{fixture.random_number<uint32_t>(2, 20),};
+   auto const testIterationsNumber{testPeriod * 10,};
+   double const testPriceStepValue{testPriceStep,};
+   std::vector<indicator> testIndicators;
+   for (uint32_t testIndicatorIndex{0,}; testIndicatorIndex < testIndicatorsNumber; ++testIndicatorIndex)
+   {
+      testIndicators.emplace_back(testIndicatorArgs...);
+   }
+   indicator testCopyAssignedIndicator{testIndicatorArgs...,};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      for (auto &testIndicator : testIndicators)
+      {
+         std::ignore = testIndicator.calc(testIteration, testPrice);
+      }
+      std::ignore = testCopyAssignedIndicator.calc(testIteration, testPrice);
+   }
+   indicator testCopiedIndicator{testIndicators.front(),};
+   testCopyAssignedIndicator = testIndicators.back();
+   auto testMovedIndicator{std::move(testIndicators[testIndicatorsNumber / 2]),};
+   testIndicators[testIndicatorsNumber / 2] = testCopiedIndicator;
+   for (auto testIteration{testIterationsNumber,}; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testValue{testCopiedIndicator.calc(testIteration, testPrice),};
+      for (auto *testIndicator : {std::addressof(testCopyAssignedIndicator), std::addressof(testMovedIndicator),})
+      {
+         auto const testIndicatorValue{testIndicator->calc(testIteration, testPrice),};
+         ASSERT_EQ(testValue.upper, testIndicatorValue.upper);
+         ASSERT_EQ(testValue.middle, testIndicatorValue.middle);
+         ASSERT_EQ(testValue.lower, testIndicatorValue.lower);
+      }
+      for (auto &testIndicator : testIndicators)
+      {
+         auto const testIndicatorValue{testIndicator.calc(testIteration, testPrice),};
+         ASSERT_EQ(testValue.upper, testIndicatorValue.upper);
+         ASSERT_EQ(testValue.middle, testIndicatorValue.middle);
+         ASSERT_EQ(testValue.lower, testIndicatorValue.lower);
+      }
+   }
+}
+
+TEST_F(TeAn, BollingerBandsCopyable)
+{
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      auto const testPeriod{random_number<uint32_t>(2, 50),};
+      auto const testUpperBandMultiplier{random_number<double>(1.0, 3.0),};
+      auto const testLowerBandMultiplier{random_number<double>(1.0, 3.0),};
+      ASSERT_NO_FATAL_FAILURE(test_copyable_bollinger_bands<bollinger_bands<simple_moving_average<20>>>(*this, testPriceStep, 20, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_copyable_bollinger_bands<bollinger_bands<simple_moving_average<>>>(*this, testPriceStep, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_copyable_bollinger_bands<bollinger_bands<exponential_moving_average<>>>(*this, testPriceStep, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier, random_number<uint32_t>(0, 10)));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator, typename... indicator_args>
+void test_lookahead_bollinger_bands(TeAn &fixture, decimal const testPriceStep, uint32_t const testPeriod, indicator_args const... testIndicatorArgs)
+{
+   auto const testIterationsNumber{testPeriod * 4,};
+   double const testPriceStepValue{testPriceStep,};
+   indicator testIndicator{testIndicatorArgs...,};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      /// Every hypothetical continuation must match a copy that commits the same values, and leave the indicator intact
+      auto const testLookaheadsNumber{fixture.random_number<uint32_t>(1, testPeriod),};
+      auto testLookahead{testIndicator.lookahead(),};
+      indicator testCopiedIndicator{testIndicator,};
+      for (uint32_t testLookaheadIndex{0,}; testLookaheadIndex < testLookaheadsNumber; ++testLookaheadIndex)
+      {
+         auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+         auto const testValue{testCopiedIndicator.calc_extended(testIteration + testLookaheadIndex, testPrice),};
+         auto const testLookaheadValue{testLookahead.calc_extended(testIteration + testLookaheadIndex, testPrice),};
+         if (true == std::isnan(testValue.upper))
+         {
+            ASSERT_TRUE(std::isnan(testLookaheadValue.upper));
+            continue;
+         }
+         ASSERT_EQ(testValue.upper, testLookaheadValue.upper);
+         ASSERT_EQ(testValue.middle, testLookaheadValue.middle);
+         ASSERT_EQ(testValue.lower, testLookaheadValue.lower);
+         ASSERT_EQ(testValue.percent_b, testLookaheadValue.percent_b);
+         ASSERT_EQ(testValue.bandwidth, testLookaheadValue.bandwidth);
+      }
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      std::ignore = testIndicator.calc(testIteration, testPrice);
+   }
+}
+
+TEST_F(TeAn, BollingerBandsLookahead)
+{
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      auto const testPeriod{random_number<uint32_t>(2, 50),};
+      auto const testUpperBandMultiplier{random_number<double>(1.0, 3.0),};
+      auto const testLowerBandMultiplier{random_number<double>(1.0, 3.0),};
+      ASSERT_NO_FATAL_FAILURE(test_lookahead_bollinger_bands<bollinger_bands<simple_moving_average<20>>>(*this, testPriceStep, 20, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_lookahead_bollinger_bands<bollinger_bands<simple_moving_average<>>>(*this, testPriceStep, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_lookahead_bollinger_bands<bollinger_bands<exponential_moving_average<>>>(*this, testPriceStep, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier, random_number<uint32_t>(0, 10)));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator, typename... indicator_args>
+void test_pick_many_bollinger_bands(TeAn &fixture, decimal const testPriceStep, uint32_t const testPeriod, indicator_args const... testIndicatorArgs)
+{
+   double const testPriceStepValue{testPriceStep,};
+   indicator testIndicator{testIndicatorArgs...,};
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      /// More candidates than one stack chunk holds, each must see the same committed state as a single pick
+      std::vector<double> testCandidates(fixture.random_number<size_t>(1, 200));
+      for (auto &testCandidate : testCandidates)
+      {
+         testCandidate = testPriceStepValue * fixture.random_number<int64_t>(100, 1000);
+      }
+      std::vector<bollinger_bands_result> testValues(testCandidates.size());
+      testIndicator.pick_many(testIteration, testCandidates, testValues);
+      for (size_t testCandidateIndex{0,}; testCandidateIndex < testCandidates.size(); ++testCandidateIndex)
+      {
+         auto const testExpectedValue{testIndicator.pick(testIteration, testCandidates[testCandidateIndex]),};
+         auto const &testValue{testValues[testCandidateIndex],};
+         if (true == std::isnan(testExpectedValue.middle))
+         {
+            ASSERT_TRUE(std::isnan(testValue.upper));
+            ASSERT_TRUE(std::isnan(testValue.middle));
+            ASSERT_TRUE(std::isnan(testValue.lower));
+            continue;
+         }
+         ASSERT_EQ(testExpectedValue.upper, testValue.upper);
+         ASSERT_EQ(testExpectedValue.middle, testValue.middle);
+         ASSERT_EQ(testExpectedValue.lower, testValue.lower);
+      }
+      std::ignore = testIndicator.calc(testIteration, testPriceStepValue * fixture.random_number<int64_t>(100, 1000));
+   }
+}
+
+TEST_F(TeAn, BollingerBandsPickMany)
+{
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      auto const testPeriod{random_number<uint32_t>(2, 50),};
+      auto const testUpperBandMultiplier{random_number<double>(1.0, 3.0),};
+      auto const testLowerBandMultiplier{random_number<double>(1.0, 3.0),};
+      ASSERT_NO_FATAL_FAILURE(test_pick_many_bollinger_bands<bollinger_bands<simple_moving_average<20>>>(*this, testPriceStep, 20, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_pick_many_bollinger_bands<bollinger_bands<simple_moving_average<>>>(*this, testPriceStep, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_pick_many_bollinger_bands<bollinger_bands<exponential_moving_average<20>>>(*this, testPriceStep, 20, testUpperBandMultiplier, testLowerBandMultiplier, testPeriod));
+      ASSERT_NO_FATAL_FAILURE(test_pick_many_bollinger_bands<bollinger_bands<exponential_moving_average<>>>(*this, testPriceStep, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier, testPeriod));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator, typename... indicator_args>
+void test_solve_bollinger_bands(
+   TeAn &fixture,
+   decimal const testPriceStep,
+   uint32_t const testPeriod,
+   double const testUpperBandMultiplier,
+   double const testLowerBandMultiplier,
+   indicator_args const... testIndicatorArgs
+)
+{
+   double const testPriceStepValue{testPriceStep,};
+   indicator testIndicator{testIndicatorArgs..., testUpperBandMultiplier, testLowerBandMultiplier,};
+   /// Prices keep rising, so the retained values are never flat
+   auto testPrice{testPriceStepValue * 100,};
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      auto const testUpperValue{testIndicator.solve_upper_band(testIteration),};
+      if (((testPeriod - 1) > testIteration) || (static_cast<double>(testPeriod - 1) <= (testUpperBandMultiplier * testUpperBandMultiplier)))
+      {
+         ASSERT_TRUE(std::isnan(testUpperValue));
+      }
+      else
+      {
+         ASSERT_TRUE(std::isfinite(testUpperValue));
+         ASSERT_NEAR(testUpperValue, testIndicator.pick(testIteration, testUpperValue).upper, testUpperValue * 1e-9);
+      }
+      auto const testLowerValue{testIndicator.solve_lower_band(testIteration),};
+      if (((testPeriod - 1) > testIteration) || (static_cast<double>(testPeriod - 1) <= (testLowerBandMultiplier * testLowerBandMultiplier)))
+      {
+         ASSERT_TRUE(std::isnan(testLowerValue));
+      }
+      else
+      {
+         ASSERT_TRUE(std::isfinite(testLowerValue));
+         ASSERT_NEAR(testLowerValue, testIndicator.pick(testIteration, testLowerValue).lower, std::abs(testLowerValue) * 1e-9);
+      }
+      testPrice += testPriceStepValue * fixture.random_number<int64_t>(1, 10);
+      std::ignore = testIndicator.calc(testIteration, testPrice);
+   }
+}
+
+TEST_F(TeAn, BollingerBandsSolve)
+{
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      auto const testPeriod{random_number<uint32_t>(3, 50),};
+      auto const testUpperBandMultiplier{random_number<double>(1.0, 3.0),};
+      auto const testLowerBandMultiplier{random_number<double>(1.0, 3.0),};
+      ASSERT_NO_FATAL_FAILURE(test_solve_bollinger_bands<bollinger_bands<simple_moving_average<20>>>(*this, testPriceStep, 20, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_solve_bollinger_bands<bollinger_bands<simple_moving_average<>>>(*this, testPriceStep, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier, testPeriod));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator, typename... indicator_args>
+void test_amend_bollinger_bands(TeAn &fixture, uint32_t const testPeriod, indicator_args const... testIndicatorArgs)
+{
+   indicator testIndicator{testIndicatorArgs...,};
+   indicator testExpectedIndicator{testIndicatorArgs...,};
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// An amended calc must match a calc with the final input, whole prices keep the amended sums exact
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+      auto testPrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      auto testValue{testIndicator.amend(testIteration, testPrice),};
+      for (auto testAmendsNumber{fixture.random_number<uint32_t>(0, 3),}; 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+         testValue = testIndicator.amend(testIteration, testPrice);
+      }
+      auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice),};
+      if (true == std::isnan(testExpectedValue.middle))
+      {
+         ASSERT_TRUE(std::isnan(testValue.middle));
+         continue;
+      }
+      ASSERT_NEAR(testExpectedValue.upper, testValue.upper, testExpectedValue.middle * 1e-9);
+      ASSERT_NEAR(testExpectedValue.middle, testValue.middle, testExpectedValue.middle * 1e-9);
+      ASSERT_NEAR(testExpectedValue.lower, testValue.lower, testExpectedValue.middle * 1e-9);
+   }
+}
+
+TEST_F(TeAn, BollingerBandsAmend)
+{
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testUpperBandMultiplier{random_number<double>(1.0, 3.0),};
+      auto const testLowerBandMultiplier{random_number<double>(1.0, 3.0),};
+      ASSERT_NO_FATAL_FAILURE(test_amend_bollinger_bands<bollinger_bands<simple_moving_average<>>>(*this, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier));
+      ASSERT_NO_FATAL_FAILURE(test_amend_bollinger_bands<bollinger_bands<exponential_moving_average<>>>(*this, testPeriod, testPeriod, testUpperBandMultiplier, testLowerBandMultiplier, random_number<uint32_t>(0, 10)));
+   }
+   ASSERT_NO_FATAL_FAILURE(test_amend_bollinger_bands<bollinger_bands<simple_moving_average<20>>>(*this, 20, 2.0, 2.0));
+}
+
+template<typename indicator, typename restored_indicator, typename other_period_indicator>
+void test_state_bollinger_bands(TeAn &fixture, indicator &testIndicator, restored_indicator &testRestoredIndicator, other_period_indicator &testOtherPeriodIndicator, uint32_t const testPeriod)
+{
+   /// Both the deviation window and the moving average are saved, so the state may be saved at any phase of either
+   auto const testIterationsNumber{fixture.random_number<uint32_t>(1, testPeriod * 3),};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+   }
+   std::vector<std::byte> testState;
+   state_writer testWriter{testState,};
+   testIndicator.save(testIterationsNumber - 1, testWriter);
+   /// States of another format version, of another sequence number or of another period are rejected
+   auto testOtherVersionState{testState,};
+   testOtherVersionState.front() ^= std::byte{0xff};
+   state_reader testOtherVersionReader{testOtherVersionState,};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber - 1, testOtherVersionReader));
+   ASSERT_FALSE(testOtherVersionReader.good());
+   state_reader testOtherSequenceNumberReader{testState,};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber, testOtherSequenceNumberReader));
+   state_reader testOtherPeriodReader{testState,};
+   ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber - 1, testOtherPeriodReader));
+   /// A failed load may leave the indicator partially restored, so it is reset before the state is loaded for good
+   testRestoredIndicator.reset();
+   state_reader testReader{testState,};
+   ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+   ASSERT_EQ(testState.size(), testReader.position());
+   for (auto testIteration{testIterationsNumber,}; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      auto const testValue{testIndicator.calc(testIteration, testPrice),};
+      auto const testRestoredValue{testRestoredIndicator.calc(testIteration, testPrice),};
+      if (true == std::isnan(testValue.middle))
+      {
+         ASSERT_TRUE(std::isnan(testRestoredValue.middle));
+         continue;
+      }
+      ASSERT_EQ(testValue.upper, testRestoredValue.upper);
+      ASSERT_EQ(testValue.middle, testRestoredValue.middle);
+      ASSERT_EQ(testValue.lower, testRestoredValue.lower);
+   }
+}
+
+TEST_F(TeAn, BollingerBandsState)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testUpperBandMultiplier{random_number<double>(1.0, 3.0),};
+      auto const testLowerBandMultiplier{random_number<double>(1.0, 3.0),};
+      auto const testUnstablePeriod{random_number<uint32_t>(0, 10),};
+      bollinger_bands<simple_moving_average<>> testIndicator{testPeriod, testUpperBandMultiplier, testLowerBandMultiplier,};
+      bollinger_bands<simple_moving_average<>> testRestoredIndicator{testPeriod, testUpperBandMultiplier, testLowerBandMultiplier,};
+      bollinger_bands<simple_moving_average<>> testOtherPeriodIndicator{testPeriod + 1, testUpperBandMultiplier, testLowerBandMultiplier,};
+      ASSERT_NO_FATAL_FAILURE(test_state_bollinger_bands(*this, testIndicator, testRestoredIndicator, testOtherPeriodIndicator, testPeriod));
+      bollinger_bands<exponential_moving_average<>> testExponentialIndicator{testPeriod, testUpperBandMultiplier, testLowerBandMultiplier, testUnstablePeriod,};
+      bollinger_bands<exponential_moving_average<>> testRestoredExponentialIndicator{testPeriod, testUpperBandMultiplier, testLowerBandMultiplier, testUnstablePeriod,};
+      bollinger_bands<exponential_moving_average<>> testOtherPeriodExponentialIndicator{testPeriod + 1, testUpperBandMultiplier, testLowerBandMultiplier, testUnstablePeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_state_bollinger_bands(*this, testExponentialIndicator, testRestoredExponentialIndicator, testOtherPeriodExponentialIndicator, testPeriod));
+   }
+   bollinger_bands<simple_moving_average<testFixedPeriod>> testFixedIndicator{2.0, 2.0,};
+   bollinger_bands<simple_moving_average<testFixedPeriod>> testRestoredFixedIndicator{2.0, 2.0,};
+   bollinger_bands<simple_moving_average<testFixedPeriod + 1>> testOtherPeriodFixedIndicator{2.0, 2.0,};
+   ASSERT_NO_FATAL_FAILURE(test_state_bollinger_bands(*this, testFixedIndicator, testRestoredFixedIndicator, testOtherPeriodFixedIndicator, testFixedPeriod));
+   /// A deviation window on a foreign memory resource shares the state layout, loading into it never allocates
+   counting_memory_resource testMemoryResource;
+   bollinger_bands<simple_moving_average<>> testIndicator{testFixedPeriod, 2.0, 2.0,};
+   bollinger_bands<simple_moving_average<>> testArenaIndicator{testFixedPeriod, 2.0, 2.0, std::addressof(testMemoryResource),};
+   bollinger_bands<simple_moving_average<>> testOtherPeriodIndicator{testFixedPeriod + 1, 2.0, 2.0,};
+   auto const testAllocationsNumber{testMemoryResource.allocations(),};
+   ASSERT_NO_FATAL_FAILURE(test_state_bollinger_bands(*this, testIndicator, testArenaIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   ASSERT_EQ(testAllocationsNumber, testMemoryResource.allocations());
+}
+
 }
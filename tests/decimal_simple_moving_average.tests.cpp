@@ -0,0 +1,90 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "tean.tests.hpp" /// for tean::tests::TeAn
+
+#include "tean/decimal_simple_moving_average.hpp" /// for the test target
+#include "tean/simple_moving_average.hpp" /// for tean::simple_moving_average
+
+#include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+
+#include <cmath> /// for std::isnan
+#include <cstdint> /// for int64_t, uint32_t
+#include <memory> /// for std::make_unique
+
+namespace tean::tests
+{
+
+TEST_F(TeAn, DecimalSimpleMovingAverage)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPricePrecision = inverted_power_of_ten[testPriceStep.scale / 2] * inverted_power_of_ten[6];
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 10;
+         decimal_simple_moving_average testIndicator{testPeriod, testPriceStep.scale};
+         simple_moving_average<> testAdditionalIndicator{testPeriod};
+         ASSERT_EQ(testPeriod, testIndicator.period());
+         ASSERT_EQ(testIndicator.lookback_period(), testAdditionalIndicator.lookback_period());
+         ASSERT_EQ(testPriceStep.scale, testIndicator.scale());
+         auto testPrices = std::make_unique<int64_t[]>(testIterationsNumber);
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            auto const testPrice = testPriceStep.value * random_number<int64_t>(100, 1000);
+            testPrices[testIteration] = testPrice;
+            auto const testAdditionalValue = testAdditionalIndicator.calc(testIteration, static_cast<double>(decimal{.value = testPrice, .scale = testPriceStep.scale}));
+            if (testIndicator.lookback_period() > testIteration)
+            {
+               ASSERT_TRUE(std::isnan(testIndicator.pick(testIteration, testPrice)));
+               ASSERT_TRUE(std::isnan(testIndicator.calc(testIteration, testPrice)));
+               continue;
+            }
+            int64_t testSum = 0;
+            for (auto testWindowIndex = testIteration - testIndicator.lookback_period(); testWindowIndex <= testIteration; ++testWindowIndex)
+            {
+               testSum += testPrices[testWindowIndex];
+            }
+            int64_t testPickSum = 0;
+            auto const testPickValue = testIndicator.pick(testIteration, testPrice, testPickSum);
+            ASSERT_EQ(testSum, testPickSum);
+            int64_t testCalcSum = 0;
+            auto const testCalcValue = testIndicator.calc(testIteration, testPrice, testCalcSum);
+            ASSERT_EQ(testSum, testCalcSum);
+            ASSERT_DOUBLE_EQ(testPickValue, testCalcValue);
+            ASSERT_DOUBLE_EQ(testCalcValue, static_cast<double>(testSum) / (testPeriod * static_cast<double>(power_of_ten[testPriceStep.scale])));
+            ASSERT_THAT(testCalcValue, testing::DoubleNear(testAdditionalValue, testPricePrecision));
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "tean.tests.hpp" /// for tean::tests::TeAn
+
+#include "tean/decimal_variance.hpp" /// for the test target
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/variance.hpp" /// for tean::variance
+
+#include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear
+#include <gtest/gtest.h> /// for ASSERT_EQ, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+
+#include <cmath> /// for std::isnan
+#include <cstddef> /// for std::byte
+#include <cstdint> /// for int64_t, uint32_t
+#include <memory> /// for std::make_unique
+#include <tuple> /// for std::ignore
+#include <vector> /// for std::vector
+
+namespace tean::tests
+{
+
+TEST_F(TeAn, DecimalVariance)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPricePrecision = inverted_power_of_ten[testPriceStep.scale / 3] * inverted_power_of_ten[1];
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 10;
+         decimal_variance testIndicator{testPeriod, testPriceStep.scale};
+         variance<> testAdditionalIndicator{testPeriod};
+         ASSERT_EQ(testPeriod, testIndicator.period());
+         ASSERT_EQ(testIndicator.lookback_period(), testAdditionalIndicator.lookback_period());
+         ASSERT_EQ(testPriceStep.scale, testIndicator.scale());
+         auto testPrices = std::make_unique<int64_t[]>(testIterationsNumber);
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            /// Occasional spikes would leave rounding residue in double running sums
+            auto const testPrice = (0 == random_number<uint32_t>(0, testPeriod))
+               ? testPriceStep.value * random_number<int64_t>(100, 1000) * static_cast<int64_t>(power_of_ten[6])
+               : testPriceStep.value * random_number<int64_t>(100, 1000)
+            ;
+            testPrices[testIteration] = testPrice;
+            if (testIndicator.lookback_period() > testIteration)
+            {
+               double testMean = 0;
+               ASSERT_TRUE(std::isnan(testIndicator.pick(testIteration, testPrice, testMean)));
+               ASSERT_TRUE(std::isnan(testMean));
+               ASSERT_TRUE(std::isnan(testIndicator.calc(testIteration, testPrice, testMean)));
+               ASSERT_TRUE(std::isnan(testMean));
+               continue;
+            }
+            double testPickMean = 0;
+            auto const testPickValue = testIndicator.pick(testIteration, testPrice, testPickMean);
+            double testCalcMean = 0;
+            auto const testCalcValue = testIndicator.calc(testIteration, testPrice, testCalcMean);
+            ASSERT_EQ(testPickValue, testCalcValue);
+            ASSERT_EQ(testPickMean, testCalcMean);
+            /// Integer running sums carry no history, a fresh indicator over the same window must agree exactly
+            decimal_variance testWindowIndicator{testPeriod, testPriceStep.scale};
+            double testWindowValue = 0;
+            double testWindowMean = 0;
+            for (uint32_t testWindowIteration = 0; testWindowIteration < testPeriod; ++testWindowIteration)
+            {
+               testWindowValue = testWindowIndicator.calc(testWindowIteration, testPrices[testIteration - testIndicator.lookback_period() + testWindowIteration], testWindowMean);
+            }
+            ASSERT_EQ(testWindowValue, testCalcValue);
+            ASSERT_EQ(testWindowMean, testCalcMean);
+            double testAdditionalMean = 0;
+            variance<> testAdditionalWindowIndicator{testPeriod};
+            double testAdditionalValue = 0;
+            for (uint32_t testWindowIteration = 0; testWindowIteration < testPeriod; ++testWindowIteration)
+            {
+               auto const testWindowPrice = testPrices[testIteration - testIndicator.lookback_period() + testWindowIteration];
+               testAdditionalValue = testAdditionalWindowIndicator.calc(testWindowIteration, static_cast<double>(decimal{.value = testWindowPrice, .scale = testPriceStep.scale}), testAdditionalMean);
+            }
+            ASSERT_THAT(testCalcMean, testing::DoubleNear(testAdditionalMean, testPricePrecision * testAdditionalMean));
+            ASSERT_THAT(testCalcValue, testing::DoubleNear(testAdditionalValue, testPricePrecision * testAdditionalMean * testAdditionalMean));
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, DecimalVarianceState)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 50;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      decimal_variance testIndicator{testPeriod, 2};
+      /// The ring cursor moves with every calc, so the state may be saved at any phase of the window
+      auto const testIterationsNumber = random_number<uint32_t>(1, testPeriod * 3);
+      for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+      {
+         std::ignore = testIndicator.calc(testIteration, random_number<int64_t>(10000, 100000));
+      }
+      std::vector<std::byte> testState;
+      state_writer testWriter{testState};
+      testIndicator.save(testIterationsNumber - 1, testWriter);
+      decimal_variance testRestoredIndicator{testPeriod, 2};
+      state_reader testReader{testState};
+      ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+      ASSERT_EQ(testState.size(), testReader.position());
+      for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+      {
+         auto const testPrice = random_number<int64_t>(10000, 100000);
+         auto const testValue = testIndicator.calc(testIteration, testPrice);
+         auto const testRestoredValue = testRestoredIndicator.calc(testIteration, testPrice);
+         ASSERT_EQ(std::isnan(testValue), std::isnan(testRestoredValue));
+         if (false == std::isnan(testValue))
+         {
+            ASSERT_EQ(testValue, testRestoredValue);
+         }
+      }
+   }
+}
+
+}
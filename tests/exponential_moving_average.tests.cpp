@@ -27,15 +27,19 @@
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
 #include "tean/exponential_moving_average.hpp" /// for the test target
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleEq, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <ta_func.h> /// for TA_EMA, TA_EMA_Lookback, TA_FUNC_UNST_EMA, TA_SetUnstablePeriod, TA_SUCCESS
 
 #include <cmath> /// for std::isnan
+#include <cstddef> /// for std::byte
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::vector
 
 namespace tean::tests
@@ -52,7 +56,7 @@ TEST_F(TeAn, ExponentialMovingAverage)
       {
          auto const testIterationsNumber = testPeriod * 10;
          auto const testUnstablePeriod = random_number<uint32_t>(0, testPeriod);
-         exponential_moving_average testIndicator{testPeriod, testUnstablePeriod};
+         exponential_moving_average<> testIndicator{testPeriod, testUnstablePeriod};
          ASSERT_EQ(testPeriod, testIndicator.period());
          auto testPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          for (uint32_t testIteration = 0; testIteration < testIndicator.lookback_period(); ++testIteration)
@@ -121,4 +125,192 @@ TEST_F(TeAn, ExponentialMovingAverage)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+TEST_F(TeAn, ExponentialMovingAverageState)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testUnstablePeriod = random_number<uint32_t>(0, testPeriod);
+         exponential_moving_average<> testIndicator{testPeriod, testUnstablePeriod};
+         /// The state may be saved anywhere, including inside the lookback and the untrusted period
+         auto const testIterationsNumber = random_number<uint32_t>(1, testIndicator.lookback_period() * 2);
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            std::ignore = testIndicator.calc(testIteration, testPriceStepValue * random_number<int64_t>(100, 1000));
+         }
+         std::vector<std::byte> testState;
+         state_writer testWriter{testState};
+         testIndicator.save(testIterationsNumber - 1, testWriter);
+         exponential_moving_average<> testRestoredIndicator{testPeriod, testUnstablePeriod};
+         state_reader testReader{testState};
+         ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+         ASSERT_EQ(testState.size(), testReader.position());
+         exponential_moving_average<> testOtherUnstablePeriodIndicator{testPeriod, testUnstablePeriod + 1};
+         state_reader testOtherUnstablePeriodReader{testState};
+         ASSERT_FALSE(testOtherUnstablePeriodIndicator.load(testIterationsNumber - 1, testOtherUnstablePeriodReader));
+         for (auto testIteration = testIterationsNumber; testIteration < (testIndicator.lookback_period() + testPeriod * 2); ++testIteration)
+         {
+            auto const testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testValue = testIndicator.calc(testIteration, testPrice);
+            auto const testRestoredValue = testRestoredIndicator.calc(testIteration, testPrice);
+            ASSERT_EQ(std::isnan(testValue), std::isnan(testRestoredValue));
+            if (false == std::isnan(testValue))
+            {
+               ASSERT_EQ(testValue, testRestoredValue);
+            }
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, ExponentialMovingAverageAmend)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testUnstablePeriod = random_number<uint32_t>(0, testPeriod);
+         exponential_moving_average<> testIndicator{testPeriod, testUnstablePeriod};
+         exponential_moving_average<> testExpectedIndicator{testPeriod, testUnstablePeriod};
+         for (uint32_t testIteration = 0; testIteration < (testIndicator.lookback_period() + testPeriod * 2); ++testIteration)
+         {
+            /// An amended calc must be indistinguishable from a calc with the final input
+            std::ignore = testIndicator.calc(testIteration, testPriceStepValue * random_number<int64_t>(100, 1000));
+            auto testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto testValue = testIndicator.amend(testIteration, testPrice);
+            for (auto testAmendsNumber = random_number<uint32_t>(0, 3); 0 < testAmendsNumber; --testAmendsNumber)
+            {
+               testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+               testValue = testIndicator.amend(testIteration, testPrice);
+            }
+            auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+            ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+            if (false == std::isnan(testExpectedValue))
+            {
+               ASSERT_EQ(testExpectedValue, testValue);
+            }
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<uint32_t test_period>
+void test_fixed_exponential_moving_average_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testIterationsNumber{test_period * 10,};
+   auto const testUnstablePeriod{fixture.random_number<uint32_t>(0, test_period),};
+   exponential_moving_average<test_period> testIndicator{testUnstablePeriod,};
+   exponential_moving_average<> testRuntimeIndicator{test_period, testUnstablePeriod,};
+   ASSERT_EQ(testIndicator.lookback_period(), testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testIteration{0,}; testIteration < (testIndicator.lookback_period() + testIterationsNumber); ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testPickValue{testIndicator.pick(testIteration, testPrice),};
+      auto const testCalcValue{testIndicator.calc(testIteration, testPrice),};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testPrice),};
+      if (testIndicator.lookback_period() > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickValue));
+         ASSERT_TRUE(std::isnan(testCalcValue));
+         ASSERT_TRUE(std::isnan(testRuntimeValue));
+         continue;
+      }
+      ASSERT_DOUBLE_EQ(testPickValue, testRuntimeValue);
+      ASSERT_DOUBLE_EQ(testCalcValue, testRuntimeValue);
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_exponential_moving_average(TeAn &fixture, decimal const testPriceStep)
+{
+   test_fixed_exponential_moving_average_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_exponential_moving_average<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, ExponentialMovingAverageFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_exponential_moving_average<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_exponential_moving_average<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_exponential_moving_average_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   /// Carried forward and zero volume bars repeat the latest input, decay only bars are zeros
+   auto testLatestValue{0.0,};
+   auto const testExpectedCalc = [&] (uint64_t const testSequenceNumber, double const testValue)
+   {
+      testLatestValue = testValue;
+      return testExpectedIndicator.calc(testSequenceNumber, testValue);
+   };
+   uint64_t testSequenceNumber{0,};
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         auto const testGap{fixture.random_number<uint64_t>(1, testPeriod * 3),};
+         auto const testFill{static_cast<gap_fill>(fixture.random_number<int>(0, 2)),};
+         testIndicator.skip(testSequenceNumber, testGap, testFill);
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedCalc(testSequenceNumber + testGapIndex, (gap_fill::decay_only == testFill) ? 0.0 : testLatestValue);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      auto const testValue{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      auto const testExpectedValue{testExpectedCalc(testSequenceNumber, testValue),};
+      auto const testActualValue{testIndicator.calc(testSequenceNumber, testValue),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testActualValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testActualValue, testExpectedValue * 1e-9);
+      }
+      if (0 == fixture.random_number<uint32_t>(0, 2))
+      {
+         /// A skip leaves nothing to amend, yet the calc that follows it can be amended
+         auto const testAmendedValue{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+         testLatestValue = testAmendedValue;
+         auto const testExpectedAmendedValue{testExpectedIndicator.amend(testSequenceNumber, testAmendedValue),};
+         auto const testActualAmendedValue{testIndicator.amend(testSequenceNumber, testAmendedValue),};
+         ASSERT_EQ(std::isnan(testExpectedAmendedValue), std::isnan(testActualAmendedValue));
+         if (false == std::isnan(testExpectedAmendedValue))
+         {
+            ASSERT_NEAR(testExpectedAmendedValue, testActualAmendedValue, testExpectedAmendedValue * 1e-9);
+         }
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, ExponentialMovingAverageSkip)
+{
+   constexpr uint32_t testFixedPeriod{10,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      exponential_moving_average<> testIndicator{testPeriod, 0,};
+      exponential_moving_average<> testExpectedIndicator{testPeriod, 0,};
+      ASSERT_NO_FATAL_FAILURE(test_exponential_moving_average_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   exponential_moving_average<testFixedPeriod> testFixedIndicator{0,};
+   exponential_moving_average<testFixedPeriod> testExpectedFixedIndicator{0,};
+   ASSERT_NO_FATAL_FAILURE(test_exponential_moving_average_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
 }
@@ -0,0 +1,106 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+
+#include "tean.tests.hpp" /// for tean::tests::TeAn
+
+#include "tean/indicator_store.hpp" /// for the test target
+#include "tean/relative_strength_index.hpp" /// for tean::relative_strength_index
+#include "tean/sum_over_period.hpp" /// for tean::sum_over_period
+
+#include <gtest/gtest.h> /// for ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+
+#include <cmath> /// for std::isnan
+#include <cstdint> /// for int64_t, uint32_t, uint64_t
+#include <filesystem> /// for std::filesystem::file_size, std::filesystem::remove, std::filesystem::temp_directory_path
+#include <fstream> /// for std::ofstream
+#include <ios> /// for std::ios
+#include <string> /// for std::string, std::to_string
+#include <vector> /// for std::vector
+
+namespace tean::tests
+{
+
+TEST_F(TeAn, IndicatorStore)
+{
+   constexpr uint32_t testSlotsNumber{16,};
+   constexpr uint32_t testIterationsNumber{100,};
+   auto const testPath{(std::filesystem::temp_directory_path() / ("tean.indicator_store." + std::to_string(random_number<uint64_t>(0, static_cast<uint64_t>(-1))))).string(),};
+   std::vector<sum_over_period<20>> testSums(testSlotsNumber);
+   std::vector<relative_strength_index<14>> testRSIs(testSlotsNumber);
+   auto const testStep = [&] (uint64_t const testFirstIteration)
+   {
+      indicator_store<sum_over_period<20>> testSumStore;
+      ASSERT_TRUE(testSumStore.open(testPath + ".sum", testSlotsNumber, sum_over_period<20>{}));
+      ASSERT_EQ(testSlotsNumber, testSumStore.size());
+      indicator_store<relative_strength_index<14>> testRSIStore;
+      ASSERT_TRUE(testRSIStore.open(testPath + ".rsi", testSlotsNumber, relative_strength_index<14>{}));
+      for (auto testIteration{testFirstIteration,}; testIteration < (testFirstIteration + testIterationsNumber); ++testIteration)
+      {
+         for (uint32_t testSlot{0,}; testSlot < testSlotsNumber; ++testSlot)
+         {
+            auto const testPrice{0.01 * random_number<int64_t>(100, 1000),};
+            ASSERT_EQ(testSums[testSlot].calc(testIteration, testPrice), testSumStore[testSlot].calc(testIteration, testPrice));
+            auto const testRSIValue{testRSIs[testSlot].calc(testIteration, testPrice),};
+            auto const testStoredRSIValue{testRSIStore[testSlot].calc(testIteration, testPrice),};
+            ASSERT_EQ(std::isnan(testRSIValue), std::isnan(testStoredRSIValue));
+            if (false == std::isnan(testRSIValue))
+            {
+               ASSERT_EQ(testRSIValue, testStoredRSIValue);
+            }
+         }
+      }
+      ASSERT_TRUE(testSumStore.sync());
+   };
+   /// Reopened stores continue every slot exactly where the previous mapping stopped
+   ASSERT_NO_FATAL_FAILURE(testStep(0));
+   ASSERT_NO_FATAL_FAILURE(testStep(testIterationsNumber));
+   ASSERT_NO_FATAL_FAILURE(testStep(testIterationsNumber * 2));
+   /// Stores of another slots number or of another indicator layout are rejected
+   indicator_store<sum_over_period<20>> testOtherSizeStore;
+   ASSERT_FALSE(testOtherSizeStore.open(testPath + ".sum", testSlotsNumber + 1, sum_over_period<20>{}));
+   ASSERT_FALSE(testOtherSizeStore.is_open());
+   indicator_store<sum_over_period<21>> testOtherLayoutStore;
+   ASSERT_FALSE(testOtherLayoutStore.open(testPath + ".sum", testSlotsNumber, sum_over_period<21>{}));
+   /// An indicator of the very same layout but of another type is told apart by the type tag
+   static_assert(sizeof(relative_strength_index<14>) == sizeof(relative_strength_index<15>));
+   indicator_store<relative_strength_index<15>> testOtherTypeStore;
+   ASSERT_FALSE(testOtherTypeStore.open(testPath + ".rsi", testSlotsNumber, relative_strength_index<15>{}));
+   /// Rejected files are left untouched instead of being extended to the store size
+   auto const testFileSize{std::filesystem::file_size(testPath + ".sum"),};
+   ASSERT_FALSE(testOtherSizeStore.open(testPath + ".sum", testSlotsNumber * 2, sum_over_period<20>{}));
+   ASSERT_EQ(testFileSize, std::filesystem::file_size(testPath + ".sum"));
+   {
+      std::ofstream testForeignFile{testPath + ".foreign", std::ios::binary,};
+      testForeignFile << "not a store";
+   }
+   ASSERT_FALSE(testOtherSizeStore.open(testPath + ".foreign", testSlotsNumber, sum_over_period<20>{}));
+   ASSERT_EQ(std::string{"not a store"}.size(), std::filesystem::file_size(testPath + ".foreign"));
+   std::filesystem::remove(testPath + ".foreign");
+   std::filesystem::remove(testPath + ".sum");
+   std::filesystem::remove(testPath + ".rsi");
+}
+
+}
@@ -24,19 +24,24 @@
 */
 
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "memory_resource.tests.hpp" /// for tean::tests::counting_memory_resource
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 #include "tean/linear_regression.hpp" /// for the test target
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <ta_func.h> /// for TA_LINEARREG, TA_LINEARREG_INTERCEPT, TA_LINEARREG_INTERCEPT_Lookback, TA_LINEARREG_Lookback, TA_LINEARREG_SLOPE, TA_LINEARREG_SLOPE_Lookback, TA_SUCCESS, TA_TSF, TA_TSF_Lookback
 
-#include <algorithm> /// for std::fill
-#include <cmath> /// for std::isfinite
+#include <algorithm> /// for std::fill, std::max
+#include <cmath> /// for std::isfinite, std::isnan, std::sqrt
+#include <cstddef> /// for size_t, std::byte
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -203,6 +208,91 @@ void test_linear_regression_step(TeAn &fixture, decimal const testPriceStep)
          }
       }
    }
+   {
+      auto const testResummationPeriod{fixture.random_number<uint32_t>(2, test_period * 2),};
+      linear_regression<test_period> testIndicator{testResummationPeriod,};
+      linear_regression<> testRuntimeIndicator{test_period, testResummationPeriod,};
+      ASSERT_EQ(testResummationPeriod, testIndicator.resummation_period());
+      ASSERT_EQ(testResummationPeriod, testRuntimeIndicator.resummation_period());
+      for (uint32_t testIteration{0,}; testIteration < (testLookbackPeriod + testIterationsNumber); ++testIteration)
+      {
+         auto const testCalcValue{testIndicator.calc(testIteration, testPrices[testIteration]),};
+         auto const testRuntimeCalcValue{testRuntimeIndicator.calc(testIteration, testPrices[testIteration]),};
+         if (testLookbackPeriod > testIteration)
+         {
+            ASSERT_FALSE(std::isfinite(testCalcValue.intercept));
+            ASSERT_FALSE(std::isfinite(testCalcValue.slope));
+            ASSERT_FALSE(std::isfinite(testRuntimeCalcValue.intercept));
+            ASSERT_FALSE(std::isfinite(testRuntimeCalcValue.slope));
+         }
+         else
+         {
+            ASSERT_THAT(testCalcValue.intercept, testIntercepts[testIteration - testLookbackPeriod]);
+            ASSERT_THAT(testCalcValue.slope, testSlopes[testIteration - testLookbackPeriod]);
+            ASSERT_THAT(testRuntimeCalcValue.intercept, testIntercepts[testIteration - testLookbackPeriod]);
+            ASSERT_THAT(testRuntimeCalcValue.slope, testSlopes[testIteration - testLookbackPeriod]);
+         }
+      }
+   }
+   {
+      constexpr double testChannelWidth{2,};
+      auto const testPricePrecision{inverted_power_of_ten[std::max<uint32_t>(6, testPriceStep.scale)],};
+      linear_regression<test_period> testIndicator{};
+      linear_regression<> testRuntimeIndicator{test_period,};
+      for (uint32_t testIteration{0,}; testIteration < (testLookbackPeriod + testIterationsNumber); ++testIteration)
+      {
+         auto const testCalcValue{testIndicator.calc_extended(testIteration, testPrices[testIteration], testChannelWidth),};
+         auto const testRuntimeCalcValue{testRuntimeIndicator.calc_extended(testIteration, testPrices[testIteration], testChannelWidth),};
+         if (testLookbackPeriod > testIteration)
+         {
+            ASSERT_FALSE(std::isfinite(testCalcValue.r_squared));
+            ASSERT_FALSE(std::isfinite(testCalcValue.standard_error));
+            ASSERT_FALSE(std::isfinite(testRuntimeCalcValue.r_squared));
+            ASSERT_FALSE(std::isfinite(testRuntimeCalcValue.standard_error));
+            continue;
+         }
+         auto const *const testWindow{testPrices.get() + testIteration - testLookbackPeriod,};
+         constexpr auto testMeanX{testLookbackPeriod * 0.5,};
+         double testMeanY{0,};
+         for (uint32_t x{0,}; x < test_period; ++x)
+         {
+            testMeanY += testWindow[x];
+         }
+         testMeanY /= test_period;
+         double testSquareDeviationX{0,};
+         double testDeviationXY{0,};
+         double testSquareDeviationY{0,};
+         for (uint32_t x{0,}; x < test_period; ++x)
+         {
+            testSquareDeviationX += (x - testMeanX) * (x - testMeanX);
+            testDeviationXY += (x - testMeanX) * (testWindow[x] - testMeanY);
+            testSquareDeviationY += (testWindow[x] - testMeanY) * (testWindow[x] - testMeanY);
+         }
+         auto const testSlope{testDeviationXY / testSquareDeviationX,};
+         auto const testIntercept{testMeanY - testSlope * testMeanX,};
+         double testSquareError{0,};
+         for (uint32_t x{0,}; x < test_period; ++x)
+         {
+            auto const testError{testWindow[x] - testIntercept - testSlope * x,};
+            testSquareError += testError * testError;
+         }
+         auto const testValue{testIntercept + testSlope * testLookbackPeriod,};
+         auto const testStandardError{(2 < test_period) ? std::sqrt(testSquareError / (test_period - 2)) : 0.0,};
+         auto const testRSquared{(0 < testSquareDeviationY) ? (1.0 - testSquareError / testSquareDeviationY) : 0.0,};
+         auto const testStandardErrorPrecision{testPricePrecision + testStandardError * 1e-9,};
+         for (auto const &testExtendedValue : {testCalcValue, testRuntimeCalcValue,})
+         {
+            ASSERT_THAT(testExtendedValue.intercept, testIntercepts[testIteration - testLookbackPeriod]);
+            ASSERT_THAT(testExtendedValue.slope, testSlopes[testIteration - testLookbackPeriod]);
+            ASSERT_THAT(testExtendedValue.value, testing::DoubleNear(testValue, testPricePrecision));
+            ASSERT_THAT(testExtendedValue.forecast, testing::DoubleNear(testValue + testSlope, testPricePrecision));
+            ASSERT_THAT(testExtendedValue.r_squared, testing::DoubleNear(testRSquared, 1e-9));
+            ASSERT_THAT(testExtendedValue.standard_error, testing::DoubleNear(testStandardError, testStandardErrorPrecision));
+            ASSERT_THAT(testExtendedValue.upper_channel, testing::DoubleNear(testValue + testChannelWidth * testStandardError, testPricePrecision + testStandardErrorPrecision * testChannelWidth));
+            ASSERT_THAT(testExtendedValue.lower_channel, testing::DoubleNear(testValue - testChannelWidth * testStandardError, testPricePrecision + testStandardErrorPrecision * testChannelWidth));
+         }
+      }
+   }
 }
 
 template<uint32_t test_period>
@@ -222,4 +312,284 @@ TEST_F(TeAn, LinearRegression)
    ASSERT_NO_FATAL_FAILURE(test_linear_regression<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00,}));
 }
 
+TEST_F(TeAn, LinearRegressionMemoryResource)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      /// The window of y values is the only allocation, the x values follow from the period, calcs never allocate
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = std::make_unique<linear_regression<>>(testPeriod, 1, std::addressof(testMemoryResource));
+      ASSERT_EQ(1u, testMemoryResource.allocations());
+      ASSERT_EQ(testPeriod * sizeof(double), testMemoryResource.allocated_bytes());
+      linear_regression<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testIndicator->calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue.slope == testValue.slope) || (std::isnan(testExpectedValue.slope) && std::isnan(testValue.slope)));
+         ASSERT_TRUE((testExpectedValue.intercept == testValue.intercept) || (std::isnan(testExpectedValue.intercept) && std::isnan(testValue.intercept)));
+      }
+      /// Copies take the default memory resource, and the indicator gives back everything it took once destroyed
+      auto const testCopiedIndicator = *testIndicator;
+      ASSERT_EQ(1u, testMemoryResource.allocations());
+      testIndicator.reset();
+      ASSERT_EQ(1u, testMemoryResource.deallocations());
+   }
+}
+
+TEST_F(TeAn, LinearRegressionInline)
+{
+   constexpr uint32_t testInlineCapacity = 16;
+   for (uint32_t testPeriod = 2; testPeriod <= (testInlineCapacity * 2); ++testPeriod)
+   {
+      /// Windows up to the inline capacity never reach the memory resource
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = linear_regression<static_cast<uint32_t>(-1), testInlineCapacity>{testPeriod, 1, std::addressof(testMemoryResource)};
+      ASSERT_EQ((testInlineCapacity < testPeriod) ? 1u : 0u, testMemoryResource.allocations());
+      linear_regression<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testIndicator.calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue.slope == testValue.slope) || (std::isnan(testExpectedValue.slope) && std::isnan(testValue.slope)));
+         ASSERT_TRUE((testExpectedValue.intercept == testValue.intercept) || (std::isnan(testExpectedValue.intercept) && std::isnan(testValue.intercept)));
+      }
+      /// A copy has to rebind the window to its own inline storage
+      auto testCopiedIndicator = testIndicator;
+      auto const *const testObject = reinterpret_cast<std::byte const *>(std::addressof(testCopiedIndicator));
+      auto const *const testRing = reinterpret_cast<std::byte const *>(testCopiedIndicator.window().older.data());
+      ASSERT_EQ(false == (testInlineCapacity < testPeriod), (testObject <= testRing) && ((testObject + sizeof(testCopiedIndicator)) > testRing));
+      for (uint32_t testIteration = (testPeriod * 10); testIteration < (testPeriod * 12); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testCopiedIndicator.calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue.slope == testValue.slope) || (std::isnan(testExpectedValue.slope) && std::isnan(testValue.slope)));
+         ASSERT_TRUE((testExpectedValue.intercept == testValue.intercept) || (std::isnan(testExpectedValue.intercept) && std::isnan(testValue.intercept)));
+      }
+   }
+}
+
+template<typename indicator>
+void test_linear_regression_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevPrice = 0.0;
+   uint64_t testSequenceNumber = 0;
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward and zero volume bars repeat the latest value
+         auto const testGap = fixture.random_number<uint64_t>(1, testPeriod * 3);
+         testIndicator.skip(testSequenceNumber, testGap, fixture.random_bool() ? gap_fill::carry_forward : gap_fill::zero_volume);
+         for (uint64_t testGapIndex = 0; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrice);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      testPrevPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto const testExpectedValue = testExpectedIndicator.calc(testSequenceNumber, testPrevPrice);
+      auto const testValue = testIndicator.calc(testSequenceNumber, testPrevPrice);
+      ASSERT_EQ(std::isnan(testExpectedValue.slope), std::isnan(testValue.slope));
+      if (false == std::isnan(testExpectedValue.slope))
+      {
+         /// The skip may resum at another bar than the calcs it replaces, which only moves the rounding
+         ASSERT_NEAR(testExpectedValue.slope, testValue.slope, 1e-9);
+         ASSERT_NEAR(testExpectedValue.intercept, testValue.intercept, 1e-9);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, LinearRegressionSkip)
+{
+   constexpr uint32_t testFixedPeriod = 20;
+   for (uint32_t testPeriod = 2; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testResummationPeriod = random_number<uint32_t>(1, testPeriod * 3);
+      linear_regression<> testIndicator{testPeriod, testResummationPeriod,};
+      linear_regression<> testExpectedIndicator{testPeriod, testResummationPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_linear_regression_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   linear_regression<testFixedPeriod> testFixedIndicator{testFixedPeriod * 3,};
+   linear_regression<testFixedPeriod> testExpectedFixedIndicator{testFixedPeriod * 3,};
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator>
+void test_linear_regression_amend(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   for (uint32_t testIteration = 0; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// An amended calc must match a calc with the final input, the sums swap the replaced input for the new one
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+      auto testPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto testValue = testIndicator.amend(testIteration, testPrice);
+      for (auto testAmendsNumber = fixture.random_number<uint32_t>(0, 3); 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+         testValue = testIndicator.amend(testIteration, testPrice);
+      }
+      auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+      ASSERT_EQ(std::isnan(testExpectedValue.slope), std::isnan(testValue.slope));
+      if (false == std::isnan(testExpectedValue.slope))
+      {
+         ASSERT_NEAR(testExpectedValue.slope, testValue.slope, 1e-9);
+         ASSERT_NEAR(testExpectedValue.intercept, testValue.intercept, 1e-9);
+      }
+   }
+}
+
+TEST_F(TeAn, LinearRegressionAmend)
+{
+   constexpr uint32_t testFixedPeriod = 20;
+   for (uint32_t testPeriod = 2; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testResummationPeriod = random_number<uint32_t>(1, testPeriod * 3);
+      linear_regression<> testIndicator{testPeriod, testResummationPeriod,};
+      linear_regression<> testExpectedIndicator{testPeriod, testResummationPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_linear_regression_amend(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   linear_regression<testFixedPeriod> testFixedIndicator{testFixedPeriod * 3,};
+   linear_regression<testFixedPeriod> testExpectedFixedIndicator{testFixedPeriod * 3,};
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_amend(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator>
+void test_linear_regression_lookahead(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod)
+{
+   constexpr double testChannelWidth = 2;
+   for (uint32_t testIteration = 0; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// Whole prices keep every sum exact, so the view that never resums must match a copy that commits the same values
+      auto testLookahead = testIndicator.lookahead();
+      indicator testExpectedIndicator{testIndicator};
+      auto const testLookaheadsNumber = fixture.random_number<uint32_t>(1, testPeriod);
+      for (uint32_t testLookaheadIndex = 0; testLookaheadIndex < testLookaheadsNumber; ++testLookaheadIndex)
+      {
+         auto const testSequenceNumber = testIteration + testLookaheadIndex;
+         auto const testPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+         if (true == fixture.random_bool())
+         {
+            auto const testExpectedValue = testExpectedIndicator.calc(testSequenceNumber, testPrice);
+            auto const testValue = testLookahead.calc(testSequenceNumber, testPrice);
+            ASSERT_EQ(std::isnan(testExpectedValue.slope), std::isnan(testValue.slope));
+            if (false == std::isnan(testExpectedValue.slope))
+            {
+               ASSERT_EQ(testExpectedValue.slope, testValue.slope);
+               ASSERT_EQ(testExpectedValue.intercept, testValue.intercept);
+            }
+         }
+         else
+         {
+            auto const testExpectedValue = testExpectedIndicator.calc_extended(testSequenceNumber, testPrice, testChannelWidth);
+            auto const testValue = testLookahead.calc_extended(testSequenceNumber, testPrice, testChannelWidth);
+            ASSERT_EQ(std::isnan(testExpectedValue.slope), std::isnan(testValue.slope));
+            if (false == std::isnan(testExpectedValue.slope))
+            {
+               ASSERT_EQ(testExpectedValue.slope, testValue.slope);
+               ASSERT_EQ(testExpectedValue.intercept, testValue.intercept);
+               ASSERT_EQ(testExpectedValue.r_squared, testValue.r_squared);
+               ASSERT_EQ(testExpectedValue.upper_channel, testValue.upper_channel);
+               ASSERT_EQ(testExpectedValue.lower_channel, testValue.lower_channel);
+            }
+         }
+      }
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+   }
+}
+
+TEST_F(TeAn, LinearRegressionLookahead)
+{
+   constexpr uint32_t testFixedPeriod = 20;
+   for (uint32_t testPeriod = 2; testPeriod <= 50; ++testPeriod)
+   {
+      linear_regression<> testIndicator{testPeriod, random_number<uint32_t>(1, testPeriod * 3),};
+      ASSERT_NO_FATAL_FAILURE(test_linear_regression_lookahead(*this, testIndicator, testPeriod));
+   }
+   linear_regression<static_cast<uint32_t>(-1), 32> testInlineIndicator{testFixedPeriod, testFixedPeriod,};
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_lookahead(*this, testInlineIndicator, testFixedPeriod));
+   linear_regression<testFixedPeriod> testFixedIndicator{testFixedPeriod * 3,};
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_lookahead(*this, testFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator, typename restored_indicator, typename other_period_indicator>
+void test_linear_regression_state(TeAn &fixture, indicator &testIndicator, restored_indicator &testRestoredIndicator, other_period_indicator &testOtherPeriodIndicator, uint32_t const testPeriod)
+{
+   /// The ring cursor and the resummation countdown move with every calc, so the state may be saved at any phase of the window
+   auto const testIterationsNumber = fixture.random_number<uint32_t>(1, testPeriod * 3);
+   for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+   {
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+   }
+   std::vector<std::byte> testState;
+   state_writer testWriter{testState};
+   testIndicator.save(testIterationsNumber - 1, testWriter);
+   /// States of another format version, of another sequence number or of another period are rejected
+   auto testOtherVersionState = testState;
+   testOtherVersionState.front() ^= std::byte{0xff};
+   state_reader testOtherVersionReader{testOtherVersionState};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber - 1, testOtherVersionReader));
+   ASSERT_FALSE(testOtherVersionReader.good());
+   state_reader testOtherSequenceNumberReader{testState};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber, testOtherSequenceNumberReader));
+   state_reader testOtherPeriodReader{testState};
+   ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber - 1, testOtherPeriodReader));
+   /// A failed load may leave the indicator partially restored, so it is reset before the state is loaded for good
+   testRestoredIndicator.reset();
+   state_reader testReader{testState};
+   ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+   ASSERT_EQ(testState.size(), testReader.position());
+   for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto const testValue = testIndicator.calc(testIteration, testPrice);
+      auto const testRestoredValue = testRestoredIndicator.calc(testIteration, testPrice);
+      ASSERT_EQ(std::isnan(testValue.slope), std::isnan(testRestoredValue.slope));
+      if (false == std::isnan(testValue.slope))
+      {
+         ASSERT_EQ(testValue.slope, testRestoredValue.slope);
+         ASSERT_EQ(testValue.intercept, testRestoredValue.intercept);
+      }
+   }
+}
+
+TEST_F(TeAn, LinearRegressionState)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 50;
+   constexpr uint32_t testFixedPeriod = 14;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      auto const testResummationPeriod = random_number<uint32_t>(1, testPeriod * 3);
+      linear_regression<> testIndicator{testPeriod, testResummationPeriod};
+      linear_regression<> testRestoredIndicator{testPeriod, testResummationPeriod};
+      linear_regression<> testOtherPeriodIndicator{testPeriod + 1, testResummationPeriod};
+      ASSERT_NO_FATAL_FAILURE(test_linear_regression_state(*this, testIndicator, testRestoredIndicator, testOtherPeriodIndicator, testPeriod));
+   }
+   constexpr uint32_t testResummationPeriod = testFixedPeriod * 3;
+   /// Heap, inline, fixed period and foreign memory resource rings share the state layout, loading into them never allocates
+   counting_memory_resource testMemoryResource;
+   linear_regression<> testIndicator{testFixedPeriod, testResummationPeriod};
+   linear_regression<static_cast<uint32_t>(-1), 16> testInlineIndicator{testFixedPeriod, testResummationPeriod};
+   linear_regression<> testArenaIndicator{testFixedPeriod, testResummationPeriod, std::addressof(testMemoryResource)};
+   linear_regression<testFixedPeriod> testFixedIndicator{testResummationPeriod};
+   linear_regression<> testOtherPeriodIndicator{testFixedPeriod + 1, testResummationPeriod};
+   auto const testAllocationsNumber = testMemoryResource.allocations();
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_state(*this, testIndicator, testInlineIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_state(*this, testIndicator, testArenaIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_state(*this, testIndicator, testFixedIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testFixedIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_linear_regression_state(*this, testFixedIndicator, testIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   ASSERT_EQ(testAllocationsNumber, testMemoryResource.allocations());
+}
+
 }
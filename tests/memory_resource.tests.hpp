@@ -0,0 +1,93 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef> /// for size_t
+#include <memory> /// for std::addressof
+#include <memory_resource> /// for std::pmr::memory_resource, std::pmr::new_delete_resource
+
+namespace tean::tests
+{
+
+/// Forwards to the upstream resource and counts what goes through it
+class [[nodiscard]] counting_memory_resource final : public std::pmr::memory_resource
+{
+private: using super = std::pmr::memory_resource;
+
+public:
+   [[maybe_unused, nodiscard]] explicit counting_memory_resource(std::pmr::memory_resource *const inUpstream = std::pmr::new_delete_resource()) noexcept :
+      super(),
+      m_upstream(inUpstream)
+   {}
+
+   counting_memory_resource(counting_memory_resource &&) = delete;
+   counting_memory_resource(counting_memory_resource const &) = delete;
+
+   counting_memory_resource &operator = (counting_memory_resource &&) = delete;
+   counting_memory_resource &operator = (counting_memory_resource const &) = delete;
+
+   [[maybe_unused, nodiscard]] size_t allocations() const noexcept
+   {
+      return m_allocations;
+   }
+
+   [[maybe_unused, nodiscard]] size_t allocated_bytes() const noexcept
+   {
+      return m_allocatedBytes;
+   }
+
+   [[maybe_unused, nodiscard]] size_t deallocations() const noexcept
+   {
+      return m_deallocations;
+   }
+
+private:
+   std::pmr::memory_resource *m_upstream;
+   size_t m_allocations{0,};
+   size_t m_allocatedBytes{0,};
+   size_t m_deallocations{0,};
+
+   [[nodiscard]] void *do_allocate(size_t const inBytes, size_t const inAlignment) override
+   {
+      auto *const memory{m_upstream->allocate(inBytes, inAlignment),};
+      ++m_allocations;
+      m_allocatedBytes += inBytes;
+      return memory;
+   }
+
+   void do_deallocate(void *const inMemory, size_t const inBytes, size_t const inAlignment) override
+   {
+      m_upstream->deallocate(inMemory, inBytes, inAlignment);
+      ++m_deallocations;
+   }
+
+   [[nodiscard]] bool do_is_equal(std::pmr::memory_resource const &inOther) const noexcept override
+   {
+      return this == std::addressof(inOther);
+   }
+};
+
+}
@@ -24,20 +24,26 @@
 */
 
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "memory_resource.tests.hpp" /// for tean::tests::counting_memory_resource
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 #include "tean/minimum_in_period.hpp" /// for the test target
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <indicators.h> /// for ti_min, ti_min_start, TI_OKAY
 #include <ta_func.h> /// for TA_MIN, TA_MIN_Lookback, TA_SUCCESS
 
-#include <algorithm> /// for std::fill
+#include <algorithm> /// for std::fill, std::min, std::min_element
 #include <cmath> /// for std::isnan
+#include <cstddef> /// for size_t, std::byte
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <span> /// for std::span
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -54,7 +60,7 @@ TEST_F(TeAn, MinimumInPeriod)
       for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
       {
          auto const testIterationsNumber = testPeriod * 10;
-         minimum_in_period testIndicator{testPeriod};
+         minimum_in_period<> testIndicator{testPeriod};
          ASSERT_EQ(testPeriod, testIndicator.period());
          auto testPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          {
@@ -143,4 +149,379 @@ TEST_F(TeAn, MinimumInPeriod)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+TEST_F(TeAn, MinimumInPeriodTrend)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep, int64_t const testPriceDirection)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 10;
+         minimum_in_period<> testIndicator{testPeriod};
+         auto testPrices = std::make_unique<double[]>(testIterationsNumber);
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            auto const testPrice = testPriceStepValue * (1000 + testPriceDirection * static_cast<int64_t>(testIteration));
+            testPrices[testIteration] = testPrice;
+            auto const testWindowBegin = (testIteration < testIndicator.lookback_period()) ? 0 : (testIteration - testIndicator.lookback_period());
+            auto const testValue = *std::min_element(testPrices.get() + testWindowBegin, testPrices.get() + testIteration + 1);
+            auto const testPickValue = testIndicator.pick(testIteration, testPrice);
+            ASSERT_FALSE(std::isnan(testPickValue));
+            ASSERT_DOUBLE_EQ(testPickValue, testValue);
+            auto const testCalcValue = testIndicator.calc(testIteration, testPrice);
+            ASSERT_FALSE(std::isnan(testCalcValue));
+            ASSERT_DOUBLE_EQ(testCalcValue, testValue);
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}, -1));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}, 0));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}, 1));
+}
+
+TEST_F(TeAn, MinimumInPeriodBatch)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 10;
+         minimum_in_period<> testIndicator{testPeriod};
+         minimum_in_period<> testBatchIndicator{testPeriod};
+         std::vector<double> testPrices;
+         std::vector<double> testValues;
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            auto const testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            testPrices.push_back(testPrice);
+            testValues.push_back(testIndicator.calc(testIteration, testPrice));
+         }
+         std::vector<double> testBatchValues(testIterationsNumber, std::numeric_limits<double>::signaling_NaN());
+         for (uint32_t testBatchBegin = 0; testBatchBegin < testIterationsNumber; )
+         {
+            auto const testBatchSize = std::min(random_number<uint32_t>(1, testPeriod * 3), testIterationsNumber - testBatchBegin);
+            testBatchIndicator.calc(
+               testBatchBegin,
+               std::span{testPrices}.subspan(testBatchBegin, testBatchSize),
+               std::span{testBatchValues}.subspan(testBatchBegin, testBatchSize)
+            );
+            testBatchBegin += testBatchSize;
+         }
+         ASSERT_EQ(testBatchValues, testValues);
+         for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+         {
+            auto const testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testValue = testIndicator.calc(testIteration, testPrice);
+            ASSERT_EQ(testBatchIndicator.pick(testIteration, testPrice), testValue);
+            ASSERT_EQ(testBatchIndicator.calc(testIteration, testPrice), testValue);
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+
+template<uint32_t test_period>
+void test_fixed_minimum_in_period_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testIterationsNumber{test_period * 10,};
+   minimum_in_period<test_period> testIndicator{};
+   minimum_in_period<> testRuntimeIndicator{test_period,};
+   ASSERT_EQ(minimum_in_period<test_period>::lookback_period, testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   std::vector<double> testPrices;
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      testPrices.push_back(testPrice);
+      ASSERT_EQ(testIndicator.pick(testIteration, testPrice), testRuntimeIndicator.pick(testIteration, testPrice));
+      ASSERT_EQ(testIndicator.calc(testIteration, testPrice), testRuntimeIndicator.calc(testIteration, testPrice));
+   }
+   testIndicator.reset();
+   testRuntimeIndicator.reset();
+   std::vector<double> testValues(testIterationsNumber, std::numeric_limits<double>::signaling_NaN());
+   std::vector<double> testRuntimeValues(testIterationsNumber, std::numeric_limits<double>::signaling_NaN());
+   for (uint32_t testBatchBegin{0,}; testBatchBegin < testIterationsNumber; )
+   {
+      auto const testBatchSize{std::min(fixture.random_number<uint32_t>(1, test_period * 3), testIterationsNumber - testBatchBegin),};
+      auto const testBatchPrices{std::span{testPrices}.subspan(testBatchBegin, testBatchSize),};
+      testIndicator.calc(testBatchBegin, testBatchPrices, std::span{testValues}.subspan(testBatchBegin, testBatchSize));
+      testRuntimeIndicator.calc(testBatchBegin, testBatchPrices, std::span{testRuntimeValues}.subspan(testBatchBegin, testBatchSize));
+      testBatchBegin += testBatchSize;
+   }
+   ASSERT_EQ(testValues, testRuntimeValues);
+   for (auto testIteration{testIterationsNumber,}; testIteration < (testIterationsNumber + test_period * 2); ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      ASSERT_EQ(testIndicator.pick(testIteration, testPrice), testRuntimeIndicator.pick(testIteration, testPrice));
+      ASSERT_EQ(testIndicator.calc(testIteration, testPrice), testRuntimeIndicator.calc(testIteration, testPrice));
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_minimum_in_period(TeAn &fixture, decimal const testPriceStep)
+{
+   test_fixed_minimum_in_period_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_minimum_in_period<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, MinimumInPeriodFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_minimum_in_period<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_minimum_in_period<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, MinimumInPeriodAmend)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         minimum_in_period<> testIndicator{testPeriod};
+         minimum_in_period<> testExpectedIndicator{testPeriod};
+         for (uint32_t testIteration = 0; testIteration < (testIndicator.lookback_period() + testPeriod * 10); ++testIteration)
+         {
+            /// Narrow prices make amends both beyond and within the committed extreme, ties included
+            std::ignore = testIndicator.calc(testIteration, testPriceStepValue * random_number<int64_t>(100, 110));
+            auto testPrice = testPriceStepValue * random_number<int64_t>(100, 110);
+            auto testValue = testIndicator.amend(testIteration, testPrice);
+            for (auto testAmendsNumber = random_number<uint32_t>(0, 3); 0 < testAmendsNumber; --testAmendsNumber)
+            {
+               testPrice = testPriceStepValue * random_number<int64_t>(100, 110);
+               testValue = testIndicator.amend(testIteration, testPrice);
+            }
+            ASSERT_EQ(testExpectedIndicator.calc(testIteration, testPrice), testValue);
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_minimum_in_period_lookahead_step(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   for (uint32_t testIteration = 0; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      /// Every hypothetical continuation must match a copy that commits the same values, and leave the indicator intact
+      auto testLookahead = testIndicator.lookahead();
+      indicator testExpectedIndicator{testIndicator};
+      auto const testLookaheadsNumber = fixture.random_number<uint32_t>(1, testPeriod);
+      for (uint32_t testLookaheadIndex = 0; testLookaheadIndex < testLookaheadsNumber; ++testLookaheadIndex)
+      {
+         auto const testPrice = testPriceStepValue * fixture.random_number<int64_t>(100, 110);
+         ASSERT_EQ(testExpectedIndicator.calc(testIteration + testLookaheadIndex, testPrice), testLookahead.calc(testIteration + testLookaheadIndex, testPrice));
+      }
+      std::ignore = testIndicator.calc(testIteration, testPriceStepValue * fixture.random_number<int64_t>(100, 110));
+      if (true == fixture.random_bool())
+      {
+         /// The amended input of the latest calc is still outside the deque
+         std::ignore = testIndicator.amend(testIteration, testPriceStepValue * fixture.random_number<int64_t>(100, 110));
+      }
+   }
+}
+
+TEST_F(TeAn, MinimumInPeriodLookahead)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   constexpr uint32_t testFixedPeriod = 14;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         minimum_in_period<> testIndicator{testPeriod};
+         ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_lookahead_step(*this, testIndicator, testPeriod, testPriceStepValue));
+      }
+      minimum_in_period<static_cast<uint32_t>(-1), 16> testInlineIndicator{testFixedPeriod};
+      ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_lookahead_step(*this, testInlineIndicator, testFixedPeriod, testPriceStepValue));
+      minimum_in_period<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_lookahead_step(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, MinimumInPeriodMemoryResource)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      /// The window and the deque of its minimum candidates are allocated once each, when the indicator is built, calcs never allocate
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = std::make_unique<minimum_in_period<>>(testPeriod, std::addressof(testMemoryResource));
+      ASSERT_EQ(2u, testMemoryResource.allocations());
+      ASSERT_EQ(testPeriod * (sizeof(double) + sizeof(uint32_t)), testMemoryResource.allocated_bytes());
+      minimum_in_period<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testIndicator->calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+      /// Copies take the default memory resource, and the indicator gives back everything it took once destroyed
+      auto const testCopiedIndicator = *testIndicator;
+      ASSERT_EQ(2u, testMemoryResource.allocations());
+      testIndicator.reset();
+      ASSERT_EQ(2u, testMemoryResource.deallocations());
+   }
+}
+
+TEST_F(TeAn, MinimumInPeriodInline)
+{
+   constexpr uint32_t testInlineCapacity = 16;
+   for (uint32_t testPeriod = 2; testPeriod <= (testInlineCapacity * 2); ++testPeriod)
+   {
+      /// Windows up to the inline capacity keep both the values and the deque inside the indicator
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = minimum_in_period<static_cast<uint32_t>(-1), testInlineCapacity>{testPeriod, std::addressof(testMemoryResource)};
+      ASSERT_EQ((testInlineCapacity < testPeriod) ? 2u : 0u, testMemoryResource.allocations());
+      minimum_in_period<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testIndicator.calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+      /// A copy has to rebind the window to its own inline storage
+      auto testCopiedIndicator = testIndicator;
+      auto const *const testObject = reinterpret_cast<std::byte const *>(std::addressof(testCopiedIndicator));
+      auto const *const testRing = reinterpret_cast<std::byte const *>(testCopiedIndicator.window().older.data());
+      ASSERT_EQ(false == (testInlineCapacity < testPeriod), (testObject <= testRing) && ((testObject + sizeof(testCopiedIndicator)) > testRing));
+      for (uint32_t testIteration = (testPeriod * 10); testIteration < (testPeriod * 12); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testCopiedIndicator.calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+   }
+}
+
+template<typename indicator>
+void test_minimum_in_period_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevPrice = 0.0;
+   uint64_t testSequenceNumber = 0;
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward and zero volume bars repeat the latest value
+         auto const testGap = fixture.random_number<uint64_t>(1, testPeriod * 3);
+         testIndicator.skip(testSequenceNumber, testGap, fixture.random_bool() ? gap_fill::carry_forward : gap_fill::zero_volume);
+         for (uint64_t testGapIndex = 0; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrice);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      testPrevPrice = static_cast<double>(fixture.random_number<int64_t>(100, 110));
+      ASSERT_EQ(testExpectedIndicator.calc(testSequenceNumber, testPrevPrice), testIndicator.calc(testSequenceNumber, testPrevPrice));
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, MinimumInPeriodSkip)
+{
+   constexpr uint32_t testFixedPeriod = 20;
+   for (uint32_t testPeriod = 2; testPeriod <= 50; ++testPeriod)
+   {
+      minimum_in_period<> testIndicator{testPeriod};
+      minimum_in_period<> testExpectedIndicator{testPeriod};
+      ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   minimum_in_period<testFixedPeriod> testFixedIndicator{};
+   minimum_in_period<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator, typename restored_indicator, typename other_period_indicator>
+void test_minimum_in_period_state(TeAn &fixture, indicator &testIndicator, restored_indicator &testRestoredIndicator, other_period_indicator &testOtherPeriodIndicator, uint32_t const testPeriod)
+{
+   /// The ring cursor and the deque move with every calc, so the state may be saved at any phase of the window
+   auto const testIterationsNumber = fixture.random_number<uint32_t>(1, testPeriod * 3);
+   for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+   {
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+   }
+   std::vector<std::byte> testState;
+   state_writer testWriter{testState};
+   testIndicator.save(testIterationsNumber - 1, testWriter);
+   /// States of another format version, of another sequence number or of another period are rejected
+   auto testOtherVersionState = testState;
+   testOtherVersionState.front() ^= std::byte{0xff};
+   state_reader testOtherVersionReader{testOtherVersionState};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber - 1, testOtherVersionReader));
+   ASSERT_FALSE(testOtherVersionReader.good());
+   state_reader testOtherSequenceNumberReader{testState};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber, testOtherSequenceNumberReader));
+   state_reader testOtherPeriodReader{testState};
+   ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber - 1, testOtherPeriodReader));
+   /// A failed load may leave the indicator partially restored, so it is reset before the state is loaded for good
+   testRestoredIndicator.reset();
+   state_reader testReader{testState};
+   ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+   ASSERT_EQ(testState.size(), testReader.position());
+   for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto const testValue = testIndicator.calc(testIteration, testPrice);
+      auto const testRestoredValue = testRestoredIndicator.calc(testIteration, testPrice);
+      ASSERT_EQ(std::isnan(testValue), std::isnan(testRestoredValue));
+      if (false == std::isnan(testValue))
+      {
+         ASSERT_EQ(testValue, testRestoredValue);
+      }
+   }
+}
+
+TEST_F(TeAn, MinimumInPeriodState)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 50;
+   constexpr uint32_t testFixedPeriod = 14;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      minimum_in_period<> testIndicator{testPeriod};
+      minimum_in_period<> testRestoredIndicator{testPeriod};
+      minimum_in_period<> testOtherPeriodIndicator{testPeriod + 1};
+      ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_state(*this, testIndicator, testRestoredIndicator, testOtherPeriodIndicator, testPeriod));
+   }
+   /// Heap, inline, fixed period and foreign memory resource rings share the state layout, loading into them never allocates
+   counting_memory_resource testMemoryResource;
+   minimum_in_period<> testIndicator{testFixedPeriod};
+   minimum_in_period<static_cast<uint32_t>(-1), 16> testInlineIndicator{testFixedPeriod};
+   minimum_in_period<> testArenaIndicator{testFixedPeriod, std::addressof(testMemoryResource)};
+   minimum_in_period<testFixedPeriod> testFixedIndicator{};
+   minimum_in_period<> testOtherPeriodIndicator{testFixedPeriod + 1};
+   auto const testAllocationsNumber = testMemoryResource.allocations();
+   ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_state(*this, testIndicator, testInlineIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_state(*this, testIndicator, testArenaIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_state(*this, testIndicator, testFixedIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testFixedIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_minimum_in_period_state(*this, testFixedIndicator, testIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   ASSERT_EQ(testAllocationsNumber, testMemoryResource.allocations());
+}
+
 }
@@ -26,18 +26,21 @@
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 #include "tean/relative_strength_index.hpp" /// for the test target
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <indicators.h> /// for TI_OKAY, ti_rsi, ti_rsi_start
 #include <ta_func.h> /// for TA_FUNC_UNST_RSI, TA_RSI, TA_RSI_Lookback, TA_SetUnstablePeriod, TA_SUCCESS
 
 #include <algorithm> /// for std::fill
-#include <cmath> /// for std::isnan
+#include <cmath> /// for std::isfinite, std::isnan
+#include <cstddef> /// for size_t
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -54,7 +57,7 @@ TEST_F(TeAn, RelativeStrengthIndex)
       for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
       {
          auto const testIterationsNumber = testPeriod * 10;
-         relative_strength_index testIndicator{testPeriod};
+         relative_strength_index<> testIndicator{testPeriod};
          ASSERT_EQ(testPeriod, testIndicator.period());
          auto testPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          for (uint32_t testIteration = 0; testIteration < testIndicator.lookback_period(); ++testIteration)
@@ -132,4 +135,238 @@ TEST_F(TeAn, RelativeStrengthIndex)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+
+template<uint32_t test_period>
+void test_fixed_relative_strength_index_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testIterationsNumber{test_period * 10,};
+   relative_strength_index<test_period> testIndicator{};
+   relative_strength_index<> testRuntimeIndicator{test_period,};
+   ASSERT_EQ(relative_strength_index<test_period>::lookback_period, testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testPickValue{testIndicator.pick(testIteration, testPrice),};
+      auto const testCalcValue{testIndicator.calc(testIteration, testPrice),};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testPrice),};
+      if (relative_strength_index<test_period>::lookback_period > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickValue));
+         ASSERT_TRUE(std::isnan(testCalcValue));
+         ASSERT_TRUE(std::isnan(testRuntimeValue));
+         continue;
+      }
+      ASSERT_NEAR(testPickValue, testRuntimeValue, 1e-9);
+      ASSERT_NEAR(testCalcValue, testRuntimeValue, 1e-9);
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_relative_strength_index(TeAn &fixture, decimal const testPriceStep)
+{
+   test_fixed_relative_strength_index_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_relative_strength_index<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, RelativeStrengthIndexFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_relative_strength_index<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_relative_strength_index<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_relative_strength_index_pick_many(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      /// Every candidate must see the same committed state as a single pick
+      std::vector<double> testCandidates(fixture.random_number<size_t>(1, 100));
+      for (auto &testCandidate : testCandidates)
+      {
+         testCandidate = testPriceStepValue * fixture.random_number<int64_t>(100, 110);
+      }
+      std::vector<double> testValues(testCandidates.size());
+      testIndicator.pick_many(testIteration, testCandidates, testValues);
+      for (size_t testCandidateIndex{0,}; testCandidateIndex < testCandidates.size(); ++testCandidateIndex)
+      {
+         auto const testExpectedValue{testIndicator.pick(testIteration, testCandidates[testCandidateIndex]),};
+         ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValues[testCandidateIndex]));
+         if (false == std::isnan(testExpectedValue))
+         {
+            ASSERT_EQ(testExpectedValue, testValues[testCandidateIndex]);
+         }
+      }
+      std::ignore = testIndicator.calc(testIteration, testPriceStepValue * fixture.random_number<int64_t>(100, 110));
+   }
+}
+
+TEST_F(TeAn, RelativeStrengthIndexPickMany)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      double const testPriceStepValue{testPriceStep,};
+      for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+      {
+         relative_strength_index<> testIndicator{testPeriod,};
+         ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_pick_many(*this, testIndicator, testPeriod, testPriceStepValue));
+      }
+      relative_strength_index<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_pick_many(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_relative_strength_index_solve(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      auto const testTarget{fixture.random_number<double>(1.0, 99.0),};
+      auto const testValue{testIndicator.solve(testIteration, testTarget),};
+      if (testPeriod > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testValue));
+      }
+      else
+      {
+         ASSERT_TRUE(std::isfinite(testValue));
+         ASSERT_NEAR(testTarget, testIndicator.pick(testIteration, testValue), 1e-6);
+      }
+      /// Prices alternate around the base, so every move is either a gain or a loss and both sides stay non-zero
+      auto const testOffset{fixture.random_number<int64_t>(1, 10),};
+      std::ignore = testIndicator.calc(testIteration, testPriceStepValue * (100 + ((0 == (testIteration % 2)) ? testOffset : -testOffset)));
+   }
+}
+
+TEST_F(TeAn, RelativeStrengthIndexSolve)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      double const testPriceStepValue{testPriceStep,};
+      for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+      {
+         relative_strength_index<> testIndicator{testPeriod,};
+         ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_solve(*this, testIndicator, testPeriod, testPriceStepValue));
+      }
+      relative_strength_index<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_solve(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_relative_strength_index_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   auto testPrevValue{0.0,};
+   uint64_t testSequenceNumber{0,};
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Every fill leaves the price where it was
+         auto const testGap{fixture.random_number<uint64_t>(1, testPeriod * 3),};
+         testIndicator.skip(testSequenceNumber, testGap, static_cast<gap_fill>(fixture.random_number<int>(0, 2)));
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevValue);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      testPrevValue = testPriceStepValue * fixture.random_number<int64_t>(100, 110);
+      auto const testExpectedValue{testExpectedIndicator.calc(testSequenceNumber, testPrevValue),};
+      auto const testValue{testIndicator.calc(testSequenceNumber, testPrevValue),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, 1e-9);
+      }
+      if (0 == fixture.random_number<uint32_t>(0, 2))
+      {
+         /// A skip leaves nothing to amend, yet the calc that follows it can be amended
+         testPrevValue = testPriceStepValue * fixture.random_number<int64_t>(100, 110);
+         auto const testExpectedAmendedValue{testExpectedIndicator.amend(testSequenceNumber, testPrevValue),};
+         auto const testAmendedValue{testIndicator.amend(testSequenceNumber, testPrevValue),};
+         ASSERT_EQ(std::isnan(testExpectedAmendedValue), std::isnan(testAmendedValue));
+         if (false == std::isnan(testExpectedAmendedValue))
+         {
+            ASSERT_NEAR(testExpectedAmendedValue, testAmendedValue, 1e-9);
+         }
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, RelativeStrengthIndexSkip)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      double const testPriceStepValue{testPriceStep,};
+      for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+      {
+         relative_strength_index<> testIndicator{testPeriod,};
+         relative_strength_index<> testExpectedIndicator{testPeriod,};
+         ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_skip(*this, testIndicator, testExpectedIndicator, testPeriod, testPriceStepValue));
+      }
+      relative_strength_index<testFixedPeriod> testFixedIndicator{};
+      relative_strength_index<testFixedPeriod> testExpectedFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_relative_strength_index_amend(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// An amended calc must match a calc with the final input, the averages roll back to the preceding bar before each amend
+      std::ignore = testIndicator.calc(testIteration, testPriceStepValue * fixture.random_number<int64_t>(100, 110));
+      auto testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 110),};
+      auto testValue{testIndicator.amend(testIteration, testPrice),};
+      for (auto testAmendsNumber{fixture.random_number<uint32_t>(0, 3),}; 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testPrice = testPriceStepValue * fixture.random_number<int64_t>(100, 110);
+         testValue = testIndicator.amend(testIteration, testPrice);
+      }
+      auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, 1e-9);
+      }
+   }
+}
+
+TEST_F(TeAn, RelativeStrengthIndexAmend)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      double const testPriceStepValue{testPriceStep,};
+      for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+      {
+         relative_strength_index<> testIndicator{testPeriod,};
+         relative_strength_index<> testExpectedIndicator{testPeriod,};
+         ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_amend(*this, testIndicator, testExpectedIndicator, testPeriod, testPriceStepValue));
+      }
+      relative_strength_index<testFixedPeriod> testFixedIndicator{};
+      relative_strength_index<testFixedPeriod> testExpectedFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_relative_strength_index_amend(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
 }
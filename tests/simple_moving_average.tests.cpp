@@ -26,11 +26,12 @@
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 #include "tean/simple_moving_average.hpp" /// for the test target
 #include "tean/sum_over_period.hpp" /// for tean::sum_over_period
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <indicators.h> /// for TI_OKAY, ti_sma, ti_sma_start
 #include <ta_func.h> /// for TA_SMA, TA_SMA_Lookback, TA_SUCCESS
 
@@ -39,6 +40,7 @@
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -55,12 +57,12 @@ TEST_F(TeAn, SimpleMovingAverage)
       for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
       {
          auto const testIterationsNumber = testPeriod * 10;
-         simple_moving_average testIndicator{testPeriod};
+         simple_moving_average<> testIndicator{testPeriod};
          ASSERT_EQ(testPeriod, testIndicator.period());
          auto testPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          auto testValues = std::make_unique<testing::Matcher<double>[]>(testIterationsNumber);
          {
-            tean::sum_over_period testAdditionalIndicator{testPeriod};
+            tean::sum_over_period<> testAdditionalIndicator{testPeriod};
             for (uint32_t testIteration = 0; testIteration < testIndicator.lookback_period(); ++testIteration)
             {
                auto const testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
@@ -149,4 +151,135 @@ TEST_F(TeAn, SimpleMovingAverage)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+
+template<uint32_t test_period>
+void test_fixed_simple_moving_average_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testIterationsNumber{test_period * 10,};
+   simple_moving_average<test_period> testIndicator{};
+   simple_moving_average<> testRuntimeIndicator{test_period,};
+   ASSERT_EQ(simple_moving_average<test_period>::lookback_period, testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      double testPickAdditionalValue{0,};
+      auto const testPickValue{testIndicator.pick(testIteration, testPrice, testPickAdditionalValue),};
+      double testCalcAdditionalValue{0,};
+      auto const testCalcValue{testIndicator.calc(testIteration, testPrice, testCalcAdditionalValue),};
+      double testRuntimeAdditionalValue{0,};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testPrice, testRuntimeAdditionalValue),};
+      ASSERT_EQ(testPickAdditionalValue, testRuntimeAdditionalValue);
+      ASSERT_EQ(testCalcAdditionalValue, testRuntimeAdditionalValue);
+      if (simple_moving_average<test_period>::lookback_period > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickValue));
+         ASSERT_TRUE(std::isnan(testCalcValue));
+         ASSERT_TRUE(std::isnan(testRuntimeValue));
+         continue;
+      }
+      ASSERT_DOUBLE_EQ(testPickValue, testRuntimeValue);
+      ASSERT_DOUBLE_EQ(testCalcValue, testRuntimeValue);
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_simple_moving_average(TeAn &fixture, decimal const testPriceStep)
+{
+   test_fixed_simple_moving_average_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_simple_moving_average<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, SimpleMovingAverageFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_simple_moving_average<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_simple_moving_average<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_simple_moving_average_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevValue{0.0,};
+   uint64_t testSequenceNumber{0,};
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward and zero volume bars repeat the latest value
+         auto const testGap{fixture.random_number<uint64_t>(1, testPeriod * 3),};
+         testIndicator.skip(testSequenceNumber, testGap, fixture.random_bool() ? gap_fill::carry_forward : gap_fill::zero_volume);
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevValue);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      testPrevValue = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto const testExpectedValue{testExpectedIndicator.calc(testSequenceNumber, testPrevValue),};
+      auto const testValue{testIndicator.calc(testSequenceNumber, testPrevValue),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_NEAR(testExpectedValue, testValue, testExpectedValue * 1e-12);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, SimpleMovingAverageSkip)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      simple_moving_average<> testIndicator{testPeriod,};
+      simple_moving_average<> testExpectedIndicator{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_simple_moving_average_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   simple_moving_average<testFixedPeriod> testFixedIndicator{};
+   simple_moving_average<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_simple_moving_average_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator>
+void test_simple_moving_average_amend(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// An amended calc must match a calc with the final input
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+      auto testValue{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      auto testAverage{testIndicator.amend(testIteration, testValue),};
+      for (auto testAmendsNumber{fixture.random_number<uint32_t>(0, 3),}; 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testValue = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+         testAverage = testIndicator.amend(testIteration, testValue);
+      }
+      auto const testExpectedAverage{testExpectedIndicator.calc(testIteration, testValue),};
+      ASSERT_EQ(std::isnan(testExpectedAverage), std::isnan(testAverage));
+      if (false == std::isnan(testExpectedAverage))
+      {
+         ASSERT_NEAR(testExpectedAverage, testAverage, testExpectedAverage * 1e-12);
+      }
+   }
+}
+
+TEST_F(TeAn, SimpleMovingAverageAmend)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      simple_moving_average<> testIndicator{testPeriod,};
+      simple_moving_average<> testExpectedIndicator{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_simple_moving_average_amend(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   simple_moving_average<testFixedPeriod> testFixedIndicator{};
+   simple_moving_average<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_simple_moving_average_amend(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
 }
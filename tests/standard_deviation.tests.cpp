@@ -26,6 +26,7 @@
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
 #include "tean/simple_moving_average.hpp" /// for tean::simple_moving_average
 #include "tean/standard_deviation.hpp" /// for the test target
 
@@ -39,6 +40,7 @@
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -56,7 +58,7 @@ void test_standard_deviation_step(TeAn &fixture, decimal const testPriceStep)
       auto const testPricePrecision{inverted_power_of_ten[testPriceStep.scale / 3] * inverted_power_of_ten[3],};
       double const testPriceStepValue{testPriceStep,};
       {
-         tean::simple_moving_average testAdditionalIndicator{test_period,};
+         tean::simple_moving_average<test_period> testAdditionalIndicator{};
          for (uint32_t testIteration{0,}; testIteration < testLookbackPeriod; ++testIteration)
          {
             auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(power_of_ten[testPriceStep.scale], power_of_ten[testPriceStep.scale + 2]),};
@@ -200,4 +202,48 @@ TEST_F(TeAn, StandardDeviation)
    ASSERT_NO_FATAL_FAILURE(test_standard_deviation<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+template<typename indicator>
+void test_standard_deviation_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevPrice{0.0,};
+   uint64_t testSequenceNumber{0,};
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward and zero volume bars repeat the latest value
+         auto const testGap{fixture.random_number<uint64_t>(1, testPeriod * 3),};
+         testIndicator.skip(testSequenceNumber, testGap, fixture.random_bool() ? gap_fill::carry_forward : gap_fill::zero_volume);
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrice);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      testPrevPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto const testExpectedValue{testExpectedIndicator.calc(testSequenceNumber, testPrevPrice),};
+      auto const testValue{testIndicator.calc(testSequenceNumber, testPrevPrice),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_EQ(testExpectedValue, testValue);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, StandardDeviationSkip)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      standard_deviation<> testIndicator{testPeriod,};
+      standard_deviation<> testExpectedIndicator{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_standard_deviation_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   standard_deviation<testFixedPeriod> testFixedIndicator{};
+   standard_deviation<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_standard_deviation_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
 }
@@ -24,20 +24,26 @@
 */
 
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "memory_resource.tests.hpp" /// for tean::tests::counting_memory_resource
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 #include "tean/sum_over_period.hpp" /// for the test target
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_GE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <indicators.h> /// for TI_OKAY, ti_sum, ti_sum_start
 #include <ta_func.h> /// for TA_SUCCESS, TA_SUM, TA_SUM_Lookback
 
-#include <algorithm> /// for std::fill
-#include <cmath> /// for std::isnan
+#include <algorithm> /// for std::fill, std::ranges::equal
+#include <cmath> /// for std::abs, std::isnan
+#include <cstddef> /// for size_t, std::byte
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <span> /// for std::span
+#include <tuple> /// for std::ignore
+#include <utility> /// for std::move
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -54,7 +60,7 @@ TEST_F(TeAn, SumOverPeriod)
       for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
       {
          auto const testIterationsNumber = testPeriod * 10;
-         sum_over_period testIndicator{testPeriod};
+         sum_over_period<> testIndicator{testPeriod};
          ASSERT_EQ(testPeriod, testIndicator.period());
          auto testPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          {
@@ -143,4 +149,385 @@ TEST_F(TeAn, SumOverPeriod)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+TEST_F(TeAn, SumOverPeriodCompensated)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   constexpr auto testRelativePrecision = inverted_power_of_ten[14];
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 100;
+         auto const testResummationPeriod = random_number<uint32_t>(1, testPeriod * 4);
+         sum_over_period<> testIndicator{testPeriod, testResummationPeriod};
+         ASSERT_EQ(testResummationPeriod, testIndicator.resummation_period());
+         auto testPrices = std::make_unique<double[]>(testIterationsNumber);
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            /// Occasional spikes make plain add-then-subtract lose the low order bits of the window sum
+            auto const testPrice = (0 == random_number<uint32_t>(0, testPeriod))
+               ? testPriceStepValue * random_number<int64_t>(100, 1000) * power_of_ten[9]
+               : testPriceStepValue * random_number<int64_t>(100, 1000)
+            ;
+            testPrices[testIteration] = testPrice;
+            long double testSum = 0;
+            for (auto testWindowIndex = (testIteration < testPeriod) ? 0 : (testIteration - testIndicator.lookback_period()); testWindowIndex <= testIteration; ++testWindowIndex)
+            {
+               testSum += testPrices[testWindowIndex];
+            }
+            auto const testValue = static_cast<double>(testSum);
+            auto const testPickValue = testIndicator.pick(testIteration, testPrice);
+            ASSERT_THAT(testPickValue, testing::DoubleNear(testValue, std::abs(testValue) * testRelativePrecision));
+            auto const testCalcValue = testIndicator.calc(testIteration, testPrice);
+            ASSERT_THAT(testCalcValue, testing::DoubleNear(testValue, std::abs(testValue) * testRelativePrecision));
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+
+template<uint32_t test_period>
+void test_fixed_sum_over_period_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testIterationsNumber{test_period * 10,};
+   auto const testResummationPeriod{fixture.random_number<uint32_t>(0, test_period * 4),};
+   sum_over_period<test_period> testIndicator{testResummationPeriod,};
+   sum_over_period<> testRuntimeIndicator{test_period, testResummationPeriod,};
+   ASSERT_EQ(sum_over_period<test_period>::lookback_period, testRuntimeIndicator.lookback_period());
+   ASSERT_EQ(testResummationPeriod, testIndicator.resummation_period());
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      ASSERT_EQ(testIndicator.pick(testIteration, testPrice), testRuntimeIndicator.pick(testIteration, testPrice));
+      ASSERT_EQ(testIndicator.calc(testIteration, testPrice), testRuntimeIndicator.calc(testIteration, testPrice));
+   }
+   testIndicator.reset();
+   testRuntimeIndicator.reset();
+   for (uint32_t testIteration{0,}; testIteration < test_period; ++testIteration)
+   {
+      auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      ASSERT_EQ(testIndicator.calc(testIteration, testPrice), testRuntimeIndicator.calc(testIteration, testPrice));
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_sum_over_period(TeAn &fixture, decimal const testPriceStep)
+{
+   test_fixed_sum_over_period_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_sum_over_period<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, SumOverPeriodFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_sum_over_period<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_sum_over_period<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+
+template<typename indicator>
+void test_sum_over_period_window_step(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, uint32_t const testWindowSize)
+{
+   std::vector<double> testPrices;
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 10); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      testPrices.push_back(testPrice);
+      [[maybe_unused]] auto const testValue{testIndicator.calc(testIteration, testPrice),};
+      if (testWindowSize > testPrices.size())
+      {
+         continue;
+      }
+      auto const testWindow{testIndicator.window(),};
+      ASSERT_EQ(testWindowSize, testWindow.size());
+      ASSERT_GE(testWindow.older.size(), 1);
+      std::vector<double> testWindowValues{testWindow.older.begin(), testWindow.older.end(),};
+      testWindowValues.insert(testWindowValues.end(), testWindow.newer.begin(), testWindow.newer.end());
+      ASSERT_TRUE(std::ranges::equal(testWindowValues, std::span{testPrices}.last(testWindowSize)));
+      for (uint32_t testIndex{0,}; testIndex < testWindowSize; ++testIndex)
+      {
+         ASSERT_EQ(testWindowValues[testIndex], testWindow[testIndex]);
+      }
+   }
+}
+
+template<uint32_t test_period>
+void test_sum_over_period_window(TeAn &fixture)
+{
+   {
+      sum_over_period<test_period> testIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_sum_over_period_window_step(fixture, testIndicator, test_period, test_period));
+   }
+   {
+      sum_over_period<> testIndicator{test_period,};
+      ASSERT_NO_FATAL_FAILURE(test_sum_over_period_window_step(fixture, testIndicator, test_period, test_period));
+   }
+   if constexpr (2 < test_period)
+   {
+      test_sum_over_period_window<test_period - 1>(fixture);
+   }
+}
+
+TEST_F(TeAn, SumOverPeriodWindow)
+{
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_window<50>(*this));
+}
+
+TEST_F(TeAn, SumOverPeriodMemoryResource)
+{
+   constexpr uint32_t testMinPeriod{2,};
+   constexpr uint32_t testMaxPeriod{100,};
+   for (auto testPeriod{testMinPeriod,}; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      /// The window is the only allocation, made when the indicator is built, calcs never allocate
+      counting_memory_resource testMemoryResource;
+      auto testIndicator{std::make_unique<sum_over_period<>>(testPeriod, 0, std::addressof(testMemoryResource)),};
+      ASSERT_EQ(1u, testMemoryResource.allocations());
+      ASSERT_EQ(testPeriod * sizeof(double), testMemoryResource.allocated_bytes());
+      sum_over_period<> testExpectedIndicator{testPeriod,};
+      for (uint32_t testIteration{0,}; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice{static_cast<double>(random_number<int64_t>(100, 1000)),};
+         auto const testValue{testIndicator->calc(testIteration, testPrice),};
+         auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice),};
+         ASSERT_EQ(testExpectedValue, testValue);
+      }
+      /// Copies take the default memory resource, and the indicator gives back everything it took once destroyed
+      auto const testCopiedIndicator{*testIndicator,};
+      ASSERT_EQ(1u, testMemoryResource.allocations());
+      testIndicator.reset();
+      ASSERT_EQ(1u, testMemoryResource.deallocations());
+   }
+}
+
+TEST_F(TeAn, SumOverPeriodInline)
+{
+   constexpr uint32_t testInlineCapacity{16,};
+   for (uint32_t testPeriod{2,}; testPeriod <= (testInlineCapacity * 2); ++testPeriod)
+   {
+      /// Windows up to the inline capacity never reach the memory resource
+      counting_memory_resource testMemoryResource;
+      auto testIndicator{sum_over_period<static_cast<uint32_t>(-1), testInlineCapacity>{testPeriod, 0, std::addressof(testMemoryResource)},};
+      ASSERT_EQ((testInlineCapacity < testPeriod) ? 1u : 0u, testMemoryResource.allocations());
+      sum_over_period<> testExpectedIndicator{testPeriod,};
+      for (uint32_t testIteration{0,}; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice{static_cast<double>(random_number<int64_t>(100, 1000)),};
+         auto const testValue{testIndicator.calc(testIteration, testPrice),};
+         auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice),};
+         ASSERT_EQ(testExpectedValue, testValue);
+      }
+      /// A copy has to rebind the window to its own inline storage
+      auto testCopiedIndicator{testIndicator,};
+      auto const *const testObject{reinterpret_cast<std::byte const *>(std::addressof(testCopiedIndicator)),};
+      auto const *const testRing{reinterpret_cast<std::byte const *>(testCopiedIndicator.window().older.data()),};
+      ASSERT_EQ(false == (testInlineCapacity < testPeriod), (testObject <= testRing) && ((testObject + sizeof(testCopiedIndicator)) > testRing));
+      for (uint32_t testIteration{testPeriod * 10,}; testIteration < (testPeriod * 12); ++testIteration)
+      {
+         auto const testPrice{static_cast<double>(random_number<int64_t>(100, 1000)),};
+         auto const testValue{testCopiedIndicator.calc(testIteration, testPrice),};
+         auto const testExpectedValue{testExpectedIndicator.calc(testIteration, testPrice),};
+         ASSERT_EQ(testExpectedValue, testValue);
+      }
+   }
+}
+
+template<typename indicator>
+void test_sum_over_period_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   uint64_t testSequenceNumber{0,};
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      auto const testValue{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      if (0 == fixture.random_number<uint32_t>(0, 4))
+      {
+         /// Gaps shorter and longer than the period must match consuming the same value for every missing sequence number
+         auto const testGap{fixture.random_number<uint64_t>(1, testPeriod * 3),};
+         testIndicator.skip(testSequenceNumber, testGap, testValue);
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testValue);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      auto const testExpectedValue{testExpectedIndicator.calc(testSequenceNumber, testValue),};
+      ASSERT_NEAR(testExpectedValue, testIndicator.calc(testSequenceNumber, testValue), testExpectedValue * 1e-12);
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, SumOverPeriodSkip)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testResummationPeriod{random_number<uint32_t>(0, testPeriod * 2),};
+      sum_over_period<> testIndicator{testPeriod, testResummationPeriod,};
+      sum_over_period<> testExpectedIndicator{testPeriod, testResummationPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_sum_over_period_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   sum_over_period<testFixedPeriod> testFixedIndicator{};
+   sum_over_period<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+   sum_over_period<testFixedPeriod> testCompensatedIndicator{testFixedPeriod,};
+   sum_over_period<testFixedPeriod> testExpectedCompensatedIndicator{testFixedPeriod,};
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_skip(*this, testCompensatedIndicator, testExpectedCompensatedIndicator, testFixedPeriod));
+}
+
+TEST_F(TeAn, SumOverPeriodMoveAcrossMemoryResources)
+{
+   auto const testPeriod{random_number<uint32_t>(2, 100),};
+   counting_memory_resource testSourceMemoryResource;
+   counting_memory_resource testTargetMemoryResource;
+   auto testExpectedIndicator = sum_over_period<>{testPeriod,};
+   auto testSourceIndicator = sum_over_period<>{testPeriod, 0, std::addressof(testSourceMemoryResource),};
+   auto testIndicator = sum_over_period<>{testPeriod, 0, std::addressof(testTargetMemoryResource),};
+   ASSERT_EQ(1u, testTargetMemoryResource.allocations());
+   uint32_t testIteration{0,};
+   for (; testIteration < (testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(random_number<int64_t>(100, 1000)),};
+      ASSERT_EQ(testExpectedIndicator.calc(testIteration, testPrice), testSourceIndicator.calc(testIteration, testPrice));
+   }
+   /// The storage of another memory resource cannot be taken over, the values go into the storage the target already owns
+   testIndicator = std::move(testSourceIndicator);
+   ASSERT_EQ(1u, testTargetMemoryResource.allocations());
+   ASSERT_EQ(0u, testTargetMemoryResource.deallocations());
+   ASSERT_EQ(1u, testSourceMemoryResource.allocations());
+   for (; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(random_number<int64_t>(100, 1000)),};
+      ASSERT_EQ(testExpectedIndicator.calc(testIteration, testPrice), testIndicator.calc(testIteration, testPrice));
+   }
+   /// A longer window does not fit, so the target grows its storage from its own memory resource
+   auto testLongerIndicator = sum_over_period<>{testPeriod * 2, 0, std::addressof(testSourceMemoryResource),};
+   testIndicator = std::move(testLongerIndicator);
+   ASSERT_EQ(2u, testTargetMemoryResource.allocations());
+   ASSERT_EQ(1u, testTargetMemoryResource.deallocations());
+   ASSERT_EQ(testPeriod * 2, testIndicator.period());
+   /// Within the same memory resource the storage is handed over without allocating
+   auto testSameResourceIndicator = sum_over_period<>{testPeriod, 0, std::addressof(testTargetMemoryResource),};
+   testIndicator = std::move(testSameResourceIndicator);
+   ASSERT_EQ(3u, testTargetMemoryResource.allocations());
+   ASSERT_EQ(2u, testTargetMemoryResource.deallocations());
+}
+
+template<typename indicator>
+void test_sum_over_period_amend(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 8); ++testIteration)
+   {
+      /// An amended calc must match a calc with the final input, including the calcs that resum the window
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+      auto testValue{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      auto testSum{testIndicator.amend(testIteration, testValue),};
+      for (auto testAmendsNumber{fixture.random_number<uint32_t>(0, 3),}; 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testValue = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+         testSum = testIndicator.amend(testIteration, testValue);
+      }
+      auto const testExpectedSum{testExpectedIndicator.calc(testIteration, testValue),};
+      ASSERT_NEAR(testExpectedSum, testSum, testExpectedSum * 1e-12);
+   }
+}
+
+TEST_F(TeAn, SumOverPeriodAmend)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testResummationPeriod{random_number<uint32_t>(0, testPeriod * 2),};
+      sum_over_period<> testIndicator{testPeriod, testResummationPeriod,};
+      sum_over_period<> testExpectedIndicator{testPeriod, testResummationPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_sum_over_period_amend(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   sum_over_period<testFixedPeriod> testFixedIndicator{};
+   sum_over_period<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_amend(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+   sum_over_period<testFixedPeriod> testCompensatedIndicator{testFixedPeriod,};
+   sum_over_period<testFixedPeriod> testExpectedCompensatedIndicator{testFixedPeriod,};
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_amend(*this, testCompensatedIndicator, testExpectedCompensatedIndicator, testFixedPeriod));
+}
+
+template<typename indicator, typename restored_indicator, typename other_period_indicator>
+void test_sum_over_period_state(TeAn &fixture, indicator &testIndicator, restored_indicator &testRestoredIndicator, other_period_indicator &testOtherPeriodIndicator, uint32_t const testPeriod)
+{
+   /// The ring cursor and the resummation countdown move with every calc, so the state may be saved at any phase of the window
+   auto const testIterationsNumber{fixture.random_number<uint32_t>(1, testPeriod * 3),};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+   }
+   std::vector<std::byte> testState;
+   state_writer testWriter{testState,};
+   testIndicator.save(testIterationsNumber - 1, testWriter);
+   /// States of another format version, of another sequence number or of another period are rejected
+   auto testOtherVersionState{testState,};
+   testOtherVersionState.front() ^= std::byte{0xff};
+   state_reader testOtherVersionReader{testOtherVersionState,};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber - 1, testOtherVersionReader));
+   ASSERT_FALSE(testOtherVersionReader.good());
+   state_reader testOtherSequenceNumberReader{testState,};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber, testOtherSequenceNumberReader));
+   state_reader testOtherPeriodReader{testState,};
+   ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber - 1, testOtherPeriodReader));
+   /// A failed load may leave the indicator partially restored, so it is reset before the state is loaded for good
+   testRestoredIndicator.reset();
+   state_reader testReader{testState,};
+   ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+   ASSERT_EQ(testState.size(), testReader.position());
+   for (auto testIteration{testIterationsNumber,}; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      auto const testValue{testIndicator.calc(testIteration, testPrice),};
+      auto const testRestoredValue{testRestoredIndicator.calc(testIteration, testPrice),};
+      ASSERT_EQ(std::isnan(testValue), std::isnan(testRestoredValue));
+      if (false == std::isnan(testValue))
+      {
+         ASSERT_EQ(testValue, testRestoredValue);
+      }
+   }
+}
+
+TEST_F(TeAn, SumOverPeriodState)
+{
+   constexpr uint32_t testMinPeriod{2,};
+   constexpr uint32_t testMaxPeriod{50,};
+   constexpr uint32_t testFixedPeriod{14,};
+   for (auto testPeriod{testMinPeriod,}; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      auto const testResummationPeriod{random_number<uint32_t>(1, testPeriod * 3),};
+      sum_over_period<> testIndicator{testPeriod, testResummationPeriod,};
+      sum_over_period<> testRestoredIndicator{testPeriod, testResummationPeriod,};
+      sum_over_period<> testOtherPeriodIndicator{testPeriod + 1, testResummationPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_sum_over_period_state(*this, testIndicator, testRestoredIndicator, testOtherPeriodIndicator, testPeriod));
+   }
+   constexpr uint32_t testResummationPeriod{testFixedPeriod * 3,};
+   /// Heap, inline, fixed period and foreign memory resource rings share the state layout, loading into them never allocates
+   counting_memory_resource testMemoryResource;
+   sum_over_period<> testIndicator{testFixedPeriod, testResummationPeriod,};
+   sum_over_period<static_cast<uint32_t>(-1), 16> testInlineIndicator{testFixedPeriod, testResummationPeriod,};
+   sum_over_period<> testArenaIndicator{testFixedPeriod, testResummationPeriod, std::addressof(testMemoryResource),};
+   sum_over_period<testFixedPeriod> testFixedIndicator{testResummationPeriod,};
+   sum_over_period<> testOtherPeriodIndicator{testFixedPeriod + 1, testResummationPeriod,};
+   auto const testAllocationsNumber{testMemoryResource.allocations(),};
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_state(*this, testIndicator, testInlineIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_state(*this, testIndicator, testArenaIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_state(*this, testIndicator, testFixedIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testFixedIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_sum_over_period_state(*this, testFixedIndicator, testIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   ASSERT_EQ(testAllocationsNumber, testMemoryResource.allocations());
+}
+
 }
@@ -24,21 +24,27 @@
 */
 
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "memory_resource.tests.hpp" /// for tean::tests::counting_memory_resource
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 #include "tean/simple_moving_average.hpp" /// for tean::simple_moving_average
 #include "tean/variance.hpp" /// for the test target
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_GE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <indicators.h> /// for TI_OKAY, ti_var, ti_var_start
 #include <ta_func.h> /// for TA_SUCCESS, TA_VAR, TA_VAR_Lookback
 
-#include <algorithm> /// for std::fill
-#include <cmath> /// for std::isnan
+#include <algorithm> /// for std::fill, std::ranges::equal
+#include <cmath> /// for std::abs, std::isnan
+#include <cstddef> /// for size_t, std::byte
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <span> /// for std::span
+#include <tuple> /// for std::ignore
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -56,7 +62,7 @@ void test_variance_step(TeAn &fixture, decimal const testPriceStep)
       auto const testPricePrecision{inverted_power_of_ten[testPriceStep.scale / 3] * inverted_power_of_ten[1],};
       double const testPriceStepValue{testPriceStep,};
       {
-         tean::simple_moving_average testAdditionalIndicator{test_period};
+         tean::simple_moving_average<test_period> testAdditionalIndicator{};
          for (uint32_t testIteration{0,}; testIteration < testLookbackPeriod; ++testIteration)
          {
             auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(power_of_ten[testPriceStep.scale], power_of_ten[testPriceStep.scale + 1]),};
@@ -195,4 +201,343 @@ TEST_F(TeAn, Variance)
    ASSERT_NO_FATAL_FAILURE(test_variance<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+template<uint32_t test_period>
+void test_compensated_variance_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testLookbackPeriod{variance<test_period>::lookback_period,};
+   constexpr auto testIterationsNumber{test_period * 100,};
+   constexpr auto testRelativePrecision{inverted_power_of_ten[12],};
+   auto const testResummationPeriod{fixture.random_number<uint32_t>(1, test_period * 4),};
+   variance<test_period> testIndicator{testResummationPeriod,};
+   variance<> testRuntimeIndicator{test_period, testResummationPeriod,};
+   ASSERT_EQ(testResummationPeriod, testIndicator.resummation_period());
+   ASSERT_EQ(testResummationPeriod, testRuntimeIndicator.resummation_period());
+   double const testPriceStepValue{testPriceStep,};
+   auto const testPrices{std::make_unique<double[]>(testIterationsNumber),};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      /// Occasional spikes make plain add-then-subtract lose the low order bits of the window sums
+      auto const testPrice{
+         (0 == fixture.random_number<uint32_t>(0, test_period))
+            ? testPriceStepValue * fixture.random_number<int64_t>(100, 1000) * power_of_ten[6]
+            : testPriceStepValue * fixture.random_number<int64_t>(100, 1000)
+      };
+      testPrices[testIteration] = testPrice;
+      if (testLookbackPeriod > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testIndicator.pick(testIteration, testPrice)));
+         ASSERT_TRUE(std::isnan(testIndicator.calc(testIteration, testPrice)));
+         ASSERT_TRUE(std::isnan(testRuntimeIndicator.pick(testIteration, testPrice)));
+         ASSERT_TRUE(std::isnan(testRuntimeIndicator.calc(testIteration, testPrice)));
+         continue;
+      }
+      long double testMean{0,};
+      for (auto testWindowIndex{testIteration - testLookbackPeriod,}; testWindowIndex <= testIteration; ++testWindowIndex)
+      {
+         testMean += testPrices[testWindowIndex];
+      }
+      testMean /= test_period;
+      long double testVariance{0,};
+      for (auto testWindowIndex{testIteration - testLookbackPeriod,}; testWindowIndex <= testIteration; ++testWindowIndex)
+      {
+         testVariance += (testPrices[testWindowIndex] - testMean) * (testPrices[testWindowIndex] - testMean);
+      }
+      testVariance /= test_period;
+      /// E[x^2] - E[x]^2 cancellation is proportional to E[x^2], not to the variance itself
+      auto const testPrecision{static_cast<double>(testVariance + testMean * testMean) * testRelativePrecision,};
+      auto const testValue{static_cast<double>(testVariance),};
+      ASSERT_THAT(testIndicator.pick(testIteration, testPrice), testing::DoubleNear(testValue, testPrecision));
+      ASSERT_THAT(testIndicator.calc(testIteration, testPrice), testing::DoubleNear(testValue, testPrecision));
+      ASSERT_THAT(testRuntimeIndicator.pick(testIteration, testPrice), testing::DoubleNear(testValue, testPrecision));
+      ASSERT_THAT(testRuntimeIndicator.calc(testIteration, testPrice), testing::DoubleNear(testValue, testPrecision));
+   }
+}
+
+template<uint32_t test_period>
+void test_compensated_variance(TeAn &fixture, decimal const testPriceStep)
+{
+   test_compensated_variance_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_compensated_variance<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, VarianceCompensated)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_compensated_variance<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_compensated_variance<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+
+template<typename indicator>
+void test_variance_window_step(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, uint32_t const testWindowSize)
+{
+   std::vector<double> testPrices;
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 10); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      testPrices.push_back(testPrice);
+      [[maybe_unused]] auto const testValue{testIndicator.calc(testIteration, testPrice),};
+      if (testWindowSize > testPrices.size())
+      {
+         continue;
+      }
+      auto const testWindow{testIndicator.window(),};
+      ASSERT_EQ(testWindowSize, testWindow.size());
+      ASSERT_GE(testWindow.older.size(), 1);
+      std::vector<double> testWindowValues{testWindow.older.begin(), testWindow.older.end(),};
+      testWindowValues.insert(testWindowValues.end(), testWindow.newer.begin(), testWindow.newer.end());
+      ASSERT_TRUE(std::ranges::equal(testWindowValues, std::span{testPrices}.last(testWindowSize)));
+      for (uint32_t testIndex{0,}; testIndex < testWindowSize; ++testIndex)
+      {
+         ASSERT_EQ(testWindowValues[testIndex], testWindow[testIndex]);
+      }
+   }
+}
+
+template<uint32_t test_period>
+void test_variance_window(TeAn &fixture)
+{
+   {
+      variance<test_period> testIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_variance_window_step(fixture, testIndicator, test_period, test_period - 1));
+   }
+   {
+      variance<> testIndicator{test_period,};
+      ASSERT_NO_FATAL_FAILURE(test_variance_window_step(fixture, testIndicator, test_period, test_period - 1));
+   }
+   if constexpr (2 < test_period)
+   {
+      test_variance_window<test_period - 1>(fixture);
+   }
+}
+
+TEST_F(TeAn, VarianceWindow)
+{
+   ASSERT_NO_FATAL_FAILURE(test_variance_window<50>(*this));
+}
+
+TEST_F(TeAn, VarianceAmend)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   constexpr auto testPricePrecision = inverted_power_of_ten[8];
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testResummationPeriod = random_number<uint32_t>(0, 1) * testPeriod * 3;
+         variance<> testIndicator{testPeriod, testResummationPeriod,};
+         variance<> testExpectedIndicator{testPeriod, testResummationPeriod,};
+         for (uint32_t testIteration = 0; testIteration < (testIndicator.lookback_period() + testPeriod * 10); ++testIteration)
+         {
+            /// An amended calc must match a calc with the final input, up to the rounding of the replaced terms
+            std::ignore = testIndicator.calc(testIteration, testPriceStepValue * random_number<int64_t>(100, 1000));
+            auto testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto testMean = std::numeric_limits<double>::signaling_NaN();
+            auto testValue = testIndicator.amend(testIteration, testPrice, testMean);
+            for (auto testAmendsNumber = random_number<uint32_t>(0, 3); 0 < testAmendsNumber; --testAmendsNumber)
+            {
+               testPrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+               testValue = testIndicator.amend(testIteration, testPrice, testMean);
+            }
+            auto testExpectedMean = std::numeric_limits<double>::signaling_NaN();
+            auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice, testExpectedMean);
+            ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+            if (false == std::isnan(testExpectedValue))
+            {
+               ASSERT_NEAR(testExpectedValue, testValue, testPricePrecision * testExpectedMean * testExpectedMean);
+               ASSERT_NEAR(testExpectedMean, testMean, testPricePrecision * testExpectedMean);
+            }
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, VarianceMemoryResource)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      /// Only the lookback period values are kept, the newest value is folded into the running sums, calcs never allocate
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = std::make_unique<variance<>>(testPeriod, 0, std::addressof(testMemoryResource));
+      ASSERT_EQ(1u, testMemoryResource.allocations());
+      ASSERT_EQ((testPeriod - 1) * sizeof(double), testMemoryResource.allocated_bytes());
+      variance<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testIndicator->calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+      /// Copies take the default memory resource, and the indicator gives back everything it took once destroyed
+      auto const testCopiedIndicator = *testIndicator;
+      ASSERT_EQ(1u, testMemoryResource.allocations());
+      testIndicator.reset();
+      ASSERT_EQ(1u, testMemoryResource.deallocations());
+   }
+}
+
+TEST_F(TeAn, VarianceInline)
+{
+   constexpr uint32_t testInlineCapacity = 16;
+   for (uint32_t testPeriod = 2; testPeriod <= (testInlineCapacity * 2); ++testPeriod)
+   {
+      /// The window is one value shorter than the period, so a period one longer than the inline capacity still fits inline
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = variance<static_cast<uint32_t>(-1), testInlineCapacity>{testPeriod, 0, std::addressof(testMemoryResource)};
+      ASSERT_EQ((testInlineCapacity < (testPeriod - 1)) ? 1u : 0u, testMemoryResource.allocations());
+      variance<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testIndicator.calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+      /// A copy has to rebind the window to its own inline storage
+      auto testCopiedIndicator = testIndicator;
+      auto const *const testObject = reinterpret_cast<std::byte const *>(std::addressof(testCopiedIndicator));
+      auto const *const testRing = reinterpret_cast<std::byte const *>(testCopiedIndicator.window().older.data());
+      ASSERT_EQ(false == (testInlineCapacity < (testPeriod - 1)), (testObject <= testRing) && ((testObject + sizeof(testCopiedIndicator)) > testRing));
+      for (uint32_t testIteration = (testPeriod * 10); testIteration < (testPeriod * 12); ++testIteration)
+      {
+         auto const testPrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testValue = testCopiedIndicator.calc(testIteration, testPrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+   }
+}
+
+template<typename indicator>
+void test_variance_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevPrice = 0.0;
+   uint64_t testSequenceNumber = 0;
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward and zero volume bars repeat the latest value
+         auto const testGap = fixture.random_number<uint64_t>(1, testPeriod * 3);
+         testIndicator.skip(testSequenceNumber, testGap, fixture.random_bool() ? gap_fill::carry_forward : gap_fill::zero_volume);
+         for (uint64_t testGapIndex = 0; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrice);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      testPrevPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto testExpectedMean = std::numeric_limits<double>::signaling_NaN();
+      auto const testExpectedValue = testExpectedIndicator.calc(testSequenceNumber, testPrevPrice, testExpectedMean);
+      auto testMean = std::numeric_limits<double>::signaling_NaN();
+      auto const testValue = testIndicator.calc(testSequenceNumber, testPrevPrice, testMean);
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         /// The skip may resum at another bar than the calcs it replaces, which only moves the rounding
+         ASSERT_NEAR(testExpectedValue, testValue, 1e-6);
+         ASSERT_NEAR(testExpectedMean, testMean, 1e-9);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, VarianceSkip)
+{
+   constexpr uint32_t testFixedPeriod = 20;
+   for (uint32_t testPeriod = 2; testPeriod <= 50; ++testPeriod)
+   {
+      auto const testResummationPeriod = random_number<uint32_t>(0, 1) * testPeriod * 3;
+      variance<> testIndicator{testPeriod, testResummationPeriod,};
+      variance<> testExpectedIndicator{testPeriod, testResummationPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_variance_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   variance<testFixedPeriod> testFixedIndicator{testFixedPeriod * 3,};
+   variance<testFixedPeriod> testExpectedFixedIndicator{testFixedPeriod * 3,};
+   ASSERT_NO_FATAL_FAILURE(test_variance_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
+
+template<typename indicator, typename restored_indicator, typename other_period_indicator>
+void test_variance_state(TeAn &fixture, indicator &testIndicator, restored_indicator &testRestoredIndicator, other_period_indicator &testOtherPeriodIndicator, uint32_t const testPeriod)
+{
+   /// The ring cursor and the resummation countdown move with every calc, so the state may be saved at any phase of the window
+   auto const testIterationsNumber = fixture.random_number<uint32_t>(1, testPeriod * 3);
+   for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+   {
+      std::ignore = testIndicator.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+   }
+   std::vector<std::byte> testState;
+   state_writer testWriter{testState};
+   testIndicator.save(testIterationsNumber - 1, testWriter);
+   /// States of another format version, of another sequence number or of another period are rejected
+   auto testOtherVersionState = testState;
+   testOtherVersionState.front() ^= std::byte{0xff};
+   state_reader testOtherVersionReader{testOtherVersionState};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber - 1, testOtherVersionReader));
+   ASSERT_FALSE(testOtherVersionReader.good());
+   state_reader testOtherSequenceNumberReader{testState};
+   ASSERT_FALSE(testRestoredIndicator.load(testIterationsNumber, testOtherSequenceNumberReader));
+   state_reader testOtherPeriodReader{testState};
+   ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber - 1, testOtherPeriodReader));
+   /// A failed load may leave the indicator partially restored, so it is reset before the state is loaded for good
+   testRestoredIndicator.reset();
+   state_reader testReader{testState};
+   ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+   ASSERT_EQ(testState.size(), testReader.position());
+   for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto const testValue = testIndicator.calc(testIteration, testPrice);
+      auto const testRestoredValue = testRestoredIndicator.calc(testIteration, testPrice);
+      ASSERT_EQ(std::isnan(testValue), std::isnan(testRestoredValue));
+      if (false == std::isnan(testValue))
+      {
+         ASSERT_EQ(testValue, testRestoredValue);
+      }
+   }
+}
+
+TEST_F(TeAn, VarianceState)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 50;
+   constexpr uint32_t testFixedPeriod = 14;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      auto const testResummationPeriod = random_number<uint32_t>(1, testPeriod * 3);
+      variance<> testIndicator{testPeriod, testResummationPeriod};
+      variance<> testRestoredIndicator{testPeriod, testResummationPeriod};
+      variance<> testOtherPeriodIndicator{testPeriod + 1, testResummationPeriod};
+      ASSERT_NO_FATAL_FAILURE(test_variance_state(*this, testIndicator, testRestoredIndicator, testOtherPeriodIndicator, testPeriod));
+   }
+   constexpr uint32_t testResummationPeriod = testFixedPeriod * 3;
+   /// Heap, inline, fixed period and foreign memory resource rings share the state layout, loading into them never allocates
+   counting_memory_resource testMemoryResource;
+   variance<> testIndicator{testFixedPeriod, testResummationPeriod};
+   variance<static_cast<uint32_t>(-1), 16> testInlineIndicator{testFixedPeriod, testResummationPeriod};
+   variance<> testArenaIndicator{testFixedPeriod, testResummationPeriod, std::addressof(testMemoryResource)};
+   variance<testFixedPeriod> testFixedIndicator{testResummationPeriod};
+   variance<> testOtherPeriodIndicator{testFixedPeriod + 1, testResummationPeriod};
+   auto const testAllocationsNumber = testMemoryResource.allocations();
+   ASSERT_NO_FATAL_FAILURE(test_variance_state(*this, testIndicator, testInlineIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_variance_state(*this, testIndicator, testArenaIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_variance_state(*this, testIndicator, testFixedIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   testFixedIndicator.reset();
+   ASSERT_NO_FATAL_FAILURE(test_variance_state(*this, testFixedIndicator, testIndicator, testOtherPeriodIndicator, testFixedPeriod));
+   ASSERT_EQ(testAllocationsNumber, testMemoryResource.allocations());
+}
+
 }
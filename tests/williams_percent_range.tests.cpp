@@ -24,20 +24,28 @@
 */
 
 #include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::power_of_ten
+#include "memory_resource.tests.hpp" /// for tean::tests::counting_memory_resource
 #include "tean.tests.hpp" /// for tean::tests::TeAn
 
+#include "tean/gap_fill.hpp" /// for tean::gap_fill
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
 #include "tean/williams_percent_range.hpp" /// for the test target
 
 #include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleEq, testing::ElementsAreArray, testing::Matcher
-#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+#include <gtest/gtest.h> /// for ASSERT_DOUBLE_EQ, ASSERT_EQ, ASSERT_FALSE, ASSERT_NEAR, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
 #include <indicators.h> /// for TI_OKAY, ti_willr, ti_willr_start
 #include <ta_func.h> /// for TA_SUCCESS, TA_WILLR, TA_WILLR_Lookback
 
-#include <algorithm> /// for std::fill
-#include <cmath> /// for std::isnan
+#include <algorithm> /// for std::fill, std::max, std::min
+#include <array> /// for std::array
+#include <cmath> /// for std::isfinite, std::isnan
+#include <cstddef> /// for size_t, std::byte
 #include <cstdint> /// for int64_t, uint32_t
 #include <limits> /// for std::numeric_limits
 #include <memory> /// for std::addressof, std::make_unique
+#include <span> /// for std::span
+#include <tuple> /// for std::ignore
+#include <utility> /// for std::move
 #include <vector> /// for std::begin, std::end, std::vector
 
 namespace tean::tests
@@ -53,7 +61,7 @@ TEST_F(TeAn, WilliamsPercentRange)
       for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
       {
          auto const testIterationsNumber = testPeriod * 10;
-         williams_percent_range testIndicator{testPeriod};
+         williams_percent_range<> testIndicator{testPeriod};
          ASSERT_EQ(testPeriod, testIndicator.period());
          auto testHighPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
          auto testLowPrices = std::make_unique<double[]>(testIndicator.lookback_period() + testIterationsNumber);
@@ -146,4 +154,565 @@ TEST_F(TeAn, WilliamsPercentRange)
    ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+TEST_F(TeAn, WilliamsPercentRangeBatch)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 10;
+         williams_percent_range<> testIndicator{testPeriod};
+         williams_percent_range<> testBatchIndicator{testPeriod};
+         std::vector<double> testHighPrices;
+         std::vector<double> testLowPrices;
+         std::vector<double> testClosePrices;
+         std::vector<double> testValues;
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            auto const testClosePrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testHighPrice = testClosePrice + testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testLowPrice = testClosePrice - testPriceStepValue * random_number<int64_t>(0, 50);
+            testHighPrices.push_back(testHighPrice);
+            testLowPrices.push_back(testLowPrice);
+            testClosePrices.push_back(testClosePrice);
+            testValues.push_back(testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice));
+         }
+         std::vector<double> testBatchValues(testIterationsNumber, std::numeric_limits<double>::signaling_NaN());
+         for (uint32_t testBatchBegin = 0; testBatchBegin < testIterationsNumber; )
+         {
+            auto const testBatchSize = std::min(random_number<uint32_t>(1, testPeriod * 3), testIterationsNumber - testBatchBegin);
+            testBatchIndicator.calc(
+               testBatchBegin,
+               std::span{testHighPrices}.subspan(testBatchBegin, testBatchSize),
+               std::span{testLowPrices}.subspan(testBatchBegin, testBatchSize),
+               std::span{testClosePrices}.subspan(testBatchBegin, testBatchSize),
+               std::span{testBatchValues}.subspan(testBatchBegin, testBatchSize)
+            );
+            testBatchBegin += testBatchSize;
+         }
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            if (testIteration < testIndicator.lookback_period())
+            {
+               ASSERT_TRUE(std::isnan(testBatchValues[testIteration]));
+            }
+            else
+            {
+               ASSERT_EQ(testBatchValues[testIteration], testValues[testIteration]);
+            }
+         }
+         for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+         {
+            auto const testClosePrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testHighPrice = testClosePrice + testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testLowPrice = testClosePrice - testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testValue = testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+            ASSERT_EQ(testBatchIndicator.pick(testIteration, testHighPrice, testLowPrice, testClosePrice), testValue);
+            ASSERT_EQ(testBatchIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice), testValue);
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, WilliamsPercentRangeCopyable)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 10;
+         std::vector<williams_percent_range<>> testIndicators;
+         testIndicators.emplace_back(testPeriod);
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            auto const testClosePrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testHighPrice = testClosePrice + testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testLowPrice = testClosePrice - testPriceStepValue * random_number<int64_t>(0, 50);
+            std::ignore = testIndicators.front().calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         }
+         /// Copies of one indicator, including relocated ones, continue the same stream independently
+         williams_percent_range<> testCopyAssignedIndicator{testMinPeriod};
+         testCopyAssignedIndicator = testIndicators.front();
+         for (uint32_t testCopyIndex = 0; testCopyIndex < 10; ++testCopyIndex)
+         {
+            testIndicators.push_back(testIndicators.back());
+         }
+         auto testMovedIndicator = std::move(testIndicators.back());
+         testIndicators.pop_back();
+         for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+         {
+            auto const testClosePrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testHighPrice = testClosePrice + testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testLowPrice = testClosePrice - testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testValue = testMovedIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+            ASSERT_EQ(testCopyAssignedIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice), testValue);
+            for (auto &testIndicator : testIndicators)
+            {
+               ASSERT_EQ(testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice), testValue);
+            }
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, WilliamsPercentRangeState)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   constexpr uint32_t testFixedPeriod = 14;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         auto const testIterationsNumber = testPeriod * 10;
+         williams_percent_range<> testIndicator{testPeriod};
+         for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+         {
+            auto const testClosePrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testHighPrice = testClosePrice + testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testLowPrice = testClosePrice - testPriceStepValue * random_number<int64_t>(0, 50);
+            std::ignore = testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         }
+         std::vector<std::byte> testState;
+         state_writer testWriter{testState};
+         testIndicator.save(testIterationsNumber - 1, testWriter);
+         /// A restored indicator continues the stream exactly like the saved one, a fixed period indicator shares the state layout
+         williams_percent_range<> testRestoredIndicator{testPeriod};
+         state_reader testReader{testState};
+         ASSERT_TRUE(testRestoredIndicator.load(testIterationsNumber - 1, testReader));
+         ASSERT_EQ(testState.size(), testReader.position());
+         williams_percent_range<testFixedPeriod> testFixedIndicator{};
+         state_reader testFixedReader{testState};
+         ASSERT_EQ(testFixedPeriod == testPeriod, testFixedIndicator.load(testIterationsNumber - 1, testFixedReader));
+         /// States of another period, of another sequence number or truncated ones are rejected
+         williams_percent_range<> testOtherPeriodIndicator{testPeriod + 1};
+         state_reader testOtherPeriodReader{testState};
+         ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber - 1, testOtherPeriodReader));
+         state_reader testOtherSequenceNumberReader{testState};
+         ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber, testOtherSequenceNumberReader));
+         state_reader testTruncatedReader{std::span{testState}.first(testState.size() - 1)};
+         ASSERT_FALSE(testOtherPeriodIndicator.load(testIterationsNumber - 1, testTruncatedReader));
+         ASSERT_FALSE(testTruncatedReader.good());
+         for (auto testIteration = testIterationsNumber; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+         {
+            auto const testClosePrice = testPriceStepValue * random_number<int64_t>(100, 1000);
+            auto const testHighPrice = testClosePrice + testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testLowPrice = testClosePrice - testPriceStepValue * random_number<int64_t>(0, 50);
+            auto const testValue = testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+            ASSERT_EQ(testRestoredIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice), testValue);
+            if (testFixedPeriod == testPeriod)
+            {
+               ASSERT_EQ(testFixedIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice), testValue);
+            }
+         }
+      }
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_williams_percent_range_amend_step(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testIterationsNumber, double const testPriceStepValue)
+{
+   auto const testPrices = [&] ()
+   {
+      auto const testClosePrice = testPriceStepValue * fixture.random_number<int64_t>(100, 110);
+      return std::array<double, 3>{
+         testClosePrice + testPriceStepValue * fixture.random_number<int64_t>(0, 5),
+         testClosePrice - testPriceStepValue * fixture.random_number<int64_t>(0, 5),
+         testClosePrice,
+      };
+   };
+   for (uint32_t testIteration = 0; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto testPrice = testPrices();
+      std::ignore = testIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+      testPrice = testPrices();
+      auto testValue = testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+      for (auto testAmendsNumber = fixture.random_number<uint32_t>(0, 3); 0 < testAmendsNumber; --testAmendsNumber)
+      {
+         testPrice = testPrices();
+         testValue = testIndicator.amend(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+      }
+      auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_EQ(testExpectedValue, testValue);
+      }
+   }
+}
+
+TEST_F(TeAn, WilliamsPercentRangeAmend)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   constexpr uint32_t testFixedPeriod = 14;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         williams_percent_range<> testIndicator{testPeriod};
+         williams_percent_range<> testExpectedIndicator{testPeriod};
+         ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_amend_step(*this, testIndicator, testExpectedIndicator, testPeriod * 10, testPriceStepValue));
+      }
+      williams_percent_range<testFixedPeriod> testFixedIndicator{};
+      williams_percent_range<testFixedPeriod> testFixedExpectedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_amend_step(*this, testFixedIndicator, testFixedExpectedIndicator, testFixedPeriod * 10, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_williams_percent_range_lookahead_step(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   auto const testPrices = [&] ()
+   {
+      auto const testClosePrice = testPriceStepValue * fixture.random_number<int64_t>(100, 110);
+      return std::array<double, 3>{
+         testClosePrice + testPriceStepValue * fixture.random_number<int64_t>(0, 5),
+         testClosePrice - testPriceStepValue * fixture.random_number<int64_t>(0, 5),
+         testClosePrice,
+      };
+   };
+   for (uint32_t testIteration = 0; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      /// Every hypothetical continuation must match a copy that commits the same values, and leave the indicator intact
+      auto testLookahead = testIndicator.lookahead();
+      indicator testExpectedIndicator{testIndicator};
+      auto const testLookaheadsNumber = fixture.random_number<uint32_t>(1, testPeriod);
+      for (uint32_t testLookaheadIndex = 0; testLookaheadIndex < testLookaheadsNumber; ++testLookaheadIndex)
+      {
+         auto const testPrice = testPrices();
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration + testLookaheadIndex, testPrice[0], testPrice[1], testPrice[2]);
+         auto const testValue = testLookahead.calc(testIteration + testLookaheadIndex, testPrice[0], testPrice[1], testPrice[2]);
+         ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+         if (false == std::isnan(testExpectedValue))
+         {
+            ASSERT_EQ(testExpectedValue, testValue);
+         }
+      }
+      auto const testPrice = testPrices();
+      std::ignore = testIndicator.calc(testIteration, testPrice[0], testPrice[1], testPrice[2]);
+   }
+}
+
+TEST_F(TeAn, WilliamsPercentRangeLookahead)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   constexpr uint32_t testFixedPeriod = 14;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         williams_percent_range<> testIndicator{testPeriod};
+         ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_lookahead_step(*this, testIndicator, testPeriod, testPriceStepValue));
+      }
+      williams_percent_range<static_cast<uint32_t>(-1), 16> testInlineIndicator{testFixedPeriod};
+      ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_lookahead_step(*this, testInlineIndicator, testFixedPeriod, testPriceStepValue));
+      williams_percent_range<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_lookahead_step(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_williams_percent_range_pick_many_step(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   for (uint32_t testIteration = 0; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      /// Each candidate close widens the forming bar, and must see the same committed state as a single pick
+      auto const testHighPrice = testPriceStepValue * fixture.random_number<int64_t>(105, 110);
+      auto const testLowPrice = testPriceStepValue * fixture.random_number<int64_t>(100, 105);
+      std::vector<double> testCloses(fixture.random_number<size_t>(1, 100));
+      for (auto &testClose : testCloses)
+      {
+         testClose = testPriceStepValue * fixture.random_number<int64_t>(95, 115);
+      }
+      std::vector<double> testValues(testCloses.size());
+      testIndicator.pick_many(testIteration, testHighPrice, testLowPrice, testCloses, testValues);
+      for (size_t testCloseIndex = 0; testCloseIndex < testCloses.size(); ++testCloseIndex)
+      {
+         auto const testClose = testCloses[testCloseIndex];
+         auto const testExpectedValue = testIndicator.pick(testIteration, std::max(testHighPrice, testClose), std::min(testLowPrice, testClose), testClose);
+         ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValues[testCloseIndex]));
+         if (false == std::isnan(testExpectedValue))
+         {
+            ASSERT_EQ(testExpectedValue, testValues[testCloseIndex]);
+         }
+      }
+      std::ignore = testIndicator.calc(testIteration, testHighPrice, testLowPrice, testLowPrice);
+   }
+}
+
+TEST_F(TeAn, WilliamsPercentRangePickMany)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 50;
+   constexpr uint32_t testFixedPeriod = 14;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         williams_percent_range<> testIndicator{testPeriod};
+         ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_pick_many_step(*this, testIndicator, testPeriod, testPriceStepValue));
+      }
+      williams_percent_range<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_pick_many_step(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<uint32_t test_period>
+void test_fixed_williams_percent_range_step(TeAn &fixture, decimal const testPriceStep)
+{
+   constexpr auto testLookbackPeriod{williams_percent_range<test_period>::lookback_period,};
+   constexpr auto testIterationsNumber{test_period * 10,};
+   williams_percent_range<test_period> testIndicator{};
+   williams_percent_range<> testRuntimeIndicator{test_period,};
+   ASSERT_EQ(testLookbackPeriod, testRuntimeIndicator.lookback_period());
+   double const testPriceStepValue{testPriceStep,};
+   std::vector<double> testHighPrices;
+   std::vector<double> testLowPrices;
+   std::vector<double> testClosePrices;
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      auto const testClosePrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testHighPrice{testClosePrice + testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      auto const testLowPrice{testClosePrice - testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      testHighPrices.push_back(testHighPrice);
+      testLowPrices.push_back(testLowPrice);
+      testClosePrices.push_back(testClosePrice);
+      auto const testPickValue{testIndicator.pick(testIteration, testHighPrice, testLowPrice, testClosePrice),};
+      auto const testCalcValue{testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice),};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice),};
+      if (testLookbackPeriod > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testPickValue));
+         ASSERT_TRUE(std::isnan(testCalcValue));
+         ASSERT_TRUE(std::isnan(testRuntimeValue));
+         continue;
+      }
+      ASSERT_EQ(testPickValue, testRuntimeValue);
+      ASSERT_EQ(testCalcValue, testRuntimeValue);
+   }
+   testIndicator.reset();
+   testRuntimeIndicator.reset();
+   std::vector<double> testValues(testIterationsNumber, std::numeric_limits<double>::signaling_NaN());
+   std::vector<double> testRuntimeValues(testIterationsNumber, std::numeric_limits<double>::signaling_NaN());
+   for (uint32_t testBatchBegin{0,}; testBatchBegin < testIterationsNumber; )
+   {
+      auto const testBatchSize{std::min(fixture.random_number<uint32_t>(1, test_period * 3), testIterationsNumber - testBatchBegin),};
+      auto const testBatchHighPrices{std::span{testHighPrices}.subspan(testBatchBegin, testBatchSize),};
+      auto const testBatchLowPrices{std::span{testLowPrices}.subspan(testBatchBegin, testBatchSize),};
+      auto const testBatchClosePrices{std::span{testClosePrices}.subspan(testBatchBegin, testBatchSize),};
+      testIndicator.calc(testBatchBegin, testBatchHighPrices, testBatchLowPrices, testBatchClosePrices, std::span{testValues}.subspan(testBatchBegin, testBatchSize));
+      testRuntimeIndicator.calc(testBatchBegin, testBatchHighPrices, testBatchLowPrices, testBatchClosePrices, std::span{testRuntimeValues}.subspan(testBatchBegin, testBatchSize));
+      testBatchBegin += testBatchSize;
+   }
+   for (auto testIteration{testLookbackPeriod,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      ASSERT_EQ(testValues[testIteration], testRuntimeValues[testIteration]);
+   }
+   for (auto testIteration{testIterationsNumber,}; testIteration < (testIterationsNumber + test_period * 2); ++testIteration)
+   {
+      auto const testClosePrice{testPriceStepValue * fixture.random_number<int64_t>(100, 1000),};
+      auto const testHighPrice{testClosePrice + testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      auto const testLowPrice{testClosePrice - testPriceStepValue * fixture.random_number<int64_t>(0, 50),};
+      auto const testRuntimeValue{testRuntimeIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice),};
+      ASSERT_EQ(testIndicator.pick(testIteration, testHighPrice, testLowPrice, testClosePrice), testRuntimeValue);
+      ASSERT_EQ(testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice), testRuntimeValue);
+   }
+}
+
+template<uint32_t test_period>
+void test_fixed_williams_percent_range(TeAn &fixture, decimal const testPriceStep)
+{
+   test_fixed_williams_percent_range_step<test_period>(fixture, testPriceStep);
+   if constexpr (2 < test_period)
+   {
+      test_fixed_williams_percent_range<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, WilliamsPercentRangeFixed)
+{
+   constexpr uint32_t testMaxPeriod{100,};
+   ASSERT_NO_FATAL_FAILURE(test_fixed_williams_percent_range<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_fixed_williams_percent_range<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_williams_percent_range_solve_step(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   for (uint32_t testIteration = 0; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      /// Every bar has a range, so the window is never flat
+      auto const testHighPrice = testPriceStepValue * fixture.random_number<int64_t>(106, 110);
+      auto const testLowPrice = testPriceStepValue * fixture.random_number<int64_t>(100, 105);
+      auto const testTarget = fixture.random_number<double>(-100.0, 0.0);
+      auto const testClose = testIndicator.solve(testIteration, testHighPrice, testLowPrice, testTarget);
+      if ((testPeriod - 1) > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testClose));
+      }
+      else
+      {
+         ASSERT_TRUE(std::isfinite(testClose));
+         auto const testValue = testIndicator.pick(testIteration, std::max(testHighPrice, testClose), std::min(testLowPrice, testClose), testClose);
+         ASSERT_NEAR(testTarget, testValue, 1e-6);
+      }
+      std::ignore = testIndicator.calc(testIteration, testHighPrice, testLowPrice, testLowPrice);
+   }
+}
+
+TEST_F(TeAn, WilliamsPercentRangeSolve)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 50;
+   constexpr uint32_t testFixedPeriod = 14;
+   auto const testStep = [&] (decimal const &testPriceStep)
+   {
+      auto const testPriceStepValue = static_cast<double>(testPriceStep);
+      for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+      {
+         williams_percent_range<> testIndicator{testPeriod};
+         ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_solve_step(*this, testIndicator, testPeriod, testPriceStepValue));
+      }
+      williams_percent_range<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_solve_step(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, WilliamsPercentRangeMemoryResource)
+{
+   constexpr uint32_t testMinPeriod = 2;
+   constexpr uint32_t testMaxPeriod = 100;
+   for (auto testPeriod = testMinPeriod; testPeriod <= testMaxPeriod; ++testPeriod)
+   {
+      /// The high and low window and the deques of the highest high and lowest low candidates are allocated once each, calcs never allocate
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = std::make_unique<williams_percent_range<>>(testPeriod, std::addressof(testMemoryResource));
+      ASSERT_EQ(3u, testMemoryResource.allocations());
+      ASSERT_EQ(testPeriod * (2 * sizeof(double) + 2 * sizeof(uint32_t)), testMemoryResource.allocated_bytes());
+      williams_percent_range<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testClosePrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testHighPrice = testClosePrice + random_number<int64_t>(0, 50);
+         auto const testLowPrice = testClosePrice - random_number<int64_t>(0, 50);
+         auto const testValue = testIndicator->calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+      /// Copies take the default memory resource, and the indicator gives back everything it took once destroyed
+      auto const testCopiedIndicator = *testIndicator;
+      ASSERT_EQ(3u, testMemoryResource.allocations());
+      testIndicator.reset();
+      ASSERT_EQ(3u, testMemoryResource.deallocations());
+   }
+}
+
+TEST_F(TeAn, WilliamsPercentRangeInline)
+{
+   constexpr uint32_t testInlineCapacity = 16;
+   for (uint32_t testPeriod = 2; testPeriod <= (testInlineCapacity * 2); ++testPeriod)
+   {
+      /// Windows up to the inline capacity keep the high and low values and both deques inside the indicator
+      counting_memory_resource testMemoryResource;
+      auto testIndicator = williams_percent_range<static_cast<uint32_t>(-1), testInlineCapacity>{testPeriod, std::addressof(testMemoryResource)};
+      ASSERT_EQ((testInlineCapacity < testPeriod) ? 3u : 0u, testMemoryResource.allocations());
+      williams_percent_range<> testExpectedIndicator{testPeriod};
+      for (uint32_t testIteration = 0; testIteration < (testPeriod * 10); ++testIteration)
+      {
+         auto const testClosePrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testHighPrice = testClosePrice + random_number<int64_t>(0, 50);
+         auto const testLowPrice = testClosePrice - random_number<int64_t>(0, 50);
+         auto const testValue = testIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+      /// A copy has to rebind the windows to its own inline storage
+      auto testCopiedIndicator = testIndicator;
+      for (uint32_t testIteration = (testPeriod * 10); testIteration < (testPeriod * 12); ++testIteration)
+      {
+         auto const testClosePrice = static_cast<double>(random_number<int64_t>(100, 1000));
+         auto const testHighPrice = testClosePrice + random_number<int64_t>(0, 50);
+         auto const testLowPrice = testClosePrice - random_number<int64_t>(0, 50);
+         auto const testValue = testCopiedIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         auto const testExpectedValue = testExpectedIndicator.calc(testIteration, testHighPrice, testLowPrice, testClosePrice);
+         ASSERT_TRUE((testExpectedValue == testValue) || (std::isnan(testExpectedValue) && std::isnan(testValue)));
+      }
+   }
+}
+
+template<typename indicator>
+void test_williams_percent_range_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevPrice = std::array<double, 3>{};
+   uint64_t testSequenceNumber = 0;
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward bars repeat the latest high and low, any close within them leaves the window alike
+         auto const testGap = fixture.random_number<uint64_t>(1, testPeriod * 3);
+         testIndicator.skip(testSequenceNumber, testGap, gap_fill::carry_forward);
+         for (uint64_t testGapIndex = 0; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrice[0], testPrevPrice[1], testPrevPrice[2]);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      auto const testClosePrice = static_cast<double>(fixture.random_number<int64_t>(100, 110));
+      testPrevPrice = std::array<double, 3>{
+         testClosePrice + fixture.random_number<int64_t>(0, 5),
+         testClosePrice - fixture.random_number<int64_t>(0, 5),
+         testClosePrice,
+      };
+      auto const testExpectedValue = testExpectedIndicator.calc(testSequenceNumber, testPrevPrice[0], testPrevPrice[1], testPrevPrice[2]);
+      auto const testValue = testIndicator.calc(testSequenceNumber, testPrevPrice[0], testPrevPrice[1], testPrevPrice[2]);
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_EQ(testExpectedValue, testValue);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, WilliamsPercentRangeSkip)
+{
+   constexpr uint32_t testFixedPeriod = 14;
+   for (uint32_t testPeriod = 2; testPeriod <= 50; ++testPeriod)
+   {
+      williams_percent_range<> testIndicator{testPeriod};
+      williams_percent_range<> testExpectedIndicator{testPeriod};
+      ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   williams_percent_range<testFixedPeriod> testFixedIndicator{};
+   williams_percent_range<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_williams_percent_range_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
 }
@@ -0,0 +1,372 @@
+/*
+   Part of the TeAn Project (https://github.com/cpp4ever/tean), under the MIT License
+   SPDX-License-Identifier: MIT
+
+   Copyright (c) 2024-2026 Mikhail Smirnov
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to deal
+   in the Software without restriction, including without limitation the rights
+   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+   copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in all
+   copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+#include "decimal.tests.hpp" /// for tean::tests::decimal, tean::tests::inverted_power_of_ten, tean::tests::power_of_ten
+#include "memory_resource.tests.hpp" /// for tean::tests::counting_memory_resource
+#include "tean.tests.hpp" /// for tean::tests::TeAn
+
+#include "tean/indicator_state.hpp" /// for tean::state_reader, tean::state_writer
+#include "tean/linear_regression.hpp" /// for tean::linear_regression
+#include "tean/maximum_in_period.hpp" /// for tean::maximum_in_period
+#include "tean/minimum_in_period.hpp" /// for tean::minimum_in_period
+#include "tean/simple_moving_average.hpp" /// for tean::simple_moving_average
+#include "tean/standard_deviation.hpp" /// for tean::standard_deviation
+#include "tean/sum_over_period.hpp" /// for tean::sum_over_period
+#include "tean/variance.hpp" /// for tean::variance
+#include "tean/window_statistics.hpp" /// for the test target
+#include "tean/z_score.hpp" /// for tean::z_score
+
+#include <gmock/gmock.h> /// for ASSERT_THAT, testing::DoubleNear
+#include <gtest/gtest.h> /// for ASSERT_EQ, ASSERT_FALSE, ASSERT_NO_FATAL_FAILURE, ASSERT_TRUE
+
+#include <algorithm> /// for std::max
+#include <cmath> /// for std::isnan
+#include <cstddef> /// for std::byte
+#include <cstdint> /// for int64_t, uint32_t
+#include <memory> /// for std::addressof
+#include <tuple> /// for std::ignore, std::tie
+#include <vector> /// for std::vector
+
+namespace tean::tests
+{
+
+template<typename statistics, typename... indicators>
+void test_window_statistics_step(
+   TeAn &fixture,
+   decimal const testPriceStep,
+   uint32_t const testPeriod,
+   statistics &testStatistics,
+   indicators &...testIndicators
+)
+{
+   auto const testIndicatorsTuple{std::tie(testIndicators...),};
+   auto &[testSum, testMovingAverage, testVariance, testStandardDeviation, testZScore, testMaximum, testMinimum, testLinearRegression] = testIndicatorsTuple;
+   auto const testIterationsNumber{testPeriod * 10,};
+   auto const testPricePrecision{inverted_power_of_ten[testPriceStep.scale / 3] * inverted_power_of_ten[3],};
+   double const testPriceStepValue{testPriceStep,};
+   for (uint32_t testReset{0,}; testReset < 2; ++testReset)
+   {
+      for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+      {
+         auto const testPrice{testPriceStepValue * fixture.random_number<int64_t>(power_of_ten[testPriceStep.scale], power_of_ten[testPriceStep.scale + 2]),};
+         testStatistics.calc(testIteration, testPrice);
+         ASSERT_EQ(testPrice, testStatistics.newest());
+         auto const testSumValue{testSum.calc(testIteration, testPrice),};
+         auto const testMovingAverageValue{testMovingAverage.calc(testIteration, testPrice),};
+         auto const testVarianceValue{testVariance.calc(testIteration, testPrice),};
+         auto const testStandardDeviationValue{testStandardDeviation.calc(testIteration, testPrice),};
+         auto const testZScoreValue{testZScore.calc(testIteration, testPrice),};
+         auto const testMaximumValue{testMaximum.calc(testIteration, testPrice),};
+         auto const testMinimumValue{testMinimum.calc(testIteration, testPrice),};
+         auto const testLinearRegressionValue{testLinearRegression.calc(testIteration, testPrice),};
+         if ((testPeriod - 1) > testIteration)
+         {
+            ASSERT_TRUE(std::isnan(testStatistics.sum()));
+            ASSERT_TRUE(std::isnan(testStatistics.mean()));
+            ASSERT_TRUE(std::isnan(testStatistics.variance()));
+            ASSERT_TRUE(std::isnan(testStatistics.z_score()));
+            ASSERT_TRUE(std::isnan(testStatistics.maximum()));
+            ASSERT_TRUE(std::isnan(testStatistics.minimum()));
+            ASSERT_TRUE(std::isnan(testStatistics.linear_regression().slope));
+            continue;
+         }
+         ASSERT_THAT(testStatistics.sum(), testing::DoubleNear(testSumValue, testPricePrecision));
+         ASSERT_THAT(testStatistics.mean(), testing::DoubleNear(testMovingAverageValue, testPricePrecision));
+         ASSERT_THAT(testStatistics.variance(), testing::DoubleNear(testVarianceValue, std::max(testPricePrecision, testVarianceValue * inverted_power_of_ten[9])));
+         ASSERT_THAT(testStatistics.standard_deviation(), testing::DoubleNear(testStandardDeviationValue, testPricePrecision));
+         ASSERT_THAT(testStatistics.z_score(), testing::DoubleNear(testZScoreValue, testPricePrecision));
+         ASSERT_EQ(testStatistics.maximum(), testMaximumValue);
+         ASSERT_EQ(testStatistics.minimum(), testMinimumValue);
+         ASSERT_THAT(testStatistics.linear_regression().intercept, testing::DoubleNear(testLinearRegressionValue.intercept, testPricePrecision));
+         ASSERT_THAT(testStatistics.linear_regression().slope, testing::DoubleNear(testLinearRegressionValue.slope, testPricePrecision));
+      }
+      testStatistics.reset();
+      (testIndicators.reset(), ...);
+   }
+}
+
+template<uint32_t test_period>
+void test_window_statistics(TeAn &fixture, decimal const testPriceStep)
+{
+   {
+      window_statistics<test_period> testStatistics{};
+      sum_over_period<test_period> testSum{};
+      simple_moving_average<test_period> testMovingAverage{};
+      variance<test_period> testVariance{};
+      standard_deviation<test_period> testStandardDeviation{};
+      z_score<test_period> testZScore{};
+      maximum_in_period<test_period> testMaximum{};
+      minimum_in_period<test_period> testMinimum{};
+      linear_regression<test_period> testLinearRegression{};
+      ASSERT_EQ(testStatistics.lookback_period, testMovingAverage.lookback_period);
+      ASSERT_NO_FATAL_FAILURE(
+         test_window_statistics_step(
+            fixture,
+            testPriceStep,
+            test_period,
+            testStatistics,
+            testSum,
+            testMovingAverage,
+            testVariance,
+            testStandardDeviation,
+            testZScore,
+            testMaximum,
+            testMinimum,
+            testLinearRegression
+         )
+      );
+   }
+   {
+      window_statistics<> testStatistics{test_period,};
+      sum_over_period<> testSum{test_period,};
+      simple_moving_average<> testMovingAverage{test_period,};
+      variance<> testVariance{test_period,};
+      standard_deviation<> testStandardDeviation{test_period,};
+      z_score<> testZScore{test_period,};
+      maximum_in_period<> testMaximum{test_period,};
+      minimum_in_period<> testMinimum{test_period,};
+      linear_regression<> testLinearRegression{test_period,};
+      ASSERT_EQ(test_period, testStatistics.period());
+      ASSERT_EQ(testStatistics.lookback_period(), testMovingAverage.lookback_period());
+      ASSERT_NO_FATAL_FAILURE(
+         test_window_statistics_step(
+            fixture,
+            testPriceStep,
+            test_period,
+            testStatistics,
+            testSum,
+            testMovingAverage,
+            testVariance,
+            testStandardDeviation,
+            testZScore,
+            testMaximum,
+            testMinimum,
+            testLinearRegression
+         )
+      );
+   }
+   if constexpr (2 < test_period)
+   {
+      test_window_statistics<test_period - 1>(fixture, testPriceStep);
+   }
+}
+
+TEST_F(TeAn, WindowStatistics)
+{
+   constexpr uint32_t testMaxPeriod{50,};
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+TEST_F(TeAn, WindowStatisticsFeatures)
+{
+   constexpr uint32_t testPeriod{20,};
+   constexpr auto testFeatures{window_statistics_features::maximum | window_statistics_features::minimum,};
+   window_statistics<testPeriod, testFeatures> testStatistics{};
+   window_statistics<> testRuntimeStatistics{testPeriod,};
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 10); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(random_number<int64_t>(100, 1000)),};
+      testStatistics.calc(testIteration, testPrice);
+      testRuntimeStatistics.calc(testIteration, testPrice);
+      if ((testPeriod - 1) <= testIteration)
+      {
+         ASSERT_EQ(testStatistics.maximum(), testRuntimeStatistics.maximum());
+         ASSERT_EQ(testStatistics.minimum(), testRuntimeStatistics.minimum());
+      }
+   }
+}
+
+template<typename statistics, typename restored_statistics, typename other_period_statistics>
+void test_window_statistics_state(TeAn &fixture, statistics &testStatistics, restored_statistics &testRestoredStatistics, other_period_statistics &testOtherPeriodStatistics, uint32_t const testPeriod)
+{
+   /// The ring cursor, both deques and the sums move with every calc, so the state may be saved at any phase of the window
+   auto const testIterationsNumber{fixture.random_number<uint32_t>(1, testPeriod * 3),};
+   for (uint32_t testIteration{0,}; testIteration < testIterationsNumber; ++testIteration)
+   {
+      testStatistics.calc(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+   }
+   std::vector<std::byte> testState;
+   state_writer testWriter{testState,};
+   testStatistics.save(testIterationsNumber - 1, testWriter);
+   /// States of another format version, of another sequence number or of another period are rejected
+   auto testOtherVersionState{testState,};
+   testOtherVersionState.front() ^= std::byte{0xff};
+   state_reader testOtherVersionReader{testOtherVersionState,};
+   ASSERT_FALSE(testRestoredStatistics.load(testIterationsNumber - 1, testOtherVersionReader));
+   ASSERT_FALSE(testOtherVersionReader.good());
+   state_reader testOtherSequenceNumberReader{testState,};
+   ASSERT_FALSE(testRestoredStatistics.load(testIterationsNumber, testOtherSequenceNumberReader));
+   state_reader testOtherPeriodReader{testState,};
+   ASSERT_FALSE(testOtherPeriodStatistics.load(testIterationsNumber - 1, testOtherPeriodReader));
+   /// A failed load may leave the window partially restored, so it is reset before the state is loaded for good
+   testRestoredStatistics.reset();
+   state_reader testReader{testState,};
+   ASSERT_TRUE(testRestoredStatistics.load(testIterationsNumber - 1, testReader));
+   ASSERT_EQ(testState.size(), testReader.position());
+   for (auto testIteration{testIterationsNumber,}; testIteration < (testIterationsNumber + testPeriod * 2); ++testIteration)
+   {
+      auto const testPrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      testStatistics.calc(testIteration, testPrice);
+      testRestoredStatistics.calc(testIteration, testPrice);
+      if ((testPeriod - 1) > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testRestoredStatistics.mean()));
+         continue;
+      }
+      ASSERT_EQ(testStatistics.mean(), testRestoredStatistics.mean());
+      ASSERT_EQ(testStatistics.variance(), testRestoredStatistics.variance());
+      ASSERT_EQ(testStatistics.maximum(), testRestoredStatistics.maximum());
+      ASSERT_EQ(testStatistics.minimum(), testRestoredStatistics.minimum());
+      ASSERT_EQ(testStatistics.linear_regression().slope, testRestoredStatistics.linear_regression().slope);
+   }
+}
+
+TEST_F(TeAn, WindowStatisticsState)
+{
+   constexpr uint32_t testFixedPeriod{14,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      window_statistics<> testStatistics{testPeriod,};
+      window_statistics<> testRestoredStatistics{testPeriod,};
+      window_statistics<> testOtherPeriodStatistics{testPeriod + 1,};
+      ASSERT_NO_FATAL_FAILURE(test_window_statistics_state(*this, testStatistics, testRestoredStatistics, testOtherPeriodStatistics, testPeriod));
+   }
+   /// Heap, fixed period and foreign memory resource windows share the state layout, loading into them never allocates
+   counting_memory_resource testMemoryResource;
+   window_statistics<> testStatistics{testFixedPeriod,};
+   window_statistics<> testArenaStatistics{testFixedPeriod, std::addressof(testMemoryResource),};
+   window_statistics<testFixedPeriod> testFixedStatistics{};
+   window_statistics<> testOtherPeriodStatistics{testFixedPeriod + 1,};
+   auto const testAllocationsNumber{testMemoryResource.allocations(),};
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics_state(*this, testStatistics, testArenaStatistics, testOtherPeriodStatistics, testFixedPeriod));
+   testStatistics.reset();
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics_state(*this, testStatistics, testFixedStatistics, testOtherPeriodStatistics, testFixedPeriod));
+   testFixedStatistics.reset();
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics_state(*this, testFixedStatistics, testStatistics, testOtherPeriodStatistics, testFixedPeriod));
+   ASSERT_EQ(testAllocationsNumber, testMemoryResource.allocations());
+   /// A window tracking other features is rejected as well
+   window_statistics<testFixedPeriod, window_statistics_features::sum> testOtherFeaturesStatistics{};
+   std::vector<std::byte> testState;
+   state_writer testWriter{testState,};
+   testFixedStatistics.reset();
+   testFixedStatistics.calc(0, 100.0);
+   testFixedStatistics.save(0, testWriter);
+   state_reader testReader{testState,};
+   ASSERT_FALSE(testOtherFeaturesStatistics.load(0, testReader));
+}
+
+template<typename statistics>
+void test_window_statistics_pick(TeAn &fixture, statistics &testStatistics, uint32_t const testPeriod)
+{
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 10); ++testIteration)
+   {
+      /// Picks leave the window intact, the last one must match the accessors after a calc with the same value
+      for (auto testPicksNumber{fixture.random_number<uint32_t>(0, 3),}; 0 < testPicksNumber; --testPicksNumber)
+      {
+         std::ignore = testStatistics.pick(testIteration, static_cast<double>(fixture.random_number<int64_t>(100, 1000)));
+      }
+      auto const testPrice{static_cast<double>(fixture.random_number<int64_t>(100, 1000)),};
+      auto const testValue{testStatistics.pick(testIteration, testPrice),};
+      testStatistics.calc(testIteration, testPrice);
+      if ((testPeriod - 1) > testIteration)
+      {
+         ASSERT_TRUE(std::isnan(testValue.sum));
+         ASSERT_TRUE(std::isnan(testValue.maximum));
+         ASSERT_TRUE(std::isnan(testValue.minimum));
+         continue;
+      }
+      if constexpr (requires { testStatistics.sum(); })
+      {
+         ASSERT_EQ(testStatistics.sum(), testValue.sum);
+         ASSERT_EQ(testStatistics.mean(), testValue.mean);
+      }
+      else
+      {
+         ASSERT_TRUE(std::isnan(testValue.sum));
+         ASSERT_TRUE(std::isnan(testValue.mean));
+      }
+      if constexpr (requires { testStatistics.variance(); })
+      {
+         ASSERT_EQ(testStatistics.variance(), testValue.variance);
+         ASSERT_EQ(testStatistics.standard_deviation(), testValue.standard_deviation);
+         ASSERT_EQ(testStatistics.z_score(), testValue.z_score);
+      }
+      else
+      {
+         ASSERT_TRUE(std::isnan(testValue.variance));
+         ASSERT_TRUE(std::isnan(testValue.z_score));
+      }
+      if constexpr (requires { testStatistics.linear_regression(); })
+      {
+         ASSERT_EQ(testStatistics.linear_regression().intercept, testValue.linear_regression.intercept);
+         ASSERT_EQ(testStatistics.linear_regression().slope, testValue.linear_regression.slope);
+      }
+      else
+      {
+         ASSERT_TRUE(std::isnan(testValue.linear_regression.slope));
+      }
+      if constexpr (requires { testStatistics.maximum(); })
+      {
+         ASSERT_EQ(testStatistics.maximum(), testValue.maximum);
+      }
+      else
+      {
+         ASSERT_TRUE(std::isnan(testValue.maximum));
+      }
+      if constexpr (requires { testStatistics.minimum(); })
+      {
+         ASSERT_EQ(testStatistics.minimum(), testValue.minimum);
+      }
+      else
+      {
+         ASSERT_TRUE(std::isnan(testValue.minimum));
+      }
+   }
+}
+
+TEST_F(TeAn, WindowStatisticsPick)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   constexpr auto testExtremumFeatures{window_statistics_features::maximum | window_statistics_features::minimum,};
+   constexpr auto testSumFeatures{window_statistics_features::sum | window_statistics_features::sum_of_squares,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      window_statistics<> testStatistics{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_window_statistics_pick(*this, testStatistics, testPeriod));
+      window_statistics<static_cast<uint32_t>(-1), testExtremumFeatures> testExtremumStatistics{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_window_statistics_pick(*this, testExtremumStatistics, testPeriod));
+      window_statistics<static_cast<uint32_t>(-1), testSumFeatures> testSumStatistics{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_window_statistics_pick(*this, testSumStatistics, testPeriod));
+   }
+   window_statistics<testFixedPeriod> testFixedStatistics{};
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics_pick(*this, testFixedStatistics, testFixedPeriod));
+   window_statistics<testFixedPeriod, testExtremumFeatures> testFixedExtremumStatistics{};
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics_pick(*this, testFixedExtremumStatistics, testFixedPeriod));
+   window_statistics<testFixedPeriod, window_statistics_features::sum_xy> testFixedRegressionStatistics{};
+   ASSERT_NO_FATAL_FAILURE(test_window_statistics_pick(*this, testFixedRegressionStatistics, testFixedPeriod));
+}
+
+}
@@ -26,6 +26,7 @@
 #include "decimal.tests.hpp"
 #include "tean.tests.hpp"
 
+#include "tean/gap_fill.hpp"
 #include "tean/standard_deviation.hpp"
 #include "tean/z_score.hpp"
 
@@ -159,4 +160,131 @@ TEST_F(TeAn, ZScore)
    ASSERT_NO_FATAL_FAILURE(test_z_score<testMaxPeriod>(*this, decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
 }
 
+template<typename indicator>
+void test_z_score_pick_many(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      /// More candidates than one stack chunk holds, each must see the same committed state as a single pick
+      std::vector<double> testCandidates(fixture.random_number<size_t>(1, 200));
+      for (auto &testCandidate : testCandidates)
+      {
+         testCandidate = testPriceStepValue * fixture.random_number<int64_t>(100, 1000);
+      }
+      std::vector<double> testValues(testCandidates.size());
+      testIndicator.pick_many(testIteration, testCandidates, testValues);
+      for (size_t testCandidateIndex{0,}; testCandidateIndex < testCandidates.size(); ++testCandidateIndex)
+      {
+         auto const testExpectedValue{testIndicator.pick(testIteration, testCandidates[testCandidateIndex]),};
+         ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValues[testCandidateIndex]));
+         if (false == std::isnan(testExpectedValue))
+         {
+            ASSERT_EQ(testExpectedValue, testValues[testCandidateIndex]);
+         }
+      }
+      std::ignore = testIndicator.calc(testIteration, testPriceStepValue * fixture.random_number<int64_t>(100, 1000));
+   }
+}
+
+TEST_F(TeAn, ZScorePickMany)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      double const testPriceStepValue{testPriceStep,};
+      auto const testPeriod{random_number<uint32_t>(2, 50),};
+      z_score<> testIndicator{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_z_score_pick_many(*this, testIndicator, testPeriod, testPriceStepValue));
+      z_score<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_z_score_pick_many(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_z_score_solve(TeAn &fixture, indicator &testIndicator, uint32_t const testPeriod, double const testPriceStepValue)
+{
+   /// Prices keep rising, so the retained values are never flat
+   auto testPrice{testPriceStepValue * 100,};
+   for (uint32_t testIteration{0,}; testIteration < (testPeriod * 4); ++testIteration)
+   {
+      auto const testTarget{fixture.random_number<double>(-2.0, 2.0),};
+      auto const testValue{testIndicator.solve(testIteration, testTarget),};
+      if (((testPeriod - 1) > testIteration) || (static_cast<double>(testPeriod - 1) <= (testTarget * testTarget)))
+      {
+         ASSERT_TRUE(std::isnan(testValue));
+      }
+      else
+      {
+         ASSERT_TRUE(std::isfinite(testValue));
+         ASSERT_NEAR(testTarget, testIndicator.pick(testIteration, testValue), 1e-6);
+      }
+      testPrice += testPriceStepValue * fixture.random_number<int64_t>(1, 10);
+      std::ignore = testIndicator.calc(testIteration, testPrice);
+   }
+}
+
+TEST_F(TeAn, ZScoreSolve)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   auto const testStep = [&] (decimal const testPriceStep)
+   {
+      double const testPriceStepValue{testPriceStep,};
+      for (uint32_t testPeriod{3,}; testPeriod <= 50; ++testPeriod)
+      {
+         z_score<> testIndicator{testPeriod,};
+         ASSERT_NO_FATAL_FAILURE(test_z_score_solve(*this, testIndicator, testPeriod, testPriceStepValue));
+      }
+      z_score<testFixedPeriod> testFixedIndicator{};
+      ASSERT_NO_FATAL_FAILURE(test_z_score_solve(*this, testFixedIndicator, testFixedPeriod, testPriceStepValue));
+   };
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[0]), .scale = 12}));
+   ASSERT_NO_FATAL_FAILURE(testStep(decimal{.value = static_cast<int64_t>(power_of_ten[6]), .scale = 00}));
+}
+
+template<typename indicator>
+void test_z_score_skip(TeAn &fixture, indicator &testIndicator, indicator &testExpectedIndicator, uint32_t const testPeriod)
+{
+   auto testPrevPrice{0.0,};
+   uint64_t testSequenceNumber{0,};
+   while ((testPeriod * 8) > testSequenceNumber)
+   {
+      if ((0 < testSequenceNumber) && (0 == fixture.random_number<uint32_t>(0, 4)))
+      {
+         /// Carried forward and zero volume bars repeat the latest value
+         auto const testGap{fixture.random_number<uint64_t>(1, testPeriod * 3),};
+         testIndicator.skip(testSequenceNumber, testGap, fixture.random_bool() ? gap_fill::carry_forward : gap_fill::zero_volume);
+         for (uint64_t testGapIndex{0,}; testGapIndex < testGap; ++testGapIndex)
+         {
+            std::ignore = testExpectedIndicator.calc(testSequenceNumber + testGapIndex, testPrevPrice);
+         }
+         testSequenceNumber += testGap;
+         continue;
+      }
+      testPrevPrice = static_cast<double>(fixture.random_number<int64_t>(100, 1000));
+      auto const testExpectedValue{testExpectedIndicator.calc(testSequenceNumber, testPrevPrice),};
+      auto const testValue{testIndicator.calc(testSequenceNumber, testPrevPrice),};
+      ASSERT_EQ(std::isnan(testExpectedValue), std::isnan(testValue));
+      if (false == std::isnan(testExpectedValue))
+      {
+         ASSERT_EQ(testExpectedValue, testValue);
+      }
+      ++testSequenceNumber;
+   }
+}
+
+TEST_F(TeAn, ZScoreSkip)
+{
+   constexpr uint32_t testFixedPeriod{20,};
+   for (uint32_t testPeriod{2,}; testPeriod <= 50; ++testPeriod)
+   {
+      z_score<> testIndicator{testPeriod,};
+      z_score<> testExpectedIndicator{testPeriod,};
+      ASSERT_NO_FATAL_FAILURE(test_z_score_skip(*this, testIndicator, testExpectedIndicator, testPeriod));
+   }
+   z_score<testFixedPeriod> testFixedIndicator{};
+   z_score<testFixedPeriod> testExpectedFixedIndicator{};
+   ASSERT_NO_FATAL_FAILURE(test_z_score_skip(*this, testFixedIndicator, testExpectedFixedIndicator, testFixedPeriod));
+}
 }